@@ -0,0 +1,135 @@
+
+/** $VER: Articulation.h (2026.10.18) P. Stuer - Block-based envelope and LFO engine **/
+
+#pragma once
+
+#include <vector>
+
+#include "Region.h"
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Evaluates the volume envelope, the modulation envelope, the modulation LFO and the vibrato LFO of many voices at once.
+/// The state is kept in structure-of-arrays form and advanced once per block. The results are converted with the lookup tables of sf::units.
+/// </summary>
+class articulation_engine_t
+{
+public:
+    static constexpr uint32_t NoSlot = ~0u;
+
+    enum class stage_t : uint8_t
+    {
+        Delay, Attack, Hold, Decay, Sustain, Release, Finished
+    };
+
+    articulation_engine_t(uint32_t sampleRate, uint32_t capacity);
+
+    articulation_engine_t(const articulation_engine_t &) = delete;
+    articulation_engine_t & operator=(const articulation_engine_t &) = delete;
+
+    uint32_t Start(const region_t & region, int key) noexcept;
+    void Release(uint32_t slot) noexcept;
+    void Free(uint32_t slot) noexcept;
+
+    bool SetGenerator(uint32_t slot, GeneratorOperator generator, float value) noexcept;
+
+    void Process(uint32_t frameCount) noexcept;
+
+    // Results of the last call to Process(), indexed by slot.
+    const float * GetGains() const noexcept { return _Gain.data(); }
+    const float * GetPitchRatios() const noexcept { return _PitchRatio.data(); }
+    const float * GetFilterCutoffs() const noexcept { return _FilterCutoff.data(); }
+
+    float GetGain(uint32_t slot) const noexcept { return _Gain[slot]; }                 // Volume envelope and modulation LFO, linear
+    float GetPitchRatio(uint32_t slot) const noexcept { return _PitchRatio[slot]; }     // Modulation envelope and both LFOs, as a frequency ratio
+    float GetFilterCutoff(uint32_t slot) const noexcept { return _FilterCutoff[slot]; } // initialFilterFc with the modulation envelope and modulation LFO, in Hz
+
+    stage_t GetStage(uint32_t slot) const noexcept { return (stage_t) _VolEnv.Stage[slot]; }
+    bool IsFinished(uint32_t slot) const noexcept { return _VolEnv.Stage[slot] == (uint8_t) stage_t::Finished; }
+
+    uint32_t GetCapacity() const noexcept { return (uint32_t) _Gain.size(); }
+    uint32_t GetActiveCount() const noexcept { return GetCapacity() - (uint32_t) _FreeSlots.size(); }
+
+private:
+    /// <summary>
+    /// The state of one kind of DAHDSR envelope for all slots.
+    /// </summary>
+    struct envelope_t
+    {
+        void Resize(size_t size);
+
+        void Start(uint32_t slot, int32_t delay, int32_t attack, int32_t hold, int32_t decay, float sustain, int32_t release) noexcept;
+        void Release(uint32_t slot, bool isLogarithmic) noexcept;
+        void Stop(uint32_t slot) noexcept;
+
+        void Advance(uint32_t first, uint32_t last, int32_t frameCount) noexcept;
+        void Enter(uint32_t slot, stage_t stage) noexcept;
+
+        // State
+        std::vector<uint8_t> Stage;
+        std::vector<int32_t> Remaining;     // Frames left in the stage
+        std::vector<float> Value;           // 0.0 - 1.0
+        std::vector<float> Rate;            // Change of the value per frame
+
+        // Parameters
+        std::vector<int32_t> DelayFrames;
+        std::vector<int32_t> AttackFrames;
+        std::vector<int32_t> HoldFrames;
+        std::vector<float> DecayRate;       // Full-scale change per frame
+        std::vector<float> ReleaseRate;     // Full-scale change per frame
+        std::vector<float> Sustain;
+    };
+
+    /// <summary>
+    /// The state of one kind of triangle LFO for all slots.
+    /// </summary>
+    struct lfo_t
+    {
+        void Resize(size_t size);
+
+        void Start(uint32_t slot, int32_t delay, float increment) noexcept;
+        void Advance(uint32_t first, uint32_t last, int32_t frameCount) noexcept;
+
+        std::vector<int32_t> Delay;         // Frames left before the LFO starts
+        std::vector<float> Phase;           // 0.0 - 1.0
+        std::vector<float> Increment;       // Phase change per frame
+        std::vector<float> Value;           // -1.0 - 1.0
+    };
+
+    void Evaluate(uint32_t first, uint32_t last) noexcept;
+
+    int32_t ToFrames(int32_t timecents) const noexcept;
+
+private:
+    uint32_t _SampleRate;
+    uint32_t _SlotCount;                    // Slots up to the highest one in use.
+
+    std::vector<uint32_t> _FreeSlots;
+
+    envelope_t _VolEnv;                     // Value is linear in amplitude during the attack and linear in dB (0.0 = -96 dB) otherwise.
+    envelope_t _ModEnv;                     // Value is linear.
+    lfo_t _ModLFO;
+    lfo_t _VibLFO;
+
+    // Modulation depths
+    std::vector<float> _ModLfoToPitch;
+    std::vector<float> _VibLfoToPitch;
+    std::vector<float> _ModEnvToPitch;
+    std::vector<float> _InitialFilterFc;
+    std::vector<float> _ModLfoToFilterFc;
+    std::vector<float> _ModEnvToFilterFc;
+    std::vector<float> _ModLfoToVolume;
+
+    // Results
+    std::vector<float> _Gain;
+    std::vector<float> _PitchRatio;
+    std::vector<float> _FilterCutoff;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
@@ -0,0 +1,124 @@
+
+/** $VER: AsyncReader.h (2026.10.18) P. Stuer - Batched asynchronous reads of file ranges **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Platform.h"
+
+namespace sf
+{
+
+class thread_pool_t;
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Describes a range of a file to read and the buffer that receives it.
+/// </summary>
+struct read_request_t
+{
+    uint64_t Offset;                        // in bytes, from the start of the file
+    void * Data;
+    uint32_t Size;                          // in bytes
+    uint32_t BytesRead;                     // Set when the batch completes. Less than Size at the end of the file or on an error.
+};
+
+/// <summary>
+/// Options for the asynchronous reader.
+/// </summary>
+struct async_reader_options_t
+{
+    async_reader_options_t() : QueueDepth(128), MaxGap(16384), MaxReadSize(4 * 1024 * 1024), ThreadCount(4), UseIOUring(true) { }
+
+    uint32_t QueueDepth;                    // Maximum number of reads in flight.
+    uint32_t MaxGap;                        // Requests separated by no more than this many bytes are coalesced into one read; the gap is read and discarded.
+    uint32_t MaxReadSize;                   // Maximum size of a coalesced read.
+    uint32_t ThreadCount;                   // Worker threads of the fallback.
+    bool UseIOUring;                        // Use io_uring on Linux when the kernel allows it.
+};
+
+/// <summary>
+/// Reads batches of file ranges into caller-provided buffers. The requests of a batch are sorted, and adjacent or nearby ranges are coalesced into
+/// vectored reads that scatter directly into the buffers. On Linux the reads are submitted through io_uring, so a batch that fits in the queue
+/// costs a single system call. Elsewhere, or when io_uring is not available, a thread pool issues the reads.
+/// One batch can be in flight at a time. The requests and their buffers must stay valid until Wait() returns.
+/// </summary>
+class async_reader_t
+{
+public:
+    async_reader_t(const std::filesystem::path & filePath, const async_reader_options_t & options = { });
+    ~async_reader_t();
+
+    async_reader_t(const async_reader_t &) = delete;
+    async_reader_t & operator=(const async_reader_t &) = delete;
+
+    void Submit(std::span<read_request_t> requests);
+    void Wait();
+
+    void Read(std::span<read_request_t> requests);
+
+    bool IsIOUring() const noexcept { return _Ring != nullptr; }
+    const char * GetBackendName() const noexcept { return IsIOUring() ? "io_uring" : "thread pool"; }
+
+    uint64_t GetFileSize() const noexcept { return _File.Size(); }
+
+    uint64_t GetRequestCount() const noexcept { return _RequestCount; }
+    uint64_t GetReadCount() const noexcept { return _ReadCount; }
+    uint64_t GetSystemCallCount() const noexcept { return _SystemCallCount; }
+
+private:
+    /// <summary>
+    /// A coalesced read.
+    /// </summary>
+    struct read_t
+    {
+        uint64_t Offset;
+        uint64_t Size;
+        uint32_t FirstVector;
+        uint32_t VectorCount;
+        uint32_t FirstRequest;              // Index in _Order
+        uint32_t RequestCount;
+    };
+
+    struct ring_t;
+
+    void Plan(std::span<read_request_t> requests);
+    void Complete(const read_t & read, uint64_t bytesRead) noexcept;
+
+    void Pump(bool wait);
+
+    bool CreateRing(uint32_t entries) noexcept;
+    void DestroyRing() noexcept;
+
+private:
+    async_reader_options_t _Options;
+
+    platform::file_t _File;
+
+    std::span<read_request_t> _Requests;
+    std::vector<uint32_t> _Order;           // Request indices sorted by offset
+    std::vector<read_t> _Reads;
+    std::vector<platform::io_vector_t> _Vectors;
+    std::vector<uint8_t> _Gap;              // Receives the gaps between coalesced requests, MaxGap bytes per worker
+
+    size_t _NextRead;                       // First read that has not been submitted
+    size_t _InFlight;
+
+    ring_t * _Ring;                         // io_uring instance, or nullptr
+    std::unique_ptr<thread_pool_t> _Pool;
+
+    uint64_t _RequestCount;
+    uint64_t _ReadCount;
+    uint64_t _SystemCallCount;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
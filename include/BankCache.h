@@ -0,0 +1,163 @@
+
+/** $VER: BankCache.h (2026.10.18) P. Stuer - Precompiled binary bank cache that is loaded by mapping it into memory **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "Region.h"
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Represents a preset in the bank cache. The presets are sorted by key.
+/// </summary>
+struct cached_preset_t
+{
+    uint32_t Key;                           // (MIDI bank << 16) | MIDI program
+    uint32_t PresetIndex;                   // Index of the preset in the source bank.
+    uint32_t FirstRegion;
+    uint32_t RegionCount;
+    uint32_t NameOffset;                    // Offset in the name pool.
+};
+
+/// <summary>
+/// Represents a resolved region in the bank cache: the contents of a region_t without the sample pointer.
+/// </summary>
+struct cached_region_t
+{
+    int32_t Get(GeneratorOperator generator) const noexcept { return Generators[(size_t) generator]; }
+
+    uint32_t SampleIndex;
+
+    uint8_t KeyLo, KeyHi;
+    uint8_t VelLo, VelHi;
+
+    uint32_t PresetGlobalZoneIndex;
+    uint32_t PresetZoneIndex;
+    uint32_t InstrumentGlobalZoneIndex;
+    uint32_t InstrumentZoneIndex;
+
+    int32_t Generators[region_t::GeneratorCount];
+};
+
+/// <summary>
+/// Represents a sample header in the bank cache.
+/// </summary>
+struct cached_sample_t
+{
+    uint32_t Start;                         // in sample data points
+    uint32_t End;
+    uint32_t LoopStart;
+    uint32_t LoopEnd;
+    uint32_t SampleRate;
+     uint8_t Pitch;
+      int8_t PitchCorrection;
+    uint16_t SampleLink;
+    uint16_t SampleType;
+    uint16_t Reserved;
+    uint32_t NameOffset;                    // Offset in the name pool.
+};
+
+static_assert(sizeof(cached_preset_t) == 20);
+static_assert(sizeof(cached_region_t) == 24 + 4 * region_t::GeneratorCount);
+static_assert(sizeof(cached_sample_t) == 32);
+
+/// <summary>
+/// Implements a versioned, position-independent cache of a parsed bank with its regions already resolved. The cache is mapped into memory and used in place:
+/// opening it involves no parsing and no allocation. All offsets are relative to the start of the file and the sample data is page-aligned.
+/// A cache is identified by the content hash of the file it was created from (see catalog_t::HashFile()), so a modified bank never matches a stale cache.
+/// Modulators are not cached; use the zone indices of a region with the source bank to compile them.
+/// </summary>
+class bank_cache_t
+{
+public:
+    bank_cache_t() noexcept : _Header(), _Names(), _NamesSize() { }
+
+    bank_cache_t(const bank_cache_t &) = delete;
+    bank_cache_t & operator=(const bank_cache_t &) = delete;
+
+    bool Open(const std::filesystem::path & filePath, uint64_t sourceHash = 0);
+    void Close() noexcept;
+
+    bool IsOpen() const noexcept { return _Header != nullptr; }
+
+    static void Write(const std::filesystem::path & filePath, const bank_t & bank, uint64_t sourceHash);
+    static std::filesystem::path GetPath(const std::filesystem::path & directoryPath, uint64_t sourceHash);
+
+    int FindPreset(uint16_t midiBank, uint16_t midiProgram) const noexcept;
+    size_t Resolve(uint16_t midiBank, uint16_t midiProgram, uint8_t key, uint8_t velocity, std::span<const cached_region_t *> regions) const noexcept;
+    bool GetSampleRanges(uint16_t midiBank, uint16_t midiProgram, std::vector<sample_range_t> & ranges) const;
+
+    std::span<const cached_preset_t> Presets() const noexcept { return GetSpan<cached_preset_t>(_Header->Presets); }
+    std::span<const cached_region_t> Regions() const noexcept { return GetSpan<cached_region_t>(_Header->Regions); }
+    std::span<const cached_sample_t> Samples() const noexcept { return GetSpan<cached_sample_t>(_Header->Samples); }
+
+    std::span<const cached_region_t> GetRegions(const cached_preset_t & preset) const noexcept { return Regions().subspan(preset.FirstRegion, preset.RegionCount); }
+
+    std::span<const int16_t> SampleData() const noexcept { return GetSpan<int16_t>(_Header->SampleData); }
+    std::span<const uint8_t> SampleDataLSB() const noexcept { return GetSpan<uint8_t>(_Header->SampleDataLSB); }
+
+    const char * GetName(uint32_t offset) const noexcept { return (offset < _NamesSize) ? _Names + offset : ""; }
+    const char * GetBankName() const noexcept { return GetName(_Header->NameOffset); }
+
+    uint64_t GetSampleDataOffset() const noexcept { return _Header->SampleData.Offset; } // File offset of the 16-bit sample data, for streaming.
+    uint64_t GetSourceHash() const noexcept { return _Header->SourceHash; }
+    uint32_t GetSamplePadding() const noexcept { return _Header->SamplePadding; }
+
+    static constexpr uint32_t Magic = 0x43424653; // "SFBC"
+    static constexpr uint32_t Version = 1;
+    static constexpr uint64_t Alignment = 4096; // Alignment of the sample data
+
+private:
+    struct section_t
+    {
+        uint64_t Offset;
+        uint64_t Size;                      // in bytes
+    };
+
+    struct header_t
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t ByteOrder;                 // 0x01020304 in the byte order of the writer
+        uint32_t GeneratorCount;            // region_t::GeneratorCount of the writer
+        uint64_t SourceHash;
+        uint64_t FileSize;
+
+        section_t Presets;
+        section_t Regions;
+        section_t Samples;
+        section_t Names;
+        section_t SampleData;
+        section_t SampleDataLSB;
+
+        uint32_t NameOffset;                // Name of the bank
+        uint32_t SamplePadding;             // bank_t::SamplePadding
+    };
+
+    template <typename T> std::span<const T> GetSpan(const section_t & section) const noexcept
+    {
+        return std::span<const T>((const T *) (_File.Data() + section.Offset), (size_t) (section.Size / sizeof(T)));
+    }
+
+    bool IsValid() const noexcept;
+
+private:
+    sf::platform::mapped_file_t _File;
+
+    const header_t * _Header;
+    const char * _Names;
+    uint32_t _NamesSize;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
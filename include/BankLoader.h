@@ -0,0 +1,104 @@
+
+/** $VER: BankLoader.h (2026.10.18) P. Stuer - Process-wide service that loads and shares banks **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Soundfont.h"
+
+namespace sf
+{
+
+class thread_pool_t;
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Options for the bank loader.
+/// </summary>
+struct bank_loader_options_t
+{
+    bank_loader_options_t() : MemoryBudget((uint64_t) 1024 * 1024 * 1024), ThreadCount(), ShareSamples() { }
+
+    uint64_t MemoryBudget;                  // Maximum number of bytes of the banks that the loader keeps alive, in bytes. The most recently used bank is kept even if it exceeds the budget.
+    uint32_t ThreadCount;                   // Number of loader threads. 0 creates a thread for each hardware thread.
+    bool ShareSamples;                      // Shares the samples of the loaded banks through sample_store_t::Instance(). Shared samples don't count against the budget.
+};
+
+/// <summary>
+/// Loads SoundFont, DLS and ECW banks and shares them between the parts of a process that use the same file. Banks are identified by their canonical path,
+/// file size and last write time so a modified file is loaded again. Concurrent requests for the same file wait for a single load; different files are loaded
+/// in parallel.
+///
+/// The loader keeps the least recently used banks alive within a memory budget. An evicted bank is freed when its last user releases it; until then a request
+/// for the same file returns it without loading it again.
+/// </summary>
+class bank_loader_t
+{
+public:
+    using bank_ptr_t = std::shared_ptr<const bank_t>;
+
+    bank_loader_t(const bank_loader_options_t & options = { });
+    ~bank_loader_t();
+
+    bank_loader_t(const bank_loader_t &) = delete;
+    bank_loader_t & operator=(const bank_loader_t &) = delete;
+
+    static bank_loader_t & Instance();
+
+    std::shared_future<bank_ptr_t> LoadAsync(const std::filesystem::path & filePath);
+    bank_ptr_t Load(const std::filesystem::path & filePath) { return LoadAsync(filePath).get(); }
+
+    void Clear();
+
+    uint64_t GetMemoryUsage() const;
+    size_t GetBankCount() const;
+
+    static bank_t ReadBank(const std::filesystem::path & filePath);
+
+private:
+    /// <summary>
+    /// A bank file that is being loaded, is kept alive by the loader or may still be in use.
+    /// </summary>
+    struct entry_t
+    {
+        uint64_t FileSize;
+        int64_t LastWriteTime;
+
+        std::shared_future<bank_ptr_t> Future; // Valid while the bank is being loaded.
+        bank_ptr_t Bank;                    // Set while the bank counts against the memory budget.
+        std::weak_ptr<const bank_t> WeakBank;
+
+        uint64_t Size;                      // in bytes
+        uint64_t LastUse;
+        uint64_t LoadId;
+    };
+
+    void Complete(const std::filesystem::path & filePath, uint64_t loadId, bank_ptr_t bank, std::vector<bank_ptr_t> & evicted);
+    void Evict(const entry_t * keep, std::vector<bank_ptr_t> & evicted);
+
+    static std::shared_future<bank_ptr_t> MakeReady(bank_ptr_t bank);
+
+private:
+    bank_loader_options_t _Options;
+
+    mutable std::mutex _Mutex;
+    std::map<std::filesystem::path, entry_t> _Entries; // by canonical path
+    uint64_t _MemoryUsage;
+    uint64_t _Clock;
+    uint64_t _NextLoadId;
+
+    std::unique_ptr<thread_pool_t> _Pool;   // Destroyed first: the loads refer to the loader.
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
@@ -0,0 +1,132 @@
+
+/** $VER: BankSnapshot.h (2026.10.18) P. Stuer - Immutable bank snapshots that can be replaced while they are in use **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Region.h"
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Represents an immutable bank and its region resolver. Snapshots are shared with std::shared_ptr by the threads that may allocate and through a bank_publisher_t by real-time threads.
+/// </summary>
+class bank_snapshot_t
+{
+public:
+    bank_snapshot_t(bank_t && bank, uint64_t version = 0) : _Bank(std::move(bank)), _Resolver(_Bank), _Version(version) { }
+
+    bank_snapshot_t(const bank_snapshot_t &) = delete;
+    bank_snapshot_t & operator=(const bank_snapshot_t &) = delete;
+
+    const bank_t & GetBank() const noexcept { return _Bank; }
+    const region_resolver_t & GetResolver() const noexcept { return _Resolver; }
+    uint64_t GetVersion() const noexcept { return _Version; }
+
+private:
+    const bank_t _Bank;
+    const region_resolver_t _Resolver;
+    const uint64_t _Version;
+};
+
+/// <summary>
+/// Publishes the current snapshot of a bank to reader threads, RCU-style. Publish() replaces the snapshot with one atomic exchange; readers keep using the
+/// snapshot they acquired until they release it. A replaced snapshot is reclaimed by Publish() or Reclaim() once no reader can still use it, so the last
+/// reference is never dropped on a reader thread.
+///
+/// A real-time thread registers a reader slot once, with RegisterReader(), and then calls Acquire() with it, e.g. at the start of each audio block.
+/// Acquire() and the read lock it returns don't lock, allocate or touch a reference count. A slot holds at most one read lock at a time.
+/// </summary>
+class bank_publisher_t
+{
+public:
+    /// <summary>
+    /// Gives a reader access to the snapshot that was current when it was acquired.
+    /// </summary>
+    class read_lock_t
+    {
+    public:
+        read_lock_t() noexcept : _Slot(), _Snapshot() { }
+        read_lock_t(std::atomic<uint64_t> * slot, const bank_snapshot_t * snapshot) noexcept : _Slot(slot), _Snapshot(snapshot) { }
+        ~read_lock_t() { Release(); }
+
+        read_lock_t(const read_lock_t &) = delete;
+        read_lock_t & operator=(const read_lock_t &) = delete;
+
+        read_lock_t(read_lock_t && other) noexcept : _Slot(other._Slot), _Snapshot(other._Snapshot) { other._Slot = nullptr; other._Snapshot = nullptr; }
+        read_lock_t & operator=(read_lock_t && other) noexcept;
+
+        void Release() noexcept;
+
+        const bank_snapshot_t * Get() const noexcept { return _Snapshot; }
+        const bank_snapshot_t * operator->() const noexcept { return _Snapshot; }
+
+        explicit operator bool() const noexcept { return _Snapshot != nullptr; }
+
+    private:
+        std::atomic<uint64_t> * _Slot;
+        const bank_snapshot_t * _Snapshot;
+    };
+
+    bank_publisher_t(uint32_t maxReaders = 64);
+
+    bank_publisher_t(const bank_publisher_t &) = delete;
+    bank_publisher_t & operator=(const bank_publisher_t &) = delete;
+
+    void Publish(std::shared_ptr<const bank_snapshot_t> snapshot);
+    std::shared_ptr<const bank_snapshot_t> Get() const;
+
+    size_t Reclaim();
+
+    uint32_t RegisterReader();
+    void UnregisterReader(uint32_t reader) noexcept;
+
+    read_lock_t Acquire(uint32_t reader) const noexcept;
+
+private:
+    static constexpr uint64_t Idle = 0;     // Epoch of a slot that holds no read lock
+
+    /// <summary>
+    /// The epoch in which a reader acquired its snapshot, or Idle.
+    /// </summary>
+    struct alignas(64) slot_t
+    {
+        std::atomic<uint64_t> Epoch;
+        std::atomic<bool> IsRegistered;
+    };
+
+    /// <summary>
+    /// A replaced snapshot that readers which acquired it before the specified epoch may still use.
+    /// </summary>
+    struct retired_t
+    {
+        uint64_t Epoch;
+        std::shared_ptr<const bank_snapshot_t> Snapshot;
+    };
+
+    void ReclaimLocked(std::vector<retired_t> & reclaimed);
+
+private:
+    std::unique_ptr<slot_t[]> _Slots;
+    uint32_t _SlotCount;
+
+    std::atomic<const bank_snapshot_t *> _Current;
+    std::atomic<uint64_t> _Epoch;
+
+    mutable std::mutex _Mutex;              // Serializes the writers.
+    std::shared_ptr<const bank_snapshot_t> _CurrentOwner;
+    std::vector<retired_t> _Retired;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
@@ -1,5 +1,5 @@
 
-/** $VER: BaseTypes.h (2025.09.07) P. Stuer - Base types for soundfont handling **/
+/** $VER: BaseTypes.h (2026.10.18) P. Stuer - Base types for soundfont handling **/
 
 #pragma once
 
@@ -8,8 +8,12 @@
 #include <vector>
 #include <unordered_map>
 
+#include "Platform.h"
+
 #include <libriff.h>
 
+#include "Metrics.h"
+
 namespace sf
 {
 #pragma warning(disable: 4820) // x bytes padding
@@ -143,6 +147,20 @@ private:
 
 class soundfont_writer_base_t : public riff::writer_t
 {
+public:
+    /// <summary>
+    /// Writes a chunk and measures it.
+    /// </summary>
+    template <typename F> uint32_t WriteChunk(uint32_t chunkId, F && writer)
+    {
+        METRICS_SCOPE("Chunk", chunkId);
+
+        const uint32_t Size = riff::writer_t::WriteChunk(chunkId, std::forward<F>(writer));
+
+        METRICS_BYTES(Size);
+
+        return Size;
+    }
 };
 
 }
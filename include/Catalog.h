@@ -0,0 +1,103 @@
+
+/** $VER: Catalog.h (2026.10.18) P. Stuer - Persistent index of the banks in a directory tree **/
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "BaseTypes.h"
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Represents a preset as recorded in the catalog.
+/// </summary>
+class catalog_preset_t
+{
+public:
+    std::string Name;
+
+    uint16_t Bank;
+    uint16_t Program;
+};
+
+/// <summary>
+/// Represents a cataloged bank file.
+/// </summary>
+class catalog_entry_t
+{
+public:
+    enum FileType : uint8_t
+    {
+        Unknown = 0,
+        SoundFont = 1,                      // .sbk, .sf2, .sf3, .sf4
+        DLS = 2,                            // .dls, .dlp
+        ECW = 3,                            // .ecw
+    };
+
+public:
+    catalog_entry_t() noexcept : FileSize(), LastWriteTime(), Hash(), Type(FileType::Unknown), IsValid(), InstrumentCount(), SampleCount(), SampleDataSize() { }
+
+public:
+    std::string Path;                       // UTF-8 path, relative to the root of the cataloged directory tree.
+
+    uint64_t FileSize;                      // Size of the file in bytes.
+    int64_t LastWriteTime;                  // Last write time of the file in file clock ticks.
+    uint64_t Hash;                          // XXH64 hash of the file content (0 if content hashing was disabled).
+
+    FileType Type;
+    bool IsValid;                           // False if the file could not be parsed.
+
+    uint32_t InstrumentCount;
+    uint32_t SampleCount;
+    uint64_t SampleDataSize;                // Size of the sample data in bytes.
+
+    std::vector<catalog_preset_t> Presets;
+};
+
+struct catalog_options_t
+{
+    catalog_options_t() : HashContent(true) { }
+
+    bool HashContent;                       // Calculates a content hash for each (re-)parsed file.
+};
+
+/// <summary>
+/// Implements a persistent catalog of the banks in a directory tree. Only new and modified files are parsed when the catalog is updated.
+/// </summary>
+class catalog_t
+{
+public:
+    catalog_t() noexcept : _IsModified() { }
+
+    bool Load(const std::filesystem::path & filePath);
+    void Save(const std::filesystem::path & filePath) const;
+
+    size_t Update(const std::filesystem::path & directoryPath, const catalog_options_t & options = { });
+
+    const catalog_entry_t * Find(const std::string & path) const noexcept;
+
+    const std::vector<catalog_entry_t> & Entries() const noexcept { return _Entries; }
+
+    bool IsModified() const noexcept { return _IsModified; }
+
+    static catalog_entry_t::FileType GetFileType(const std::filesystem::path & filePath) noexcept;
+    static void Examine(const std::filesystem::path & filePath, catalog_entry_t & entry);
+    static uint64_t HashFile(const std::filesystem::path & filePath);
+
+private:
+    std::vector<catalog_entry_t> _Entries;  // Sorted by path.
+    bool _IsModified;
+
+    static const uint32_t Magic = 0x49434653; // "SFCI"
+    static const uint32_t Version = 2; // 2: Sample data size includes DLS wave data and sm24 bytes.
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
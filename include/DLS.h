@@ -1,5 +1,5 @@
 
-/** $VER: DLS.h (2025.09.07) P. Stuer - DLS data types (Based on "Downloadable Sounds Level 2.2 Version 1.0", April 2006) **/
+/** $VER: DLS.h (2026.10.18) P. Stuer - DLS data types (Based on "Downloadable Sounds Level 2.2 Version 1.0", April 2006) **/
 
 #pragma once
 
@@ -161,7 +161,7 @@ public:
 class wave_t
 {
 public:
-    wave_t() noexcept : FormatTag(WAVE_FORMAT_PCM), Channels(1), SamplesPerSec(), AvgBytesPerSec(), BlockAlign(), BitsPerSample(16) { }
+    wave_t() noexcept : FormatTag(WAVE_FORMAT_PCM), Channels(1), SamplesPerSec(), AvgBytesPerSec(), BlockAlign(), BitsPerSample(16), DataSize() { }
 
 public:
     std::string Name;
@@ -177,6 +177,7 @@ public:
 
     wave_sample_t WaveSample;
     std::vector<uint8_t> Data;
+    uint32_t DataSize;                  // Size of the data chunk in bytes, also set when the data was not read.
 
     properties_t Properties;
 };
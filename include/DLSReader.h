@@ -3,8 +3,6 @@
 
 #pragma once
 
-#include "pch.h"
-
 #include "DLS.h"
 
 #include <RIFF.h>
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #pragma region DLS Level 1
 
 // Downloadable Sounds Level 2.2 Version 1.0", April 2006, Table 9: DLS Level 2 Sources, Controls, Destinations and Transforms
@@ -133,10 +135,10 @@ constexpr uint16_t DLS_CDL_QUERYSUPPORTED       = 0x0012; // 32-bit value return
 #ifndef _DLSID
 typedef struct _DLSID
 {
-    ULONG   ulData1;
-    USHORT  usData2;
-    USHORT  usData3;
-    BYTE    abData4[8];
+    uint32_t ulData1;
+    uint16_t usData2;
+    uint16_t usData3;
+    uint8_t  abData4[8];
 } DLSID;
 #endif
 
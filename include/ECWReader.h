@@ -1,15 +1,27 @@
 
-/** $VER: ECWReader.h (2025.05.01) P. Stuer - Implements a reader for a ECW-compliant wave set. **/
+/** $VER: ECWReader.h (2026.10.18) P. Stuer - Implements a reader for a ECW-compliant wave set. **/
 
 #pragma once
 
-#include "pch.h"
+#include <string.h>
+
+#include <span>
 
 #include "Waveset.h"
+#include "ECW.h"
 
 namespace ecw
 {
 
+struct reader_options_t
+{
+    reader_options_t() : ReadSampleData(true) { }
+
+    reader_options_t(bool readSampleData) : ReadSampleData(readSampleData) { }
+
+    bool ReadSampleData;
+};
+
 /// <summary>
 /// Implements a reader for an ECW file.
 /// </summary>
@@ -72,7 +84,7 @@ public:
         _Stream->Offset(size);
     }
 
-    void Process(waveset_t & ecw);
+    void Process(waveset_t & ecw, const reader_options_t & options = { });
 
 private:
     std::string ReadString(const char * data, size_t length)
@@ -86,4 +98,59 @@ protected:
 private:
 };
 
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Implements a reader that maps an ECW file into memory. The maps and headers are exposed as spans into the mapping and the waveform of a sample is only read when it is accessed.
+/// </summary>
+class mapped_reader_t
+{
+public:
+    mapped_reader_t() noexcept : _Header() { }
+
+    void Open(const std::filesystem::path & filePath);
+    void Close() noexcept;
+
+    void Process(waveset_t & ws) const;
+
+    const ecwHeader & Header() const noexcept { return *_Header; }
+
+    std::span<const bank_map_t> BankMaps() const noexcept { return GetSpan<bank_map_t>(_Header->BankMapOffs, _Header->BankMapCount); }
+    std::span<const drum_kit_map_t> DrumKitMaps() const noexcept { return GetSpan<drum_kit_map_t>(_Header->DrumKitMapOffs, _Header->DrumKitMapCount); }
+    std::span<const midi_patch_map_t> MIDIPatchMaps() const noexcept { return GetSpan<midi_patch_map_t>(_Header->MIDIPatchMapOffs, _Header->MIDIPatchMapCount); }
+    std::span<const drum_note_map_t> DrumNoteMaps() const noexcept { return GetSpan<drum_note_map_t>(_Header->DrumNoteMapOffs, _Header->DrumNoteMapCount); }
+
+    std::span<const instrument_t> Instruments() const noexcept { return GetSpan<instrument_t>(_Header->InstrumentHeaderOffs, _Header->InstrumentHeaderCount); }
+    std::span<const patch_t> Patches() const noexcept { return GetSpan<patch_t>(_Header->PatchHeaderOffs, _Header->PatchHeaderCount); }
+
+    std::span<const ecwSampleSet> SampleSets() const noexcept { return _SampleSets; }
+    std::span<const ecwSample> SampleHeaders() const noexcept { return GetSpan<ecwSample>(_Header->SampleHeaderOffs, _Header->SampleHeaderCount); }
+
+    std::span<const uint8_t> SampleData() const noexcept { return GetSpan<uint8_t>(_Header->SampleDataOffs, _Header->SampleDataSize); }
+    std::span<const uint8_t> GetSampleData(const sample_t & sample) const;
+
+private:
+    // All types are packed so the spans need no particular alignment.
+    template <typename T> std::span<const T> GetSpan(uint32_t offset, uint32_t count) const noexcept
+    {
+        static_assert(alignof(T) == 1);
+
+        return std::span<const T>((const T *) (_File.Data() + offset), count);
+    }
+
+    void ValidateRange(const char * name, uint64_t offset, uint64_t size, uint64_t count, uint64_t itemSize) const;
+
+    std::vector<uint16_t> GetArray(uint32_t offset, uint32_t count) const;
+
+    static std::string ToString(const char * data, size_t size);
+
+private:
+    sf::platform::mapped_file_t _File;
+
+    const ecwHeader * _Header;
+    std::span<const ecwSampleSet> _SampleSets;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
 }
@@ -0,0 +1,65 @@
+
+/** $VER: Filter.h (2026.10.18) P. Stuer - Resonant low-pass filters of many voices **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cmath>
+#include <vector>
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Implements the resonant low-pass filters of many voices as state variable filters. The state is kept in structure-of-arrays form, indexed by the same slots as articulation_engine_t.
+/// The coefficients are updated once per block. Groups of Lanes voices are filtered in parallel with SSE2 or NEON.
+/// </summary>
+class lowpass_filter_t
+{
+public:
+    static constexpr uint32_t Lanes = 8;
+
+    lowpass_filter_t(uint32_t sampleRate, uint32_t capacity);
+
+    void Start(uint32_t slot) noexcept;
+
+    void SetCutoff(uint32_t slot, float cutoff) noexcept;
+    void SetResonance(uint32_t slot, float resonance) noexcept;
+
+    void Process(uint32_t slot, float * data, uint32_t frameCount) noexcept;
+    void Process(const uint32_t * slots, float * const * data, uint32_t count, uint32_t frameCount) noexcept;
+
+    uint32_t GetCapacity() const noexcept { return (uint32_t) _A1.size(); }
+
+    /// <summary>
+    /// Replaces a state value that is decaying towards the denormal range by zero. Arithmetic on denormals is very slow on most processors.
+    /// </summary>
+    static float FlushToZero(float value) noexcept { return (std::fabs(value) < 1e-15f) ? 0.f : value; }
+
+private:
+    void UpdateCoefficients(uint32_t slot) noexcept;
+    void ProcessLanes(const uint32_t * slots, float * const * data, uint32_t frameCount) noexcept;
+
+private:
+    float _SampleRate;
+
+    // Parameters
+    std::vector<float> _Cutoff;             // in Hz
+    std::vector<float> _K;                  // 1 / Q
+
+    // Coefficients
+    std::vector<float> _A1;
+    std::vector<float> _A2;
+    std::vector<float> _A3;
+
+    // State
+    std::vector<float> _Ic1;
+    std::vector<float> _Ic2;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
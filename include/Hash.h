@@ -0,0 +1,188 @@
+
+/** $VER: Hash.h (2026.10.18) P. Stuer - Content hashing (XXH64) **/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace sf
+{
+
+/// <summary>
+/// Implements the 64-bit xxHash algorithm (XXH64). Used to identify file and sample content.
+/// </summary>
+class hash_t
+{
+public:
+    hash_t(uint64_t seed = 0) noexcept
+    {
+        Reset(seed);
+    }
+
+    void Reset(uint64_t seed = 0) noexcept
+    {
+        _Seed = seed;
+
+        _V[0] = seed + Prime1 + Prime2;
+        _V[1] = seed + Prime2;
+        _V[2] = seed;
+        _V[3] = seed - Prime1;
+
+        _TotalSize = 0;
+        _BufferSize = 0;
+    }
+
+    /// <summary>
+    /// Adds data to the hash.
+    /// </summary>
+    void Update(const void * data, size_t size) noexcept
+    {
+        const uint8_t * p = (const uint8_t *) data;
+        const uint8_t * End = p + size;
+
+        _TotalSize += size;
+
+        if (_BufferSize + size < sizeof(_Buffer))
+        {
+            ::memcpy(_Buffer + _BufferSize, p, size);
+            _BufferSize += size;
+
+            return;
+        }
+
+        if (_BufferSize != 0)
+        {
+            const size_t Size = sizeof(_Buffer) - _BufferSize;
+
+            ::memcpy(_Buffer + _BufferSize, p, Size);
+            p += Size;
+
+            ProcessStripe(_Buffer);
+
+            _BufferSize = 0;
+        }
+
+        while (p + sizeof(_Buffer) <= End)
+        {
+            ProcessStripe(p);
+            p += sizeof(_Buffer);
+        }
+
+        if (p < End)
+        {
+            _BufferSize = (size_t) (End - p);
+
+            ::memcpy(_Buffer, p, _BufferSize);
+        }
+    }
+
+    /// <summary>
+    /// Gets the hash of the data added so far.
+    /// </summary>
+    uint64_t Digest() const noexcept
+    {
+        uint64_t h;
+
+        if (_TotalSize >= sizeof(_Buffer))
+        {
+            h = Rotl(_V[0], 1) + Rotl(_V[1], 7) + Rotl(_V[2], 12) + Rotl(_V[3], 18);
+
+            for (const auto v : _V)
+                h = MergeRound(h, v);
+        }
+        else
+            h = _Seed + Prime5;
+
+        h += _TotalSize;
+
+        const uint8_t * p = _Buffer;
+        const uint8_t * End = _Buffer + _BufferSize;
+
+        while (p + 8 <= End)
+        {
+            h ^= Round(0, Load64(p));
+            h  = Rotl(h, 27) * Prime1 + Prime4;
+            p += 8;
+        }
+
+        if (p + 4 <= End)
+        {
+            h ^= (uint64_t) Load32(p) * Prime1;
+            h  = Rotl(h, 23) * Prime2 + Prime3;
+            p += 4;
+        }
+
+        while (p < End)
+        {
+            h ^= (*p) * Prime5;
+            h  = Rotl(h, 11) * Prime1;
+            ++p;
+        }
+
+        h ^= h >> 33;
+        h *= Prime2;
+        h ^= h >> 29;
+        h *= Prime3;
+        h ^= h >> 32;
+
+        return h;
+    }
+
+    /// <summary>
+    /// Calculates the hash of a block of data.
+    /// </summary>
+    static uint64_t Calculate(const void * data, size_t size, uint64_t seed = 0) noexcept
+    {
+        hash_t Hash(seed);
+
+        Hash.Update(data, size);
+
+        return Hash.Digest();
+    }
+
+private:
+    void ProcessStripe(const uint8_t * p) noexcept
+    {
+        _V[0] = Round(_V[0], Load64(p));
+        _V[1] = Round(_V[1], Load64(p +  8));
+        _V[2] = Round(_V[2], Load64(p + 16));
+        _V[3] = Round(_V[3], Load64(p + 24));
+    }
+
+    static uint64_t Round(uint64_t acc, uint64_t input) noexcept
+    {
+        acc += input * Prime2;
+        acc  = Rotl(acc, 31);
+
+        return acc * Prime1;
+    }
+
+    static uint64_t MergeRound(uint64_t acc, uint64_t value) noexcept
+    {
+        acc ^= Round(0, value);
+
+        return acc * Prime1 + Prime4;
+    }
+
+    static uint64_t Rotl(uint64_t x, int r) noexcept { return (x << r) | (x >> (64 - r)); }
+
+    static uint64_t Load64(const uint8_t * p) noexcept { uint64_t v; ::memcpy(&v, p, sizeof(v)); return v; }
+    static uint32_t Load32(const uint8_t * p) noexcept { uint32_t v; ::memcpy(&v, p, sizeof(v)); return v; }
+
+private:
+    static constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+    static constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr uint64_t Prime3 = 0x165667B19E3779F9ull;
+    static constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+    static constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+    uint64_t _Seed;
+    uint64_t _V[4];
+    uint64_t _TotalSize;
+
+    uint8_t _Buffer[32];
+    size_t _BufferSize;
+};
+
+}
@@ -0,0 +1,54 @@
+
+/** $VER: Interpolator.h (2026.10.18) P. Stuer - Sample interpolation kernels **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "Platform.h"
+
+namespace sf
+{
+
+enum class interpolation_t : uint8_t
+{
+    Linear,                     // 2 points
+    Cubic,                      // 4-point Catmull-Rom spline
+    Sinc,                       // 8-point Blackman-windowed sinc
+};
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Describes the sample points to interpolate. The offsets are in sample points, like the ones of sample_t.
+/// </summary>
+struct interpolator_source_t
+{
+    const int16_t * Data;       // 16-bit sample points, e.g. bank_t::SampleData
+    const uint8_t * DataLSB;    // Optional low bytes of 24-bit sample points, e.g. bank_t::SampleDataLSB
+    size_t Count;               // Number of sample points in Data (and DataLSB)
+
+    uint32_t Start;
+    uint32_t End;
+    uint32_t LoopStart;
+    uint32_t LoopEnd;
+
+    uint32_t Padding;           // Guard points laid out by bank_t::PadSamples() around this range, 0 if unknown.
+
+    bool IsLooping;             // Wrap from LoopEnd to LoopStart instead of stopping at End.
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+/// <summary>
+/// Resamples up to frameCount points to normalized float samples. The position and increment are 32.32 fixed-point sample offsets.
+/// Returns the number of frames written, which is less than frameCount when a source that doesn't loop reaches its end.
+/// </summary>
+using interpolator_fn_t = uint32_t (*)(const interpolator_source_t & source, uint64_t & position, uint64_t increment, float * data, uint32_t frameCount);
+
+interpolator_fn_t GetInterpolator(interpolation_t interpolation) noexcept;
+interpolator_fn_t GetInterpolator(interpolation_t interpolation, instruction_set_t instructionSet) noexcept;
+
+const char * GetInterpolationName(interpolation_t interpolation) noexcept;
+
+}
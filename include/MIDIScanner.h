@@ -0,0 +1,141 @@
+
+/** $VER: MIDIScanner.h (2026.10.18) P. Stuer - Computes the working set of a Standard MIDI File **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "Region.h"
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Identifies the bank select rules of a MIDI file.
+/// </summary>
+enum class midi_system_t : uint8_t
+{
+    Auto,                                   // GS rules until a GM, GS or XG reset message selects the rules.
+    GM,                                     // Bank select is ignored. Channel 10 plays the percussion presets.
+    GS,                                     // Bank select MSB selects the bank. Channel 10, and parts switched to a drum map, play the percussion presets.
+    XG,                                     // Bank select MSB 126 or 127 selects the percussion presets; LSB selects the bank if MSB is 0.
+};
+
+/// <summary>
+/// Options for the MIDI file scanner.
+/// </summary>
+struct midi_scanner_options_t
+{
+    midi_scanner_options_t() : System(midi_system_t::Auto) { }
+
+    midi_system_t System;
+};
+
+/// <summary>
+/// Represents a range of bytes.
+/// </summary>
+struct byte_range_t
+{
+    uint64_t Offset;
+    uint64_t Size;
+};
+
+/// <summary>
+/// Represents the parts of a bank that a song needs.
+/// </summary>
+struct working_set_t
+{
+    std::vector<uint16_t> Presets;          // Indices in bank_t::Presets of the presets that play notes, sorted
+    std::vector<sample_range_t> Samples;    // Samples of the regions that play notes, and their stereo partners, sorted by sample index
+    std::vector<byte_range_t> SampleData;   // Merged byte ranges of bank_t::SampleData that hold the samples
+    std::vector<byte_range_t> SampleDataLSB;// Merged byte ranges of bank_t::SampleDataLSB, empty if the bank has no 24-bit data
+
+    uint64_t SampleDataSize;                // in bytes
+    uint64_t SampleDataLSBSize;             // in bytes
+    uint64_t PeakMemory;                    // Estimate, in bytes: the sample data of the working set and the bank definitions
+
+    uint32_t NoteCount;
+    uint32_t PeakVoices;                    // Estimate: the maximum number of voices of held and sustained notes, without release tails
+    uint32_t MissingNoteCount;              // Notes for which the bank has no preset or no region
+};
+
+/// <summary>
+/// Scans the note, program change and bank select events of a Standard MIDI File (or an RMID file) and resolves them against a bank the way renderer_t does,
+/// to find the presets, samples and sample data that the song needs. Only regions that respond to a note and velocity of the song are part of the working set.
+/// </summary>
+class midi_scanner_t
+{
+public:
+    midi_scanner_t(const bank_t & bank, const midi_scanner_options_t & options = { });
+
+    midi_scanner_t(const midi_scanner_t &) = delete;
+    midi_scanner_t & operator=(const midi_scanner_t &) = delete;
+
+    working_set_t Scan(const std::filesystem::path & filePath);
+    working_set_t Scan(std::span<const uint8_t> data);
+
+private:
+    /// <summary>
+    /// A MIDI event in a track. System exclusive messages refer to their data in the file.
+    /// </summary>
+    struct event_t
+    {
+        uint64_t Time;                      // in ticks
+        uint8_t Status;
+        uint8_t Data1;
+        uint8_t Data2;
+        uint32_t DataOffset;                // System exclusive messages only
+        uint32_t DataSize;
+    };
+
+    struct channel_t
+    {
+        uint16_t Bank;
+        uint8_t Program;
+        uint8_t BankMSB;
+        uint8_t BankLSB;
+        bool IsPercussion;                  // GS drum part
+        bool IsSustained;
+        uint16_t HeldVoices[128];           // Voices of the held notes, by key
+        uint32_t SustainedVoices;           // Voices of the released notes that the sustain pedal holds
+    };
+
+    static std::span<const uint8_t> FindSMF(std::span<const uint8_t> data) noexcept;
+    void ReadTracks(std::span<const uint8_t> data);
+    static void ReadTrack(std::span<const uint8_t> data, size_t offset, size_t size, std::vector<event_t> & events);
+
+    void Reset() noexcept;
+    void ProcessSysEx(std::span<const uint8_t> data) noexcept;
+    void NoteOn(working_set_t & workingSet, uint8_t channel, uint8_t key, uint8_t velocity);
+    void NoteOff(uint8_t channel, uint8_t key) noexcept;
+    void SetBank(uint8_t channel) noexcept;
+
+    void Finish(working_set_t & workingSet) const;
+
+private:
+    const bank_t & _Bank;
+    region_resolver_t _Resolver;
+    midi_scanner_options_t _Options;
+
+    midi_system_t _System;
+    channel_t _Channels[16];
+    uint32_t _ActiveVoices;
+
+    std::vector<event_t> _Events;
+    std::vector<region_t> _Regions;
+
+    std::unordered_map<uint32_t, uint16_t> _Notes; // (preset index << 16) | (key << 8) | velocity to the number of regions
+    std::vector<bool> _IsPresetUsed;
+    std::vector<bool> _IsSampleUsed;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
@@ -0,0 +1,115 @@
+
+/** $VER: Metrics.h (2026.10.18) P. Stuer - Optional timing, I/O and allocation instrumentation **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Collects the metrics of the scopes executed by the threads it is attached to. Scopes are inclusive: the time, bytes and allocations of a scope include those of its nested scopes.
+/// </summary>
+class metrics_t
+{
+public:
+    // Aggregated metrics of all scopes with the same name and chunk id.
+    struct entry_t
+    {
+        const char * Name;
+        uint32_t ChunkId;                   // FOURCC of the chunk or 0 for a phase.
+
+        uint64_t Count;                     // Number of times the scope was executed.
+        uint64_t Time;                      // Total time (in ns)
+        uint64_t Bytes;                     // Bytes read or written
+        uint64_t Allocations;               // Number of allocations reported through RecordAllocation()
+        uint64_t AllocatedBytes;
+    };
+
+    // Metrics of a single execution of a scope.
+    struct event_t
+    {
+        const char * Name;
+        uint32_t ChunkId;
+        uint32_t Depth;                     // Nesting level of the scope
+
+        uint64_t Time;
+        uint64_t Bytes;
+        uint64_t Allocations;
+        uint64_t AllocatedBytes;
+    };
+
+    using callback_t = std::function<void(const event_t & event)>;
+
+public:
+    metrics_t(callback_t callback = nullptr) : Callback(callback) { }
+
+    void Reset() noexcept { _Entries.clear(); }
+
+    const std::vector<entry_t> & Entries() const noexcept { return _Entries; }
+    const entry_t * Find(const char * name, uint32_t chunkId = 0) const noexcept;
+
+    void Add(const event_t & event);
+
+    static metrics_t * Attach(metrics_t * metrics) noexcept;
+    static metrics_t * Current() noexcept;
+
+    static void RecordAllocation(size_t size) noexcept;
+
+public:
+    callback_t Callback;                    // Receives an event at the end of each scope. Called on the thread that executed the scope.
+
+private:
+    std::vector<entry_t> _Entries;
+};
+
+/// <summary>
+/// Measures a phase or chunk. Does nothing unless a metrics_t instance is attached to the current thread.
+/// </summary>
+class metrics_scope_t
+{
+public:
+    metrics_scope_t(const char * name, uint32_t chunkId = 0, uint64_t bytes = 0) noexcept;
+    ~metrics_scope_t();
+
+    metrics_scope_t(const metrics_scope_t &) = delete;
+    metrics_scope_t & operator=(const metrics_scope_t &) = delete;
+
+    void AddBytes(uint64_t bytes) noexcept { _Bytes += bytes; }
+    void AddAllocation(size_t size) noexcept { ++_Allocations; _AllocatedBytes += size; }
+
+private:
+    metrics_t * _Metrics;
+    metrics_scope_t * _Parent;
+
+    const char * _Name;
+    uint32_t _ChunkId;
+    uint32_t _Depth;
+
+    std::chrono::steady_clock::time_point _Start;
+
+    uint64_t _Bytes;
+    uint64_t _Allocations;
+    uint64_t _AllocatedBytes;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
+
+#ifndef LIBSF_NO_METRICS
+#define METRICS_SCOPE(...)      sf::metrics_scope_t __MetricsScope(__VA_ARGS__)
+#define METRICS_CHUNK(ch)       sf::metrics_scope_t __MetricsScope("Chunk", (ch).Id, ((ch).Id != FOURCC_LIST) ? (ch).Size : 0) // The bytes of a list are attributed to its chunks.
+#define METRICS_BYTES(bytes)    __MetricsScope.AddBytes(bytes)
+#else
+#define METRICS_SCOPE(...)
+#define METRICS_CHUNK(ch)
+#define METRICS_BYTES(bytes)
+#endif
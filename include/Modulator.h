@@ -0,0 +1,138 @@
+
+/** $VER: Modulator.h (2026.10.18) P. Stuer - Compiles the modulators of a region to a flat program **/
+
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "Region.h"
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// The values of the modulation sources: the 128 MIDI controllers followed by the 128 general controllers (SF2.04, 8.2.1), as 14-bit values (0 - 16383).
+/// 7-bit controllers are shifted left by 7 bits. The note-on velocity, key number and poly pressure belong to a voice; set them before evaluating the program of that voice.
+/// </summary>
+struct modulator_inputs_t
+{
+    static constexpr size_t SourceCount = 256;
+
+    static constexpr uint8_t GeneralController = 128;   // Index of the first general controller
+    static constexpr uint8_t Velocity        = GeneralController + 2;
+    static constexpr uint8_t KeyNumber       = GeneralController + 3;
+    static constexpr uint8_t PolyPressure    = GeneralController + 10;
+    static constexpr uint8_t ChannelPressure = GeneralController + 13;
+    static constexpr uint8_t PitchWheel      = GeneralController + 14;
+    static constexpr uint8_t PitchWheelSensitivity = GeneralController + 16;
+
+    void Reset() noexcept;
+
+    std::array<uint16_t, SourceCount> Values;
+};
+
+/// <summary>
+/// Represents the modulators of a region, merged with the default modulators, as a list of operations grouped by destination.
+/// </summary>
+class modulator_program_t
+{
+public:
+    typedef std::bitset<modulator_inputs_t::SourceCount> source_set_t;
+
+    struct op_t
+    {
+        const float * SourceCurve;          // 129 entries; see GetCurve().
+        const float * AmountSourceCurve;
+        float Amount;
+        uint8_t Source;                     // Index in modulator_inputs_t::Values
+        uint8_t AmountSource;
+        bool IsAbsolute;                    // Absolute value transform
+    };
+
+    struct destination_t
+    {
+        GeneratorOperator Generator;
+        uint16_t FirstOp;
+        uint16_t OpCount;
+        int32_t Min;                        // Limits of the generator
+        int32_t Max;
+        source_set_t Sources;               // Sources read by the operations of this destination
+    };
+
+    void Evaluate(const modulator_inputs_t & inputs, float * values) const noexcept;
+    uint64_t Update(const modulator_inputs_t & inputs, uint8_t source, float * values) const noexcept;
+
+    void Apply(const float * values, region_t & region) const noexcept;
+
+    bool IsAffectedBy(uint8_t source) const noexcept { return _Sources.test(source); }
+
+    std::span<const op_t> GetOps() const noexcept { return _Ops; }
+    std::span<const destination_t> GetDestinations() const noexcept { return _Destinations; }
+
+    static const float * GetCurve(uint16_t source) noexcept;
+
+private:
+    float Evaluate(const modulator_inputs_t & inputs, const destination_t & destination) const noexcept;
+
+    static float Lookup(const float * curve, uint16_t value) noexcept
+    {
+        const uint32_t Index = (uint32_t) value >> 7;
+
+        return curve[Index] + (curve[Index + 1] - curve[Index]) * (float) (value & 0x7F) * (1.f / 128.f);
+    }
+
+private:
+    std::vector<op_t> _Ops;
+    std::vector<destination_t> _Destinations;
+    source_set_t _Sources;
+
+    friend class modulator_compiler_t;
+};
+
+/// <summary>
+/// Compiles the modulators of the regions of a bank. Each combination of a preset zone and an instrument zone is compiled once.
+/// </summary>
+class modulator_compiler_t
+{
+public:
+    modulator_compiler_t(const bank_t & bank);
+
+    modulator_compiler_t(const modulator_compiler_t &) = delete;
+    modulator_compiler_t & operator=(const modulator_compiler_t &) = delete;
+
+    const modulator_program_t & Compile(const region_t & region);
+
+    size_t GetProgramCount() const noexcept { return _Programs.size(); }
+
+    static std::span<const modulator_t> GetDefaultModulators() noexcept;
+
+private:
+    static void Override(std::vector<modulator_t> & modulators, std::span<const modulator_t> zoneModulators);
+    static void Add(std::vector<modulator_t> & modulators, std::span<const modulator_t> zoneModulators);
+
+    static bool IsIdentical(const modulator_t & a, const modulator_t & b) noexcept;
+    static bool IsSupported(const modulator_t & modulator) noexcept;
+    static bool IsValidSource(uint16_t source) noexcept;
+    static uint8_t GetSourceIndex(uint16_t source) noexcept;
+
+    std::span<const modulator_t> GetPresetZoneModulators(uint32_t zoneIndex) const noexcept;
+    std::span<const modulator_t> GetInstrumentZoneModulators(uint32_t zoneIndex) const noexcept;
+
+private:
+    const bank_t & _Bank;
+
+    std::unordered_map<uint64_t, modulator_program_t> _Programs; // (Instrument zone << 32) | preset zone to program
+
+    std::vector<modulator_t> _Modulators;
+    std::vector<modulator_t> _PresetModulators;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
@@ -0,0 +1,161 @@
+
+/** $VER: Platform.h (2026.10.18) P. Stuer - Isolates the platform-specific parts of the library **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <string>
+
+#ifdef _WIN32
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <windows.h>
+#include <mmreg.h>
+
+#else
+
+#ifndef mmioFOURCC
+#define mmioFOURCC(ch0, ch1, ch2, ch3) ((uint32_t) (uint8_t) (ch0) | ((uint32_t) (uint8_t) (ch1) << 8) | ((uint32_t) (uint8_t) (ch2) << 16) | ((uint32_t) (uint8_t) (ch3) << 24))
+#endif
+
+#ifndef MAKEWORD
+#define MAKEWORD(lo, hi)    ((uint16_t) (((uint8_t) ((lo) & 0xFF)) | ((uint16_t) ((uint8_t) ((hi) & 0xFF))) << 8))
+#define LOWORD(x)           ((uint16_t) ((x) & 0xFFFF))
+#define HIWORD(x)           ((uint16_t) (((uint32_t) (x) >> 16) & 0xFFFF))
+#endif
+
+#ifndef _countof
+#define _countof(x)         (sizeof(x) / sizeof((x)[0]))
+#endif
+
+#ifndef WAVE_FORMAT_PCM
+#define WAVE_FORMAT_PCM         0x0001
+#define WAVE_FORMAT_IEEE_FLOAT  0x0003
+#define WAVE_FORMAT_ALAW        0x0006
+#define WAVE_FORMAT_MULAW       0x0007
+#endif
+
+#endif
+
+namespace sf
+{
+
+#pragma pack(push, 1)
+
+/// <summary>
+/// Represents a GUID as stored in a RIFF file.
+/// </summary>
+struct guid_t
+{
+    uint32_t Data1;
+    uint16_t Data2;
+    uint16_t Data3;
+    uint8_t Data4[8];
+};
+
+#pragma pack(pop)
+
+/// <summary>
+/// Identifies the best instruction set for which the library contains optimized code.
+/// </summary>
+enum class instruction_set_t : uint8_t
+{
+    Scalar,
+    SSE2,
+    AVX2,                               // AVX2 and FMA
+    NEON,
+};
+
+namespace platform
+{
+    std::string GetLocalDateTime();
+
+    instruction_set_t GetInstructionSet() noexcept;
+    const char * GetInstructionSetName(instruction_set_t instructionSet) noexcept;
+
+    std::string ToString(const guid_t & guid);
+
+    size_t GetPageSize() noexcept;
+    void DiscardPages(const void * data, size_t size) noexcept;
+    void PrefetchPages(const void * data, size_t size) noexcept;
+
+#pragma warning(disable: 4820) // x bytes padding
+
+    /// <summary>
+    /// Maps a file read-only into memory.
+    /// </summary>
+    class mapped_file_t
+    {
+    public:
+        mapped_file_t() noexcept : _Data(), _Size(), _Handle() { }
+        ~mapped_file_t() { Close(); }
+
+        mapped_file_t(const mapped_file_t &) = delete;
+        mapped_file_t & operator=(const mapped_file_t &) = delete;
+
+        mapped_file_t(mapped_file_t && other) noexcept : _Data(other._Data), _Size(other._Size), _Handle(other._Handle) { other._Data = nullptr; other._Size = 0; other._Handle = nullptr; }
+        mapped_file_t & operator=(mapped_file_t && other) noexcept;
+
+        void Open(const std::filesystem::path & filePath);
+        void Close() noexcept;
+
+        bool IsOpen() const noexcept { return (_Data != nullptr) || (_Handle != nullptr); }
+
+        const uint8_t * Data() const noexcept { return _Data; }
+        uint64_t Size() const noexcept { return _Size; }
+
+    private:
+        const uint8_t * _Data;
+        uint64_t _Size;
+        void * _Handle;                     // File mapping handle (Windows only)
+    };
+
+    /// <summary>
+    /// Describes a buffer of a vectored read. Has the layout of struct iovec on POSIX systems.
+    /// </summary>
+    struct io_vector_t
+    {
+        void * Data;
+        size_t Size;
+    };
+
+    /// <summary>
+    /// Opens a file read-only for reads at arbitrary offsets. Reads don't share a file position so several threads can read concurrently.
+    /// </summary>
+    class file_t
+    {
+    public:
+        file_t() noexcept : _Size(), _Handle() { }
+        ~file_t() { Close(); }
+
+        file_t(const file_t &) = delete;
+        file_t & operator=(const file_t &) = delete;
+
+        void Open(const std::filesystem::path & filePath);
+        void Close() noexcept;
+
+        bool IsOpen() const noexcept { return _Handle != nullptr; }
+
+        size_t Read(uint64_t offset, void * data, size_t size) const noexcept;
+        size_t Read(uint64_t offset, const io_vector_t * vectors, size_t count) const noexcept;
+
+        uint64_t Size() const noexcept { return _Size; }
+
+#ifndef _WIN32
+        int Descriptor() const noexcept { return (int) (intptr_t) _Handle - 1; }
+#endif
+
+    private:
+        uint64_t _Size;
+        void * _Handle;                     // File handle (Windows) or file descriptor + 1 (POSIX)
+    };
+
+#pragma warning(default: 4820) // x bytes padding
+}
+
+}
@@ -0,0 +1,59 @@
+
+/** $VER: Prefetcher.h (2026.10.18) P. Stuer - Warms the sample data of a preset after a program change **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "AsyncReader.h"
+#include "Region.h"
+
+namespace sf
+{
+
+class bank_cache_t;
+class thread_pool_t;
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Reads the sample data of a preset in the background so the first note after a program change doesn't wait for the disk. The data is read into a scratch
+/// buffer and discarded; what remains is a warm file cache for the reader of the same file, e.g. a sample_streamer_t or a mapped bank_cache_t.
+/// Prefetches are executed one after the other, in the order in which they were issued, on a worker thread of the instance.
+/// </summary>
+class sample_prefetcher_t
+{
+public:
+    sample_prefetcher_t(const std::filesystem::path & filePath, uint64_t dataOffset, const async_reader_options_t & options = { });
+    ~sample_prefetcher_t();
+
+    sample_prefetcher_t(const sample_prefetcher_t &) = delete;
+    sample_prefetcher_t & operator=(const sample_prefetcher_t &) = delete;
+
+    std::future<uint64_t> Prefetch(std::vector<sample_range_t> ranges);
+    std::future<uint64_t> Prefetch(const region_resolver_t & resolver, uint16_t midiBank, uint16_t midiProgram);
+    std::future<uint64_t> Prefetch(const bank_cache_t & cache, uint16_t midiBank, uint16_t midiProgram);
+
+    static constexpr size_t ScratchSize = 4 * 1024 * 1024; // Bytes read per batch
+
+private:
+    uint64_t Read(const std::vector<sample_range_t> & ranges);
+
+private:
+    async_reader_t _Reader;
+    uint64_t _DataOffset;                   // File offset of the 16-bit sample data
+
+    std::vector<uint8_t> _Scratch;
+    std::vector<read_request_t> _Batch;
+
+    std::unique_ptr<thread_pool_t> _Pool;   // Destroyed first so queued prefetches finish while the members above are valid.
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
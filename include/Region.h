@@ -0,0 +1,89 @@
+
+/** $VER: Region.h (2026.10.18) P. Stuer - Resolves the playable regions of a bank **/
+
+#pragma once
+
+#include <array>
+#include <unordered_map>
+
+#include "Soundfont.h"
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Represents an instrument zone combined with the preset zone that refers to it, i.e. everything needed to start a voice.
+/// </summary>
+struct region_t
+{
+    static constexpr size_t GeneratorCount = (size_t) GeneratorOperator::endOper;
+    static constexpr uint32_t NoZone = ~0u;
+
+    int32_t Get(GeneratorOperator generator) const noexcept { return Generators[(size_t) generator]; }
+
+    uint16_t SampleIndex;
+    const sample_t * Sample;
+
+    uint8_t KeyLo, KeyHi;                       // Intersection of the preset and instrument zone key ranges.
+    uint8_t VelLo, VelHi;                       // Intersection of the preset and instrument zone velocity ranges.
+
+    uint32_t PresetGlobalZoneIndex;             // NoZone if the preset has no global zone.
+    uint32_t PresetZoneIndex;
+    uint32_t InstrumentGlobalZoneIndex;         // NoZone if the instrument has no global zone.
+    uint32_t InstrumentZoneIndex;
+
+    std::array<int32_t, GeneratorCount> Generators; // Instrument values with the preset offsets added, clamped to their limits.
+};
+
+/// <summary>
+/// Represents the sample data points of a sample, including the guard points laid out by bank_t::PadSamples().
+/// </summary>
+struct sample_range_t
+{
+    uint32_t SampleIndex;
+    uint32_t Start;                             // in sample data points
+    uint32_t End;
+};
+
+/// <summary>
+/// Finds the regions of a bank that respond to a key and velocity.
+/// </summary>
+class region_resolver_t
+{
+public:
+    region_resolver_t(const bank_t & bank);
+
+    bool Resolve(uint16_t midiBank, uint16_t midiProgram, uint8_t key, uint8_t velocity, std::vector<region_t> & regions) const;
+    void GetRegions(size_t presetIndex, std::vector<region_t> & regions) const;
+    bool GetSampleRanges(uint16_t midiBank, uint16_t midiProgram, std::vector<sample_range_t> & ranges) const;
+    bool GetSampleRange(uint32_t sampleIndex, sample_range_t & range) const noexcept;
+
+    int FindPreset(uint16_t midiBank, uint16_t midiProgram) const noexcept;
+
+private:
+    struct zone_t
+    {
+        std::array<int32_t, region_t::GeneratorCount> Generators;
+        uint8_t KeyLo, KeyHi;
+        uint8_t VelLo, VelHi;
+    };
+
+    void AddRegions(size_t presetIndex, uint8_t keyLo, uint8_t keyHi, uint8_t velLo, uint8_t velHi, std::vector<region_t> & regions) const;
+
+    static void ApplyGenerators(std::span<const generator_t> generators, zone_t & zone) noexcept;
+    static bool HasGenerator(std::span<const generator_t> generators, GeneratorOperator generator, uint16_t & value) noexcept;
+
+    std::span<const generator_t> GetPresetZoneGenerators(size_t zoneIndex) const noexcept;
+    std::span<const generator_t> GetInstrumentZoneGenerators(size_t zoneIndex) const noexcept;
+
+private:
+    const bank_t & _Bank;
+
+    std::unordered_map<uint32_t, uint16_t> _Presets; // (MIDI bank << 16) | MIDI program to preset index
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
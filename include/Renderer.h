@@ -0,0 +1,185 @@
+
+/** $VER: Renderer.h (2026.10.18) P. Stuer - Minimal offline renderer for banks **/
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "Articulation.h"
+#include "BankCache.h"
+#include "Filter.h"
+#include "Interpolator.h"
+#include "Modulator.h"
+#include "SampleCache.h"
+#include "SampleResidency.h"
+#include "Region.h"
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+enum class note_event_type_t : uint8_t
+{
+    NoteOn,
+    NoteOff,
+    ProgramChange,
+    AllNotesOff,
+    ControlChange,
+    PitchBend,
+    ChannelPressure,
+};
+
+/// <summary>
+/// Represents a note event to be rendered.
+/// </summary>
+struct note_event_t
+{
+    uint64_t Time;              // Frame, relative to the start of the output buffer, at which the event takes effect.
+    note_event_type_t Type;
+    uint8_t Channel;            // 0 - 15
+    uint8_t Key;                // Key number (NoteOn, NoteOff), program number (ProgramChange) or controller number (ControlChange)
+    uint8_t Velocity;           // NoteOn only; a velocity of 0 releases the key.
+    uint16_t Bank;              // ProgramChange only; 128 selects the percussion presets.
+    uint16_t Value;             // 0 - 127 (ControlChange, ChannelPressure) or 0 - 16383 with 8192 as center (PitchBend)
+};
+
+/// <summary>
+/// Options for the renderer.
+/// </summary>
+struct renderer_options_t
+{
+    renderer_options_t() : SampleRate(44100), MaxVoices(256), Interpolation(interpolation_t::Linear), SampleCache(), BankCache(), Residency() { }
+
+    uint32_t SampleRate;        // Output sample rate in Hz.
+    uint32_t MaxVoices;         // The oldest voice is stolen when a note needs more voices.
+    interpolation_t Interpolation;
+    sample_cache_t * SampleCache; // Plays the samples from a compressed sample cache of the bank instead of the sample pool. A sample that is not in the cache is decoded when a voice starts.
+    const bank_cache_t * BankCache; // Plays the samples from the mapped sample pool of a bank cache written from the bank instead of bank_t::SampleData, which can then be released.
+    sample_residency_t * Residency; // Keeps the samples of the voices resident. An evicted sample is read again when a voice starts. Must manage the pool the renderer plays from, and is required for the bank of a managed_bank_t.
+};
+
+/// <summary>
+/// Renders note events to interleaved stereo 32-bit float PCM using the 16-bit or 24-bit samples and the generators of a bank.
+/// Supports sample playback with loops, the envelopes, the LFOs, the modulators, the resonant low-pass filter, pitch, attenuation and pan.
+/// Modulators are evaluated when a voice starts. A controller change only re-evaluates the destinations that depend on that controller; of those, attenuation, pitch, pan, the modulation depths and the filter change while a voice plays.
+/// </summary>
+class renderer_t
+{
+public:
+    static constexpr uint32_t ChannelCount = 16;
+    static constexpr uint32_t BlockSize = 64;           // Frames between envelope, LFO and filter coefficient updates.
+
+    renderer_t(const bank_t & bank, const renderer_options_t & options = { });
+    ~renderer_t();
+
+    renderer_t(const renderer_t &) = delete;
+    renderer_t & operator=(const renderer_t &) = delete;
+
+    void NoteOn(uint8_t channel, uint8_t key, uint8_t velocity);
+    void NoteOff(uint8_t channel, uint8_t key) noexcept;
+    void ProgramChange(uint8_t channel, uint16_t midiBank, uint8_t program) noexcept;
+    void ControlChange(uint8_t channel, uint8_t controller, uint8_t value) noexcept;
+    void PitchBend(uint8_t channel, uint16_t value) noexcept;
+    void ChannelPressure(uint8_t channel, uint8_t value) noexcept;
+    void AllNotesOff() noexcept;
+    void Reset() noexcept;
+
+    void Process(const note_event_t & event);
+
+    void Render(float * data, size_t frameCount) noexcept;
+    void Render(std::span<const note_event_t> events, std::span<float> data);
+
+    size_t GetActiveVoiceCount() const noexcept { return _Voices.size(); }
+    uint64_t GetVoiceFrameCount() const noexcept { return _VoiceFrameCount; }
+
+    const renderer_options_t & GetOptions() const noexcept { return _Options; }
+
+private:
+    struct voice_t
+    {
+        interpolator_source_t Source;
+        sample_handle_t Block;  // Keeps a shared or decoded sample alive while the voice plays it.
+        uint32_t ResidentSample; // Sample acquired from the residency manager, or UINT32_MAX.
+
+        uint64_t Position;      // 32.32 fixed-point
+        double BaseIncrement;   // Sample points per frame without modulation
+        double Increment;       // Sample points per frame with the modulators but without the articulation
+
+        float Gain;             // Attenuation
+        float GainL;
+        float GainR;
+        float LastGain;         // Attenuation and envelope gain at the end of the previous block
+
+        uint32_t Slot;          // Slot in the articulation engine
+
+        uint64_t Serial;
+        int32_t ExclusiveClass;
+        uint8_t Channel;
+        uint8_t Key;
+        uint8_t SampleMode;
+        bool IsReleased;
+        bool IsFinished;
+
+        bool IsLooping() const noexcept { return (SampleMode == 1) || ((SampleMode == 3) && !IsReleased); }
+    };
+
+    struct channel_t
+    {
+        modulator_inputs_t Inputs;
+        uint16_t RPN;           // Registered parameter selected by controllers 101 and 100
+        uint16_t Bank;
+        uint8_t Program;
+    };
+
+    /// <summary>
+    /// The modulators of a voice, indexed by articulation slot.
+    /// </summary>
+    struct modulation_t
+    {
+        const modulator_program_t * Program;
+        region_t Region;        // Generators without modulation
+        std::array<float, region_t::GeneratorCount> Values;
+        uint8_t Key;            // Key number and velocity seen by the modulators
+        uint8_t Velocity;
+    };
+
+    bool StartVoice(const region_t & region, uint8_t channel, uint8_t key, uint8_t velocity);
+    voice_t & AllocateVoice() noexcept;
+    void FreeVoice(voice_t & voice) noexcept;
+
+    void SetSource(uint8_t channel, uint8_t source, uint16_t value) noexcept;
+    void Modulate(voice_t & voice, uint64_t generators) noexcept;
+
+    void RenderVoices(voice_t * const * voices, uint32_t count, float * data, uint32_t frameCount) noexcept;
+
+private:
+    const bank_t & _Bank;
+    renderer_options_t _Options;
+
+    region_resolver_t _Resolver;
+    std::vector<region_t> _Regions;
+
+    modulator_compiler_t _Compiler;
+    std::vector<modulation_t> _Modulation;
+
+    const int16_t * _SampleData;
+    const uint8_t * _SampleDataLSB;
+    size_t _SampleCount;
+
+    interpolator_fn_t _Interpolator;
+    articulation_engine_t _Articulation;
+    lowpass_filter_t _Filter;
+    alignas(32) float _Buffers[lowpass_filter_t::Lanes][BlockSize];
+
+    std::vector<voice_t> _Voices;
+    channel_t _Channels[ChannelCount];
+
+    uint64_t _Serial;
+    uint64_t _VoiceFrameCount;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
@@ -1,9 +1,9 @@
 
-/** $VER: SF2Reader.h (2025.04.27) P. Stuer **/
+/** $VER: SF2Reader.h (2026.10.18) P. Stuer **/
 
 #pragma once
 
-#include "SoundFont.h"
+#include "Soundfont.h"
 
 #define FOURCC_SFBK mmioFOURCC('s','f','b','k')
 
@@ -47,9 +47,17 @@ struct soundfont_reader_options_t
 class reader_t : public soundfont_reader_base_t
 {
 public:
-    reader_t() noexcept : soundfont_reader_base_t() { }
+    reader_t() noexcept : soundfont_reader_base_t(), _SampleDataLSBSize() { }
 
     void Process(bank_t & sf, const soundfont_reader_options_t & options);
+
+    /// <summary>
+    /// Gets the size of the sm24 chunk of the last processed bank in bytes, also when the sample data was not read.
+    /// </summary>
+    uint32_t SampleDataLSBSize() const noexcept { return _SampleDataLSBSize; }
+
+private:
+    uint32_t _SampleDataLSBSize;
 };
 
 }
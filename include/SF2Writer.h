@@ -3,7 +3,7 @@
 
 #pragma once
 
-#include "SoundFont.h"
+#include "Soundfont.h"
 
 #define FOURCC_SFBK mmioFOURCC('s','f','b','k')
 
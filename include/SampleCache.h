@@ -0,0 +1,113 @@
+
+/** $VER: SampleCache.h (2026.10.18) P. Stuer - Compressed sample data with a cache of decoded samples **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <list>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "Region.h"
+#include "SampleStore.h"
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Options for the compressed sample cache.
+/// </summary>
+struct sample_cache_options_t
+{
+    sample_cache_options_t() : Budget(16 * 1024 * 1024) { }
+
+    uint64_t Budget;                        // Maximum number of bytes of decoded samples, in bytes. The most recently decoded sample is kept even if it exceeds the budget.
+};
+
+/// <summary>
+/// Counters of the compressed sample cache.
+/// </summary>
+struct sample_cache_statistics_t
+{
+    uint64_t Hits;                          // Requests for a sample that was decoded
+    uint64_t Misses;                        // Requests that decoded a sample
+    uint64_t Evictions;
+    uint64_t DecodeTime;                    // Total time spent decoding, in ns
+
+    uint64_t CompressedSize;                // in bytes
+    uint64_t UncompressedSize;              // in bytes
+    uint64_t DecodedSize;                   // Bytes of the decoded samples in the cache
+
+    double GetHitRate() const noexcept { return (Hits + Misses != 0) ? (double) Hits / (double) (Hits + Misses) : 0.; }
+};
+
+/// <summary>
+/// Holds the sample data of a bank delta-compressed and decodes a sample the first time it is requested. The decoded samples are kept in a cache
+/// with a byte budget; the least recently used samples are evicted first. A decoded sample is a sample_block_t with the same layout as a shared sample,
+/// so renderer_t plays it directly (see renderer_options_t::SampleCache). Call Prefetch() from a worker thread, e.g. after a program change, to decode
+/// the samples of a preset before its first note. The sample pool of the bank can be released once the cache has been created. The cache is thread-safe.
+/// </summary>
+class sample_cache_t
+{
+public:
+    static constexpr uint32_t FrameSize = 256;  // Number of sample points that are compressed together
+
+    sample_cache_t(const bank_t & bank, const sample_cache_options_t & options = { });
+
+    sample_cache_t(const sample_cache_t &) = delete;
+    sample_cache_t & operator=(const sample_cache_t &) = delete;
+
+    sample_handle_t Get(uint32_t sampleIndex);
+    sample_handle_t Find(uint32_t sampleIndex);
+
+    size_t Prefetch(std::span<const sample_range_t> ranges);
+
+    void Clear();
+
+    sample_cache_statistics_t GetStatistics() const;
+
+    static void Encode(const int16_t * data, size_t count, std::vector<uint8_t> & encoded);
+    static void Decode(const uint8_t * encoded, size_t count, int16_t * data) noexcept;
+
+private:
+    /// <summary>
+    /// A compressed sample.
+    /// </summary>
+    struct sample_t
+    {
+        std::vector<uint8_t> Data;          // Delta-compressed 16-bit sample points
+        std::vector<uint8_t> DataLSB;       // Uncompressed low bytes of the 24-bit sample points
+        uint32_t Count;                     // Number of sample points
+        uint64_t Hash;
+    };
+
+    /// <summary>
+    /// A decoded sample in the cache.
+    /// </summary>
+    struct entry_t
+    {
+        sample_handle_t Block;
+        std::list<uint32_t>::iterator Use;  // Position in the list of recently used samples
+    };
+
+    sample_handle_t DecodeSample(uint32_t sampleIndex) const;
+
+private:
+    sample_cache_options_t _Options;
+
+    std::vector<sample_t> _Samples;         // by sample index
+
+    mutable std::mutex _Mutex;
+    std::vector<entry_t> _Entries;          // by sample index
+    std::list<uint32_t> _Uses;              // Sample indices of the decoded samples, most recently used first
+
+    sample_cache_statistics_t _Statistics;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
@@ -0,0 +1,71 @@
+
+/** $VER: SamplePool.h (2026.10.18) P. Stuer - Normalized float copy of the sample pool of a bank **/
+
+#pragma once
+
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Soundfont.h"
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Options for the creation of a float sample pool.
+/// </summary>
+struct sample_pool_options_t
+{
+    sample_pool_options_t() : IsLazy(false) { }
+
+    bool IsLazy;                // Convert each sample the first time it is requested instead of the whole pool at once.
+};
+
+/// <summary>
+/// Holds the sample points of a bank as normalized 32-bit floats (-1.0 - 1.0). The 24-bit low bytes are merged in when the bank has them.
+/// The pool is 32-byte aligned and uses the offsets of the sample headers, including the guard points laid out by bank_t::PadSamples().
+/// A lazy pool is silent until a sample is requested. It is not thread-safe.
+/// </summary>
+class sample_pool_t
+{
+public:
+    static constexpr size_t Alignment = 32;
+
+    sample_pool_t(const bank_t & bank, const sample_pool_options_t & options = { });
+
+    sample_pool_t(const sample_pool_t &) = delete;
+    sample_pool_t & operator=(const sample_pool_t &) = delete;
+
+    std::span<const float> GetSample(size_t sampleIndex);
+
+    const float * GetData() const noexcept { return _Data.get(); }
+    size_t GetCount() const noexcept { return _Count; }
+
+    bool IsConverted(size_t sampleIndex) const noexcept { return _IsConverted.empty() || ((sampleIndex < _IsConverted.size()) && _IsConverted[sampleIndex]); }
+    bool Is24Bit() const noexcept { return _DataLSB != nullptr; }
+
+private:
+    struct deleter_t
+    {
+        void operator()(float * data) const noexcept { ::operator delete[](data, std::align_val_t(Alignment)); }
+    };
+
+    void Convert(size_t first, size_t last) noexcept;
+
+private:
+    const bank_t & _Bank;
+
+    const int16_t * _Data16;
+    const uint8_t * _DataLSB;
+    size_t _Count;
+
+    std::unique_ptr<float[], deleter_t> _Data;
+    std::vector<bool> _IsConverted;         // Empty if the whole pool has been converted.
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
@@ -0,0 +1,192 @@
+
+/** $VER: SampleResidency.h (2026.10.18) P. Stuer - Keeps the used samples of a bank in memory within a budget **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <vector>
+
+#include "Platform.h"
+#include "Region.h"
+
+namespace sf
+{
+
+class bank_cache_t;
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Options for the sample residency manager.
+/// </summary>
+struct sample_residency_options_t
+{
+    sample_residency_options_t() : Budget((uint64_t) 256 * 1024 * 1024) { }
+
+    uint64_t Budget;                        // Maximum number of bytes of the pages that hold resident samples, in bytes. Samples in use are never evicted.
+};
+
+/// <summary>
+/// Residency and access counters of a bank or a preset.
+/// </summary>
+struct residency_statistics_t
+{
+    uint64_t Hits;                          // Accesses to a resident sample
+    uint64_t Misses;                        // Accesses that made a sample resident again
+    uint64_t Evictions;                     // Bank only
+
+    uint64_t ResidentSize;                  // Bytes of the pages that hold resident samples (bank) or bytes of the resident samples (preset)
+    uint64_t TotalSize;                     // in bytes
+
+    uint32_t ResidentCount;                 // Number of resident samples
+    uint32_t SampleCount;
+
+    double GetHitRate() const noexcept { return (Hits + Misses != 0) ? (double) Hits / (double) (Hits + Misses) : 0.; }
+};
+
+/// <summary>
+/// Residency and access counters of a preset. A sample that is used by several presets counts for each of them.
+/// </summary>
+struct preset_residency_t
+{
+    uint16_t Bank;
+    uint16_t Program;
+
+    residency_statistics_t Statistics;
+};
+
+/// <summary>
+/// Tracks the use of the samples of a bank and keeps the recently used ones in memory within a budget. The least recently used samples are evicted by
+/// releasing the whole pages of the sample pool that no resident sample uses, and are made resident again when they are acquired.
+///
+/// A sample pool mapped from a bank cache is read from the file again by the system. A sample pool in memory is managed through a managed_bank_t, which
+/// owns the bank and reads the pool again from its source file. The 24-bit low bytes always stay resident.
+///
+/// Acquire() a sample before reading it and Release() it when done (see renderer_options_t::Residency). The manager is thread-safe; Acquire() may read
+/// from the file.
+/// </summary>
+class sample_residency_t
+{
+public:
+    sample_residency_t(const bank_cache_t & cache, const sample_residency_options_t & options = { });
+
+    sample_residency_t(const sample_residency_t &) = delete;
+    sample_residency_t & operator=(const sample_residency_t &) = delete;
+
+    bool Acquire(uint32_t sampleIndex);
+    void Release(uint32_t sampleIndex) noexcept;
+
+    uint64_t Trim();
+
+    bool IsResident(uint32_t sampleIndex) const;
+    uint64_t GetAccessCount(uint32_t sampleIndex) const;
+
+    residency_statistics_t GetStatistics() const;
+    std::vector<preset_residency_t> GetPresetStatistics() const;
+
+    /// <summary>
+    /// Gets the sample pool that is managed.
+    /// </summary>
+    const uint8_t * GetSampleData() const noexcept { return (_Data != nullptr) ? _Data : _MappedData; }
+
+private:
+    friend class managed_bank_t;
+
+    sample_residency_t(bank_t & bank, const std::filesystem::path & filePath, uint64_t dataOffset, const sample_residency_options_t & options);
+
+    bool Restore();
+
+    /// <summary>
+    /// The residency of a sample. The offsets are in bytes, relative to the start of the sample pool, and include the guard points.
+    /// </summary>
+    struct sample_t
+    {
+        uint64_t Offset;
+        uint64_t Size;
+
+        uint64_t Hits;
+        uint64_t Misses;
+
+        uint32_t PinCount;                  // Number of Acquire() calls without a Release()
+        bool IsAvailable;                   // False for ROM samples and samples outside the pool.
+        bool IsResident;
+
+        std::list<uint32_t>::iterator Use;  // Position in the list of resident samples
+    };
+
+    struct preset_t
+    {
+        uint16_t Bank;
+        uint16_t Program;
+        std::vector<uint32_t> Samples;
+    };
+
+    void Initialize(const uint8_t * data, size_t sampleCount, const std::vector<sample_range_t> & ranges, bool isResident);
+
+    bool Load(uint32_t sampleIndex);
+    void Unload(uint32_t sampleIndex) noexcept;
+    void Evict(uint32_t keep) noexcept;
+
+    void Discard(size_t firstPage, size_t lastPage) const noexcept;
+
+    // Pages are counted from the page that holds the start of the pool.
+    size_t GetFirstPage(const sample_t & sample) const noexcept { return (size_t) ((sample.Offset + _PageOffset) / _PageSize); }
+    size_t GetLastPage(const sample_t & sample) const noexcept { return (size_t) ((sample.Offset + sample.Size + _PageOffset + _PageSize - 1) / _PageSize); }
+
+    uint64_t GetPageStart(size_t page) const noexcept { const uint64_t Start = (uint64_t) page * _PageSize; return (Start > _PageOffset) ? std::min(Start - _PageOffset, _Size) : 0; } // Offset in the pool, clamped to the pool
+
+private:
+    sample_residency_options_t _Options;
+
+    uint8_t * _Data;                        // Sample pool in memory, read again from _File, or nullptr.
+    const uint8_t * _MappedData;            // Sample pool mapped from a file, or nullptr.
+    uint64_t _Size;
+
+    platform::file_t _File;
+    uint64_t _DataOffset;
+
+    size_t _PageSize;
+    size_t _PageOffset;                     // Offset of the start of the pool in its first page
+
+    mutable std::mutex _Mutex;
+    std::vector<sample_t> _Samples;         // by sample index
+    std::vector<preset_t> _Presets;
+    std::vector<uint32_t> _PageUseCounts;   // Number of resident samples that use each page of the pool
+    std::list<uint32_t> _Uses;              // Indices of the resident samples, most recently used first
+
+    uint64_t _ResidentSize;                 // Bytes of the pages in use
+    uint64_t _Evictions;
+};
+
+/// <summary>
+/// Owns a bank whose sample pool in memory is managed by a sample_residency_t. The bank is only accessible as const and can't be copied: the operations that
+/// read its pool directly throw (see bank_t::CheckSamplePool()) and a renderer of the bank must use Residency(). The pool must have the layout of the 16-bit
+/// sample data in the source file at the specified offset, i.e. the bank must not be padded.
+/// </summary>
+class managed_bank_t
+{
+public:
+    managed_bank_t(bank_t && bank, const std::filesystem::path & filePath, uint64_t dataOffset, const sample_residency_options_t & options = { });
+
+    managed_bank_t(const managed_bank_t &) = delete;
+    managed_bank_t & operator=(const managed_bank_t &) = delete;
+
+    const bank_t & Bank() const noexcept { return _Bank; }
+
+    sample_residency_t & Residency() noexcept { return _Residency; }
+    const sample_residency_t & Residency() const noexcept { return _Residency; }
+
+    bank_t Release();
+
+private:
+    bank_t _Bank;
+    sample_residency_t _Residency;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
@@ -0,0 +1,85 @@
+
+/** $VER: SampleStore.h (2026.10.18) P. Stuer - Process-wide store that shares identical samples between banks **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Holds the sample points of one sample, including its guard points. Blocks are immutable and shared by all banks with the same sample content.
+/// </summary>
+class sample_block_t
+{
+public:
+    sample_block_t(const int16_t * data, const uint8_t * dataLSB, size_t count, uint64_t hash);
+    sample_block_t(std::vector<int16_t> && data, std::vector<uint8_t> && dataLSB, uint64_t hash) noexcept : _Data(std::move(data)), _DataLSB(std::move(dataLSB)), _Hash(hash) { }
+
+    sample_block_t(const sample_block_t &) = delete;
+    sample_block_t & operator=(const sample_block_t &) = delete;
+
+    const int16_t * Data() const noexcept { return _Data.data(); }
+    const uint8_t * DataLSB() const noexcept { return !_DataLSB.empty() ? _DataLSB.data() : nullptr; }
+    size_t Count() const noexcept { return _Data.size(); }
+
+    uint64_t Hash() const noexcept { return _Hash; }
+
+    size_t GetMemorySize() const noexcept { return _Data.size() * sizeof(int16_t) + _DataLSB.size(); }
+
+    bool IsEqual(const int16_t * data, const uint8_t * dataLSB, size_t count) const noexcept;
+
+private:
+    std::vector<int16_t> _Data;
+    std::vector<uint8_t> _DataLSB;          // Empty if the sample has no 24-bit data.
+    uint64_t _Hash;
+};
+
+using sample_handle_t = std::shared_ptr<const sample_block_t>;
+
+/// <summary>
+/// Shares sample blocks between banks by content. Interning a sample returns the block of an earlier sample with the same points, or a new block if there is none.
+/// A block is freed when the last bank that refers to it releases its handle. The store only keeps weak references.
+/// </summary>
+class sample_store_t
+{
+public:
+    sample_store_t() : _InternCount(), _SharedCount() { }
+
+    sample_store_t(const sample_store_t &) = delete;
+    sample_store_t & operator=(const sample_store_t &) = delete;
+
+    static sample_store_t & Instance();
+
+    sample_handle_t Intern(const int16_t * data, const uint8_t * dataLSB, size_t count);
+
+    size_t Purge();
+
+    size_t GetBlockCount() const;
+    uint64_t GetMemoryUsage() const;
+
+    uint64_t GetInternCount() const { std::lock_guard Lock(_Mutex); return _InternCount; }
+    uint64_t GetSharedCount() const { std::lock_guard Lock(_Mutex); return _SharedCount; }
+
+private:
+    sample_handle_t Find(uint64_t hash, const int16_t * data, const uint8_t * dataLSB, size_t count);
+
+private:
+    mutable std::mutex _Mutex;
+    std::unordered_multimap<uint64_t, std::weak_ptr<const sample_block_t>> _Blocks; // by content hash
+
+    uint64_t _InternCount;                  // Number of interned samples
+    uint64_t _SharedCount;                  // Number of interned samples that reused an existing block
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
@@ -0,0 +1,189 @@
+
+/** $VER: SampleStreamer.h (2026.10.18) P. Stuer - Streams sample data from disk with a resident preload of each sample **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "AsyncReader.h"
+#include "Soundfont.h"
+
+namespace sf
+{
+
+class bank_cache_t;
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Options for the streaming of sample data.
+/// </summary>
+struct sample_streamer_options_t
+{
+    sample_streamer_options_t() : PreloadPoints(32768), StreamPoints(65536), ReadPoints(16384), MaxStreams(256) { }
+
+    uint32_t PreloadPoints;                 // Points at the start of each sample that are kept in memory (64 KB of 16-bit data).
+    uint32_t StreamPoints;                  // Size of the ring buffer of each stream, rounded up to a power of 2.
+    uint32_t ReadPoints;                    // Points per disk read.
+    uint32_t MaxStreams;                    // Number of voices that can play at the same time.
+};
+
+/// <summary>
+/// Provides the 16-bit sample points of a bank that doesn't fit in memory. The first PreloadPoints of each sample are read when the instance is created;
+/// the remainder is read from disk by a background thread into a lock-free ring buffer per stream. Samples that are shorter than the preload, and loops that
+/// end within it, never touch the disk. Loops beyond the preload are unrolled by the I/O thread so a stream is always read sequentially.
+/// The I/O thread collects the reads of all streams that need data and submits them as one batch (see async_reader_t).
+///
+/// A stream is controlled by one thread, e.g. the audio thread: Start(), Read() and Stop() don't lock, allocate or wait for I/O. Data that has not arrived
+/// in time is an underrun: Read() returns fewer points and the stream resumes where it stopped.
+/// </summary>
+class sample_streamer_t
+{
+public:
+    sample_streamer_t(const std::filesystem::path & filePath, uint64_t dataOffset, std::span<const sample_t> samples, const sample_streamer_options_t & options = { });
+    sample_streamer_t(const std::filesystem::path & cachePath, const bank_cache_t & cache, const sample_streamer_options_t & options = { });
+    ~sample_streamer_t();
+
+    sample_streamer_t(const sample_streamer_t &) = delete;
+    sample_streamer_t & operator=(const sample_streamer_t &) = delete;
+
+    bool Start(uint32_t stream, uint32_t sampleIndex, uint32_t offset, bool isLooping) noexcept;
+    void Stop(uint32_t stream) noexcept;
+
+    uint32_t Read(uint32_t stream, int16_t * data, uint32_t count) noexcept;
+
+    bool IsFinished(uint32_t stream) const noexcept;
+    bool IsStreaming(uint32_t stream) const noexcept { return _Voices[stream].IsStreaming; }
+    bool IsResident(uint32_t sampleIndex, bool isLooping) const noexcept;
+
+    uint32_t GetMaxStreams() const noexcept { return (uint32_t) _Voices.size(); }
+    uint64_t GetUnderrunCount() const noexcept { return _UnderrunCount.load(std::memory_order_relaxed); }
+    uint64_t GetBytesRead() const noexcept { return _BytesRead.load(std::memory_order_relaxed); }
+    size_t GetPreloadSize() const noexcept { return _Preload.size() * sizeof(int16_t); }
+
+    static constexpr uint32_t MaxSampleIndex = 0xFFFF; // Start() refuses the samples beyond, because a request packs the sample index in 16 bits.
+
+private:
+    /// <summary>
+    /// A sample, with offsets relative to its start.
+    /// </summary>
+    struct sample_info_t
+    {
+        uint32_t Start;                     // in points, from the start of the sample data
+        uint32_t Length;
+        uint32_t LoopStart;
+        uint32_t LoopEnd;                   // LoopEnd > LoopStart if the sample has a valid loop
+
+        size_t PreloadOffset;               // in points, in _Preload
+        uint32_t PreloadCount;
+    };
+
+    /// <summary>
+    /// The state of a stream that is shared with the I/O thread. Each word is tagged with the generation of the request it belongs to.
+    /// </summary>
+    struct alignas(64) stream_t
+    {
+        std::atomic<uint64_t> Request;      // Generation, active flag, loop flag, sample index and first streamed point; see MakeRequest().
+        std::atomic<uint64_t> Produced;     // Generation and number of points written to the ring buffer.
+        std::atomic<uint64_t> Consumed;     // Generation and number of points read from the ring buffer.
+    };
+
+    /// <summary>
+    /// The state of a stream that only the controlling thread uses.
+    /// </summary>
+    struct voice_t
+    {
+        uint64_t Position;                  // Points played, with the loop unrolled
+        uint64_t LastWake;                  // Points produced when the I/O thread was last woken
+        uint32_t SampleIndex;
+        uint32_t StreamStart;               // First unrolled point that is read from the ring buffer
+        uint32_t Generation;
+        bool IsActive;
+        bool IsLooping;
+        bool IsStreaming;
+    };
+
+    /// <summary>
+    /// The state of a stream that only the I/O thread uses.
+    /// </summary>
+    struct producer_t
+    {
+        uint64_t Request;
+        uint64_t Filled;
+    };
+
+    /// <summary>
+    /// A pending fill of a ring buffer: the requests of a batch that belong to one stream.
+    /// </summary>
+    struct fill_t
+    {
+        uint64_t Request;
+        uint64_t Filled;                    // Points written to the ring buffer when the fill has completed
+        uint32_t Stream;
+        uint32_t FirstRequest;
+        uint32_t RequestCount;
+    };
+
+    void Initialize(const std::filesystem::path & filePath, uint64_t dataOffset, const sample_streamer_options_t & options);
+    void AddSample(uint32_t start, uint32_t end, uint32_t loopStart, uint32_t loopEnd) noexcept;
+
+    void Run() noexcept;
+    bool Prepare(uint32_t stream);
+    void Publish(const fill_t & fill) noexcept;
+    void Wake() noexcept;
+
+    bool IsLooped(const sample_info_t & sample, bool isLooping) const noexcept { return isLooping && (sample.LoopEnd > sample.LoopStart); }
+
+    static uint32_t Map(const sample_info_t & sample, bool isLooping, uint64_t position, uint32_t & segmentEnd) noexcept;
+
+    static uint64_t MakeRequest(uint32_t generation, bool isActive, bool isLooping, uint32_t sampleIndex, uint32_t streamStart) noexcept
+    {
+        return ((uint64_t) (generation & GenerationMask) << 50) | ((uint64_t) isActive << 49) | ((uint64_t) isLooping << 48) | ((uint64_t) (sampleIndex & MaxSampleIndex) << 32) | streamStart;
+    }
+
+    static uint64_t MakeCount(uint32_t generation, uint64_t count) noexcept { return ((uint64_t) (generation & GenerationMask) << 50) | (count & CountMask); }
+
+    static uint32_t GetGeneration(uint64_t word) noexcept { return (uint32_t) (word >> 50); }
+    static uint64_t GetCount(uint64_t word) noexcept { return word & CountMask; }
+
+private:
+    static constexpr uint32_t GenerationMask = 0x3FFF;
+    static constexpr uint64_t CountMask = (1ull << 50) - 1;
+
+    std::unique_ptr<async_reader_t> _Reader;
+    uint64_t _DataOffset;                   // File offset of the 16-bit sample data
+
+    uint32_t _PreloadPoints;
+    uint32_t _ReadPoints;
+    uint32_t _RingSize;                     // in points, a power of 2
+
+    std::vector<sample_info_t> _Samples;
+    std::vector<int16_t> _Preload;
+
+    std::unique_ptr<stream_t[]> _Streams;
+    std::vector<voice_t> _Voices;
+    std::vector<producer_t> _Producers;
+    std::vector<int16_t> _Rings;
+
+    std::vector<read_request_t> _Batch;     // Reads of the current pass of the I/O thread
+    std::vector<fill_t> _Fills;
+
+    std::atomic<uint64_t> _UnderrunCount;
+    std::atomic<uint64_t> _BytesRead;
+
+    std::atomic<uint32_t> _Pending;         // Set when the I/O thread has work.
+    std::atomic<bool> _IsStopping;
+
+    std::thread _Thread;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
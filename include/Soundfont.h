@@ -1,17 +1,28 @@
 
-/** $VER: Soundfont.h (2025.09.09) P. Stuer - Soundfont data types **/
+/** $VER: Soundfont.h (2026.10.18) P. Stuer - Soundfont data types **/
 
 #pragma once
 
 #include <array>
+#include <memory>
 #include <span>
 
 #include "BaseTypes.h"
 #include "DLS.h"
 
+namespace ecw
+{
+    class waveset_t;
+}
+
 namespace sf
 {
 
+class sample_block_t;
+class sample_store_t;
+class sample_residency_t;
+class managed_bank_t;
+
 #pragma warning(disable: 4820) // x bytes padding
 
 // A keyboard full of sound. Typically the collection of samples and articulation data associated with a particular MIDI preset number.
@@ -178,15 +189,75 @@ private:
     std::array<int16_t, 256> _ALawToPCM;
 };
 
+/// <summary>
+/// Options for the conversion of an ECW waveset.
+/// </summary>
+struct ecw_conversion_options_t
+{
+    ecw_conversion_options_t() : SampleRate(22050) { }
+
+    uint32_t SampleRate;                    // Wavesets don't store the sample rate of their waveforms.
+    std::span<const uint8_t> SampleData;    // Waveform area, e.g. from ecw::mapped_reader_t::SampleData(). The waveset's SampleData is used if empty.
+};
+
+/// <summary>
+/// Options for the layout of the sample pool created by bank_t::PadSamples().
+/// </summary>
+struct sample_padding_options_t
+{
+    sample_padding_options_t() : GuardPoints(8) { }
+
+    uint32_t GuardPoints;                   // Points of silence before each sample and of loop continuation after each loop. The sinc kernel reads 3 points before and 4 points after its position.
+};
+
+/// <summary>
+/// Refers to the residency manager of a bank owned by a managed_bank_t. Pages of a managed sample pool may have been discarded, so copying a managed bank
+/// throws. A copy or a move of a bank is never managed.
+/// </summary>
+class residency_link_t
+{
+public:
+    residency_link_t() noexcept : _Residency() { }
+
+    residency_link_t(const residency_link_t & other) : _Residency() { CheckCopy(other); }
+    residency_link_t(residency_link_t &&) noexcept : _Residency() { }
+
+    residency_link_t & operator=(const residency_link_t & other) { CheckCopy(other); CheckCopy(*this); return *this; }
+    residency_link_t & operator=(residency_link_t &&) noexcept { return *this; }
+
+    const sample_residency_t * Get() const noexcept { return _Residency; }
+
+private:
+    static void CheckCopy(const residency_link_t & link);
+
+private:
+    friend class managed_bank_t;
+
+    const sample_residency_t * _Residency;
+};
+
 /// <summary>
 /// Represents an SBK/SF2/SF3-compliant bank.
 /// </summary>
 class bank_t
 {
 public:
-    bank_t() noexcept : Major(), Minor(), ROMMajor(), ROMMinor() { }
+    bank_t() noexcept : Major(), Minor(), ROMMajor(), ROMMinor(), SamplePadding() { }
 
     void ConvertFrom(const dls::collection_t & collection);
+    void ConvertFrom(const ecw::waveset_t & waveset, const ecw_conversion_options_t & options = { });
+
+    void PadSamples(const sample_padding_options_t & options = { });
+
+    void ShareSamples(sample_store_t & store);
+    void CheckSamplePool(const char * operation) const;
+
+    /// <summary>
+    /// Gets the offset in the sample pool of the first point of the block of a shared sample, i.e. the first guard point.
+    /// </summary>
+    uint32_t GetSampleBlockOrigin(const sample_t & sample) const noexcept { return sample.Start - std::min(sample.Start, SamplePadding); }
+
+    size_t GetMemorySize() const noexcept;
 
     std::string DescribeGenerator(uint16_t generator, uint16_t amount) const noexcept;
     std::string DescribeModulatorSource(uint16_t modulator) const noexcept;
@@ -222,6 +293,9 @@ public:
 
     std::vector<uint8_t> SampleData;
     std::vector<uint8_t> SampleDataLSB;     // SoundFont v2.0.4 or later
+    uint32_t SamplePadding;                 // Guard points around each sample laid out by PadSamples(), 0 if the pool has its original layout.
+    std::vector<std::shared_ptr<const sample_block_t>> SampleBlocks; // Samples shared through a sample_store_t by ShareSamples(), by sample index. Empty if the bank uses its sample pool.
+    residency_link_t Residency;             // Manager that discards and reloads the pages of the sample pool if the bank is owned by a managed_bank_t.
 
     // Hydra
 
@@ -0,0 +1,69 @@
+
+/** $VER: ThreadPool.h (2026.10.18) P. Stuer - Work-stealing thread pool **/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sf
+{
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Implements a thread pool with a task queue per worker. Idle workers steal tasks from the other queues.
+/// </summary>
+class thread_pool_t
+{
+public:
+    using task_t = std::function<void()>;
+
+    thread_pool_t(size_t threadCount = 0);
+    ~thread_pool_t();
+
+    thread_pool_t(const thread_pool_t &) = delete;
+    thread_pool_t & operator=(const thread_pool_t &) = delete;
+
+    void Submit(task_t task);
+    void Wait();
+
+    size_t ThreadCount() const noexcept { return _Threads.size(); }
+
+private:
+    void Run(size_t index) noexcept;
+    bool Pop(size_t index, task_t & task) noexcept;
+
+private:
+    struct queue_t
+    {
+        std::mutex Mutex;
+        std::deque<task_t> Tasks;
+    };
+
+    std::vector<std::unique_ptr<queue_t>> _Queues;
+    std::vector<std::thread> _Threads;
+
+    std::mutex _Mutex;
+    std::condition_variable _TaskAvailable;
+    std::condition_variable _TasksDone;
+
+    int64_t _QueuedCount;                   // Number of tasks waiting in a queue.
+    int64_t _PendingCount;                  // Number of tasks waiting or running.
+    bool _IsStopping;
+
+    std::exception_ptr _Exception;          // First exception thrown by a task. Rethrown by Wait().
+
+    std::atomic<size_t> _NextQueue;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+}
@@ -0,0 +1,74 @@
+
+/** $VER: Units.h (2026.10.18) P. Stuer - Conversion of the logarithmic generator units using lookup tables **/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace sf::units
+{
+    constexpr int32_t Exp2Steps = 1200;         // Entries per octave, i.e. one per cent.
+
+    const float * GetExp2Table() noexcept;      // Exp2Steps + 1 entries: 2^(i / 1200)
+
+    /// <summary>
+    /// Calculates 2^(cents / 1200) from the table, interpolating between the entries. The relative error is below 1e-7.
+    /// </summary>
+    inline float Exp2Cents(const float * table, float cents) noexcept
+    {
+        cents = std::clamp(cents, -126.f * Exp2Steps, 127.f * Exp2Steps);
+
+        const float Octaves = std::floor(cents * (1.f / Exp2Steps));
+        const float Rest    = std::clamp(cents - Octaves * Exp2Steps, 0.f, (float) Exp2Steps - 0.001f);
+
+        const int32_t Index    = (int32_t) Rest;
+        const float   Fraction = Rest - (float) Index;
+
+        const float Mantissa = table[Index] + (table[Index + 1] - table[Index]) * Fraction;
+
+        return Mantissa * std::bit_cast<float>((uint32_t) ((int32_t) Octaves + 127) << 23);
+    }
+
+    /// <summary>
+    /// Converts cents to a frequency ratio.
+    /// </summary>
+    inline float CentsToRatio(float cents) noexcept
+    {
+        return Exp2Cents(GetExp2Table(), cents);
+    }
+
+    /// <summary>
+    /// Converts timecents to seconds.
+    /// </summary>
+    inline float TimecentsToSeconds(float timecents) noexcept
+    {
+        return Exp2Cents(GetExp2Table(), timecents);
+    }
+
+    /// <summary>
+    /// Converts absolute cents to Hz. 0 absolute cents is 8.176 Hz, the frequency of MIDI key 0.
+    /// </summary>
+    inline float AbsoluteCentsToHz(float cents) noexcept
+    {
+        return 8.1757989156f * Exp2Cents(GetExp2Table(), cents);
+    }
+
+    /// <summary>
+    /// Converts an attenuation in centibels to a linear gain: 10^(-centibels / 200). Attenuations of 144 dB or more are silent.
+    /// </summary>
+    inline float CentibelsToGain(const float * table, float centibels) noexcept
+    {
+        constexpr float CentsPerCentibel = 19.931568569324174f; // 1200 * log2(10) / 200
+
+        return (centibels < 1440.f) ? Exp2Cents(table, -centibels * CentsPerCentibel) : 0.f;
+    }
+
+    inline float CentibelsToGain(float centibels) noexcept
+    {
+        return CentibelsToGain(GetExp2Table(), centibels);
+    }
+}
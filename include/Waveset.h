@@ -1,10 +1,8 @@
 
-/** $VER: Waveset.h (2025.05.01) P. Stuer - Waveset data types **/
+/** $VER: Waveset.h (2026.10.18) P. Stuer - Waveset data types **/
 
 #pragma once
 
-#include "pch.h"
-
 #include "BaseTypes.h"
 
 namespace ecw
@@ -253,7 +251,9 @@ struct patch_t
     uint8_t Unknown11;
 };
 
-/** Describes a sample set. (22 bytes) **/
+#pragma pack(pop)
+
+/** Describes a sample set. **/
 struct sample_set_t
 {
     std::string Name;
@@ -279,15 +279,15 @@ public:
     uint32_t LoopEnd;
 };
 
-#pragma pack(pop)
-
 #pragma warning(disable: 4820)
 
 class slot_t
 {
 public:
     uint16_t Index;
-    std::string Name;
+    uint16_t SampleSet;                 // Index in the sample set list or NoSampleSet.
+
+    static constexpr uint16_t NoSampleSet = 0xFFFF;
 };
 
 class waveset_t
@@ -318,6 +318,16 @@ public:
 
     std::vector<uint8_t> SampleData;
 
+    /// <summary>
+    /// Gets the name of the sample set assigned to a slot.
+    /// </summary>
+    const std::string & GetSampleSetName(const slot_t & slot) const noexcept
+    {
+        static const std::string Empty;
+
+        return (slot.SampleSet < SampleSets.size()) ? SampleSets[slot.SampleSet].Name : Empty;
+    }
+
 private:
 };
 
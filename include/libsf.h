@@ -1,15 +1,9 @@
 
-/** $VER: libsf.h (2025.09.06) P. Stuer **/
+/** $VER: libsf.h (2026.10.18) P. Stuer **/
 
 #pragma once
 
-#include <SDKDDKVer.h>
-
-#define NOMINMAX
-
-#include <winsock2.h>
-#include <windows.h>
-#include <wincodec.h>
+#include "Platform.h"
 
 #include "Exception.h"
 #include "BaseTypes.h"
@@ -19,6 +13,27 @@
 #include "SF2Writer.h"
 #include "ECWReader.h"
 
+#include "Catalog.h"
+#include "BankCache.h"
+#include "BankSnapshot.h"
+#include "BankLoader.h"
+#include "SampleStore.h"
+#include "SampleCache.h"
+#include "SampleResidency.h"
+#include "AsyncReader.h"
+#include "SampleStreamer.h"
+#include "Prefetcher.h"
+#include "MIDIScanner.h"
+#include "ThreadPool.h"
+
+#include "Units.h"
+#include "SamplePool.h"
+#include "Articulation.h"
+#include "Modulator.h"
+#include "Filter.h"
+#include "Interpolator.h"
+#include "Renderer.h"
+
 namespace sf
 {
 
@@ -0,0 +1,404 @@
+
+/** $VER: Articulation.cpp (2026.10.18) P. Stuer - Block-based envelope and LFO engine **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+using namespace sf;
+
+/// <summary>
+/// Initializes a new instance with room for the specified number of voices.
+/// </summary>
+articulation_engine_t::articulation_engine_t(uint32_t sampleRate, uint32_t capacity) : _SampleRate(sampleRate), _SlotCount()
+{
+    if (_SampleRate == 0)
+        throw sf::exception("Invalid sample rate");
+
+    _VolEnv.Resize(capacity);
+    _ModEnv.Resize(capacity);
+    _ModLFO.Resize(capacity);
+    _VibLFO.Resize(capacity);
+
+    for (auto * Array : { &_ModLfoToPitch, &_VibLfoToPitch, &_ModEnvToPitch, &_InitialFilterFc, &_ModLfoToFilterFc, &_ModEnvToFilterFc, &_ModLfoToVolume, &_Gain, &_PitchRatio, &_FilterCutoff })
+        Array->resize(capacity);
+
+    // Hand out the lowest slots first.
+    _FreeSlots.reserve(capacity);
+
+    for (uint32_t i = capacity; i != 0; --i)
+        _FreeSlots.push_back(i - 1);
+}
+
+/// <summary>
+/// Starts the envelopes and LFOs of a voice using the generators of a region. Returns the slot of the voice or NoSlot if all slots are in use.
+/// </summary>
+uint32_t articulation_engine_t::Start(const region_t & region, int key) noexcept
+{
+    if (_FreeSlots.empty())
+        return NoSlot;
+
+    const uint32_t Slot = _FreeSlots.back();
+
+    _FreeSlots.pop_back();
+
+    _SlotCount = std::max(_SlotCount, Slot + 1);
+
+    const int32_t KeyOffset = 60 - key;
+
+    // The decay and release times are the times of a full-scale excursion: 96 dB for the volume envelope, 100% for the modulation envelope.
+    _VolEnv.Start(Slot,
+        ToFrames(region.Get(GeneratorOperator::delayVolEnv)),
+        ToFrames(region.Get(GeneratorOperator::attackVolEnv)),
+        ToFrames(region.Get(GeneratorOperator::holdVolEnv)  + region.Get(GeneratorOperator::keynumToVolEnvHold)  * KeyOffset),
+        ToFrames(region.Get(GeneratorOperator::decayVolEnv) + region.Get(GeneratorOperator::keynumToVolEnvDecay) * KeyOffset),
+        std::clamp(1.f - (float) region.Get(GeneratorOperator::sustainVolEnv) / 960.f, 0.f, 1.f),
+        ToFrames(region.Get(GeneratorOperator::releaseVolEnv)));
+
+    _ModEnv.Start(Slot,
+        ToFrames(region.Get(GeneratorOperator::delayModEnv)),
+        ToFrames(region.Get(GeneratorOperator::attackModEnv)),
+        ToFrames(region.Get(GeneratorOperator::holdModEnv)  + region.Get(GeneratorOperator::keynumToModEnvHold)  * KeyOffset),
+        ToFrames(region.Get(GeneratorOperator::decayModEnv) + region.Get(GeneratorOperator::keynumToModEnvDecay) * KeyOffset),
+        1.f - (float) std::clamp(region.Get(GeneratorOperator::sustainModEnv), 0, 1000) / 1000.f,
+        ToFrames(region.Get(GeneratorOperator::releaseModEnv)));
+
+    _ModLFO.Start(Slot, ToFrames(region.Get(GeneratorOperator::delayModLFO)), units::AbsoluteCentsToHz((float) region.Get(GeneratorOperator::freqModLFO)) / (float) _SampleRate);
+    _VibLFO.Start(Slot, ToFrames(region.Get(GeneratorOperator::delayVibLFO)), units::AbsoluteCentsToHz((float) region.Get(GeneratorOperator::freqVibLFO)) / (float) _SampleRate);
+
+    _ModLfoToPitch[Slot]    = (float) region.Get(GeneratorOperator::modLfoToPitch);
+    _VibLfoToPitch[Slot]    = (float) region.Get(GeneratorOperator::vibLfoToPitch);
+    _ModEnvToPitch[Slot]    = (float) region.Get(GeneratorOperator::modEnvToPitch);
+    _InitialFilterFc[Slot]  = (float) region.Get(GeneratorOperator::initialFilterFc);
+    _ModLfoToFilterFc[Slot] = (float) region.Get(GeneratorOperator::modLfoToFilterFc);
+    _ModEnvToFilterFc[Slot] = (float) region.Get(GeneratorOperator::modEnvToFilterFc);
+    _ModLfoToVolume[Slot]   = (float) region.Get(GeneratorOperator::modLfoToVolume);
+
+    Evaluate(Slot, Slot + 1);
+
+    return Slot;
+}
+
+/// <summary>
+/// Changes a modulation depth or the initial filter cutoff of a voice while it plays. Returns false if the generator only takes effect when the voice starts.
+/// </summary>
+bool articulation_engine_t::SetGenerator(uint32_t slot, GeneratorOperator generator, float value) noexcept
+{
+    switch (generator)
+    {
+        case GeneratorOperator::modLfoToPitch:      _ModLfoToPitch[slot]    = value; break;
+        case GeneratorOperator::vibLfoToPitch:      _VibLfoToPitch[slot]    = value; break;
+        case GeneratorOperator::modEnvToPitch:      _ModEnvToPitch[slot]    = value; break;
+        case GeneratorOperator::initialFilterFc:    _InitialFilterFc[slot]  = value; break;
+        case GeneratorOperator::modLfoToFilterFc:   _ModLfoToFilterFc[slot] = value; break;
+        case GeneratorOperator::modEnvToFilterFc:   _ModEnvToFilterFc[slot] = value; break;
+        case GeneratorOperator::modLfoToVolume:     _ModLfoToVolume[slot]   = value; break;
+
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Enters the release stage of both envelopes.
+/// </summary>
+void articulation_engine_t::Release(uint32_t slot) noexcept
+{
+    _VolEnv.Release(slot, true);
+    _ModEnv.Release(slot, false);
+}
+
+/// <summary>
+/// Stops a voice and makes its slot available. A slot must be freed only once.
+/// </summary>
+void articulation_engine_t::Free(uint32_t slot) noexcept
+{
+    if (slot >= _SlotCount)
+        return;
+
+    _VolEnv.Stop(slot);
+    _ModEnv.Stop(slot);
+
+    _Gain[slot] = 0.f;
+
+    _FreeSlots.push_back(slot);
+}
+
+/// <summary>
+/// Advances all voices by the specified number of frames and calculates their gain, pitch ratio and filter cutoff.
+/// </summary>
+void articulation_engine_t::Process(uint32_t frameCount) noexcept
+{
+    if ((frameCount == 0) || (_SlotCount == 0))
+        return;
+
+    _VolEnv.Advance(0, _SlotCount, (int32_t) frameCount);
+    _ModEnv.Advance(0, _SlotCount, (int32_t) frameCount);
+    _ModLFO.Advance(0, _SlotCount, (int32_t) frameCount);
+    _VibLFO.Advance(0, _SlotCount, (int32_t) frameCount);
+
+    Evaluate(0, _SlotCount);
+}
+
+/// <summary>
+/// Calculates the results of a range of slots from the envelope and LFO values.
+/// </summary>
+void articulation_engine_t::Evaluate(uint32_t first, uint32_t last) noexcept
+{
+    const float * Table = units::GetExp2Table();
+
+    for (uint32_t i = first; i < last; ++i)
+    {
+        const float ModEnv = _ModEnv.Value[i];
+        const float ModLFO = _ModLFO.Value[i];
+        const float VibLFO = _VibLFO.Value[i];
+
+        const float PitchCents  = ModLFO * _ModLfoToPitch[i] + VibLFO * _VibLfoToPitch[i] + ModEnv * _ModEnvToPitch[i];
+        const float FilterCents = std::clamp(_InitialFilterFc[i] + ModLFO * _ModLfoToFilterFc[i] + ModEnv * _ModEnvToFilterFc[i], 1500.f, 13500.f);
+
+        const stage_t Stage = (stage_t) _VolEnv.Stage[i];
+        const float Value = _VolEnv.Value[i];
+
+        float Gain = 0.f;
+
+        if ((Stage != stage_t::Delay) && (Stage != stage_t::Finished))
+        {
+            // A positive modLfoToVolume raises the volume on a positive LFO excursion.
+            if (Stage == stage_t::Attack)
+                Gain = Value * units::CentibelsToGain(Table, -ModLFO * _ModLfoToVolume[i]);
+            else
+                Gain = units::CentibelsToGain(Table, 960.f * (1.f - Value) - ModLFO * _ModLfoToVolume[i]);
+        }
+
+        _Gain[i]         = Gain;
+        _PitchRatio[i]   = units::Exp2Cents(Table, PitchCents);
+        _FilterCutoff[i] = 8.1757989156f * units::Exp2Cents(Table, FilterCents);
+    }
+}
+
+/// <summary>
+/// Converts a duration in timecents to frames.
+/// </summary>
+int32_t articulation_engine_t::ToFrames(int32_t timecents) const noexcept
+{
+    return (int32_t) std::lround(units::TimecentsToSeconds((float) std::clamp(timecents, -12000, 8000)) * (float) _SampleRate);
+}
+
+#pragma region envelope_t
+
+void articulation_engine_t::envelope_t::Resize(size_t size)
+{
+    Stage.resize(size, (uint8_t) stage_t::Finished);
+    Remaining.resize(size, INT32_MAX);
+
+    for (auto * Array : { &Value, &Rate, &DecayRate, &ReleaseRate, &Sustain })
+        Array->resize(size);
+
+    for (auto * Array : { &DelayFrames, &AttackFrames, &HoldFrames })
+        Array->resize(size);
+}
+
+/// <summary>
+/// Starts the envelope of a slot. Stages without any frames are skipped.
+/// </summary>
+void articulation_engine_t::envelope_t::Start(uint32_t slot, int32_t delay, int32_t attack, int32_t hold, int32_t decay, float sustain, int32_t release) noexcept
+{
+    DelayFrames[slot]  = delay;
+    AttackFrames[slot] = attack;
+    HoldFrames[slot]   = hold;
+    DecayRate[slot]    = 1.f / (float) std::max(decay, 1);
+    ReleaseRate[slot]  = 1.f / (float) std::max(release, 1);
+    Sustain[slot]      = sustain;
+
+    Enter(slot, stage_t::Delay);
+
+    Advance(slot, slot + 1, 0);
+}
+
+/// <summary>
+/// Enters the release stage. A logarithmic envelope converts the linear amplitude of the attack stage to its dB scale first.
+/// </summary>
+void articulation_engine_t::envelope_t::Release(uint32_t slot, bool isLogarithmic) noexcept
+{
+    const stage_t Current = (stage_t) Stage[slot];
+
+    if ((Current == stage_t::Release) || (Current == stage_t::Finished))
+        return;
+
+    if (Current == stage_t::Delay)
+    {
+        Stop(slot);
+
+        return;
+    }
+
+    if ((Current == stage_t::Attack) && isLogarithmic)
+        Value[slot] = (Value[slot] > 0.f) ? std::max(1.f + (200.f * std::log10(Value[slot])) / 960.f, 0.f) : 0.f;
+
+    Enter(slot, stage_t::Release);
+}
+
+/// <summary>
+/// Silences the envelope of a slot.
+/// </summary>
+void articulation_engine_t::envelope_t::Stop(uint32_t slot) noexcept
+{
+    Enter(slot, stage_t::Finished);
+}
+
+/// <summary>
+/// Advances the envelopes of a range of slots. The stages are ramps of known length, so the common case is a multiply-add that the compiler can vectorize.
+/// </summary>
+void articulation_engine_t::envelope_t::Advance(uint32_t first, uint32_t last, int32_t frameCount) noexcept
+{
+    for (uint32_t i = first; i < last; ++i)
+    {
+        Value[i]     += Rate[i] * (float) frameCount;
+        Remaining[i] -= frameCount;
+    }
+
+    // Move the envelopes that reached the end of their stage to the next one and spend the frames that are left in it.
+    for (uint32_t i = first; i < last; ++i)
+    {
+        while (Remaining[i] <= 0)
+        {
+            const int32_t Overrun = -Remaining[i];
+
+            switch ((stage_t) Stage[i])
+            {
+                case stage_t::Delay:    Enter(i, stage_t::Attack); break;
+                case stage_t::Attack:   Enter(i, stage_t::Hold); break;
+                case stage_t::Hold:     Enter(i, stage_t::Decay); break;
+                case stage_t::Decay:    Enter(i, (Sustain[i] > 0.f) ? stage_t::Sustain : stage_t::Finished); break;
+                case stage_t::Sustain:  Enter(i, stage_t::Sustain); break;
+                case stage_t::Release:
+                case stage_t::Finished:
+                default:                Enter(i, stage_t::Finished); break;
+            }
+
+            Value[i]     += Rate[i] * (float) Overrun;
+            Remaining[i] -= Overrun;
+        }
+
+        Value[i] = std::clamp(Value[i], 0.f, 1.f);
+    }
+}
+
+/// <summary>
+/// Enters a stage at its start value.
+/// </summary>
+void articulation_engine_t::envelope_t::Enter(uint32_t slot, stage_t stage) noexcept
+{
+    Stage[slot] = (uint8_t) stage;
+
+    switch (stage)
+    {
+        case stage_t::Delay:
+        {
+            Value[slot]     = 0.f;
+            Rate[slot]      = 0.f;
+            Remaining[slot] = DelayFrames[slot];
+            break;
+        }
+
+        case stage_t::Attack:
+        {
+            Value[slot]     = 0.f;
+            Rate[slot]      = 1.f / (float) std::max(AttackFrames[slot], 1);
+            Remaining[slot] = AttackFrames[slot];
+            break;
+        }
+
+        case stage_t::Hold:
+        {
+            Value[slot]     = 1.f;
+            Rate[slot]      = 0.f;
+            Remaining[slot] = HoldFrames[slot];
+            break;
+        }
+
+        case stage_t::Decay:
+        {
+            Value[slot]     = 1.f;
+            Rate[slot]      = -DecayRate[slot];
+            Remaining[slot] = (int32_t) std::ceil((1.f - Sustain[slot]) / DecayRate[slot]);
+            break;
+        }
+
+        case stage_t::Sustain:
+        {
+            Value[slot]     = Sustain[slot];
+            Rate[slot]      = 0.f;
+            Remaining[slot] = INT32_MAX;
+            break;
+        }
+
+        case stage_t::Release:
+        {
+            Rate[slot]      = -ReleaseRate[slot];
+            Remaining[slot] = (int32_t) std::ceil(Value[slot] / ReleaseRate[slot]);
+            break;
+        }
+
+        case stage_t::Finished:
+        default:
+        {
+            Value[slot]     = 0.f;
+            Rate[slot]      = 0.f;
+            Remaining[slot] = INT32_MAX;
+            break;
+        }
+    }
+}
+
+#pragma endregion
+
+#pragma region lfo_t
+
+void articulation_engine_t::lfo_t::Resize(size_t size)
+{
+    Delay.resize(size);
+
+    for (auto * Array : { &Phase, &Increment, &Value })
+        Array->resize(size);
+}
+
+/// <summary>
+/// Starts the LFO of a slot.
+/// </summary>
+void articulation_engine_t::lfo_t::Start(uint32_t slot, int32_t delay, float increment) noexcept
+{
+    Delay[slot]     = delay;
+    Phase[slot]     = 0.f;
+    Increment[slot] = increment;
+    Value[slot]     = 0.f;
+}
+
+/// <summary>
+/// Advances the LFOs of a range of slots. The triangle starts at 0 and rises first.
+/// </summary>
+void articulation_engine_t::lfo_t::Advance(uint32_t first, uint32_t last, int32_t frameCount) noexcept
+{
+    for (uint32_t i = first; i < last; ++i)
+    {
+        const int32_t Frames = std::clamp(frameCount - Delay[i], 0, frameCount);
+
+        Delay[i] = std::max(Delay[i] - frameCount, 0);
+
+        float p = Phase[i] + Increment[i] * (float) Frames;
+
+        p -= (float) (int32_t) p; // The phase is never negative.
+
+        Phase[i] = p;
+
+        float t = p + 0.25f;
+
+        t -= (float) (int32_t) t;
+
+        Value[i] = 1.f - 4.f * std::fabs(t - 0.5f);
+    }
+}
+
+#pragma endregion
@@ -0,0 +1,447 @@
+
+/** $VER: AsyncReader.cpp (2026.10.18) P. Stuer - Batched asynchronous reads of file ranges **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "AsyncReader.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define SF_HAS_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+using namespace sf;
+
+namespace
+{
+    // Maximum number of buffers in a coalesced read, well below IOV_MAX.
+    constexpr uint32_t MaxVectors = 256;
+}
+
+#ifdef SF_HAS_IO_URING
+
+/// <summary>
+/// The submission and completion rings of an io_uring instance, mapped from the kernel. The rings are used through the system calls directly so there's no dependency on liburing.
+/// </summary>
+struct async_reader_t::ring_t
+{
+    int Fd;
+    uint32_t Entries;
+    uint32_t Unsubmitted;                   // Entries queued in the submission ring that the kernel has not consumed yet.
+
+    void * SQMap;
+    size_t SQMapSize;
+    void * CQMap;
+    size_t CQMapSize;
+
+    io_uring_sqe * SQEs;
+    size_t SQEsSize;
+
+    uint32_t * SQTail;
+    uint32_t * SQArray;
+    uint32_t SQMask;
+
+    uint32_t * CQHead;
+    uint32_t * CQTail;
+    uint32_t CQMask;
+    io_uring_cqe * CQEs;
+};
+
+#else
+
+struct async_reader_t::ring_t { };
+
+#endif
+
+/// <summary>
+/// Initializes a new instance.
+/// </summary>
+async_reader_t::async_reader_t(const std::filesystem::path & filePath, const async_reader_options_t & options) :
+    _Options(options), _NextRead(), _InFlight(), _Ring(), _RequestCount(), _ReadCount(), _SystemCallCount()
+{
+    _Options.QueueDepth  = std::clamp(_Options.QueueDepth, 1u, 4096u);
+    _Options.MaxReadSize = std::max(_Options.MaxReadSize, 1u);
+
+    _File.Open(filePath);
+
+    if (!_Options.UseIOUring || !CreateRing(_Options.QueueDepth))
+        _Pool = std::make_unique<thread_pool_t>(std::max(_Options.ThreadCount, 1u));
+
+    _Gap.resize((size_t) _Options.MaxGap * ((_Pool != nullptr) ? _Pool->ThreadCount() : 1));
+}
+
+/// <summary>
+/// Waits for the current batch and releases the resources.
+/// </summary>
+async_reader_t::~async_reader_t()
+{
+    try
+    {
+        Wait();
+    }
+    catch (...)
+    {
+    }
+
+    DestroyRing();
+}
+
+/// <summary>
+/// Starts reading a batch of requests. Waits for the previous batch first.
+/// </summary>
+void async_reader_t::Submit(std::span<read_request_t> requests)
+{
+    Wait();
+
+    Plan(requests);
+
+    _RequestCount += requests.size();
+    _ReadCount    += _Reads.size();
+
+    if (_Ring != nullptr)
+    {
+        Pump(false);
+    }
+    else
+    {
+        // Divide the reads over the workers. Each task discards the gaps into its own part of the gap buffer.
+        const size_t TaskCount = std::min(_Reads.size(), (size_t) _Pool->ThreadCount());
+
+        for (size_t i = 0; i < TaskCount; ++i)
+        {
+            _Pool->Submit([this, i, TaskCount]
+            {
+                uint8_t * Gap = _Gap.data() + i * _Options.MaxGap;
+
+                for (size_t j = _Reads.size() * i / TaskCount; j < _Reads.size() * (i + 1) / TaskCount; ++j)
+                {
+                    const auto & Read = _Reads[j];
+
+                    for (uint32_t k = Read.FirstVector; k < Read.FirstVector + Read.VectorCount; ++k)
+                    {
+                        if (_Vectors[k].Data == _Gap.data())
+                            _Vectors[k].Data = Gap;
+                    }
+
+                    Complete(Read, _File.Read(Read.Offset, &_Vectors[Read.FirstVector], Read.VectorCount));
+                }
+            });
+        }
+
+        _NextRead = _Reads.size();
+        _SystemCallCount += _Reads.size();
+    }
+}
+
+/// <summary>
+/// Waits until all requests of the current batch have completed.
+/// </summary>
+void async_reader_t::Wait()
+{
+    if (_Ring != nullptr)
+    {
+        while ((_NextRead < _Reads.size()) || (_InFlight != 0))
+            Pump(true);
+    }
+    else
+    if (_Pool != nullptr)
+        _Pool->Wait();
+
+    _Requests = { };
+}
+
+/// <summary>
+/// Reads a batch of requests and waits for them. A batch that fits in the queue takes a single system call with io_uring.
+/// </summary>
+void async_reader_t::Read(std::span<read_request_t> requests)
+{
+    Submit(requests);
+    Wait();
+}
+
+/// <summary>
+/// Sorts the requests by offset and coalesces them into reads.
+/// </summary>
+void async_reader_t::Plan(std::span<read_request_t> requests)
+{
+    _Requests = requests;
+
+    _Order.clear();
+    _Reads.clear();
+    _Vectors.clear();
+
+    _NextRead = 0;
+    _InFlight = 0;
+
+    for (uint32_t i = 0; i < (uint32_t) requests.size(); ++i)
+    {
+        requests[i].BytesRead = 0;
+
+        if (requests[i].Size != 0)
+            _Order.push_back(i);
+    }
+
+    std::sort(_Order.begin(), _Order.end(), [requests](uint32_t a, uint32_t b) { return requests[a].Offset < requests[b].Offset; });
+
+    for (uint32_t i = 0; i < (uint32_t) _Order.size(); ++i)
+    {
+        const auto & Request = requests[_Order[i]];
+
+        if (!_Reads.empty())
+        {
+            auto & Read = _Reads.back();
+
+            const uint64_t End = Read.Offset + Read.Size;
+
+            // Overlapping requests can't share a read because the buffers of a read are consecutive.
+            if (Request.Offset >= End)
+            {
+                const uint64_t Gap = Request.Offset - End;
+
+                if ((Gap <= _Options.MaxGap) && (Read.Size + Gap + Request.Size <= _Options.MaxReadSize) && (Read.VectorCount + 2 <= MaxVectors))
+                {
+                    if (Gap != 0)
+                    {
+                        _Vectors.push_back({ _Gap.data(), (size_t) Gap });
+                        ++Read.VectorCount;
+                    }
+
+                    _Vectors.push_back({ Request.Data, Request.Size });
+                    ++Read.VectorCount;
+
+                    Read.Size += Gap + Request.Size;
+                    ++Read.RequestCount;
+
+                    continue;
+                }
+            }
+        }
+
+        read_t Read;
+
+        Read.Offset       = Request.Offset;
+        Read.Size         = Request.Size;
+        Read.FirstVector  = (uint32_t) _Vectors.size();
+        Read.VectorCount  = 1;
+        Read.FirstRequest = i;
+        Read.RequestCount = 1;
+
+        _Reads.push_back(Read);
+        _Vectors.push_back({ Request.Data, Request.Size });
+    }
+}
+
+/// <summary>
+/// Distributes the bytes of a completed read over its requests.
+/// </summary>
+void async_reader_t::Complete(const read_t & read, uint64_t bytesRead) noexcept
+{
+    for (uint32_t i = read.FirstRequest; i < read.FirstRequest + read.RequestCount; ++i)
+    {
+        auto & Request = _Requests[_Order[i]];
+
+        const uint64_t Start = Request.Offset - read.Offset;
+
+        Request.BytesRead = (bytesRead > Start) ? (uint32_t) std::min(bytesRead - Start, (uint64_t) Request.Size) : 0;
+    }
+}
+
+#ifdef SF_HAS_IO_URING
+
+/// <summary>
+/// Queues the reads that fit in the submission ring, submits them and reaps the completions. If wait is set, waits until all reads in flight have completed.
+/// </summary>
+void async_reader_t::Pump(bool wait)
+{
+    auto & Ring = *_Ring;
+
+    uint32_t Tail = std::atomic_ref(*Ring.SQTail).load(std::memory_order_relaxed);
+
+    while ((_NextRead < _Reads.size()) && (_InFlight < Ring.Entries))
+    {
+        const auto & Read = _Reads[_NextRead];
+
+        const uint32_t Index = Tail & Ring.SQMask;
+
+        io_uring_sqe & SQE = Ring.SQEs[Index];
+
+        ::memset(&SQE, 0, sizeof(SQE));
+
+        SQE.opcode    = IORING_OP_READV;
+        SQE.fd        = _File.Descriptor();
+        SQE.addr      = (uint64_t) (uintptr_t) &_Vectors[Read.FirstVector];
+        SQE.len       = Read.VectorCount;
+        SQE.off       = Read.Offset;
+        SQE.user_data = _NextRead;
+
+        Ring.SQArray[Index] = Index;
+
+        ++Tail;
+        ++Ring.Unsubmitted;
+        ++_InFlight;
+        ++_NextRead;
+    }
+
+    std::atomic_ref(*Ring.SQTail).store(Tail, std::memory_order_release);
+
+    if ((Ring.Unsubmitted != 0) || (wait && (_InFlight != 0)))
+    {
+        const uint32_t MinComplete = wait ? (uint32_t) _InFlight : 0;
+
+        for (;;)
+        {
+            const long Result = ::syscall(__NR_io_uring_enter, Ring.Fd, Ring.Unsubmitted, MinComplete, (MinComplete != 0) ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+
+            ++_SystemCallCount;
+
+            if (Result >= 0)
+            {
+                Ring.Unsubmitted -= (uint32_t) Result;
+                break;
+            }
+
+            if (errno == EINTR)
+                continue;
+
+            // Out of resources: reap what has completed and try again on the next call.
+            if ((errno == EAGAIN) || (errno == EBUSY))
+                break;
+
+            throw sf::exception(msc::FormatText("Failed to submit reads (%s)", ::strerror(errno)));
+        }
+    }
+
+    // Reap the completions.
+    uint32_t Head = std::atomic_ref(*Ring.CQHead).load(std::memory_order_relaxed);
+    const uint32_t CQTail = std::atomic_ref(*Ring.CQTail).load(std::memory_order_acquire);
+
+    for (; Head != CQTail; ++Head)
+    {
+        const io_uring_cqe & CQE = Ring.CQEs[Head & Ring.CQMask];
+
+        const auto & Read = _Reads[(size_t) CQE.user_data];
+
+        uint64_t BytesRead = (CQE.res > 0) ? (uint64_t) CQE.res : 0;
+
+        // Finish a short read that didn't reach the end of the file synchronously.
+        if ((BytesRead < Read.Size) && (Read.Offset + BytesRead < _File.Size()))
+        {
+            BytesRead = _File.Read(Read.Offset, &_Vectors[Read.FirstVector], Read.VectorCount);
+            ++_SystemCallCount;
+        }
+
+        Complete(Read, BytesRead);
+
+        --_InFlight;
+    }
+
+    std::atomic_ref(*Ring.CQHead).store(Head, std::memory_order_release);
+}
+
+/// <summary>
+/// Creates an io_uring instance. Returns false if the kernel doesn't support it or doesn't allow it.
+/// </summary>
+bool async_reader_t::CreateRing(uint32_t entries) noexcept
+{
+    io_uring_params Params = { };
+
+    const int Fd = (int) ::syscall(__NR_io_uring_setup, entries, &Params);
+
+    if (Fd < 0)
+        return false;
+
+    auto Ring = std::make_unique<ring_t>();
+
+    Ring->Fd          = Fd;
+    Ring->Entries     = Params.sq_entries;
+    Ring->Unsubmitted = 0;
+
+    Ring->SQMapSize = Params.sq_off.array + Params.sq_entries * sizeof(uint32_t);
+    Ring->CQMapSize = Params.cq_off.cqes  + Params.cq_entries * sizeof(io_uring_cqe);
+
+    const bool IsSingleMap = (Params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+    if (IsSingleMap)
+        Ring->SQMapSize = Ring->CQMapSize = std::max(Ring->SQMapSize, Ring->CQMapSize);
+
+    Ring->SQMap = ::mmap(nullptr, Ring->SQMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Fd, IORING_OFF_SQ_RING);
+    Ring->CQMap = IsSingleMap ? Ring->SQMap : ::mmap(nullptr, Ring->CQMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Fd, IORING_OFF_CQ_RING);
+
+    Ring->SQEsSize = Params.sq_entries * sizeof(io_uring_sqe);
+    Ring->SQEs = (io_uring_sqe *) ::mmap(nullptr, Ring->SQEsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Fd, IORING_OFF_SQES);
+
+    if ((Ring->SQMap == MAP_FAILED) || (Ring->CQMap == MAP_FAILED) || ((void *) Ring->SQEs == MAP_FAILED))
+    {
+        if ((void *) Ring->SQEs != MAP_FAILED)
+            ::munmap(Ring->SQEs, Ring->SQEsSize);
+
+        if (!IsSingleMap && (Ring->CQMap != MAP_FAILED))
+            ::munmap(Ring->CQMap, Ring->CQMapSize);
+
+        if (Ring->SQMap != MAP_FAILED)
+            ::munmap(Ring->SQMap, Ring->SQMapSize);
+
+        ::close(Fd);
+
+        return false;
+    }
+
+    uint8_t * SQ = (uint8_t *) Ring->SQMap;
+    uint8_t * CQ = (uint8_t *) Ring->CQMap;
+
+    Ring->SQTail  = (uint32_t *) (SQ + Params.sq_off.tail);
+    Ring->SQArray = (uint32_t *) (SQ + Params.sq_off.array);
+    Ring->SQMask  = *(uint32_t *) (SQ + Params.sq_off.ring_mask);
+
+    Ring->CQHead  = (uint32_t *) (CQ + Params.cq_off.head);
+    Ring->CQTail  = (uint32_t *) (CQ + Params.cq_off.tail);
+    Ring->CQMask  = *(uint32_t *) (CQ + Params.cq_off.ring_mask);
+    Ring->CQEs    = (io_uring_cqe *) (CQ + Params.cq_off.cqes);
+
+    _Ring = Ring.release();
+
+    return true;
+}
+
+/// <summary>
+/// Destroys the io_uring instance.
+/// </summary>
+void async_reader_t::DestroyRing() noexcept
+{
+    if (_Ring == nullptr)
+        return;
+
+    ::munmap(_Ring->SQEs, _Ring->SQEsSize);
+
+    if (_Ring->CQMap != _Ring->SQMap)
+        ::munmap(_Ring->CQMap, _Ring->CQMapSize);
+
+    ::munmap(_Ring->SQMap, _Ring->SQMapSize);
+
+    ::close(_Ring->Fd);
+
+    delete _Ring;
+    _Ring = nullptr;
+}
+
+#else
+
+void async_reader_t::Pump(bool) { }
+
+bool async_reader_t::CreateRing(uint32_t) noexcept { return false; }
+
+void async_reader_t::DestroyRing() noexcept { }
+
+#endif
@@ -0,0 +1,479 @@
+
+/** $VER: BankCache.cpp (2026.10.18) P. Stuer - Precompiled binary bank cache that is loaded by mapping it into memory **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "BankCache.h"
+
+#include <fstream>
+
+using namespace sf;
+
+namespace
+{
+    /// <summary>
+    /// Rounds a file offset up to the specified alignment.
+    /// </summary>
+    uint64_t AlignOffset(uint64_t offset, uint64_t alignment) noexcept
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    /// <summary>
+    /// Collects the names of the bank as zero-terminated strings. Offset 0 is the empty string.
+    /// </summary>
+    class name_pool_t
+    {
+    public:
+        name_pool_t() : Data(1, '\0') { }
+
+        uint32_t Add(const std::string & name)
+        {
+            // Fixed-length names can contain trailing zeroes.
+            const size_t Size = ::strnlen(name.c_str(), name.size());
+
+            if (Size == 0)
+                return 0;
+
+            const uint32_t Offset = (uint32_t) Data.size();
+
+            Data.append(name.c_str(), Size);
+            Data.push_back('\0');
+
+            return Offset;
+        }
+
+    public:
+        std::string Data;
+    };
+
+    /// <summary>
+    /// Writes zeroes up to the specified file offset.
+    /// </summary>
+    void Pad(std::ofstream & stream, uint64_t & offset, uint64_t newOffset)
+    {
+        static const char Zeroes[64] = { };
+
+        while (offset < newOffset)
+        {
+            const uint64_t Size = std::min(newOffset - offset, (uint64_t) sizeof(Zeroes));
+
+            stream.write(Zeroes, (std::streamsize) Size);
+            offset += Size;
+        }
+    }
+
+    /// <summary>
+    /// Writes a section at the current file offset.
+    /// </summary>
+    void WriteSection(std::ofstream & stream, uint64_t & offset, const void * data, uint64_t size)
+    {
+        if (size != 0)
+            stream.write((const char *) data, (std::streamsize) size);
+
+        offset += size;
+    }
+}
+
+/// <summary>
+/// Maps a bank cache into memory. Returns false if the file does not exist, was written by another version of the library, is damaged or,
+/// if a source hash is specified, was created from different content. Throws if an existing file can't be mapped.
+/// </summary>
+bool bank_cache_t::Open(const std::filesystem::path & filePath, uint64_t sourceHash)
+{
+    METRICS_SCOPE("bank_cache_t::Open");
+
+    Close();
+
+    std::error_code ec;
+
+    if (!std::filesystem::is_regular_file(filePath, ec))
+        return false;
+
+    _File.Open(filePath);
+
+    if (_File.Size() < sizeof(header_t))
+    {
+        Close();
+
+        return false;
+    }
+
+    _Header = (const header_t *) _File.Data();
+
+    if (!IsValid() || ((sourceHash != 0) && (_Header->SourceHash != sourceHash)))
+    {
+        Close();
+
+        return false;
+    }
+
+    _Names     = (const char *) (_File.Data() + _Header->Names.Offset);
+    _NamesSize = (uint32_t) _Header->Names.Size;
+
+    return true;
+}
+
+/// <summary>
+/// Unmaps the cache. Invalidates all spans and pointers returned by this instance.
+/// </summary>
+void bank_cache_t::Close() noexcept
+{
+    _File.Close();
+
+    _Header    = nullptr;
+    _Names     = nullptr;
+    _NamesSize = 0;
+}
+
+/// <summary>
+/// Writes a cache of the specified bank. The regions of all presets are resolved and stored with the sample headers, the names and the sample data. The file is replaced atomically.
+/// </summary>
+void bank_cache_t::Write(const std::filesystem::path & filePath, const bank_t & bank, uint64_t sourceHash)
+{
+    METRICS_SCOPE("bank_cache_t::Write");
+
+    bank.CheckSamplePool("cache");
+
+    name_pool_t Names;
+
+    std::vector<cached_preset_t> Presets;
+    std::vector<cached_region_t> Regions;
+    std::vector<cached_sample_t> Samples;
+
+    {
+        const region_resolver_t Resolver(bank);
+
+        std::vector<region_t> PresetRegions;
+
+        // The last preset is the terminal record.
+        for (size_t i = 0; i + 1 < bank.Presets.size(); ++i)
+        {
+            const auto & Preset = bank.Presets[i];
+
+            PresetRegions.clear();
+
+            Resolver.GetRegions(i, PresetRegions);
+
+            cached_preset_t p;
+
+            p.Key         = ((uint32_t) Preset.MIDIBank << 16) | Preset.MIDIProgram;
+            p.PresetIndex = (uint32_t) i;
+            p.FirstRegion = (uint32_t) Regions.size();
+            p.RegionCount = (uint32_t) PresetRegions.size();
+            p.NameOffset  = Names.Add(Preset.Name);
+
+            Presets.push_back(p);
+
+            for (const auto & Region : PresetRegions)
+            {
+                cached_region_t r;
+
+                r.SampleIndex = Region.SampleIndex;
+
+                r.KeyLo = Region.KeyLo;
+                r.KeyHi = Region.KeyHi;
+                r.VelLo = Region.VelLo;
+                r.VelHi = Region.VelHi;
+
+                r.PresetGlobalZoneIndex     = Region.PresetGlobalZoneIndex;
+                r.PresetZoneIndex           = Region.PresetZoneIndex;
+                r.InstrumentGlobalZoneIndex = Region.InstrumentGlobalZoneIndex;
+                r.InstrumentZoneIndex       = Region.InstrumentZoneIndex;
+
+                std::copy(Region.Generators.begin(), Region.Generators.end(), r.Generators);
+
+                Regions.push_back(r);
+            }
+        }
+    }
+
+    // Keep the order of presets with the same key; the resolver uses the first one.
+    std::stable_sort(Presets.begin(), Presets.end(), [](const cached_preset_t & a, const cached_preset_t & b) { return a.Key < b.Key; });
+
+    Samples.reserve(bank.Samples.size());
+
+    // Clamp the sample headers to the sample data, as the renderer does, so every point of a cached sample and its guard points is within the cache.
+    const uint32_t PointCount = (uint32_t) std::min(bank.SampleData.size() / sizeof(int16_t), (size_t) UINT32_MAX);
+    const uint32_t MaxEnd     = PointCount - std::min(PointCount, bank.SamplePadding);
+
+    for (const auto & Sample : bank.Samples)
+    {
+        cached_sample_t s;
+
+        s.End             = std::min(Sample.End, MaxEnd);
+        s.Start           = std::min(Sample.Start, s.End);
+        s.LoopStart       = std::min(Sample.LoopStart, PointCount);
+        s.LoopEnd         = std::min(Sample.LoopEnd, PointCount);
+        s.SampleRate      = Sample.SampleRate;
+        s.Pitch           = Sample.Pitch;
+        s.PitchCorrection = Sample.PitchCorrection;
+        s.SampleLink      = Sample.SampleLink;
+        s.SampleType      = Sample.SampleType;
+        s.Reserved        = 0;
+        s.NameOffset      = Names.Add(Sample.Name);
+
+        Samples.push_back(s);
+    }
+
+    header_t Header = { };
+
+    Header.Magic          = Magic;
+    Header.Version        = Version;
+    Header.ByteOrder      = 0x01020304;
+    Header.GeneratorCount = (uint32_t) region_t::GeneratorCount;
+    Header.SourceHash     = sourceHash;
+    Header.NameOffset     = Names.Add(bank.Name);
+    Header.SamplePadding  = bank.SamplePadding;
+
+    if (Names.Data.size() > UINT32_MAX)
+        throw sf::exception("Too many names for a bank cache");
+
+    // Lay out the sections.
+    uint64_t Offset = sizeof(Header);
+
+    const auto Place = [&Offset](section_t & section, uint64_t size, uint64_t alignment) noexcept
+    {
+        section.Offset = AlignOffset(Offset, alignment);
+        section.Size   = size;
+
+        Offset = section.Offset + size;
+    };
+
+    Place(Header.Presets,       Presets.size() * sizeof(cached_preset_t), 8);
+    Place(Header.Regions,       Regions.size() * sizeof(cached_region_t), 8);
+    Place(Header.Samples,       Samples.size() * sizeof(cached_sample_t), 8);
+    Place(Header.Names,         Names.Data.size(), 8);
+    Place(Header.SampleData,    (uint64_t) PointCount * sizeof(int16_t), Alignment);
+    Place(Header.SampleDataLSB, (bank.SampleDataLSB.size() >= PointCount) ? PointCount : 0, Alignment); // The 24-bit data is ignored if it doesn't cover the sample data.
+
+    Header.FileSize = Offset;
+
+    std::filesystem::path TempPath = filePath;
+
+    TempPath += ".tmp";
+
+    try
+    {
+        {
+            std::ofstream Stream(TempPath, std::ios::binary | std::ios::trunc);
+
+            if (!Stream)
+                throw sf::exception(msc::FormatText("Failed to create bank cache \"%s\"", (const char *) TempPath.u8string().c_str()));
+
+            Offset = 0;
+
+            WriteSection(Stream, Offset, &Header, sizeof(Header));
+
+            Pad(Stream, Offset, Header.Presets.Offset);
+            WriteSection(Stream, Offset, Presets.data(), Header.Presets.Size);
+
+            Pad(Stream, Offset, Header.Regions.Offset);
+            WriteSection(Stream, Offset, Regions.data(), Header.Regions.Size);
+
+            Pad(Stream, Offset, Header.Samples.Offset);
+            WriteSection(Stream, Offset, Samples.data(), Header.Samples.Size);
+
+            Pad(Stream, Offset, Header.Names.Offset);
+            WriteSection(Stream, Offset, Names.Data.data(), Header.Names.Size);
+
+            Pad(Stream, Offset, Header.SampleData.Offset);
+            WriteSection(Stream, Offset, bank.SampleData.data(), Header.SampleData.Size);
+
+            Pad(Stream, Offset, Header.SampleDataLSB.Offset);
+            WriteSection(Stream, Offset, bank.SampleDataLSB.data(), Header.SampleDataLSB.Size);
+
+            if (!Stream)
+                throw sf::exception(msc::FormatText("Failed to write bank cache \"%s\"", (const char *) TempPath.u8string().c_str()));
+        }
+
+        std::filesystem::rename(TempPath, filePath);
+    }
+    catch (...)
+    {
+        std::error_code ec;
+
+        std::filesystem::remove(TempPath, ec);
+
+        throw;
+    }
+}
+
+/// <summary>
+/// Gets the path of the cache of the bank with the specified content hash.
+/// </summary>
+std::filesystem::path bank_cache_t::GetPath(const std::filesystem::path & directoryPath, uint64_t sourceHash)
+{
+    return directoryPath / msc::FormatText("%016llX.sfc", (unsigned long long) sourceHash);
+}
+
+/// <summary>
+/// Gets the index in Presets() of the preset with the specified bank and program number. Falls back to bank 0 (or program 0 for percussion) like region_resolver_t does. Returns -1 if there is no such preset.
+/// </summary>
+int bank_cache_t::FindPreset(uint16_t midiBank, uint16_t midiProgram) const noexcept
+{
+    const auto Presets = this->Presets();
+
+    const auto Find = [Presets](uint32_t key) noexcept -> int
+    {
+        auto it = std::lower_bound(Presets.begin(), Presets.end(), key, [](const cached_preset_t & preset, uint32_t key) { return preset.Key < key; });
+
+        return ((it != Presets.end()) && (it->Key == key)) ? (int) (it - Presets.begin()) : -1;
+    };
+
+    int Index = Find(((uint32_t) midiBank << 16) | midiProgram);
+
+    if (Index < 0)
+        Index = (midiBank == 128) ? Find((uint32_t) midiBank << 16) : Find(midiProgram);
+
+    return Index;
+}
+
+/// <summary>
+/// Stores the regions of the specified preset that respond to the specified key and velocity, in the order of region_resolver_t::Resolve(). Returns the number of stored regions.
+/// </summary>
+size_t bank_cache_t::Resolve(uint16_t midiBank, uint16_t midiProgram, uint8_t key, uint8_t velocity, std::span<const cached_region_t *> regions) const noexcept
+{
+    const int PresetIndex = FindPreset(midiBank, midiProgram);
+
+    if (PresetIndex < 0)
+        return 0;
+
+    size_t Count = 0;
+
+    for (const auto & Region : GetRegions(Presets()[(size_t) PresetIndex]))
+    {
+        if ((key < Region.KeyLo) || (key > Region.KeyHi) || (velocity < Region.VelLo) || (velocity > Region.VelHi))
+            continue;
+
+        if (Count == regions.size())
+            break;
+
+        regions[Count++] = &Region;
+    }
+
+    return Count;
+}
+
+/// <summary>
+/// Stores the sample ranges that the specified preset can play, as region_resolver_t::GetSampleRanges() does. The points are relative to SampleData().
+/// Returns false if the preset does not exist.
+/// </summary>
+bool bank_cache_t::GetSampleRanges(uint16_t midiBank, uint16_t midiProgram, std::vector<sample_range_t> & ranges) const
+{
+    ranges.clear();
+
+    const int PresetIndex = FindPreset(midiBank, midiProgram);
+
+    if (PresetIndex < 0)
+        return false;
+
+    const auto Samples = this->Samples();
+
+    std::vector<uint32_t> SampleIndices;
+
+    for (const auto & Region : GetRegions(Presets()[(size_t) PresetIndex]))
+    {
+        SampleIndices.push_back(Region.SampleIndex);
+
+        const auto & Sample = Samples[Region.SampleIndex];
+
+        if ((Sample.SampleType & (RightSample | LeftSample | LinkedSample)) && (Sample.SampleLink < Samples.size()))
+            SampleIndices.push_back(Sample.SampleLink);
+    }
+
+    std::sort(SampleIndices.begin(), SampleIndices.end());
+    SampleIndices.erase(std::unique(SampleIndices.begin(), SampleIndices.end()), SampleIndices.end());
+
+    const uint32_t Padding = _Header->SamplePadding;
+
+    for (const uint32_t SampleIndex : SampleIndices)
+    {
+        const auto & Sample = Samples[SampleIndex];
+
+        if ((Sample.SampleType & 0x8000) || (Sample.End <= Sample.Start))
+            continue;
+
+        sample_range_t Range;
+
+        Range.SampleIndex = SampleIndex;
+        Range.Start       = Sample.Start - std::min(Sample.Start, Padding);
+        Range.End         = Sample.End + Padding;
+
+        ranges.push_back(Range);
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Returns true if the mapped header and sections are consistent. Every index in the cache is checked so that the spans can be used without bounds checks.
+/// </summary>
+bool bank_cache_t::IsValid() const noexcept
+{
+    const auto & h = *_Header;
+
+    if ((h.Magic != Magic) || (h.Version != Version) || (h.ByteOrder != 0x01020304) || (h.GeneratorCount != region_t::GeneratorCount) || (h.FileSize != _File.Size()))
+        return false;
+
+    const auto IsValidSection = [this](const section_t & section, uint64_t alignment, uint64_t itemSize) noexcept
+    {
+        return ((section.Offset % alignment) == 0) && ((section.Size % itemSize) == 0) && (section.Offset <= _File.Size()) && (section.Size <= _File.Size() - section.Offset);
+    };
+
+    if (!IsValidSection(h.Presets,       8,         sizeof(cached_preset_t)) ||
+        !IsValidSection(h.Regions,       8,         sizeof(cached_region_t)) ||
+        !IsValidSection(h.Samples,       8,         sizeof(cached_sample_t)) ||
+        !IsValidSection(h.Names,         8,         1) ||
+        !IsValidSection(h.SampleData,    Alignment, sizeof(int16_t)) ||
+        !IsValidSection(h.SampleDataLSB, Alignment, 1))
+        return false;
+
+    // The name pool starts with the empty string and every name is terminated.
+    const char * Names = (const char *) (_File.Data() + h.Names.Offset);
+
+    if ((h.Names.Size == 0) || (h.Names.Size > UINT32_MAX) || (Names[0] != '\0') || (Names[h.Names.Size - 1] != '\0') || (h.NameOffset >= h.Names.Size))
+        return false;
+
+    const auto Regions = GetSpan<cached_region_t>(h.Regions);
+    const auto Samples = GetSpan<cached_sample_t>(h.Samples);
+
+    const auto Presets = GetSpan<cached_preset_t>(h.Presets);
+
+    for (size_t i = 0; i < Presets.size(); ++i)
+    {
+        const auto & Preset = Presets[i];
+
+        if (((uint64_t) Preset.FirstRegion + Preset.RegionCount > Regions.size()) || (Preset.NameOffset >= h.Names.Size))
+            return false;
+
+        // FindPreset() searches the presets by key.
+        if ((i != 0) && (Preset.Key < Presets[i - 1].Key))
+            return false;
+    }
+
+    for (const auto & Region : Regions)
+    {
+        if (Region.SampleIndex >= Samples.size())
+            return false;
+    }
+
+    const uint64_t PointCount = h.SampleData.Size / sizeof(int16_t);
+
+    if ((h.SampleDataLSB.Size != 0) && (h.SampleDataLSB.Size != PointCount))
+        return false;
+
+    // A sample and its guard points, and its loop, must be within the sample data.
+    for (const auto & Sample : Samples)
+    {
+        if (Sample.NameOffset >= h.Names.Size)
+            return false;
+
+        if ((Sample.Start > Sample.End) || ((uint64_t) Sample.End + ((Sample.End > Sample.Start) ? h.SamplePadding : 0) > PointCount) || (Sample.LoopStart > PointCount) || (Sample.LoopEnd > PointCount))
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,328 @@
+
+/** $VER: BankLoader.cpp (2026.10.18) P. Stuer - Process-wide service that loads and shares banks **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "BankLoader.h"
+#include "SampleStore.h"
+#include "ThreadPool.h"
+
+using namespace sf;
+
+/// <summary>
+/// Initializes a new instance.
+/// </summary>
+bank_loader_t::bank_loader_t(const bank_loader_options_t & options) : _Options(options), _MemoryUsage(), _Clock(), _NextLoadId()
+{
+    // Create the sample store first so it outlives the loads of a static loader.
+    if (_Options.ShareSamples)
+        sample_store_t::Instance();
+
+    _Pool = std::make_unique<thread_pool_t>(_Options.ThreadCount);
+}
+
+/// <summary>
+/// Finishes the loads in progress.
+/// </summary>
+bank_loader_t::~bank_loader_t()
+{
+    _Pool.reset();
+}
+
+/// <summary>
+/// Gets the loader that is shared by the whole process.
+/// </summary>
+bank_loader_t & bank_loader_t::Instance()
+{
+    static bank_loader_t Loader;
+
+    return Loader;
+}
+
+/// <summary>
+/// Gets the bank in the specified file. A bank that has been loaded before and is unmodified is returned immediately, a bank that is being loaded is shared
+/// with the requests that are waiting for it, and any other bank is loaded in the background. The future rethrows the error if the file can't be loaded.
+/// </summary>
+std::shared_future<bank_loader_t::bank_ptr_t> bank_loader_t::LoadAsync(const std::filesystem::path & filePath)
+{
+    std::error_code ec;
+
+    const auto Path = std::filesystem::canonical(filePath, ec);
+
+    const uint64_t FileSize     = !ec ? (uint64_t) std::filesystem::file_size(Path, ec) : 0;
+    const int64_t LastWriteTime = !ec ? (int64_t) std::filesystem::last_write_time(Path, ec).time_since_epoch().count() : 0;
+
+    if (ec)
+        throw sf::exception(msc::FormatText("Failed to open \"%s\": %s", (const char *) filePath.u8string().c_str(), ec.message().c_str()));
+
+    std::vector<bank_ptr_t> Evicted;
+
+    std::lock_guard Lock(_Mutex);
+
+    auto it = _Entries.find(Path);
+
+    if ((it != _Entries.end()) && (it->second.FileSize == FileSize) && (it->second.LastWriteTime == LastWriteTime))
+    {
+        auto & Entry = it->second;
+
+        if (Entry.Future.valid())
+            return Entry.Future;
+
+        Entry.LastUse = ++_Clock;
+
+        if (Entry.Bank != nullptr)
+            return MakeReady(Entry.Bank);
+
+        // The bank was evicted but is still in use. Keep it alive again.
+        auto Bank = Entry.WeakBank.lock();
+
+        if (Bank != nullptr)
+        {
+            Entry.Bank = Bank;
+
+            _MemoryUsage += Entry.Size;
+
+            Evict(&Entry, Evicted);
+
+            return MakeReady(std::move(Bank));
+        }
+    }
+
+    // Load the file, replacing any previous version. Requests that are still waiting for a previous version get that version.
+    entry_t & Entry = _Entries[Path];
+
+    if (Entry.Bank != nullptr)
+    {
+        _MemoryUsage -= Entry.Size;
+
+        Evicted.push_back(std::move(Entry.Bank));
+    }
+
+    auto Promise = std::make_shared<std::promise<bank_ptr_t>>();
+
+    Entry.FileSize      = FileSize;
+    Entry.LastWriteTime = LastWriteTime;
+    Entry.Future        = Promise->get_future().share();
+    Entry.Bank          = nullptr;
+    Entry.WeakBank.reset();
+    Entry.Size          = 0;
+    Entry.LastUse       = ++_Clock;
+    Entry.LoadId        = ++_NextLoadId;
+
+    _Pool->Submit([this, Path, LoadId = Entry.LoadId, Promise]
+    {
+        bank_ptr_t Bank;
+
+        try
+        {
+            bank_t NewBank = ReadBank(Path);
+
+            if (_Options.ShareSamples)
+                NewBank.ShareSamples(sample_store_t::Instance());
+
+            Bank = std::make_shared<const bank_t>(std::move(NewBank));
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard Lock(_Mutex);
+
+                auto it = _Entries.find(Path);
+
+                if ((it != _Entries.end()) && (it->second.LoadId == LoadId))
+                    _Entries.erase(it);
+            }
+
+            Promise->set_exception(std::current_exception());
+
+            return;
+        }
+
+        std::vector<bank_ptr_t> Evicted;
+
+        Complete(Path, LoadId, Bank, Evicted);
+
+        Promise->set_value(std::move(Bank));
+
+        // The evicted banks are released here, outside the lock.
+    });
+
+    return Entry.Future;
+}
+
+/// <summary>
+/// Releases the banks that the loader keeps alive. Banks that are still in use stay available to later requests until they are released.
+/// </summary>
+void bank_loader_t::Clear()
+{
+    std::vector<bank_ptr_t> Evicted;
+
+    std::lock_guard Lock(_Mutex);
+
+    for (auto & [ Path, Entry ] : _Entries)
+    {
+        if (Entry.Bank != nullptr)
+            Evicted.push_back(std::move(Entry.Bank));
+    }
+
+    _MemoryUsage = 0;
+}
+
+/// <summary>
+/// Gets the number of bytes of the banks that the loader keeps alive.
+/// </summary>
+uint64_t bank_loader_t::GetMemoryUsage() const
+{
+    std::lock_guard Lock(_Mutex);
+
+    return _MemoryUsage;
+}
+
+/// <summary>
+/// Gets the number of banks that the loader keeps alive.
+/// </summary>
+size_t bank_loader_t::GetBankCount() const
+{
+    std::lock_guard Lock(_Mutex);
+
+    return (size_t) std::count_if(_Entries.begin(), _Entries.end(), [](const auto & item) { return item.second.Bank != nullptr; });
+}
+
+/// <summary>
+/// Reads a SoundFont, DLS or ECW bank. DLS and ECW banks are converted to a SoundFont bank.
+/// </summary>
+bank_t bank_loader_t::ReadBank(const std::filesystem::path & filePath)
+{
+    const auto Type = catalog_t::GetFileType(filePath);
+
+    if (Type == catalog_entry_t::FileType::Unknown)
+        throw sf::exception(msc::FormatText("Unknown bank format \"%s\"", (const char *) filePath.u8string().c_str()));
+
+    msc::file_stream_t fs;
+
+    if (!fs.Open(filePath))
+        throw sf::exception(msc::FormatText("Failed to open \"%s\"", (const char *) filePath.u8string().c_str()));
+
+    bank_t Bank;
+
+    switch (Type)
+    {
+        case catalog_entry_t::FileType::SoundFont:
+        {
+            sf::reader_t sr;
+
+            if (!sr.Open(&fs, riff::reader_t::option_t::None))
+                throw sf::exception(msc::FormatText("Failed to read \"%s\"", (const char *) filePath.u8string().c_str()));
+
+            sr.Process(Bank, soundfont_reader_options_t(true));
+            break;
+        }
+
+        case catalog_entry_t::FileType::DLS:
+        {
+            dls::collection_t Collection;
+
+            dls::reader_t dr;
+
+            if (!dr.Open(&fs, riff::reader_t::option_t::None))
+                throw sf::exception(msc::FormatText("Failed to read \"%s\"", (const char *) filePath.u8string().c_str()));
+
+            dr.Process(Collection, dls::reader_options_t(true));
+
+            Bank.ConvertFrom(Collection);
+            break;
+        }
+
+        case catalog_entry_t::FileType::ECW:
+        {
+            ecw::waveset_t Waveset;
+
+            ecw::reader_t er;
+
+            if (!er.Open(&fs))
+                throw sf::exception(msc::FormatText("Failed to read \"%s\"", (const char *) filePath.u8string().c_str()));
+
+            er.Process(Waveset);
+
+            Bank.ConvertFrom(Waveset);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    fs.Close();
+
+    return Bank;
+}
+
+/// <summary>
+/// Stores a loaded bank, unless the file has been replaced or cleared while it was loading, and evicts banks to stay within the memory budget.
+/// </summary>
+void bank_loader_t::Complete(const std::filesystem::path & filePath, uint64_t loadId, bank_ptr_t bank, std::vector<bank_ptr_t> & evicted)
+{
+    std::lock_guard Lock(_Mutex);
+
+    auto it = _Entries.find(filePath);
+
+    if ((it == _Entries.end()) || (it->second.LoadId != loadId))
+        return;
+
+    auto & Entry = it->second;
+
+    Entry.Future   = { };
+    Entry.Bank     = bank;
+    Entry.WeakBank = bank;
+    Entry.Size     = bank->GetMemorySize();
+    Entry.LastUse  = ++_Clock;
+
+    _MemoryUsage += Entry.Size;
+
+    Evict(&Entry, evicted);
+}
+
+/// <summary>
+/// Evicts the least recently used banks until the memory usage is within the budget, except the specified one. Entries of banks that are no longer in use are removed.
+/// </summary>
+void bank_loader_t::Evict(const entry_t * keep, std::vector<bank_ptr_t> & evicted)
+{
+    while (_MemoryUsage > _Options.MemoryBudget)
+    {
+        entry_t * Oldest = nullptr;
+
+        for (auto & [ Path, Entry ] : _Entries)
+        {
+            if ((&Entry != keep) && (Entry.Bank != nullptr) && ((Oldest == nullptr) || (Entry.LastUse < Oldest->LastUse)))
+                Oldest = &Entry;
+        }
+
+        if (Oldest == nullptr)
+            break;
+
+        _MemoryUsage -= Oldest->Size;
+
+        evicted.push_back(std::move(Oldest->Bank));
+    }
+
+    std::erase_if(_Entries, [](const auto & item)
+    {
+        const auto & Entry = item.second;
+
+        return !Entry.Future.valid() && (Entry.Bank == nullptr) && Entry.WeakBank.expired();
+    });
+}
+
+/// <summary>
+/// Returns a future that is ready with the specified bank.
+/// </summary>
+std::shared_future<bank_loader_t::bank_ptr_t> bank_loader_t::MakeReady(bank_ptr_t bank)
+{
+    std::promise<bank_ptr_t> Promise;
+
+    Promise.set_value(std::move(bank));
+
+    return Promise.get_future().share();
+}
@@ -0,0 +1,168 @@
+
+/** $VER: BankSnapshot.cpp (2026.10.18) P. Stuer - Immutable bank snapshots that can be replaced while they are in use **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "BankSnapshot.h"
+
+using namespace sf;
+
+/// <summary>
+/// Initializes a new instance with room for the specified number of reader slots.
+/// </summary>
+bank_publisher_t::bank_publisher_t(uint32_t maxReaders) : _SlotCount(std::max(maxReaders, 1u)), _Current(), _Epoch(1)
+{
+    _Slots = std::make_unique<slot_t[]>(_SlotCount);
+
+    for (uint32_t i = 0; i < _SlotCount; ++i)
+    {
+        _Slots[i].Epoch.store(Idle);
+        _Slots[i].IsRegistered.store(false);
+    }
+}
+
+/// <summary>
+/// Makes a snapshot the current one. The previous snapshot is retired and reclaimed when the readers that may use it have released it.
+/// </summary>
+void bank_publisher_t::Publish(std::shared_ptr<const bank_snapshot_t> snapshot)
+{
+    std::vector<retired_t> Reclaimed;
+
+    {
+        std::lock_guard Lock(_Mutex);
+
+        _Current.exchange(snapshot.get());
+
+        // Readers that acquire a snapshot from now on get the new one. The ones that acquired before may still use the old one.
+        const uint64_t Epoch = _Epoch.fetch_add(1) + 1;
+
+        if (_CurrentOwner != nullptr)
+            _Retired.push_back({ Epoch, std::move(_CurrentOwner) });
+
+        _CurrentOwner = std::move(snapshot);
+
+        ReclaimLocked(Reclaimed);
+    }
+
+    // The reclaimed snapshots are freed here, outside the lock.
+}
+
+/// <summary>
+/// Gets a reference to the current snapshot, for threads that may lock and allocate.
+/// </summary>
+std::shared_ptr<const bank_snapshot_t> bank_publisher_t::Get() const
+{
+    std::lock_guard Lock(_Mutex);
+
+    return _CurrentOwner;
+}
+
+/// <summary>
+/// Drops the retired snapshots that no reader can use anymore. Call it periodically from a thread that may free memory if snapshots are published rarely.
+/// Returns the number of snapshots that are still in use.
+/// </summary>
+size_t bank_publisher_t::Reclaim()
+{
+    std::vector<retired_t> Reclaimed;
+
+    std::lock_guard Lock(_Mutex);
+
+    ReclaimLocked(Reclaimed);
+
+    return _Retired.size();
+}
+
+/// <summary>
+/// Claims a reader slot. Throws if all slots are in use.
+/// </summary>
+uint32_t bank_publisher_t::RegisterReader()
+{
+    for (uint32_t i = 0; i < _SlotCount; ++i)
+    {
+        bool IsRegistered = false;
+
+        if (_Slots[i].IsRegistered.compare_exchange_strong(IsRegistered, true))
+            return i;
+    }
+
+    throw sf::exception(msc::FormatText("Maximum number of bank readers (%u) exceeded", _SlotCount));
+}
+
+/// <summary>
+/// Releases a reader slot. The slot must not hold a read lock.
+/// </summary>
+void bank_publisher_t::UnregisterReader(uint32_t reader) noexcept
+{
+    if (reader < _SlotCount)
+        _Slots[reader].IsRegistered.store(false);
+}
+
+/// <summary>
+/// Acquires the current snapshot for a reader. The snapshot stays valid until the read lock is released. The lock is empty if nothing has been published yet.
+/// </summary>
+bank_publisher_t::read_lock_t bank_publisher_t::Acquire(uint32_t reader) const noexcept
+{
+    auto & Slot = _Slots[reader].Epoch;
+
+    // Announce the epoch before loading the pointer: a writer that retires the snapshot after this point sees the slot and keeps the snapshot.
+    Slot.store(_Epoch.load());
+
+    return read_lock_t(&Slot, _Current.load());
+}
+
+/// <summary>
+/// Moves the retired snapshots that no reader can use anymore to the specified list. A snapshot retired in epoch E can only be used by a reader that announced an epoch before E.
+/// </summary>
+void bank_publisher_t::ReclaimLocked(std::vector<retired_t> & reclaimed)
+{
+    uint64_t OldestEpoch = UINT64_MAX;
+
+    for (uint32_t i = 0; i < _SlotCount; ++i)
+    {
+        const uint64_t Epoch = _Slots[i].Epoch.load();
+
+        if (Epoch != Idle)
+            OldestEpoch = std::min(OldestEpoch, Epoch);
+    }
+
+    const auto it = std::stable_partition(_Retired.begin(), _Retired.end(), [OldestEpoch](const retired_t & retired) { return retired.Epoch > OldestEpoch; });
+
+    std::move(it, _Retired.end(), std::back_inserter(reclaimed));
+
+    _Retired.erase(it, _Retired.end());
+}
+
+/// <summary>
+/// Releases the lock and takes over another one.
+/// </summary>
+bank_publisher_t::read_lock_t & bank_publisher_t::read_lock_t::operator=(read_lock_t && other) noexcept
+{
+    if (this != &other)
+    {
+        Release();
+
+        _Slot     = other._Slot;
+        _Snapshot = other._Snapshot;
+
+        other._Slot     = nullptr;
+        other._Snapshot = nullptr;
+    }
+
+    return *this;
+}
+
+/// <summary>
+/// Releases the lock. The snapshot must not be used anymore.
+/// </summary>
+void bank_publisher_t::read_lock_t::Release() noexcept
+{
+    if (_Slot != nullptr)
+    {
+        _Slot->store(Idle);
+
+        _Slot     = nullptr;
+        _Snapshot = nullptr;
+    }
+}
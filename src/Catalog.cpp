@@ -0,0 +1,470 @@
+
+/** $VER: Catalog.cpp (2026.10.18) P. Stuer - Persistent index of the banks in a directory tree **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "Catalog.h"
+#include "Hash.h"
+
+#include <fstream>
+#include <unordered_map>
+
+using namespace sf;
+
+namespace
+{
+
+/// <summary>
+/// Serializes the catalog into a compact little-endian byte stream.
+/// </summary>
+class catalog_writer_t
+{
+public:
+    template <typename T> void Write(T value)
+    {
+        const size_t Offset = Data.size();
+
+        Data.resize(Offset + sizeof(value));
+
+        ::memcpy(Data.data() + Offset, &value, sizeof(value));
+    }
+
+    void Write(const std::string & value)
+    {
+        const uint16_t Size = (uint16_t) std::min(value.size(), (size_t) 0xFFFF);
+
+        Write(Size);
+
+        Data.insert(Data.end(), value.begin(), value.begin() + Size);
+    }
+
+public:
+    std::vector<uint8_t> Data;
+};
+
+/// <summary>
+/// Deserializes the catalog. Returns false on any attempt to read past the end of the data.
+/// </summary>
+class catalog_reader_t
+{
+public:
+    catalog_reader_t(const std::vector<uint8_t> & data) noexcept : _Data(data), _Offset() { }
+
+    template <typename T> bool Read(T & value) noexcept
+    {
+        if (_Offset + sizeof(value) > _Data.size())
+            return false;
+
+        ::memcpy(&value, _Data.data() + _Offset, sizeof(value));
+        _Offset += sizeof(value);
+
+        return true;
+    }
+
+    bool Read(std::string & value)
+    {
+        uint16_t Size;
+
+        if (!Read(Size) || (_Offset + Size > _Data.size()))
+            return false;
+
+        value.assign((const char *) _Data.data() + _Offset, Size);
+        _Offset += Size;
+
+        return true;
+    }
+
+private:
+    const std::vector<uint8_t> & _Data;
+    size_t _Offset;
+};
+
+/// <summary>
+/// Converts a fixed-length name to a string without the trailing zeroes.
+/// </summary>
+std::string TrimName(const std::string & name)
+{
+    return std::string(name.c_str(), ::strnlen(name.c_str(), name.size()));
+}
+
+}
+
+/// <summary>
+/// Loads the catalog from the specified index file. Returns false if the file does not exist or is not a valid index.
+/// </summary>
+bool catalog_t::Load(const std::filesystem::path & filePath)
+{
+    _Entries.clear();
+    _IsModified = false;
+
+    std::ifstream Stream(filePath, std::ios::binary);
+
+    if (!Stream)
+        return false;
+
+    std::vector<uint8_t> Data((std::istreambuf_iterator<char>(Stream)), std::istreambuf_iterator<char>());
+
+    catalog_reader_t Reader(Data);
+
+    uint32_t FileMagic = 0, FileVersion = 0, EntryCount = 0;
+
+    if (!Reader.Read(FileMagic) || (FileMagic != Magic) || !Reader.Read(FileVersion) || (FileVersion != Version) || !Reader.Read(EntryCount))
+        return false;
+
+    // Don't trust the count before the data has been read. An entry takes at least 50 bytes.
+    _Entries.reserve(std::min(EntryCount, (uint32_t) (Data.size() / 50)));
+
+    for (uint32_t j = 0; j < EntryCount; ++j)
+    {
+        catalog_entry_t Entry;
+
+        uint8_t Type, IsValid;
+        uint32_t PresetCount;
+
+        if (!Reader.Read(Entry.Path) || !Reader.Read(Entry.FileSize) || !Reader.Read(Entry.LastWriteTime) || !Reader.Read(Entry.Hash) ||
+            !Reader.Read(Type) || !Reader.Read(IsValid) ||
+            !Reader.Read(Entry.InstrumentCount) || !Reader.Read(Entry.SampleCount) || !Reader.Read(Entry.SampleDataSize) ||
+            !Reader.Read(PresetCount))
+        {
+            _Entries.clear();
+
+            return false;
+        }
+
+        Entry.Type    = (catalog_entry_t::FileType) Type;
+        Entry.IsValid = (IsValid != 0);
+
+        // Don't trust the count before the data has been read.
+        Entry.Presets.reserve(std::min(PresetCount, (uint32_t) (Data.size() / 6)));
+
+        for (uint32_t i = 0; i < PresetCount; ++i)
+        {
+            catalog_preset_t Preset;
+
+            if (!Reader.Read(Preset.Name) || !Reader.Read(Preset.Bank) || !Reader.Read(Preset.Program))
+            {
+                _Entries.clear();
+
+                return false;
+            }
+
+            Entry.Presets.push_back(std::move(Preset));
+        }
+
+        _Entries.push_back(std::move(Entry));
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Saves the catalog to the specified index file. The file is replaced atomically.
+/// </summary>
+void catalog_t::Save(const std::filesystem::path & filePath) const
+{
+    catalog_writer_t Writer;
+
+    Writer.Data.reserve(64 + _Entries.size() * 256);
+
+    Writer.Write(Magic);
+    Writer.Write(Version);
+    Writer.Write((uint32_t) _Entries.size());
+
+    for (const auto & Entry : _Entries)
+    {
+        Writer.Write(Entry.Path);
+        Writer.Write(Entry.FileSize);
+        Writer.Write(Entry.LastWriteTime);
+        Writer.Write(Entry.Hash);
+        Writer.Write((uint8_t) Entry.Type);
+        Writer.Write((uint8_t) (Entry.IsValid ? 1 : 0));
+        Writer.Write(Entry.InstrumentCount);
+        Writer.Write(Entry.SampleCount);
+        Writer.Write(Entry.SampleDataSize);
+        Writer.Write((uint32_t) Entry.Presets.size());
+
+        for (const auto & Preset : Entry.Presets)
+        {
+            Writer.Write(Preset.Name);
+            Writer.Write(Preset.Bank);
+            Writer.Write(Preset.Program);
+        }
+    }
+
+    std::filesystem::path TempPath = filePath;
+
+    TempPath += ".tmp";
+
+    {
+        std::ofstream Stream(TempPath, std::ios::binary | std::ios::trunc);
+
+        if (!Stream)
+            throw sf::exception(msc::FormatText("Failed to create catalog \"%s\"", (const char *) TempPath.u8string().c_str()));
+
+        Stream.write((const char *) Writer.Data.data(), (std::streamsize) Writer.Data.size());
+
+        if (!Stream)
+            throw sf::exception(msc::FormatText("Failed to write catalog \"%s\"", (const char *) TempPath.u8string().c_str()));
+    }
+
+    std::filesystem::rename(TempPath, filePath);
+}
+
+/// <summary>
+/// Updates the catalog with the banks in the specified directory tree. Only files whose size or last write time changed are parsed. Returns the number of parsed files.
+/// </summary>
+size_t catalog_t::Update(const std::filesystem::path & directoryPath, const catalog_options_t & options)
+{
+    std::unordered_map<std::string, size_t> Index;
+
+    Index.reserve(_Entries.size());
+
+    for (size_t i = 0; i < _Entries.size(); ++i)
+        Index.emplace(_Entries[i].Path, i);
+
+    std::vector<catalog_entry_t> Entries;
+
+    Entries.reserve(_Entries.size());
+
+    size_t ParsedCount = 0;
+
+    // The directory iterator caches the file size and last write time so unchanged files don't cost more than the directory enumeration itself.
+    for (const auto & Item : std::filesystem::recursive_directory_iterator(directoryPath, std::filesystem::directory_options::skip_permission_denied))
+    {
+        if (!Item.is_regular_file())
+            continue;
+
+        const auto Type = GetFileType(Item.path());
+
+        if (Type == catalog_entry_t::FileType::Unknown)
+            continue;
+
+        const std::string Path = (const char *) Item.path().lexically_relative(directoryPath).generic_u8string().c_str();
+
+        const uint64_t FileSize     = Item.file_size();
+        const int64_t LastWriteTime = (int64_t) Item.last_write_time().time_since_epoch().count();
+
+        auto it = Index.find(Path);
+
+        if (it != Index.end())
+        {
+            auto & Entry = _Entries[it->second];
+
+            if ((Entry.FileSize == FileSize) && (Entry.LastWriteTime == LastWriteTime))
+            {
+                Entries.push_back(std::move(Entry));
+                continue;
+            }
+        }
+
+        catalog_entry_t Entry;
+
+        Entry.Path          = Path;
+        Entry.FileSize      = FileSize;
+        Entry.LastWriteTime = LastWriteTime;
+        Entry.Type          = Type;
+
+        try
+        {
+            Examine(Item.path(), Entry);
+
+            Entry.IsValid = true;
+        }
+        catch (const std::exception &)
+        {
+            // Keep the entry so the file is not parsed again until it changes.
+            Entry.IsValid = false;
+        }
+
+        if (options.HashContent)
+            Entry.Hash = HashFile(Item.path());
+
+        Entries.push_back(std::move(Entry));
+
+        ++ParsedCount;
+    }
+
+    std::sort(Entries.begin(), Entries.end(), [](const catalog_entry_t & a, const catalog_entry_t & b) { return a.Path < b.Path; });
+
+    _IsModified = _IsModified || (ParsedCount != 0) || (Entries.size() != _Entries.size());
+
+    _Entries = std::move(Entries);
+
+    return ParsedCount;
+}
+
+/// <summary>
+/// Finds the entry with the specified relative path.
+/// </summary>
+const catalog_entry_t * catalog_t::Find(const std::string & path) const noexcept
+{
+    auto it = std::lower_bound(_Entries.begin(), _Entries.end(), path, [](const catalog_entry_t & entry, const std::string & path) { return entry.Path < path; });
+
+    return ((it != _Entries.end()) && (it->Path == path)) ? &*it : nullptr;
+}
+
+/// <summary>
+/// Gets the type of bank file based on the file extension.
+/// </summary>
+catalog_entry_t::FileType catalog_t::GetFileType(const std::filesystem::path & filePath) noexcept
+{
+    std::string Extension = filePath.extension().string();
+
+    std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](char c) { return (char) std::tolower((unsigned char) c); });
+
+    if ((Extension == ".sbk") || (Extension == ".sf2") || (Extension == ".sf3") || (Extension == ".sf4") || (Extension == ".arl"))
+        return catalog_entry_t::FileType::SoundFont;
+
+    if ((Extension == ".dls") || (Extension == ".dlp"))
+        return catalog_entry_t::FileType::DLS;
+
+    if (Extension == ".ecw")
+        return catalog_entry_t::FileType::ECW;
+
+    return catalog_entry_t::FileType::Unknown;
+}
+
+/// <summary>
+/// Parses a bank file and collects its metadata. Sample data is not read unless the format requires it.
+/// </summary>
+void catalog_t::Examine(const std::filesystem::path & filePath, catalog_entry_t & entry)
+{
+    msc::file_stream_t fs;
+
+    if (!fs.Open(filePath))
+        throw sf::exception(msc::FormatText("Failed to open \"%s\"", (const char *) filePath.u8string().c_str()));
+
+    switch (entry.Type)
+    {
+        case catalog_entry_t::FileType::SoundFont:
+        {
+            bank_t Bank;
+
+            sf::reader_t sr;
+
+            if (!sr.Open(&fs, riff::reader_t::option_t::None))
+                throw sf::exception(msc::FormatText("Failed to read \"%s\"", (const char *) filePath.u8string().c_str()));
+
+            sr.Process(Bank, soundfont_reader_options_t(false));
+
+            // Skip the EOP, EOI and EOS terminators.
+            if (!Bank.Presets.empty())
+            {
+                entry.Presets.reserve(Bank.Presets.size() - 1);
+
+                for (auto Preset = Bank.Presets.begin(); Preset < Bank.Presets.end() - 1; ++Preset)
+                    entry.Presets.push_back({ TrimName(Preset->Name), Preset->MIDIBank, Preset->MIDIProgram });
+            }
+
+            entry.InstrumentCount = !Bank.Instruments.empty() ? (uint32_t) Bank.Instruments.size() - 1 : 0;
+            entry.SampleCount     = !Bank.Samples.empty()     ? (uint32_t) Bank.Samples.size()     - 1 : 0;
+
+            // Each sample point has a 16-bit word in the smpl chunk and, if the bank has an sm24 chunk, a least significant byte.
+            const uint64_t PointSize = sizeof(int16_t) + ((sr.SampleDataLSBSize() != 0) ? 1 : 0);
+
+            for (size_t i = 0; i < entry.SampleCount; ++i)
+            {
+                const auto & Sample = Bank.Samples[i];
+
+                if (Sample.End > Sample.Start)
+                    entry.SampleDataSize += (uint64_t) (Sample.End - Sample.Start) * PointSize;
+            }
+            break;
+        }
+
+        case catalog_entry_t::FileType::DLS:
+        {
+            dls::collection_t Collection;
+
+            dls::reader_t dr;
+
+            if (!dr.Open(&fs, riff::reader_t::option_t::None))
+                throw sf::exception(msc::FormatText("Failed to read \"%s\"", (const char *) filePath.u8string().c_str()));
+
+            dr.Process(Collection, dls::reader_options_t(false));
+
+            entry.Presets.reserve(Collection.Instruments.size());
+
+            for (const auto & Instrument : Collection.Instruments)
+            {
+                // Same bank mapping as the DLS to SF2 conversion.
+                const uint16_t Bank = !Instrument.IsPercussion ? ((Instrument.BankMSB != 0) ? Instrument.BankMSB : Instrument.BankLSB) : 128;
+
+                entry.Presets.push_back({ Instrument.Name, Bank, Instrument.Program });
+            }
+
+            entry.InstrumentCount = (uint32_t) Collection.Instruments.size();
+            entry.SampleCount     = (uint32_t) Collection.Waves.size();
+
+            for (const auto & Wave : Collection.Waves)
+                entry.SampleDataSize += Wave.DataSize;
+            break;
+        }
+
+        case catalog_entry_t::FileType::ECW:
+        {
+            ecw::waveset_t ws;
+
+            // Map the waveset instead of reading it. Its waveform area is never touched.
+            ecw::mapped_reader_t er;
+
+            er.Open(filePath);
+            er.Process(ws);
+
+            // ECW instruments have no names. Record the melodic programs of the first MIDI bank.
+            if (!ws.BankMaps.empty() && !ws.MIDIPatchMaps.empty())
+            {
+                const uint16_t MapIndex = ws.BankMaps[0].MIDIPatchMaps[0];
+
+                if (MapIndex < ws.MIDIPatchMaps.size())
+                {
+                    entry.Presets.reserve(128);
+
+                    for (uint16_t Program = 0; Program < 128; ++Program)
+                        entry.Presets.push_back({ msc::FormatText("Instrument %d", ws.MIDIPatchMaps[MapIndex].Instruments[Program]), 0, Program });
+                }
+            }
+
+            entry.InstrumentCount = (uint32_t) ws.Instruments.size();
+            entry.SampleCount     = (uint32_t) ws.Samples.size();
+            entry.SampleDataSize  = er.SampleData().size();
+            break;
+        }
+
+        default:
+            throw sf::exception("Unsupported file type");
+    }
+
+    fs.Close();
+}
+
+/// <summary>
+/// Calculates the content hash of a file.
+/// </summary>
+uint64_t catalog_t::HashFile(const std::filesystem::path & filePath)
+{
+    std::ifstream Stream(filePath, std::ios::binary);
+
+    if (!Stream)
+        return 0;
+
+    hash_t Hash;
+
+    std::vector<char> Buffer(1024 * 1024);
+
+    while (Stream)
+    {
+        Stream.read(Buffer.data(), (std::streamsize) Buffer.size());
+
+        const auto Size = Stream.gcount();
+
+        if (Size <= 0)
+            break;
+
+        Hash.Update(Buffer.data(), (size_t) Size);
+    }
+
+    return Hash.Digest();
+}
@@ -1,14 +1,16 @@
 
-/** $VER: DLSReader.cpp (2025.09.07) P. Stuer - Implements a reader for a DLS-compliant collection. **/
+/** $VER: DLSReader.cpp (2026.10.18) P. Stuer - Implements a reader for a DLS-compliant collection. **/
 
 #include "pch.h"
 
+#ifdef _MSC_VER
 #include <CppCoreCheck/Warnings.h>
 
 #pragma warning(disable: 4100 4505 4625 4626 4710 4711 4738 5045 ALL_CPPCORECHECK_WARNINGS)
+#endif
 
-#define __TRACE
-#define __DEEP_TRACE
+//#define __TRACE
+//#define __DEEP_TRACE
 
 #include "DLSReader.h"
 #include "Exception.h"
@@ -54,6 +56,8 @@ static std::string trim(const std::string & s)
 /// </summary>
 void reader_t::Process(collection_t & dls, const reader_options_t & options)
 {
+    METRICS_SCOPE("sf::dls::reader_t::Process");
+
     _Options = options;
 
     TRACE_RESET();
@@ -71,6 +75,8 @@ void reader_t::Process(collection_t & dls, const reader_options_t & options)
 
     std::function<bool(const riff::chunk_header_t & ch)> ChunkHandler = [this, &options, &dls, &ChunkHandler](const riff::chunk_header_t & ch) -> bool
     {
+        METRICS_CHUNK(ch);
+
         switch (ch.Id)
         {
             // The Collection Header chunk defines an instrument collection.
@@ -124,19 +130,15 @@ void reader_t::Process(collection_t & dls, const reader_options_t & options)
                 TRACE_CHUNK(ch.Id, ch.Size);
                 TRACE_INDENT();
 
-                GUID Id = {};
+                guid_t Id = {};
 
                 Read(&Id.Data1, sizeof(Id.Data1));
                 Read(&Id.Data2, sizeof(Id.Data2));
                 Read(&Id.Data3, sizeof(Id.Data3));
                 Read(&Id.Data4, sizeof(Id.Data4));
 
-                WCHAR Text[32] = {};
-
-                (void) ::StringFromGUID2(Id, Text, _countof(Text));
-
                 #ifdef __DEEP_TRACE
-                ::printf("%*sId: %s\n", __TRACE_LEVEL * 4, "", msc::WideToUTF8(Text).c_str());
+                ::printf("%*sId: %s\n", __TRACE_LEVEL * 4, "", platform::ToString(Id).c_str());
                 #endif
 
                 TRACE_UNINDENT();
@@ -257,6 +259,8 @@ void reader_t::ReadInstruments(const riff::chunk_header_t & ch, std::vector<inst
 {
     std::function<bool(const riff::chunk_header_t & ch)> ChunkHandler = [this, &instruments, &ChunkHandler](const riff::chunk_header_t & ch) -> bool
     {
+        METRICS_CHUNK(ch);
+
         switch (ch.Id)
         {
             // A LIST chunk contains an ordered sequence of subchunks.
@@ -317,6 +321,8 @@ void reader_t::ReadInstrument(const riff::chunk_header_t & ch, instrument_t & in
 {
     std::function<bool(const riff::chunk_header_t & ch)> ChunkHandler = [this, &instrument, &ChunkHandler](const riff::chunk_header_t & ch) -> bool
     {
+        METRICS_CHUNK(ch);
+
         switch (ch.Id)
         {
             // The Instrument Header chunk defines an instrument within a collection.
@@ -412,6 +418,8 @@ void reader_t::ReadRegions(const riff::chunk_header_t & ch, std::vector<region_t
 {
     std::function<bool(const riff::chunk_header_t & ch)> ChunkHandler = [this, &regions, &ChunkHandler](const riff::chunk_header_t & ch) -> bool
     {
+        METRICS_CHUNK(ch);
+
         switch (ch.Id)
         {
             // A LIST chunk contains an ordered sequence of subchunks.
@@ -473,6 +481,8 @@ void reader_t::ReadRegion(const riff::chunk_header_t & ch, region_t & region)
 {
     std::function<bool(const riff::chunk_header_t & ch)> ChunkHandler = [this, &region, &ChunkHandler](const riff::chunk_header_t & ch) -> bool
     {
+        METRICS_CHUNK(ch);
+
         switch (ch.Id)
         {
             // A LIST chunk contains an ordered sequence of subchunks.
@@ -583,6 +593,8 @@ void reader_t::ReadArticulators(const riff::chunk_header_t & ch, std::vector<art
 {
     std::function<bool(const riff::chunk_header_t & ch)> ChunkHandler = [this, &articulators, &ChunkHandler](const riff::chunk_header_t & ch) -> bool
     {
+        METRICS_CHUNK(ch);
+
         switch (ch.Id)
         {
             // A LIST chunk contains an ordered sequence of subchunks.
@@ -733,6 +745,8 @@ void reader_t::ReadWaves(const riff::chunk_header_t & ch, std::vector<wave_t> &
 {
     std::function<bool(const riff::chunk_header_t & ch)> ChunkHandler = [this, &waves, &ChunkHandler](const riff::chunk_header_t & ch) -> bool
     {
+        METRICS_CHUNK(ch);
+
         switch (ch.Id)
         {
             // A LIST chunk contains an ordered sequence of subchunks.
@@ -793,6 +807,8 @@ void reader_t::ReadWave(const riff::chunk_header_t & ch, wave_t & wave)
 {
     std::function<bool(const riff::chunk_header_t & ch)> ChunkHandler = [this, &wave, &ChunkHandler](const riff::chunk_header_t & ch) -> bool
     {
+        METRICS_CHUNK(ch);
+
         switch (ch.Id)
         {
             // The Wave Format chunk specifies the format of the wave data.
@@ -849,6 +865,8 @@ void reader_t::ReadWave(const riff::chunk_header_t & ch, wave_t & wave)
                 TRACE_CHUNK(ch.Id, ch.Size);
                 TRACE_INDENT();
                 {
+                    wave.DataSize = ch.Size;
+
                     if (_Options.ReadSampleData)
                     {
                         wave.Data.resize(ch.Size);
@@ -0,0 +1,571 @@
+
+/** $VER: ECWConverter.cpp (2026.10.18) P. Stuer - Converts an ECW waveset to a SoundFont bank **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "SF2.h"
+
+using namespace sf;
+
+namespace
+{
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Converts the instruments and maps of a waveset. Each ECW instrument becomes the SF2 instrument with the same index.
+/// </summary>
+class ecw_converter_t
+{
+public:
+    ecw_converter_t(const ecw::waveset_t & waveset, bank_t & bank) : _Waveset(waveset), _Bank(bank) { }
+
+    void ConvertSamples(const ecw_conversion_options_t & options);
+    void ConvertInstruments();
+    void ConvertPresets();
+
+private:
+    void IndexSampleSets();
+
+    size_t CountZones(size_t instrumentIndex, int depth) const noexcept;
+    void AddZones(size_t instrumentIndex, uint8_t lowKey, uint8_t highKey, int depth);
+    void AddZones(const ecw::instrument_v1_t::sub_header_v1_t & subHeader, uint8_t lowKey, uint8_t highKey);
+
+    std::string GetInstrumentName(size_t instrumentIndex) const;
+    uint16_t GetSampleSet(uint16_t patchIndex) const noexcept;
+
+    void AddPreset(const std::string & name, uint16_t program, uint16_t bank);
+
+    static ecw::instrument_v1_t AsV1(const ecw::instrument_t & instrument) noexcept;
+    static ecw::instrument_v2_t AsV2(const ecw::instrument_t & instrument) noexcept;
+
+private:
+    const ecw::waveset_t & _Waveset;
+    bank_t & _Bank;
+
+    std::vector<uint32_t> _FirstSample;     // Index of the first sample header of each sample set
+    std::vector<uint32_t> _SampleCount;     // Number of sample headers of each sample set
+
+    static const int MaxDepth = 8;          // Maximum nesting of split instruments (type 255)
+    static const uint32_t TerminatorPoints = 46; // Zero data points after each sample (SoundFont 2.04 Technical Specification, 6.1 Sample Data Format in the smpl Sub-chunk)
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+constexpr uint8_t InstrumentTypeV1 = 2;
+constexpr uint8_t InstrumentTypeV2 = 255;
+}
+
+/// <summary>
+/// Initializes a SoundFont bank from an ECW waveset.
+/// </summary>
+void bank_t::ConvertFrom(const ecw::waveset_t & waveset, const ecw_conversion_options_t & options)
+{
+    METRICS_SCOPE("sf::bank_t::ConvertFrom");
+
+    Major       = 2;
+    Minor       = 4;
+    SoundEngine = "E-mu 10K1";
+    Name        = waveset.Name.c_str();
+
+    Properties.push_back(sf::property_t(FOURCC_ICRD, platform::GetLocalDateTime()));
+
+    if (!waveset.Information.empty())
+        Properties.push_back(sf::property_t(FOURCC_ICMT, waveset.Information.c_str()));
+
+    if (!waveset.Copyright.empty())
+        Properties.push_back(sf::property_t(FOURCC_ICOP, waveset.Copyright.c_str()));
+
+    if (!waveset.Description.empty())
+        Properties.push_back(sf::property_t(FOURCC_ISBJ, waveset.Description.c_str()));
+
+    ecw_converter_t Converter(waveset, *this);
+
+    Converter.ConvertSamples(options);
+    Converter.ConvertInstruments();
+    Converter.ConvertPresets();
+}
+
+/// <summary>
+/// Converts the sample headers. Each ECW sample header becomes the SF2 sample with the same index.
+/// The sample pool is built sample by sample: the waveform of each sample followed by the 46 zero data points the SoundFont specification requires.
+/// </summary>
+void ecw_converter_t::ConvertSamples(const ecw_conversion_options_t & options)
+{
+    METRICS_SCOPE("sf::bank_t::ConvertECWSamples");
+
+    const auto SampleData = !options.SampleData.empty() ? options.SampleData : std::span<const uint8_t>(_Waveset.SampleData);
+
+    const uint32_t SampleCount = (uint32_t) (SampleData.size() / sizeof(int16_t));
+
+    // Presize the sample pool.
+    {
+        size_t PointCount = 0;
+
+        for (const auto & Sample : _Waveset.Samples)
+        {
+            const uint32_t Start = std::min(Sample.SampleStart / (uint32_t) sizeof(int16_t), SampleCount);
+            const uint32_t End   = std::clamp(Sample.LoopEnd   / (uint32_t) sizeof(int16_t), Start, SampleCount);
+
+            PointCount += (size_t) (End - Start) + TerminatorPoints;
+        }
+
+        if (PointCount > UINT32_MAX)
+            throw sf::exception(msc::FormatText("Maximum size of the sample pool exceeded (%zu sample points)", PointCount));
+
+        _Bank.SampleData.assign(PointCount * sizeof(int16_t), 0);
+    }
+
+    _Bank.Samples.reserve(_Waveset.Samples.size() + 1);
+
+    uint32_t Offset = 0; // in sample points
+
+    for (const auto & Sample : _Waveset.Samples)
+    {
+        // The tuning of a sample is relative to MIDI key 127, in semitones and 1/256 semitones.
+        const int32_t Cents    = (Sample.CoarseTune * 100) + ((Sample.FineTune * 100) / 256);
+        const int32_t Semitone = (Cents >= 0) ? (Cents / 100) : -((-Cents + 99) / 100);
+
+        const uint32_t Start     = std::min(Sample.SampleStart / (uint32_t) sizeof(int16_t), SampleCount);
+        const uint32_t End       = std::clamp(Sample.LoopEnd   / (uint32_t) sizeof(int16_t), Start, SampleCount);
+        const uint32_t LoopStart = std::clamp(Sample.LoopStart / (uint32_t) sizeof(int16_t), Start, End);
+
+        ::memcpy(_Bank.SampleData.data() + ((size_t) Offset * sizeof(int16_t)), SampleData.data() + ((size_t) Start * sizeof(int16_t)), (size_t) (End - Start) * sizeof(int16_t));
+
+        _Bank.Samples.push_back(sf::sample_t
+        (
+            Sample.Name.c_str(),
+            Offset,
+            Offset + (End - Start),
+            Offset + (LoopStart - Start),
+            Offset + (End - Start),
+            options.SampleRate,
+            (uint8_t) std::clamp(127 + Semitone, 0, 127),
+            (int8_t) -(Cents - (Semitone * 100)),
+            0,
+            sf::SampleTypes::MonoSample
+        ));
+
+        Offset += (End - Start) + TerminatorPoints;
+    }
+
+    _Bank.Samples.push_back(sf::sample_t("EOS"));
+}
+
+/// <summary>
+/// Converts the instruments. Instruments of type 2 become zones that play the sample sets of their patches, instruments of type 255 borrow the zones of other instruments for each of their key ranges.
+/// </summary>
+void ecw_converter_t::ConvertInstruments()
+{
+    METRICS_SCOPE("sf::bank_t::ConvertECWInstruments");
+
+    IndexSampleSets();
+
+    // Presize the hydra. Each zone has at most 9 generators.
+    {
+        size_t ZoneCount = 0;
+
+        for (size_t i = 0; i < _Waveset.Instruments.size(); ++i)
+            ZoneCount += CountZones(i, 0);
+
+        if (ZoneCount >= 65536)
+            throw sf::exception(msc::FormatText("Maximum number of instrument zones exceeded (%zu zones)", ZoneCount));
+
+        _Bank.Instruments.reserve(_Waveset.Instruments.size() + 1);
+        _Bank.InstrumentZones.reserve(ZoneCount + 1);
+        _Bank.InstrumentGenerators.reserve((ZoneCount * 9) + 1);
+    }
+
+    for (size_t i = 0; i < _Waveset.Instruments.size(); ++i)
+    {
+        _Bank.Instruments.push_back(sf::instrument_t(GetInstrumentName(i), (uint16_t) _Bank.InstrumentZones.size()));
+
+        AddZones(i, 0, 127, 0);
+    }
+
+    if (_Bank.InstrumentGenerators.size() >= 65536)
+        throw sf::exception(msc::FormatText("Maximum number of instrument generators exceeded (%zu generators)", _Bank.InstrumentGenerators.size()));
+
+    // Add the instrument list terminator.
+    _Bank.Instruments.push_back(sf::instrument_t("EOI", (uint16_t) _Bank.InstrumentZones.size()));
+    _Bank.InstrumentZones.push_back(instrument_zone_t((uint16_t) _Bank.InstrumentGenerators.size(), (uint16_t) _Bank.InstrumentModulators.size()));
+
+    _Bank.InstrumentGenerators.push_back(sf::generator_t());
+    _Bank.InstrumentModulators.push_back(sf::modulator_t());
+}
+
+/// <summary>
+/// Converts the MIDI patch maps of the melodic banks and the drum note maps of the drum kits to presets. Bank 0 and drum kit 0 are converted completely.
+/// The other banks and drum kits only contribute the programs that differ from bank 0 or drum kit 0.
+/// </summary>
+void ecw_converter_t::ConvertPresets()
+{
+    METRICS_SCOPE("sf::bank_t::ConvertECWPresets");
+
+    const size_t InstrumentCount = _Waveset.Instruments.size();
+
+    _Bank.Presets.reserve(256);
+    _Bank.PresetZones.reserve(256 * 2);
+    _Bank.PresetGenerators.reserve(256 * 2);
+
+    // Melodic banks
+    if (!_Waveset.BankMaps.empty())
+    {
+        const auto & BankMap = _Waveset.BankMaps[0];
+
+        const uint16_t DefaultMap = BankMap.MIDIPatchMaps[0];
+
+        for (uint16_t Bank = 0; Bank < 128; ++Bank)
+        {
+            const uint16_t MapIndex = BankMap.MIDIPatchMaps[Bank];
+
+            if (MapIndex >= _Waveset.MIDIPatchMaps.size())
+                continue;
+
+            if ((Bank != 0) && (MapIndex == DefaultMap))
+                continue;
+
+            const auto & PatchMap = _Waveset.MIDIPatchMaps[MapIndex];
+
+            for (uint16_t Program = 0; Program < 128; ++Program)
+            {
+                const uint16_t Instrument = PatchMap.Instruments[Program];
+
+                if (Instrument >= InstrumentCount)
+                    continue;
+
+                if ((Bank != 0) && (DefaultMap < _Waveset.MIDIPatchMaps.size()) && (_Waveset.MIDIPatchMaps[DefaultMap].Instruments[Program] == Instrument))
+                    continue;
+
+                AddPreset(_Bank.Instruments[Instrument].Name, Program, Bank);
+
+                _Bank.PresetZones.push_back(sf::preset_zone_t((uint16_t) _Bank.PresetGenerators.size(), (uint16_t) _Bank.PresetModulators.size()));
+                _Bank.PresetGenerators.push_back(sf::generator_t(GeneratorOperator::instrument, Instrument));
+            }
+        }
+    }
+
+    // Drum kits. Consecutive notes that use the same instrument share a zone.
+    if (!_Waveset.DrumKitMaps.empty())
+    {
+        const auto & DrumKitMap = _Waveset.DrumKitMaps[0];
+
+        const uint16_t DefaultMap = DrumKitMap.DrumNoteMaps[0];
+
+        for (uint16_t Kit = 0; Kit < 128; ++Kit)
+        {
+            const uint16_t MapIndex = DrumKitMap.DrumNoteMaps[Kit];
+
+            if (MapIndex >= _Waveset.DrumNoteMaps.size())
+                continue;
+
+            if ((Kit != 0) && (MapIndex == DefaultMap))
+                continue;
+
+            const auto & NoteMap = _Waveset.DrumNoteMaps[MapIndex];
+
+            AddPreset(msc::FormatText("Drum Kit %d", Kit), Kit, 128);
+
+            for (uint16_t Note = 0; Note < 128;)
+            {
+                const uint16_t Instrument = NoteMap.Instruments[Note];
+
+                uint16_t LastNote = Note;
+
+                while ((LastNote < 127) && (NoteMap.Instruments[LastNote + 1] == Instrument))
+                    ++LastNote;
+
+                if (Instrument < InstrumentCount)
+                {
+                    _Bank.PresetZones.push_back(sf::preset_zone_t((uint16_t) _Bank.PresetGenerators.size(), (uint16_t) _Bank.PresetModulators.size()));
+
+                    _Bank.PresetGenerators.push_back(sf::generator_t(GeneratorOperator::keyRange, MAKEWORD(Note, LastNote)));       // Must be the first generator.
+                    _Bank.PresetGenerators.push_back(sf::generator_t(GeneratorOperator::instrument, Instrument));                    // Must be the last generator.
+                }
+
+                Note = LastNote + 1;
+            }
+        }
+    }
+
+    if ((_Bank.PresetZones.size() >= 65536) || (_Bank.PresetGenerators.size() >= 65536))
+        throw sf::exception(msc::FormatText("Maximum number of preset zones or generators exceeded (%zu zones, %zu generators)", _Bank.PresetZones.size(), _Bank.PresetGenerators.size()));
+
+    // Add the preset list terminator.
+    _Bank.Presets.push_back(sf::preset_t("EOP", 0, 0,  (uint16_t) _Bank.PresetZones.size()));
+    _Bank.PresetZones.push_back(sf::preset_zone_t((uint16_t) _Bank.PresetGenerators.size(), (uint16_t) _Bank.PresetModulators.size()));
+
+    _Bank.PresetGenerators.push_back(sf::generator_t());
+    _Bank.PresetModulators.push_back(sf::modulator_t());
+}
+
+/// <summary>
+/// Determines the first sample header and the number of sample headers of each sample set. Array 3 holds the first sample header of the sample set of the corresponding entry in array 2.
+/// A sample set ends with the sample that covers MIDI key 127.
+/// </summary>
+void ecw_converter_t::IndexSampleSets()
+{
+    const size_t SampleSetCount = _Waveset.SampleSets.size();
+
+    _FirstSample.assign(SampleSetCount, ~0u);
+    _SampleCount.assign(SampleSetCount, 0);
+
+    const size_t Count = std::min(_Waveset.Array2.size(), _Waveset.Array3.size());
+
+    for (size_t i = 0; i < Count; ++i)
+    {
+        const uint16_t SampleSet = _Waveset.Array2[i].SampleSet;
+        const uint16_t First     = _Waveset.Array3[i].Index;
+
+        if ((SampleSet >= SampleSetCount) || (_FirstSample[SampleSet] != ~0u) || (First >= _Waveset.Samples.size()))
+            continue;
+
+        uint32_t j = First;
+
+        while ((j < _Waveset.Samples.size()) && (_Waveset.Samples[j].HighKey < 127))
+            ++j;
+
+        _FirstSample[SampleSet] = First;
+        _SampleCount[SampleSet] = (uint32_t) std::min(j + 1, (uint32_t) _Waveset.Samples.size()) - First;
+    }
+}
+
+/// <summary>
+/// Gets an upper bound of the number of zones of an instrument.
+/// </summary>
+size_t ecw_converter_t::CountZones(size_t instrumentIndex, int depth) const noexcept
+{
+    if ((instrumentIndex >= _Waveset.Instruments.size()) || (depth > MaxDepth))
+        return 0;
+
+    const auto & Instrument = _Waveset.Instruments[instrumentIndex];
+
+    size_t Count = 0;
+
+    if (Instrument.Type == InstrumentTypeV1)
+    {
+        const auto v1 = AsV1(Instrument);
+
+        for (const auto & SubHeader : v1.SubHeaders)
+        {
+            const uint16_t SampleSet = GetSampleSet(SubHeader.PatchIndex);
+
+            if (SampleSet < _SampleCount.size())
+                Count += _SampleCount[SampleSet];
+        }
+    }
+    else
+    if (Instrument.Type == InstrumentTypeV2)
+    {
+        const auto v2 = AsV2(Instrument);
+
+        for (const auto & SubHeader : v2.SubHeaders)
+        {
+            Count += CountZones(SubHeader.InstrumentIndex, depth + 1);
+
+            if (SubHeader.NoteThreshold >= 127)
+                break;
+        }
+    }
+
+    return Count;
+}
+
+/// <summary>
+/// Adds the zones of an instrument that play in the specified key range.
+/// </summary>
+void ecw_converter_t::AddZones(size_t instrumentIndex, uint8_t lowKey, uint8_t highKey, int depth)
+{
+    if ((instrumentIndex >= _Waveset.Instruments.size()) || (depth > MaxDepth))
+        return;
+
+    const auto & Instrument = _Waveset.Instruments[instrumentIndex];
+
+    if (Instrument.Type == InstrumentTypeV1)
+    {
+        const auto v1 = AsV1(Instrument);
+
+        switch (v1.SubType)
+        {
+            case 0: // Use only the first sub-header.
+                AddZones(v1.SubHeaders[0], lowKey, highKey);
+                break;
+
+            case 1: // Use both sub-headers simultaneously.
+                AddZones(v1.SubHeaders[0], lowKey, highKey);
+                AddZones(v1.SubHeaders[1], lowKey, highKey);
+                break;
+
+            case 2: // The first sub-header plays up to and including the threshold note, the second one above it.
+            {
+                const uint8_t Threshold = std::min(v1.NoteThreshold, (uint8_t) 127);
+
+                if (lowKey <= Threshold)
+                    AddZones(v1.SubHeaders[0], lowKey, std::min(highKey, Threshold));
+
+                if ((Threshold < 127) && (highKey > Threshold))
+                    AddZones(v1.SubHeaders[1], std::max(lowKey, (uint8_t) (Threshold + 1)), highKey);
+                break;
+            }
+
+            case 3: // Use only the second sub-header.
+                AddZones(v1.SubHeaders[1], lowKey, highKey);
+                break;
+        }
+    }
+    else
+    if (Instrument.Type == InstrumentTypeV2)
+    {
+        const auto v2 = AsV2(Instrument);
+
+        uint8_t LowKey = 0;
+
+        for (const auto & SubHeader : v2.SubHeaders)
+        {
+            const uint8_t HighKey = std::min(SubHeader.NoteThreshold, (uint8_t) 127);
+
+            if (HighKey < LowKey)
+                continue;
+
+            const uint8_t Low  = std::max(LowKey, lowKey);
+            const uint8_t High = std::min(HighKey, highKey);
+
+            if (Low <= High)
+                AddZones(SubHeader.InstrumentIndex, Low, High, depth + 1);
+
+            if (HighKey == 127)
+                break;
+
+            LowKey = HighKey + 1;
+        }
+    }
+}
+
+/// <summary>
+/// Adds a zone for each sample of the sample set of a patch that plays in the specified key range.
+/// </summary>
+void ecw_converter_t::AddZones(const ecw::instrument_v1_t::sub_header_v1_t & subHeader, uint8_t lowKey, uint8_t highKey)
+{
+    const uint16_t SampleSet = GetSampleSet(subHeader.PatchIndex);
+
+    if ((SampleSet >= _FirstSample.size()) || (_FirstSample[SampleSet] == ~0u))
+        return;
+
+    const auto & Patch = _Waveset.Patches[subHeader.PatchIndex];
+
+    const uint32_t First = _FirstSample[SampleSet];
+    const uint32_t Last  = First + _SampleCount[SampleSet];
+
+    uint8_t SampleLowKey = 0;
+
+    for (uint32_t i = First; i < Last; ++i)
+    {
+        const auto & Sample = _Waveset.Samples[i];
+
+        const uint8_t SampleHighKey = std::min(Sample.HighKey, (uint8_t) 127);
+
+        const uint8_t Low  = std::max(SampleLowKey, lowKey);
+        const uint8_t High = std::min(SampleHighKey, highKey);
+
+        SampleLowKey = SampleHighKey + 1;
+
+        if (Low > High)
+            continue;
+
+        _Bank.InstrumentZones.push_back(sf::instrument_zone_t((uint16_t) _Bank.InstrumentGenerators.size(), (uint16_t) _Bank.InstrumentModulators.size()));
+
+        _Bank.InstrumentGenerators.push_back(sf::generator_t(GeneratorOperator::keyRange, MAKEWORD(Low, High)));                                // Must be the first generator.
+
+        if (subHeader.Pan != 0)
+            _Bank.InstrumentGenerators.push_back(sf::generator_t(GeneratorOperator::pan, (uint16_t) std::clamp((subHeader.Pan * 500) / 64, -500, 500)));
+
+        if (subHeader.Delay != 0)
+            _Bank.InstrumentGenerators.push_back(sf::generator_t(GeneratorOperator::delayVolEnv, (uint16_t) (int16_t) std::lround(1200. * std::log2(subHeader.Delay / 1000.))));
+
+        if (subHeader.CoarseTune != 0)
+            _Bank.InstrumentGenerators.push_back(sf::generator_t(GeneratorOperator::coarseTune, (uint16_t) subHeader.CoarseTune));
+
+        if (subHeader.FineTune != 0)
+            _Bank.InstrumentGenerators.push_back(sf::generator_t(GeneratorOperator::fineTune, (uint16_t) ((subHeader.FineTune * 100) / 256)));
+
+        if (Patch.Scale == 1)
+            _Bank.InstrumentGenerators.push_back(sf::generator_t(GeneratorOperator::scaleTuning, 0));                                           // Every key plays the same pitch.
+
+        if (subHeader.Unknown != 0)
+            _Bank.InstrumentGenerators.push_back(sf::generator_t(GeneratorOperator::exclusiveClass, subHeader.Unknown));                        // Sub-headers with the same value cut each other off.
+
+        if (Sample.Flags >= 2)
+            _Bank.InstrumentGenerators.push_back(sf::generator_t(GeneratorOperator::sampleModes, 1));                                           // Loop
+
+        _Bank.InstrumentGenerators.push_back(sf::generator_t(GeneratorOperator::sampleID, (uint16_t) i));                                      // Must be the last generator.
+    }
+}
+
+/// <summary>
+/// Gets the name of an instrument: the name of the sample set of its first patch, if any.
+/// </summary>
+std::string ecw_converter_t::GetInstrumentName(size_t instrumentIndex) const
+{
+    const auto & Instrument = _Waveset.Instruments[instrumentIndex];
+
+    if (Instrument.Type == InstrumentTypeV1)
+    {
+        const auto v1 = AsV1(Instrument);
+
+        const uint16_t SampleSet = GetSampleSet(v1.SubHeaders[(v1.SubType == 3) ? 1 : 0].PatchIndex);
+
+        if (SampleSet < _Waveset.SampleSets.size())
+        {
+            const std::string Name = _Waveset.SampleSets[SampleSet].Name.c_str();
+
+            if (!Name.empty())
+                return Name;
+        }
+    }
+
+    return msc::FormatText("Instrument %zu", instrumentIndex);
+}
+
+/// <summary>
+/// Gets the sample set played by a patch.
+/// </summary>
+uint16_t ecw_converter_t::GetSampleSet(uint16_t patchIndex) const noexcept
+{
+    if (patchIndex >= _Waveset.Patches.size())
+        return ecw::slot_t::NoSampleSet;
+
+    const uint16_t Slot = _Waveset.Patches[patchIndex].Array1Index;
+
+    return (Slot < _Waveset.Array1.size()) ? _Waveset.Array1[Slot].SampleSet : ecw::slot_t::NoSampleSet;
+}
+
+/// <summary>
+/// Adds a preset. The caller adds its zones.
+/// </summary>
+void ecw_converter_t::AddPreset(const std::string & name, uint16_t program, uint16_t bank)
+{
+    _Bank.Presets.push_back(sf::preset_t(name, program, bank, (uint16_t) _Bank.PresetZones.size()));
+}
+
+ecw::instrument_v1_t ecw_converter_t::AsV1(const ecw::instrument_t & instrument) noexcept
+{
+    static_assert(sizeof(ecw::instrument_v1_t) == sizeof(ecw::instrument_t));
+
+    ecw::instrument_v1_t v1;
+
+    ::memcpy(&v1, &instrument, sizeof(v1));
+
+    return v1;
+}
+
+ecw::instrument_v2_t ecw_converter_t::AsV2(const ecw::instrument_t & instrument) noexcept
+{
+    static_assert(sizeof(ecw::instrument_v2_t) == sizeof(ecw::instrument_t));
+
+    ecw::instrument_v2_t v2;
+
+    ::memcpy(&v2, &instrument, sizeof(v2));
+
+    return v2;
+}
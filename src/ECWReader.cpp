@@ -1,5 +1,5 @@
 
-/** $VER: ECWReader.cpp (2025.05.01) P. Stuer - Implements a reader for a ECW wave set. **/
+/** $VER: ECWReader.cpp (2026.10.18) P. Stuer - Implements a reader for a ECW wave set. **/
 
 #include "pch.h"
 
@@ -11,11 +11,15 @@
 
 using namespace ecw;
 
+static void ReadSampleSets(waveset_t & ws, std::span<const ecwSampleSet> sampleSets, const std::vector<uint16_t> & array1, const std::vector<uint16_t> & array2, const std::vector<uint16_t> & array3, std::span<const ecwSample> samples);
+
 /// <summary>
 /// Reads the complete waveset.
 /// </summary>
-void reader_t::Process(waveset_t & ws)
+void reader_t::Process(waveset_t & ws, const reader_options_t & options)
 {
+    METRICS_SCOPE("ecw::reader_t::Process");
+
     ecwHeader Header = { };
 
     Read(Header);
@@ -51,196 +55,309 @@ void reader_t::Process(waveset_t & ws)
     Read(ws.Patches.data(), Header.PatchHeaderSize);
 
     // Read the sample data.
-    ws.SampleData.resize(Header.SampleDataSize);
+    if (options.ReadSampleData)
+    {
+        ws.SampleData.resize(Header.SampleDataSize);
 
-    Offset(Header.SampleDataOffs);
-    Read(ws.SampleData.data(), Header.SampleDataSize);
+        Offset(Header.SampleDataOffs);
+        Read(ws.SampleData.data(), Header.SampleDataSize);
+    }
 
     // Read the sample sets.
-    {
-        Offset(Header.SampleDataOffs + 22);
+    Offset(Header.SampleDataOffs + 22);
 
-        uint16_t SampleSetCount = 0;
-        Read(SampleSetCount);
+    uint16_t SampleSetCount = 0;
+    Read(SampleSetCount);
 
-        std::vector<ecwSampleSet> SampleSets(SampleSetCount);
+    std::vector<ecwSampleSet> SampleSets(SampleSetCount);
 
-        Offset(Header.SampleDataOffs + 40);
-        Read(SampleSets.data(), SampleSetCount * sizeof(ecwSampleSet));
+    Offset(Header.SampleDataOffs + 40);
+    Read(SampleSets.data(), SampleSetCount * sizeof(ecwSampleSet));
 
-        ws.SampleSets.reserve(SampleSets.size());
+    // Read the slot arrays and the sample headers.
+    std::vector<uint16_t> Array1(Header.Array1Count);
 
-        for (auto & SampleSet : SampleSets)
-        {
-            std::string Name(SampleSet.Name, sizeof(SampleSet.Name));
+    Offset(Header.Array1Offs);
+    Read(Array1.data(), Header.Array1Size);
 
-            // Remove trailing spaces.
-            for (auto it = Name.rbegin(); it != Name.rend(); ++it)
-            {
-                if ((*it != ' ') && (*it != '\0'))
-                    break;
+    std::vector<uint16_t> Array2(Header.Array2Count);
 
-                *it = '\0';
-            }
+    Offset(Header.Array2Offs);
+    Read(Array2.data(), Header.Array2Size);
 
-            ws.SampleSets.push_back(sample_set_t
-            (
-                Name,
-                SampleSet.SampleIndex,
-                SampleSet.Array1Index,
-                SampleSet.Code
-            ));
-        }
+    std::vector<uint16_t> Array3(Header.Array3Count);
 
-        // Read and process array 1.
-        {
-            std::vector<uint16_t> Array1(Header.Array1Count);
+    Offset(Header.Array3Offs);
+    Read(Array3.data(), Header.Array3Size);
 
-            Offset(Header.Array1Offs);
-            Read(Array1.data(), Header.Array1Size);
+    std::vector<ecwSample> Samples(Header.SampleHeaderCount);
 
-            ws.Array1.reserve(Array1.size());
+    Offset(Header.SampleHeaderOffs);
+    Read(Samples.data(), Header.SampleHeaderSize);
 
-            uint16_t i = 0;
+    ReadSampleSets(ws, SampleSets, Array1, Array2, Array3, Samples);
+}
 
-            for (const auto & Item : Array1)
-            {
-                if (Item != 0xFFFF)
-                {
-                    std::string Name;
-
-                    for (const auto & ss : ws.SampleSets)
-                    {
-                        if (ss.Array1Index == i)
-                        {
-                            Name = ss.Name;
-                            break;
-                        }
-                    }
-
-                    ws.Array1.push_back(slot_t(Item, Name));
-                }
-                else
-                    ws.Array1.push_back(slot_t(Item, ""));
-
-                ++i;
-            }
-        }
+/// <summary>
+/// Maps a waveset and validates its layout.
+/// </summary>
+void mapped_reader_t::Open(const std::filesystem::path & filePath)
+{
+    METRICS_SCOPE("ecw::mapped_reader_t::Open");
 
-        // Read and process array 2.
-        {
-            std::vector<uint16_t> Array2(Header.Array2Count);
+    _File.Open(filePath);
 
-            Offset(Header.Array2Offs);
-            Read(Array2.data(), Header.Array2Size);
+    if (_File.Size() < sizeof(ecwHeader))
+        throw sf::exception(msc::FormatText("File too small to be a waveset (%llu bytes)", (unsigned long long) _File.Size()));
 
-            ws.Array2.reserve(Array2.size());
+    _Header = (const ecwHeader *) _File.Data();
 
-            std::vector<size_t> SampleSetArray3Index(Array2.size());
+    if (::memcmp(_Header->Id, "ECLW", sizeof(_Header->Id)) != 0)
+        throw sf::exception("Invalid waveset signature");
 
-            {
-                uint16_t i = 0;
-
-                for (const auto & Item : Array2)
-                {
-                    if (Item != 0)
-                    {
-                        std::string Name;
-
-                        // Get the name of the sample set.
-                        size_t j = 0;
-
-                        for (const auto & ss : ws.SampleSets)
-                        {
-                            if (Item == ss.Code)
-                            {
-                                Name = ss.Name;
-                                SampleSetArray3Index[i] = j;
-                                break;
-                            }
-
-                            ++j;
-                        }
-
-                        ws.Array2.push_back(slot_t(Item, Name));
-                    }
-                    else
-                        ws.Array2.push_back(slot_t(Item, ""));
-
-                    ++i;
-                }
-            }
+    const auto & h = *_Header;
 
-            // Read and process array 3.
-            {
-                std::vector<uint16_t> Array3(Header.Array3Count);
+    ValidateRange("bank maps",          h.BankMapOffs,          h.BankMapSize,          h.BankMapCount,          sizeof(bank_map_t));
+    ValidateRange("drum kit maps",      h.DrumKitMapOffs,       h.DrumKitMapSize,       h.DrumKitMapCount,       sizeof(drum_kit_map_t));
+    ValidateRange("MIDI patch maps",    h.MIDIPatchMapOffs,     h.MIDIPatchMapSize,     h.MIDIPatchMapCount,     sizeof(midi_patch_map_t));
+    ValidateRange("drum note maps",     h.DrumNoteMapOffs,      h.DrumNoteMapSize,      h.DrumNoteMapCount,      sizeof(drum_note_map_t));
+    ValidateRange("instrument headers", h.InstrumentHeaderOffs, h.InstrumentHeaderSize, h.InstrumentHeaderCount, sizeof(instrument_t));
+    ValidateRange("patch headers",      h.PatchHeaderOffs,      h.PatchHeaderSize,      h.PatchHeaderCount,      sizeof(patch_t));
+    ValidateRange("array 1",            h.Array1Offs,           h.Array1Size,           h.Array1Count,           sizeof(uint16_t));
+    ValidateRange("array 2",            h.Array2Offs,           h.Array2Size,           h.Array2Count,           sizeof(uint16_t));
+    ValidateRange("array 3",            h.Array3Offs,           h.Array3Size,           h.Array3Count,           sizeof(uint16_t));
+    ValidateRange("sample headers",     h.SampleHeaderOffs,     h.SampleHeaderSize,     h.SampleHeaderCount,     sizeof(ecwSample));
+    ValidateRange("sample data",        h.SampleDataOffs,       h.SampleDataSize,       h.SampleDataSize,        1);
+
+    // The sample set table is stored at the start of the sample data area.
+    ValidateRange("sample set count",   h.SampleDataOffs + 22ull, sizeof(uint16_t), 1, sizeof(uint16_t));
+
+    uint16_t SampleSetCount = 0;
+
+    ::memcpy(&SampleSetCount, _File.Data() + h.SampleDataOffs + 22, sizeof(SampleSetCount));
+
+    ValidateRange("sample sets",        h.SampleDataOffs + 40ull, (uint64_t) SampleSetCount * sizeof(ecwSampleSet), SampleSetCount, sizeof(ecwSampleSet));
+
+    _SampleSets = std::span<const ecwSampleSet>((const ecwSampleSet *) (_File.Data() + h.SampleDataOffs + 40), SampleSetCount);
+}
+
+/// <summary>
+/// Unmaps the waveset. Invalidates all spans returned by this instance.
+/// </summary>
+void mapped_reader_t::Close() noexcept
+{
+    _File.Close();
+
+    _Header = nullptr;
+    _SampleSets = { };
+}
+
+/// <summary>
+/// Initializes a waveset with the names, maps, headers and slots of the mapped file. The sample data is not copied; use GetSampleData() to access the waveform of a sample.
+/// </summary>
+void mapped_reader_t::Process(waveset_t & ws) const
+{
+    METRICS_SCOPE("ecw::mapped_reader_t::Process");
+
+    if (_Header == nullptr)
+        throw sf::exception("Waveset not open");
+
+    const auto & h = *_Header;
+
+    ws.Name        = ToString(h.Name,        sizeof(h.Name));
+    ws.Copyright   = ToString(h.Copyright,   sizeof(h.Copyright));
+    ws.Description = ToString(h.Description, sizeof(h.Description));
+    ws.Information = ToString(h.Information, sizeof(h.Information));
+    ws.FileName    = ToString(h.FileName,    sizeof(h.FileName));
+
+    ws.BankMaps     .assign(BankMaps()     .begin(), BankMaps()     .end());
+    ws.DrumKitMaps  .assign(DrumKitMaps()  .begin(), DrumKitMaps()  .end());
+    ws.MIDIPatchMaps.assign(MIDIPatchMaps().begin(), MIDIPatchMaps().end());
+    ws.DrumNoteMaps .assign(DrumNoteMaps() .begin(), DrumNoteMaps() .end());
+    ws.Instruments  .assign(Instruments()  .begin(), Instruments()  .end());
+    ws.Patches      .assign(Patches()      .begin(), Patches()      .end());
+
+    ws.SampleData.clear();
+
+    ReadSampleSets(ws, _SampleSets, GetArray(h.Array1Offs, h.Array1Count), GetArray(h.Array2Offs, h.Array2Count), GetArray(h.Array3Offs, h.Array3Count), SampleHeaders());
+}
+
+/// <summary>
+/// Gets the waveform of a sample, from its start up to its loop end. Only the pages that are accessed are read from disk.
+/// </summary>
+std::span<const uint8_t> mapped_reader_t::GetSampleData(const sample_t & sample) const
+{
+    const auto Data = SampleData();
+
+    if ((sample.SampleStart > sample.LoopEnd) || (sample.LoopEnd > Data.size()))
+        throw sf::exception(msc::FormatText("Sample \"%s\" exceeds the sample data area (%u..%u, %zu bytes)", sample.Name.c_str(), sample.SampleStart, sample.LoopEnd, Data.size()));
+
+    return Data.subspan(sample.SampleStart, (size_t) sample.LoopEnd - sample.SampleStart);
+}
+
+/// <summary>
+/// Throws if a header section does not fit its declared size or the file.
+/// </summary>
+void mapped_reader_t::ValidateRange(const char * name, uint64_t offset, uint64_t size, uint64_t count, uint64_t itemSize) const
+{
+    if (count * itemSize > size)
+        throw sf::exception(msc::FormatText("Invalid %s: %llu items of %llu bytes exceed the declared size of %llu bytes", name, (unsigned long long) count, (unsigned long long) itemSize, (unsigned long long) size));
+
+    if ((offset > _File.Size()) || (size > _File.Size() - offset))
+        throw sf::exception(msc::FormatText("Invalid %s: %llu bytes at offset %llu exceed the file size of %llu bytes", name, (unsigned long long) size, (unsigned long long) offset, (unsigned long long) _File.Size()));
+}
+
+/// <summary>
+/// Copies a slot array. The array is not necessarily aligned in the mapping.
+/// </summary>
+std::vector<uint16_t> mapped_reader_t::GetArray(uint32_t offset, uint32_t count) const
+{
+    std::vector<uint16_t> Array(count);
+
+    if (count != 0)
+        ::memcpy(Array.data(), _File.Data() + offset, count * sizeof(uint16_t));
 
-                Offset(Header.Array3Offs);
-                Read(Array3.data(), Header.Array3Size);
+    return Array;
+}
 
-                ws.Array3.reserve(Array3.size());
+/// <summary>
+/// Converts a fixed-length, optionally zero-terminated string.
+/// </summary>
+std::string mapped_reader_t::ToString(const char * data, size_t size)
+{
+    return std::string(data, ::strnlen(data, size));
+}
 
-                std::vector<size_t> SampleIndexInSampleSet(ws.Array1.size(), ~0u);
+/// <summary>
+/// Reads the sample sets and resolves the slots of arrays 1, 2 and 3 and the sample headers to sample sets.
+/// </summary>
+static void ReadSampleSets(waveset_t & ws, std::span<const ecwSampleSet> sampleSets, const std::vector<uint16_t> & array1, const std::vector<uint16_t> & array2, const std::vector<uint16_t> & array3, std::span<const ecwSample> samples)
+{
+    ws.SampleSets.clear();
+    ws.Array1.clear();
+    ws.Array2.clear();
+    ws.Array3.clear();
+    ws.Samples.clear();
 
-                {
-                    size_t i = 0;
+    ws.SampleSets.reserve(sampleSets.size());
 
-                    for (const auto & Item : Array3)
-                    {
-                        if (Item != 0)
-                            ws.Array3.push_back(slot_t(Item, ws.SampleSets[SampleSetArray3Index[i]].Name));
-                        else
-                            ws.Array3.push_back(slot_t(Item, ""));
+    for (auto & SampleSet : sampleSets)
+    {
+        std::string Name(SampleSet.Name, sizeof(SampleSet.Name));
 
-                        SampleIndexInSampleSet[Item] = SampleSetArray3Index[i];
+        // Remove trailing spaces.
+        for (auto it = Name.rbegin(); it != Name.rend(); ++it)
+        {
+            if ((*it != ' ') && (*it != '\0'))
+                break;
 
-                        ++i;
-                    }
-                }
+            *it = '\0';
+        }
 
-                // Read the samples.
-                {
-                    std::vector<ecwSample> Samples(Header.SampleHeaderCount);
+        ws.SampleSets.push_back(sample_set_t
+        (
+            Name,
+            SampleSet.SampleIndex,
+            SampleSet.Array1Index,
+            SampleSet.Code
+        ));
+    }
 
-                    Offset(Header.SampleHeaderOffs);
-                    Read(Samples.data(), Header.SampleHeaderSize);
+    // Index the sample sets once so each slot can be resolved in constant time. The first sample set wins if several claim the same slot or code.
+    std::vector<uint16_t> SampleSetByArray1Index(array1.size(), slot_t::NoSampleSet);
+    std::unordered_map<uint16_t, uint16_t> SampleSetByCode;
 
-                    ws.Samples.reserve(Samples.size());
+    SampleSetByCode.reserve(ws.SampleSets.size());
 
-                    size_t i = 0;
+    for (uint16_t j = 0; j < (uint16_t) ws.SampleSets.size(); ++j)
+    {
+        const auto & ss = ws.SampleSets[j];
 
-                    uint32_t SampleStart = ~0u;
-                    std::string SampleSetName;
-                    uint8_t HighKey = 0;
+        if ((ss.Array1Index < SampleSetByArray1Index.size()) && (SampleSetByArray1Index[ss.Array1Index] == slot_t::NoSampleSet))
+            SampleSetByArray1Index[ss.Array1Index] = j;
 
-                    for (auto & Sample : Samples)
-                    {
-                        uint8_t LowKey = (HighKey == 127) ? 0 : HighKey + 1;
-                        HighKey = Sample.SplitPoint;
+        SampleSetByCode.try_emplace(ss.Code, j);
+    }
 
-                        if (SampleIndexInSampleSet[i] != -1)
-                            SampleSetName = ws.SampleSets[SampleIndexInSampleSet[i]].Name;
+    // Process array 1.
+    {
+        ws.Array1.reserve(array1.size());
 
-                        ws.Samples.push_back(sample_t
-                        (
-                            SampleSetName,
-                            LowKey,
-                            HighKey,
-                            Sample.Flags,
-                            Sample.FineTune,
-                            Sample.CoarseTune,
-                            Sample.SampleStart / 8,
-                            Sample.LoopStart / 8,
-                            Sample.LoopEnd /  8
-                        ));
+        for (size_t i = 0; i < array1.size(); ++i)
+        {
+            const uint16_t Item = array1[i];
 
-                        if (Sample.SampleStart < SampleStart)
-                            SampleStart = Sample.SampleStart;
+            ws.Array1.push_back(slot_t(Item, (Item != 0xFFFF) ? SampleSetByArray1Index[i] : slot_t::NoSampleSet));
+        }
+    }
 
-                        ++i;
-                    }
-                }
+    // Process array 2.
+    {
+        ws.Array2.reserve(array2.size());
+
+        for (const auto & Item : array2)
+        {
+            uint16_t SampleSet = slot_t::NoSampleSet;
+
+            if (Item != 0)
+            {
+                auto it = SampleSetByCode.find(Item);
+
+                if (it != SampleSetByCode.end())
+                    SampleSet = it->second;
             }
+
+            ws.Array2.push_back(slot_t(Item, SampleSet));
+        }
+    }
+
+    // Process array 3. Each entry holds the index of the first sample of the sample set of the corresponding entry in array 2.
+    std::vector<uint16_t> SampleSetBySample(samples.size(), slot_t::NoSampleSet);
+
+    {
+        ws.Array3.reserve(array3.size());
+
+        for (size_t i = 0; i < array3.size(); ++i)
+        {
+            const uint16_t Item = array3[i];
+            const uint16_t SampleSet = (i < ws.Array2.size()) ? ws.Array2[i].SampleSet : slot_t::NoSampleSet;
+
+            ws.Array3.push_back(slot_t(Item, (Item != 0) ? SampleSet : slot_t::NoSampleSet));
+
+            if (Item < SampleSetBySample.size())
+                SampleSetBySample[Item] = SampleSet;
+        }
+    }
+
+    // Process the sample headers. A sample belongs to the most recent sample set that starts at or before it.
+    {
+        ws.Samples.reserve(samples.size());
+
+        uint16_t SampleSet = slot_t::NoSampleSet;
+        uint8_t HighKey = 0;
+
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            const auto & Sample = samples[i];
+
+            uint8_t LowKey = (HighKey == 127) ? 0 : HighKey + 1;
+            HighKey = Sample.SplitPoint;
+
+            if (SampleSetBySample[i] != slot_t::NoSampleSet)
+                SampleSet = SampleSetBySample[i];
+
+            ws.Samples.push_back(sample_t
+            (
+                (SampleSet != slot_t::NoSampleSet) ? ws.SampleSets[SampleSet].Name : std::string(),
+                LowKey,
+                HighKey,
+                Sample.Flags,
+                Sample.FineTune,
+                Sample.CoarseTune,
+                Sample.SampleStart / 8,
+                Sample.LoopStart / 8,
+                Sample.LoopEnd /  8
+            ));
         }
     }
 }
@@ -0,0 +1,319 @@
+
+/** $VER: Filter.cpp (2026.10.18) P. Stuer - Resonant low-pass filters of many voices **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include <numbers>
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define FILTER_SSE2
+#include <emmintrin.h>
+#elif defined(_M_ARM64) || defined(__ARM_NEON)
+#define FILTER_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace sf;
+
+/// <summary>
+/// Initializes a new instance with room for the specified number of voices.
+/// </summary>
+lowpass_filter_t::lowpass_filter_t(uint32_t sampleRate, uint32_t capacity) : _SampleRate((float) sampleRate)
+{
+    if (sampleRate == 0)
+        throw sf::exception("Invalid sample rate");
+
+    for (auto * Array : { &_Cutoff, &_K, &_A1, &_A2, &_A3, &_Ic1, &_Ic2 })
+        Array->resize(capacity);
+
+    for (uint32_t i = 0; i < capacity; ++i)
+        Start(i);
+}
+
+/// <summary>
+/// Clears the state of a voice and opens its filter. Call SetCutoff() and SetResonance() before the first block.
+/// </summary>
+void lowpass_filter_t::Start(uint32_t slot) noexcept
+{
+    _Ic1[slot] = 0.f;
+    _Ic2[slot] = 0.f;
+
+    _Cutoff[slot] = _SampleRate * 0.45f;
+    _K[slot] = std::numbers::sqrt2_v<float>;
+
+    UpdateCoefficients(slot);
+}
+
+/// <summary>
+/// Sets the cutoff frequency in Hz. The coefficients are only recalculated when the cutoff changes.
+/// </summary>
+void lowpass_filter_t::SetCutoff(uint32_t slot, float cutoff) noexcept
+{
+    // Keep the cutoff below Nyquist, where the prewarping diverges.
+    cutoff = std::clamp(cutoff, 1.f, _SampleRate * 0.45f);
+
+    if (cutoff == _Cutoff[slot])
+        return;
+
+    _Cutoff[slot] = cutoff;
+
+    UpdateCoefficients(slot);
+}
+
+/// <summary>
+/// Sets the height of the resonance peak above the DC gain in centibels (initialFilterQ). 0 cB gives a Butterworth response.
+/// </summary>
+void lowpass_filter_t::SetResonance(uint32_t slot, float resonance) noexcept
+{
+    // Q = 1 / sqrt(2) * 10^(cB / 200); the gain of the filter at the cutoff frequency is Q.
+    _K[slot] = std::numbers::sqrt2_v<float> * units::CentibelsToGain(std::clamp(resonance, 0.f, 960.f));
+
+    UpdateCoefficients(slot);
+}
+
+/// <summary>
+/// Filters a block of a voice in place.
+/// </summary>
+void lowpass_filter_t::Process(uint32_t slot, float * data, uint32_t frameCount) noexcept
+{
+    const float a1 = _A1[slot];
+    const float a2 = _A2[slot];
+    const float a3 = _A3[slot];
+
+    // v3 = x - Ic2, v1 = a1 Ic1 + a2 v3, v2 = Ic2 + a2 Ic1 + a3 v3, Ic1' = 2 v1 - Ic1, Ic2' = 2 v2 - Ic2, y = v2, as a matrix product.
+    const float C11 = 2.f * a1 - 1.f;
+    const float C12 = -2.f * a2;
+    const float C21 = 2.f * a2;
+    const float C22 = 1.f + -2.f * a3;
+    const float B2  = 2.f * a3;
+    const float Y2  = 1.f + -1.f * a3;
+
+    float Ic1 = _Ic1[slot];
+    float Ic2 = _Ic2[slot];
+
+    for (uint32_t i = 0; i < frameCount; ++i)
+    {
+        const float x = data[i];
+
+        data[i] = a3 * x + a2 * Ic1 + Y2 * Ic2;
+
+        const float n1 = C11 * Ic1 + C12 * Ic2 + C21 * x;
+        const float n2 = C21 * Ic1 + C22 * Ic2 + B2  * x;
+
+        Ic1 = n1;
+        Ic2 = n2;
+    }
+
+    _Ic1[slot] = FlushToZero(Ic1);
+    _Ic2[slot] = FlushToZero(Ic2);
+}
+
+/// <summary>
+/// Filters a block of several voices in place. Groups of Lanes voices are filtered in parallel.
+/// </summary>
+void lowpass_filter_t::Process(const uint32_t * slots, float * const * data, uint32_t count, uint32_t frameCount) noexcept
+{
+    uint32_t i = 0;
+
+    for (; i + Lanes <= count; i += Lanes)
+        ProcessLanes(slots + i, data + i, frameCount);
+
+    for (; i < count; ++i)
+        Process(slots[i], data[i], frameCount);
+}
+
+/// <summary>
+/// Recalculates the coefficients of the trapezoidal state variable filter (A. Simper, Cytomic, 2013).
+/// </summary>
+void lowpass_filter_t::UpdateCoefficients(uint32_t slot) noexcept
+{
+    const float g = std::tan(std::numbers::pi_v<float> * _Cutoff[slot] / _SampleRate);
+    const float k = _K[slot];
+
+    const float a1 = 1.f / (1.f + g * (g + k));
+
+    _A1[slot] = a1;
+    _A2[slot] = g * a1;
+    _A3[slot] = g * g * a1;
+}
+
+#if defined(FILTER_SSE2) || defined(FILTER_NEON)
+
+namespace
+{
+#if defined(FILTER_SSE2)
+    typedef __m128 vector_t;
+
+    inline vector_t Load(const float * p) noexcept { return _mm_loadu_ps(p); }
+    inline void Store(float * p, vector_t v) noexcept { _mm_storeu_ps(p, v); }
+    inline vector_t Set(float a, float b, float c, float d) noexcept { return _mm_setr_ps(a, b, c, d); }
+    inline vector_t Add(vector_t a, vector_t b) noexcept { return _mm_add_ps(a, b); }
+    inline vector_t Mul(vector_t a, vector_t b) noexcept { return _mm_mul_ps(a, b); }
+
+    inline void Transpose(vector_t & r0, vector_t & r1, vector_t & r2, vector_t & r3) noexcept
+    {
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    }
+#else
+    typedef float32x4_t vector_t;
+
+    inline vector_t Load(const float * p) noexcept { return vld1q_f32(p); }
+    inline void Store(float * p, vector_t v) noexcept { vst1q_f32(p, v); }
+    inline vector_t Set(float a, float b, float c, float d) noexcept { const float v[4] = { a, b, c, d }; return vld1q_f32(v); }
+    inline vector_t Add(vector_t a, vector_t b) noexcept { return vaddq_f32(a, b); }
+    inline vector_t Mul(vector_t a, vector_t b) noexcept { return vmulq_f32(a, b); }
+
+    inline void Transpose(vector_t & r0, vector_t & r1, vector_t & r2, vector_t & r3) noexcept
+    {
+        const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+
+        r0 = vcombine_f32(vget_low_f32(t01.val[0]),  vget_low_f32(t23.val[0]));
+        r1 = vcombine_f32(vget_low_f32(t01.val[1]),  vget_low_f32(t23.val[1]));
+        r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+#endif
+
+    /// <summary>
+    /// The filters of 4 voices, one voice per lane.
+    /// </summary>
+    struct lanes_t
+    {
+        lanes_t(const uint32_t * slots, const float * a1, const float * a2, const float * a3, const float * ic1, const float * ic2) noexcept
+        {
+            const vector_t A1 = Set(a1[slots[0]], a1[slots[1]], a1[slots[2]], a1[slots[3]]);
+            const vector_t A2 = Set(a2[slots[0]], a2[slots[1]], a2[slots[2]], a2[slots[3]]);
+            const vector_t A3 = Set(a3[slots[0]], a3[slots[1]], a3[slots[2]], a3[slots[3]]);
+
+            const vector_t One = Set(1.f, 1.f, 1.f, 1.f);
+            const vector_t Two = Set(2.f, 2.f, 2.f, 2.f);
+            const vector_t MinusOne = Set(-1.f, -1.f, -1.f, -1.f);
+
+            C11 = Add(Mul(Two, A1), MinusOne);                  // 2 a1 - 1
+            C12 = Mul(Set(-2.f, -2.f, -2.f, -2.f), A2);         // -2 a2
+            C21 = Mul(Two, A2);                                 // 2 a2
+            C22 = Add(One, Mul(Set(-2.f, -2.f, -2.f, -2.f), A3)); // 1 - 2 a3
+            B2  = Mul(Two, A3);                                 // 2 a3
+
+            Y0 = A3;
+            Y1 = A2;
+            Y2 = Add(One, Mul(MinusOne, A3));                   // 1 - a3
+
+            Ic1 = Set(ic1[slots[0]], ic1[slots[1]], ic1[slots[2]], ic1[slots[3]]);
+            Ic2 = Set(ic2[slots[0]], ic2[slots[1]], ic2[slots[2]], ic2[slots[3]]);
+        }
+
+        /// <summary>
+        /// Filters one frame of each voice. The state update is written as a matrix product so that the chain of dependent instructions from one frame to the next is short.
+        /// </summary>
+        vector_t Step(vector_t x) noexcept
+        {
+            const vector_t y  = Add(Add(Mul(Y0, x), Mul(Y1, Ic1)), Mul(Y2, Ic2));
+            const vector_t n1 = Add(Add(Mul(C11, Ic1), Mul(C12, Ic2)), Mul(C21, x));
+            const vector_t n2 = Add(Add(Mul(C21, Ic1), Mul(C22, Ic2)), Mul(B2,  x));
+
+            Ic1 = n1;
+            Ic2 = n2;
+
+            return y;
+        }
+
+        /// <summary>
+        /// Filters frames i to i + 3 of each voice.
+        /// </summary>
+        void Step4(float * const * data, uint32_t i) noexcept
+        {
+            vector_t x0 = Load(data[0] + i);
+            vector_t x1 = Load(data[1] + i);
+            vector_t x2 = Load(data[2] + i);
+            vector_t x3 = Load(data[3] + i);
+
+            Transpose(x0, x1, x2, x3);
+
+            x0 = Step(x0);
+            x1 = Step(x1);
+            x2 = Step(x2);
+            x3 = Step(x3);
+
+            Transpose(x0, x1, x2, x3);
+
+            Store(data[0] + i, x0);
+            Store(data[1] + i, x1);
+            Store(data[2] + i, x2);
+            Store(data[3] + i, x3);
+        }
+
+        /// <summary>
+        /// Filters frame i of each voice.
+        /// </summary>
+        void Step1(float * const * data, uint32_t i) noexcept
+        {
+            float y[4];
+
+            Store(y, Step(Set(data[0][i], data[1][i], data[2][i], data[3][i])));
+
+            data[0][i] = y[0]; data[1][i] = y[1]; data[2][i] = y[2]; data[3][i] = y[3];
+        }
+
+        void Save(const uint32_t * slots, float * ic1, float * ic2) const noexcept
+        {
+            float State[8];
+
+            Store(State,     Ic1);
+            Store(State + 4, Ic2);
+
+            for (uint32_t j = 0; j < 4; ++j)
+            {
+                ic1[slots[j]] = lowpass_filter_t::FlushToZero(State[j]);
+                ic2[slots[j]] = lowpass_filter_t::FlushToZero(State[4 + j]);
+            }
+        }
+
+        vector_t C11, C12, C21, C22, B2;
+        vector_t Y0, Y1, Y2;
+        vector_t Ic1, Ic2;
+    };
+}
+
+/// <summary>
+/// Filters a block of Lanes voices. Each group of 4 frames is transposed so that the filters step through time with 4 voices at once.
+/// Two independent groups of 4 voices are interleaved to hide the latency of the recursion.
+/// </summary>
+void lowpass_filter_t::ProcessLanes(const uint32_t * slots, float * const * data, uint32_t frameCount) noexcept
+{
+    lanes_t Lo(slots,     _A1.data(), _A2.data(), _A3.data(), _Ic1.data(), _Ic2.data());
+    lanes_t Hi(slots + 4, _A1.data(), _A2.data(), _A3.data(), _Ic1.data(), _Ic2.data());
+
+    uint32_t i = 0;
+
+    for (; i + 4 <= frameCount; i += 4)
+    {
+        Lo.Step4(data,     i);
+        Hi.Step4(data + 4, i);
+    }
+
+    for (; i < frameCount; ++i)
+    {
+        Lo.Step1(data,     i);
+        Hi.Step1(data + 4, i);
+    }
+
+    Lo.Save(slots,     _Ic1.data(), _Ic2.data());
+    Hi.Save(slots + 4, _Ic1.data(), _Ic2.data());
+}
+
+#else
+
+/// <summary>
+/// Filters a block of Lanes voices, one after the other.
+/// </summary>
+void lowpass_filter_t::ProcessLanes(const uint32_t * slots, float * const * data, uint32_t frameCount) noexcept
+{
+    for (uint32_t i = 0; i < Lanes; ++i)
+        Process(slots[i], data[i], frameCount);
+}
+
+#endif
@@ -0,0 +1,360 @@
+
+/** $VER: Interpolator.cpp (2026.10.18) P. Stuer - Sample interpolation kernels **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "InterpolatorKernels.h"
+
+#include <numbers>
+
+using namespace sf;
+using namespace sf::interpolator;
+
+namespace
+{
+    /// <summary>
+    /// Describes the taps of the linear kernel.
+    /// </summary>
+    struct linear_t
+    {
+        static constexpr uint32_t Left  = 0; // Taps before the point at the position
+        static constexpr uint32_t Right = 1; // Taps after the point at the position
+
+        template <bool HasLSB> static float Point(const interpolator_source_t & source, uint64_t position) noexcept;
+    };
+
+    /// <summary>
+    /// Describes the taps of the cubic kernel.
+    /// </summary>
+    struct cubic_t
+    {
+        static constexpr uint32_t Left  = 1;
+        static constexpr uint32_t Right = 2;
+
+        template <bool HasLSB> static float Point(const interpolator_source_t & source, uint64_t position) noexcept;
+    };
+
+    /// <summary>
+    /// Describes the taps of the sinc kernel.
+    /// </summary>
+    struct sinc_t
+    {
+        static constexpr uint32_t Left  = 3;
+        static constexpr uint32_t Right = 4;
+
+        template <bool HasLSB> static float Point(const interpolator_source_t & source, uint64_t position) noexcept;
+    };
+
+    /// <summary>
+    /// Reads a sample point, wrapping around the loop and returning silence outside the sample.
+    /// </summary>
+    template <bool HasLSB> float Fetch(const interpolator_source_t & source, int64_t index) noexcept
+    {
+        if (source.IsLooping)
+        {
+            if ((index >= source.LoopEnd) && (source.LoopEnd > source.LoopStart))
+                index = source.LoopStart + (index - source.LoopStart) % (source.LoopEnd - source.LoopStart);
+        }
+        else
+        if (index >= source.End)
+            return 0.f;
+
+        if ((index < source.Start) || (index >= (int64_t) source.Count))
+            return 0.f;
+
+        return Read<HasLSB>(source, (size_t) index);
+    }
+
+    template <bool HasLSB> float linear_t::Point(const interpolator_source_t & source, uint64_t position) noexcept
+    {
+        const int64_t Index = (int64_t) (position >> 32);
+
+        return Linear(Fetch<HasLSB>(source, Index), Fetch<HasLSB>(source, Index + 1), GetFraction(position));
+    }
+
+    template <bool HasLSB> float cubic_t::Point(const interpolator_source_t & source, uint64_t position) noexcept
+    {
+        const int64_t Index = (int64_t) (position >> 32);
+
+        return Cubic(Fetch<HasLSB>(source, Index - 1), Fetch<HasLSB>(source, Index), Fetch<HasLSB>(source, Index + 1), Fetch<HasLSB>(source, Index + 2), GetFraction(position));
+    }
+
+    template <bool HasLSB> float sinc_t::Point(const interpolator_source_t & source, uint64_t position) noexcept
+    {
+        const int64_t Index = (int64_t) (position >> 32);
+
+        const float * Coefficients = GetSincTable() + GetPhase(position) * SincTaps;
+
+        float Sum = 0.f;
+
+        for (uint32_t i = 0; i < SincTaps; ++i)
+            Sum += Fetch<HasLSB>(source, Index - 3 + i) * Coefficients[i];
+
+        return Sum;
+    }
+
+    template <bool HasLSB> void LinearBlock(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount) noexcept
+    {
+        constexpr float Scale = HasLSB ? Scale24 : Scale16;
+
+        for (uint32_t i = 0; i < frameCount; ++i, position += increment)
+        {
+            const size_t Index = (size_t) (position >> 32);
+
+            data[i] = Linear(Read<HasLSB>(source, Index), Read<HasLSB>(source, Index + 1), GetFraction(position)) * Scale;
+        }
+    }
+
+    template <bool HasLSB> void CubicBlock(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount) noexcept
+    {
+        constexpr float Scale = HasLSB ? Scale24 : Scale16;
+
+        for (uint32_t i = 0; i < frameCount; ++i, position += increment)
+        {
+            const size_t Index = (size_t) (position >> 32);
+
+            data[i] = Cubic(Read<HasLSB>(source, Index - 1), Read<HasLSB>(source, Index), Read<HasLSB>(source, Index + 1), Read<HasLSB>(source, Index + 2), GetFraction(position)) * Scale;
+        }
+    }
+
+    template <bool HasLSB> void SincBlock(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount) noexcept
+    {
+        constexpr float Scale = HasLSB ? Scale24 : Scale16;
+
+        const float * Table = GetSincTable();
+
+        for (uint32_t i = 0; i < frameCount; ++i, position += increment)
+        {
+            const size_t Index = (size_t) (position >> 32) - 3;
+
+            const float * Coefficients = Table + GetPhase(position) * SincTaps;
+
+            float Sum = 0.f;
+
+            for (uint32_t j = 0; j < SincTaps; ++j)
+                Sum += Read<HasLSB>(source, Index + j) * Coefficients[j];
+
+            data[i] = Sum * Scale;
+        }
+    }
+
+    /// <summary>
+    /// Drives a kernel: hands the runs of frames whose taps are all inside the sample to the block function and handles the frames near the boundaries and the loop wrap-around itself.
+    /// </summary>
+    template <typename Kernel, block_fn_t Block> uint32_t Interpolate(const interpolator_source_t & source, uint64_t & position, uint64_t increment, float * data, uint32_t frameCount)
+    {
+        increment = std::max(increment, (uint64_t) 1);
+
+        const bool IsLooping = source.IsLooping && (source.LoopEnd > source.LoopStart);
+
+        const uint32_t Limit = IsLooping ? source.LoopEnd : source.End;
+
+        const uint64_t LoopEnd    = (uint64_t) source.LoopEnd << 32;
+        const uint64_t LoopLength = (uint64_t) (source.LoopEnd - source.LoopStart) << 32;
+
+        // Guard points let a block read across Start and LoopEnd. The points after End are only silent if no loop continuation extends past it.
+        const bool IsStartPadded = source.Padding >= Kernel::Left;
+        const bool IsLimitPadded = (source.Padding >= Kernel::Right) && (IsLooping || (source.LoopEnd <= source.LoopStart) || (source.LoopEnd + source.Padding <= source.End));
+
+        // The first and last point at which a block can start reading.
+        const int64_t First = (int64_t) source.Start + (IsStartPadded ? 0 : Kernel::Left);
+        const int64_t Last  = std::min((int64_t) Limit - 1 - (IsLimitPadded ? 0 : Kernel::Right), (int64_t) source.Count - 1 - (source.DataLSB ? 2 : 0) - Kernel::Right);
+
+        const float Scale = source.DataLSB ? Scale24 : Scale16;
+
+        uint32_t Done = 0;
+
+        while (Done < frameCount)
+        {
+            const int64_t Index = (int64_t) (position >> 32);
+
+            if (Index >= Limit)
+            {
+                if (!IsLooping)
+                    break;
+
+                position -= ((position - LoopEnd) / LoopLength + 1) * LoopLength;
+
+                continue;
+            }
+
+            uint32_t Frames = 0;
+
+            if ((Index >= First) && (Index <= Last))
+                Frames = (uint32_t) std::min(((((uint64_t) Last + 1) << 32) - position + increment - 1) / increment, (uint64_t) (frameCount - Done));
+
+            if (Frames != 0)
+            {
+                Block(source, position, increment, data + Done, Frames);
+
+                position += increment * Frames;
+                Done     += Frames;
+            }
+            else
+            {
+                data[Done++] = (source.DataLSB ? Kernel::template Point<true>(source, position) : Kernel::template Point<false>(source, position)) * Scale;
+
+                position += increment;
+            }
+        }
+
+        return Done;
+    }
+
+    /// <summary>
+    /// Creates the table of the Blackman-windowed sinc kernel. The coefficients of each phase are normalized to unity gain.
+    /// </summary>
+    std::vector<float> CreateSincTable()
+    {
+        std::vector<float> Table(SincPhases * SincTaps);
+
+        for (uint32_t i = 0; i < SincPhases; ++i)
+        {
+            const double Fraction = (double) i / SincPhases;
+
+            double Coefficients[SincTaps];
+            double Sum = 0.;
+
+            for (uint32_t j = 0; j < SincTaps; ++j)
+            {
+                const double x = (double) j - 3. - Fraction; // Distance from the position, -4 < x <= 3
+
+                const double Sinc   = (x == 0.) ? 1. : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+                const double Window = 0.42 + 0.5 * std::cos(std::numbers::pi * x / 4.) + 0.08 * std::cos(2. * std::numbers::pi * x / 4.);
+
+                Coefficients[j] = Sinc * Window;
+                Sum += Coefficients[j];
+            }
+
+            for (uint32_t j = 0; j < SincTaps; ++j)
+                Table[i * SincTaps + j] = (float) (Coefficients[j] / Sum);
+        }
+
+        return Table;
+    }
+}
+
+/// <summary>
+/// Gets the coefficients of the sinc kernel.
+/// </summary>
+const float * interpolator::GetSincTable() noexcept
+{
+    static const std::vector<float> Table = CreateSincTable();
+
+    return Table.data();
+}
+
+void interpolator::LinearScalar(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+{
+    if (source.DataLSB != nullptr)
+        LinearBlock<true>(source, position, increment, data, frameCount);
+    else
+        LinearBlock<false>(source, position, increment, data, frameCount);
+}
+
+void interpolator::CubicScalar(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+{
+    if (source.DataLSB != nullptr)
+        CubicBlock<true>(source, position, increment, data, frameCount);
+    else
+        CubicBlock<false>(source, position, increment, data, frameCount);
+}
+
+void interpolator::SincScalar(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+{
+    if (source.DataLSB != nullptr)
+        SincBlock<true>(source, position, increment, data, frameCount);
+    else
+        SincBlock<false>(source, position, increment, data, frameCount);
+}
+
+/// <summary>
+/// Gets the fastest implementation of an interpolation kernel for the CPU.
+/// </summary>
+interpolator_fn_t sf::GetInterpolator(interpolation_t interpolation) noexcept
+{
+    return GetInterpolator(interpolation, platform::GetInstructionSet());
+}
+
+/// <summary>
+/// Gets the implementation of an interpolation kernel for an instruction set. Returns nullptr if the library doesn't contain it. The caller must make sure the CPU supports the instruction set.
+/// </summary>
+interpolator_fn_t sf::GetInterpolator(interpolation_t interpolation, instruction_set_t instructionSet) noexcept
+{
+    GetSincTable(); // Initialize the table outside of the render loop.
+
+    switch (instructionSet)
+    {
+        case instruction_set_t::Scalar:
+        {
+            switch (interpolation)
+            {
+                case interpolation_t::Linear:   return Interpolate<linear_t, LinearScalar>;
+                case interpolation_t::Cubic:    return Interpolate<cubic_t,  CubicScalar>;
+                case interpolation_t::Sinc:     return Interpolate<sinc_t,   SincScalar>;
+            }
+            break;
+        }
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+        case instruction_set_t::SSE2:
+        {
+            switch (interpolation)
+            {
+                case interpolation_t::Linear:   return Interpolate<linear_t, LinearSSE2>;
+                case interpolation_t::Cubic:    return Interpolate<cubic_t,  CubicSSE2>;
+                case interpolation_t::Sinc:     return Interpolate<sinc_t,   SincSSE2>;
+            }
+            break;
+        }
+#endif
+
+        case instruction_set_t::AVX2:
+        {
+            switch (interpolation)
+            {
+                case interpolation_t::Linear:   return Interpolate<linear_t, LinearAVX2>;
+                case interpolation_t::Cubic:    return Interpolate<cubic_t,  CubicAVX2>;
+                case interpolation_t::Sinc:     return Interpolate<sinc_t,   SincAVX2>;
+            }
+            break;
+        }
+#endif
+
+#if defined(_M_ARM64) || defined(__ARM_NEON)
+        case instruction_set_t::NEON:
+        {
+            switch (interpolation)
+            {
+                case interpolation_t::Linear:   return Interpolate<linear_t, LinearNEON>;
+                case interpolation_t::Cubic:    return Interpolate<cubic_t,  CubicNEON>;
+                case interpolation_t::Sinc:     return Interpolate<sinc_t,   SincNEON>;
+            }
+            break;
+        }
+#endif
+
+        default:
+            break;
+    }
+
+    return nullptr;
+}
+
+/// <summary>
+/// Gets the name of an interpolation kernel.
+/// </summary>
+const char * sf::GetInterpolationName(interpolation_t interpolation) noexcept
+{
+    switch (interpolation)
+    {
+        case interpolation_t::Linear:   return "Linear";
+        case interpolation_t::Cubic:    return "Cubic";
+        case interpolation_t::Sinc:     return "Sinc";
+    }
+
+    return "";
+}
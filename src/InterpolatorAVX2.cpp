@@ -0,0 +1,208 @@
+
+/** $VER: InterpolatorAVX2.cpp (2026.10.18) P. Stuer - AVX2 sample interpolation kernels **/
+
+#include "pch.h"
+
+#include "InterpolatorKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+using namespace sf;
+using namespace sf::interpolator;
+
+namespace
+{
+    /// <summary>
+    /// Calculates the positions of 8 consecutive frames relative to the integer part of the first position.
+    /// The offsets are exact in double precision so the results match stepping the 32.32 fixed-point position.
+    /// </summary>
+    struct lanes_t
+    {
+        lanes_t(uint64_t increment) noexcept
+        {
+            const double Increment = (double) increment * (1. / 4294967296.);
+
+            Offsets[0] = _mm256_set_pd(3. * Increment, 2. * Increment, Increment, 0.);
+            Offsets[1] = _mm256_set_pd(7. * Increment, 6. * Increment, 5. * Increment, 4. * Increment);
+        }
+
+        void Set(uint64_t position) noexcept
+        {
+            const __m256d Base = _mm256_set1_pd((double) (uint32_t) position * (1. / 4294967296.));
+
+            const __m256d p0 = _mm256_add_pd(Base, Offsets[0]);
+            const __m256d p1 = _mm256_add_pd(Base, Offsets[1]);
+
+            const __m256d i0 = _mm256_floor_pd(p0);
+            const __m256d i1 = _mm256_floor_pd(p1);
+
+            Fraction0 = _mm256_sub_pd(p0, i0);
+            Fraction1 = _mm256_sub_pd(p1, i1);
+
+            Index    = _mm256_add_epi32(_mm256_set_m128i(_mm256_cvttpd_epi32(i1), _mm256_cvttpd_epi32(i0)), _mm256_set1_epi32((int) (position >> 32)));
+            Fraction = _mm256_set_m128(_mm256_cvtpd_ps(Fraction1), _mm256_cvtpd_ps(Fraction0));
+        }
+
+        __m256i GetPhase() const noexcept
+        {
+            const __m256d Phases = _mm256_set1_pd((double) SincPhases);
+
+            return _mm256_set_m128i(_mm256_cvttpd_epi32(_mm256_mul_pd(Fraction1, Phases)), _mm256_cvttpd_epi32(_mm256_mul_pd(Fraction0, Phases)));
+        }
+
+        __m256d Offsets[2];
+        __m256d Fraction0;
+        __m256d Fraction1;
+
+        __m256i Index;
+        __m256 Fraction;
+    };
+
+    /// <summary>
+    /// Gathers the unscaled sample points at index and index + 1.
+    /// </summary>
+    template <bool HasLSB> inline void Gather(const interpolator_source_t & source, __m256i index, __m256 & s0, __m256 & s1) noexcept
+    {
+        const __m256i Points = _mm256_i32gather_epi32((const int *) source.Data, index, 2);
+
+        if constexpr (HasLSB)
+        {
+            const __m256i Bytes = _mm256_i32gather_epi32((const int *) source.DataLSB, index, 1);
+
+            const __m256i LSB0 = _mm256_and_si256(Bytes, _mm256_set1_epi32(0xFF));
+            const __m256i LSB1 = _mm256_and_si256(_mm256_srli_epi32(Bytes, 8), _mm256_set1_epi32(0xFF));
+
+            s0 = _mm256_cvtepi32_ps(_mm256_or_si256(_mm256_srai_epi32(_mm256_slli_epi32(Points, 16), 8), LSB0));
+            s1 = _mm256_cvtepi32_ps(_mm256_or_si256(_mm256_slli_epi32(_mm256_srai_epi32(Points, 16), 8), LSB1));
+        }
+        else
+        {
+            s0 = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(Points, 16), 16));
+            s1 = _mm256_cvtepi32_ps(_mm256_srai_epi32(Points, 16));
+        }
+    }
+
+    template <bool HasLSB> void LinearBlock(const interpolator_source_t & source, uint64_t & position, uint64_t increment, float * data, uint32_t frameCount) noexcept
+    {
+        const __m256 Scale = _mm256_set1_ps(HasLSB ? Scale24 : Scale16);
+
+        lanes_t Lanes(increment);
+
+        for (uint32_t i = 0; i < frameCount; i += 8, position += increment * 8)
+        {
+            Lanes.Set(position);
+
+            __m256 s0, s1;
+
+            Gather<HasLSB>(source, Lanes.Index, s0, s1);
+
+            const __m256 Result = _mm256_fmadd_ps(_mm256_sub_ps(s1, s0), Lanes.Fraction, s0);
+
+            _mm256_storeu_ps(data + i, _mm256_mul_ps(Result, Scale));
+        }
+    }
+
+    template <bool HasLSB> void CubicBlock(const interpolator_source_t & source, uint64_t & position, uint64_t increment, float * data, uint32_t frameCount) noexcept
+    {
+        const __m256 Scale = _mm256_set1_ps(HasLSB ? Scale24 : Scale16);
+
+        const __m256 Half    = _mm256_set1_ps(0.5f);
+        const __m256 OneHalf = _mm256_set1_ps(1.5f);
+        const __m256 TwoHalf = _mm256_set1_ps(2.5f);
+        const __m256 Two     = _mm256_set1_ps(2.f);
+
+        lanes_t Lanes(increment);
+
+        for (uint32_t i = 0; i < frameCount; i += 8, position += increment * 8)
+        {
+            Lanes.Set(position);
+
+            __m256 sm1, s0, s1, s2;
+
+            Gather<HasLSB>(source, _mm256_sub_epi32(Lanes.Index, _mm256_set1_epi32(1)), sm1, s0);
+            Gather<HasLSB>(source, _mm256_add_epi32(Lanes.Index, _mm256_set1_epi32(1)), s1, s2);
+
+            const __m256 c1 = _mm256_mul_ps(Half, _mm256_sub_ps(s1, sm1));
+            const __m256 c2 = _mm256_sub_ps(_mm256_fmadd_ps(Two, s1, _mm256_fnmadd_ps(TwoHalf, s0, sm1)), _mm256_mul_ps(Half, s2));
+            const __m256 c3 = _mm256_fmadd_ps(Half, _mm256_sub_ps(s2, sm1), _mm256_mul_ps(OneHalf, _mm256_sub_ps(s0, s1)));
+
+            const __m256 f = Lanes.Fraction;
+
+            const __m256 Result = _mm256_fmadd_ps(_mm256_fmadd_ps(_mm256_fmadd_ps(c3, f, c2), f, c1), f, s0);
+
+            _mm256_storeu_ps(data + i, _mm256_mul_ps(Result, Scale));
+        }
+    }
+
+    template <bool HasLSB> void SincBlock(const interpolator_source_t & source, uint64_t & position, uint64_t increment, float * data, uint32_t frameCount) noexcept
+    {
+        const __m256 Scale = _mm256_set1_ps(HasLSB ? Scale24 : Scale16);
+
+        const float * Table = GetSincTable();
+
+        lanes_t Lanes(increment);
+
+        for (uint32_t i = 0; i < frameCount; i += 8, position += increment * 8)
+        {
+            Lanes.Set(position);
+
+            const __m256i Row = _mm256_slli_epi32(Lanes.GetPhase(), 3); // * SincTaps
+
+            __m256 Sum = _mm256_setzero_ps();
+
+            for (int j = 0; j < (int) SincTaps; j += 2)
+            {
+                __m256 s0, s1;
+
+                Gather<HasLSB>(source, _mm256_add_epi32(Lanes.Index, _mm256_set1_epi32(j - 3)), s0, s1);
+
+                Sum = _mm256_fmadd_ps(s0, _mm256_i32gather_ps(Table + j,     Row, 4), Sum);
+                Sum = _mm256_fmadd_ps(s1, _mm256_i32gather_ps(Table + j + 1, Row, 4), Sum);
+            }
+
+            _mm256_storeu_ps(data + i, _mm256_mul_ps(Sum, Scale));
+        }
+    }
+
+    /// <summary>
+    /// Runs the vector loop over whole groups of 8 frames and the scalar kernel over the remainder.
+    /// </summary>
+    template <void (* Vector)(const interpolator_source_t &, uint64_t &, uint64_t, float *, uint32_t) noexcept, block_fn_t Scalar>
+    void Run(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+    {
+        const uint32_t Frames = frameCount & ~7u;
+
+        Vector(source, position, increment, data, Frames);
+
+        if (Frames != frameCount)
+            Scalar(source, position, increment, data + Frames, frameCount - Frames);
+    }
+}
+
+void interpolator::LinearAVX2(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+{
+    if (source.DataLSB != nullptr)
+        Run<LinearBlock<true>, LinearScalar>(source, position, increment, data, frameCount);
+    else
+        Run<LinearBlock<false>, LinearScalar>(source, position, increment, data, frameCount);
+}
+
+void interpolator::CubicAVX2(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+{
+    if (source.DataLSB != nullptr)
+        Run<CubicBlock<true>, CubicScalar>(source, position, increment, data, frameCount);
+    else
+        Run<CubicBlock<false>, CubicScalar>(source, position, increment, data, frameCount);
+}
+
+void interpolator::SincAVX2(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+{
+    if (source.DataLSB != nullptr)
+        Run<SincBlock<true>, SincScalar>(source, position, increment, data, frameCount);
+    else
+        Run<SincBlock<false>, SincScalar>(source, position, increment, data, frameCount);
+}
+
+#endif
@@ -0,0 +1,84 @@
+
+/** $VER: InterpolatorKernels.h (2026.10.18) P. Stuer - Internal interface of the sample interpolation kernels **/
+
+#pragma once
+
+#include "Interpolator.h"
+
+/*
+    A block function resamples frameCount frames without any boundary checks. The caller guarantees that every tap of every frame lies within [Start, Limit)
+    and that reads up to 2 sample points past the last tap stay within the array, because the AVX2 kernels gather 32 bits at a time.
+
+    The files with the SIMD kernels are compiled with different code generation options. Helpers shared with them must have internal linkage
+    so that the linker can't pick a copy that uses instructions the CPU doesn't support.
+*/
+
+namespace sf::interpolator
+{
+    using block_fn_t = void (*)(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+
+    constexpr uint32_t SincTaps   = 8;
+    constexpr uint32_t SincPhases = 256;    // Selected by the 8 most significant bits of the fractional position.
+
+    const float * GetSincTable() noexcept;  // SincPhases rows of SincTaps coefficients for the points at offsets -3 to +4.
+
+    void LinearScalar(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+    void CubicScalar(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+    void SincScalar(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+
+    void LinearSSE2(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+    void CubicSSE2(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+    void SincSSE2(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+
+    void LinearAVX2(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+    void CubicAVX2(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+    void SincAVX2(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+
+    void LinearNEON(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+    void CubicNEON(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+    void SincNEON(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount);
+
+    namespace
+    {
+        constexpr float Scale16 = 1.f / 32768.f;
+        constexpr float Scale24 = 1.f / 8388608.f;
+
+        /// <summary>
+        /// Reads an unscaled sample point: 16 bits, or 24 bits when the source has low bytes.
+        /// </summary>
+        template <bool HasLSB> inline float Read(const interpolator_source_t & source, size_t index) noexcept
+        {
+            if constexpr (HasLSB)
+                return (float) (((int32_t) source.Data[index] * 256) | source.DataLSB[index]);
+            else
+                return (float) source.Data[index];
+        }
+
+        inline float Linear(float s0, float s1, float f) noexcept
+        {
+            return s0 + (s1 - s0) * f;
+        }
+
+        inline float Cubic(float sm1, float s0, float s1, float s2, float f) noexcept
+        {
+            const float c1 = 0.5f * (s1 - sm1);
+            const float c2 = sm1 - 2.5f * s0 + 2.f * s1 - 0.5f * s2;
+            const float c3 = 0.5f * (s2 - sm1) + 1.5f * (s0 - s1);
+
+            return ((c3 * f + c2) * f + c1) * f + s0;
+        }
+
+        /// <summary>
+        /// Gets the fractional part of a position with the 24 bits of precision of a float.
+        /// </summary>
+        inline float GetFraction(uint64_t position) noexcept
+        {
+            return (float) (((uint32_t) position) >> 8) * (1.f / 16777216.f);
+        }
+
+        inline uint32_t GetPhase(uint64_t position) noexcept
+        {
+            return ((uint32_t) position) >> 24;
+        }
+    }
+}
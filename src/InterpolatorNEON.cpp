@@ -0,0 +1,222 @@
+
+/** $VER: InterpolatorNEON.cpp (2026.10.18) P. Stuer - NEON sample interpolation kernels **/
+
+#include "pch.h"
+
+#include "InterpolatorKernels.h"
+
+#if defined(_M_ARM64) || defined(__ARM_NEON)
+
+#include <arm_neon.h>
+
+using namespace sf;
+using namespace sf::interpolator;
+
+namespace
+{
+    /// <summary>
+    /// Combines 4 32-bit values into a vector.
+    /// </summary>
+    inline int32x4_t Combine(int32_t a, int32_t b, int32_t c, int32_t d) noexcept
+    {
+        return vcombine_s32(vset_lane_s32(b, vdup_n_s32(a), 1), vset_lane_s32(d, vdup_n_s32(c), 1));
+    }
+
+    /// <summary>
+    /// Calculates the sample point indexes and fractions of 4 consecutive frames.
+    /// </summary>
+    struct lanes_t
+    {
+        void Set(uint64_t position, uint64_t increment) noexcept
+        {
+            uint32_t Fractions[4];
+
+            for (int i = 0; i < 4; ++i, position += increment)
+            {
+                Index[i]     = (size_t) (position >> 32);
+                Phase[i]     = GetPhase(position);
+                Fractions[i] = ((uint32_t) position) >> 8; // Same precision as GetFraction()
+            }
+
+            Fraction = vmulq_n_f32(vcvtq_f32_s32(Combine((int32_t) Fractions[0], (int32_t) Fractions[1], (int32_t) Fractions[2], (int32_t) Fractions[3])), 1.f / 16777216.f);
+        }
+
+        size_t Index[4];
+        uint32_t Phase[4];
+        float32x4_t Fraction;
+    };
+
+    template <typename T> inline int32_t Load(const void * data) noexcept
+    {
+        T Value;
+
+        ::memcpy(&Value, data, sizeof(Value));
+
+        return (int32_t) Value;
+    }
+
+    /// <summary>
+    /// Loads the unscaled sample points at index + offset and index + offset + 1. Each pair is read with one 32-bit load.
+    /// </summary>
+    template <bool HasLSB> inline void Load(const interpolator_source_t & source, const lanes_t & lanes, int offset, float32x4_t & s0, float32x4_t & s1) noexcept
+    {
+        const int16_t * Data = source.Data + offset;
+
+        const int32x4_t v = Combine(Load<int32_t>(Data + lanes.Index[0]), Load<int32_t>(Data + lanes.Index[1]), Load<int32_t>(Data + lanes.Index[2]), Load<int32_t>(Data + lanes.Index[3]));
+
+        if constexpr (HasLSB)
+        {
+            const uint8_t * DataLSB = source.DataLSB + offset;
+
+            const int32x4_t b = Combine(Load<uint16_t>(DataLSB + lanes.Index[0]), Load<uint16_t>(DataLSB + lanes.Index[1]), Load<uint16_t>(DataLSB + lanes.Index[2]), Load<uint16_t>(DataLSB + lanes.Index[3]));
+
+            s0 = vcvtq_f32_s32(vorrq_s32(vshrq_n_s32(vshlq_n_s32(v, 16), 8), vandq_s32(b, vdupq_n_s32(0xFF))));
+            s1 = vcvtq_f32_s32(vorrq_s32(vshlq_n_s32(vshrq_n_s32(v, 16), 8), vshrq_n_s32(b, 8)));
+        }
+        else
+        {
+            s0 = vcvtq_f32_s32(vshrq_n_s32(vshlq_n_s32(v, 16), 16));
+            s1 = vcvtq_f32_s32(vshrq_n_s32(v, 16));
+        }
+    }
+
+    /// <summary>
+    /// Transposes a 4x4 matrix.
+    /// </summary>
+    inline void Transpose(float32x4_t & r0, float32x4_t & r1, float32x4_t & r2, float32x4_t & r3) noexcept
+    {
+        const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+
+        r0 = vcombine_f32(vget_low_f32(t01.val[0]),  vget_low_f32(t23.val[0]));
+        r1 = vcombine_f32(vget_low_f32(t01.val[1]),  vget_low_f32(t23.val[1]));
+        r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+
+    template <bool HasLSB> void LinearBlock(const interpolator_source_t & source, uint64_t & position, uint64_t increment, float * data, uint32_t frameCount) noexcept
+    {
+        const float Scale = HasLSB ? Scale24 : Scale16;
+
+        for (uint32_t i = 0; i < frameCount; i += 4, position += increment * 4)
+        {
+            lanes_t Lanes;
+
+            Lanes.Set(position, increment);
+
+            float32x4_t s0, s1;
+
+            Load<HasLSB>(source, Lanes, 0, s0, s1);
+
+            const float32x4_t Result = vmlaq_f32(s0, vsubq_f32(s1, s0), Lanes.Fraction);
+
+            vst1q_f32(data + i, vmulq_n_f32(Result, Scale));
+        }
+    }
+
+    template <bool HasLSB> void CubicBlock(const interpolator_source_t & source, uint64_t & position, uint64_t increment, float * data, uint32_t frameCount) noexcept
+    {
+        const float Scale = HasLSB ? Scale24 : Scale16;
+
+        for (uint32_t i = 0; i < frameCount; i += 4, position += increment * 4)
+        {
+            lanes_t Lanes;
+
+            Lanes.Set(position, increment);
+
+            float32x4_t s[4];
+
+            Load<HasLSB>(source, Lanes, -1, s[0], s[1]);
+            Load<HasLSB>(source, Lanes,  1, s[2], s[3]);
+
+            const float32x4_t f = Lanes.Fraction;
+
+            const float32x4_t c1 = vmulq_n_f32(vsubq_f32(s[2], s[0]), 0.5f);
+            const float32x4_t c2 = vmlsq_n_f32(vmlaq_n_f32(vmlsq_n_f32(s[0], s[1], 2.5f), s[2], 2.f), s[3], 0.5f);
+            const float32x4_t c3 = vmlaq_n_f32(vmulq_n_f32(vsubq_f32(s[3], s[0]), 0.5f), vsubq_f32(s[1], s[2]), 1.5f);
+
+            const float32x4_t Result = vmlaq_f32(s[1], vmlaq_f32(c1, vmlaq_f32(c2, c3, f), f), f);
+
+            vst1q_f32(data + i, vmulq_n_f32(Result, Scale));
+        }
+    }
+
+    template <bool HasLSB> void SincBlock(const interpolator_source_t & source, uint64_t & position, uint64_t increment, float * data, uint32_t frameCount) noexcept
+    {
+        const float Scale = HasLSB ? Scale24 : Scale16;
+
+        const float * Table = GetSincTable();
+
+        for (uint32_t i = 0; i < frameCount; i += 4, position += increment * 4)
+        {
+            lanes_t Lanes;
+
+            Lanes.Set(position, increment);
+
+            float32x4_t s[SincTaps];
+
+            for (int j = 0; j < (int) SincTaps; j += 2)
+                Load<HasLSB>(source, Lanes, j - 3, s[j], s[j + 1]);
+
+            float32x4_t Sum = vdupq_n_f32(0.f);
+
+            // Transpose the coefficients of the 4 frames to match the taps.
+            for (uint32_t j = 0; j < SincTaps; j += 4)
+            {
+                float32x4_t r0 = vld1q_f32(Table + Lanes.Phase[0] * SincTaps + j);
+                float32x4_t r1 = vld1q_f32(Table + Lanes.Phase[1] * SincTaps + j);
+                float32x4_t r2 = vld1q_f32(Table + Lanes.Phase[2] * SincTaps + j);
+                float32x4_t r3 = vld1q_f32(Table + Lanes.Phase[3] * SincTaps + j);
+
+                Transpose(r0, r1, r2, r3);
+
+                Sum = vmlaq_f32(Sum, s[j],     r0);
+                Sum = vmlaq_f32(Sum, s[j + 1], r1);
+                Sum = vmlaq_f32(Sum, s[j + 2], r2);
+                Sum = vmlaq_f32(Sum, s[j + 3], r3);
+            }
+
+            vst1q_f32(data + i, vmulq_n_f32(Sum, Scale));
+        }
+    }
+
+    /// <summary>
+    /// Runs the vector loop over whole groups of 4 frames and the scalar kernel over the remainder.
+    /// </summary>
+    template <void (* Vector)(const interpolator_source_t &, uint64_t &, uint64_t, float *, uint32_t) noexcept, block_fn_t Scalar>
+    void Run(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+    {
+        const uint32_t Frames = frameCount & ~3u;
+
+        Vector(source, position, increment, data, Frames);
+
+        if (Frames != frameCount)
+            Scalar(source, position, increment, data + Frames, frameCount - Frames);
+    }
+}
+
+void interpolator::LinearNEON(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+{
+    if (source.DataLSB != nullptr)
+        Run<LinearBlock<true>, LinearScalar>(source, position, increment, data, frameCount);
+    else
+        Run<LinearBlock<false>, LinearScalar>(source, position, increment, data, frameCount);
+}
+
+void interpolator::CubicNEON(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+{
+    if (source.DataLSB != nullptr)
+        Run<CubicBlock<true>, CubicScalar>(source, position, increment, data, frameCount);
+    else
+        Run<CubicBlock<false>, CubicScalar>(source, position, increment, data, frameCount);
+}
+
+void interpolator::SincNEON(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+{
+    if (source.DataLSB != nullptr)
+        Run<SincBlock<true>, SincScalar>(source, position, increment, data, frameCount);
+    else
+        Run<SincBlock<false>, SincScalar>(source, position, increment, data, frameCount);
+}
+
+#endif
@@ -0,0 +1,218 @@
+
+/** $VER: InterpolatorSSE2.cpp (2026.10.18) P. Stuer - SSE2 sample interpolation kernels **/
+
+#include "pch.h"
+
+#include "InterpolatorKernels.h"
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+
+#include <emmintrin.h>
+
+using namespace sf;
+using namespace sf::interpolator;
+
+namespace
+{
+    /// <summary>
+    /// Combines 4 32-bit values into a vector without going through memory, which would stall store forwarding.
+    /// </summary>
+    inline __m128i Combine(int32_t a, int32_t b, int32_t c, int32_t d) noexcept
+    {
+        return _mm_unpacklo_epi64(_mm_unpacklo_epi32(_mm_cvtsi32_si128(a), _mm_cvtsi32_si128(b)), _mm_unpacklo_epi32(_mm_cvtsi32_si128(c), _mm_cvtsi32_si128(d)));
+    }
+
+    /// <summary>
+    /// Calculates the sample point indexes and fractions of 4 consecutive frames.
+    /// </summary>
+    struct lanes_t
+    {
+        void Set(uint64_t position, uint64_t increment) noexcept
+        {
+            uint32_t Fractions[4];
+
+            for (int i = 0; i < 4; ++i, position += increment)
+            {
+                Index[i]     = (size_t) (position >> 32);
+                Phase[i]     = GetPhase(position);
+                Fractions[i] = ((uint32_t) position) >> 8; // Same precision as GetFraction()
+            }
+
+            Fraction = _mm_mul_ps(_mm_cvtepi32_ps(Combine((int32_t) Fractions[0], (int32_t) Fractions[1], (int32_t) Fractions[2], (int32_t) Fractions[3])), _mm_set1_ps(1.f / 16777216.f));
+        }
+
+        size_t Index[4];
+        uint32_t Phase[4];
+        __m128 Fraction;
+    };
+
+    template <typename T> inline int32_t Load(const void * data) noexcept
+    {
+        T Value;
+
+        ::memcpy(&Value, data, sizeof(Value));
+
+        return (int32_t) Value;
+    }
+
+    /// <summary>
+    /// Loads the unscaled sample points at index + offset and index + offset + 1. SSE2 can't gather so each pair is read with one 32-bit load.
+    /// </summary>
+    template <bool HasLSB> inline void Load(const interpolator_source_t & source, const lanes_t & lanes, int offset, __m128 & s0, __m128 & s1) noexcept
+    {
+        const int16_t * Data = source.Data + offset;
+
+        const __m128i v = Combine(Load<int32_t>(Data + lanes.Index[0]), Load<int32_t>(Data + lanes.Index[1]), Load<int32_t>(Data + lanes.Index[2]), Load<int32_t>(Data + lanes.Index[3]));
+
+        if constexpr (HasLSB)
+        {
+            const uint8_t * DataLSB = source.DataLSB + offset;
+
+            const __m128i b = Combine(Load<uint16_t>(DataLSB + lanes.Index[0]), Load<uint16_t>(DataLSB + lanes.Index[1]), Load<uint16_t>(DataLSB + lanes.Index[2]), Load<uint16_t>(DataLSB + lanes.Index[3]));
+
+            s0 = _mm_cvtepi32_ps(_mm_or_si128(_mm_srai_epi32(_mm_slli_epi32(v, 16), 8), _mm_and_si128(b, _mm_set1_epi32(0xFF))));
+            s1 = _mm_cvtepi32_ps(_mm_or_si128(_mm_slli_epi32(_mm_srai_epi32(v, 16), 8), _mm_srli_epi32(b, 8)));
+        }
+        else
+        {
+            s0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(v, 16), 16));
+            s1 = _mm_cvtepi32_ps(_mm_srai_epi32(v, 16));
+        }
+    }
+
+    template <bool HasLSB> void LinearBlock(const interpolator_source_t & source, uint64_t & position, uint64_t increment, float * data, uint32_t frameCount) noexcept
+    {
+        const __m128 Scale = _mm_set1_ps(HasLSB ? Scale24 : Scale16);
+
+        for (uint32_t i = 0; i < frameCount; i += 4, position += increment * 4)
+        {
+            lanes_t Lanes;
+
+            Lanes.Set(position, increment);
+
+            __m128 s0, s1;
+
+            Load<HasLSB>(source, Lanes, 0, s0, s1);
+
+            const __m128 Result = _mm_add_ps(s0, _mm_mul_ps(_mm_sub_ps(s1, s0), Lanes.Fraction));
+
+            _mm_storeu_ps(data + i, _mm_mul_ps(Result, Scale));
+        }
+    }
+
+    template <bool HasLSB> void CubicBlock(const interpolator_source_t & source, uint64_t & position, uint64_t increment, float * data, uint32_t frameCount) noexcept
+    {
+        const __m128 Scale = _mm_set1_ps(HasLSB ? Scale24 : Scale16);
+
+        const __m128 Half    = _mm_set1_ps(0.5f);
+        const __m128 OneHalf = _mm_set1_ps(1.5f);
+        const __m128 TwoHalf = _mm_set1_ps(2.5f);
+        const __m128 Two     = _mm_set1_ps(2.f);
+
+        for (uint32_t i = 0; i < frameCount; i += 4, position += increment * 4)
+        {
+            lanes_t Lanes;
+
+            Lanes.Set(position, increment);
+
+            __m128 s[4];
+
+            Load<HasLSB>(source, Lanes, -1, s[0], s[1]);
+            Load<HasLSB>(source, Lanes,  1, s[2], s[3]);
+
+            const __m128 f = Lanes.Fraction;
+
+            const __m128 c1 = _mm_mul_ps(Half, _mm_sub_ps(s[2], s[0]));
+            const __m128 c2 = _mm_sub_ps(_mm_add_ps(_mm_sub_ps(s[0], _mm_mul_ps(TwoHalf, s[1])), _mm_mul_ps(Two, s[2])), _mm_mul_ps(Half, s[3]));
+            const __m128 c3 = _mm_add_ps(_mm_mul_ps(Half, _mm_sub_ps(s[3], s[0])), _mm_mul_ps(OneHalf, _mm_sub_ps(s[1], s[2])));
+
+            const __m128 Result = _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(c3, f), c2), f), c1), f), s[1]);
+
+            _mm_storeu_ps(data + i, _mm_mul_ps(Result, Scale));
+        }
+    }
+
+    template <bool HasLSB> void SincBlock(const interpolator_source_t & source, uint64_t & position, uint64_t increment, float * data, uint32_t frameCount) noexcept
+    {
+        const __m128 Scale = _mm_set1_ps(HasLSB ? Scale24 : Scale16);
+
+        const float * Table = GetSincTable();
+
+        for (uint32_t i = 0; i < frameCount; i += 4, position += increment * 4)
+        {
+            lanes_t Lanes;
+
+            Lanes.Set(position, increment);
+
+            __m128 s[SincTaps];
+
+            for (int j = 0; j < (int) SincTaps; j += 2)
+                Load<HasLSB>(source, Lanes, j - 3, s[j], s[j + 1]);
+
+            // Transpose the coefficients of the 4 frames to match the taps.
+            const float * c0 = Table + Lanes.Phase[0] * SincTaps;
+            const float * c1 = Table + Lanes.Phase[1] * SincTaps;
+            const float * c2 = Table + Lanes.Phase[2] * SincTaps;
+            const float * c3 = Table + Lanes.Phase[3] * SincTaps;
+
+            __m128 Sum = _mm_setzero_ps();
+
+            for (uint32_t j = 0; j < SincTaps; j += 4)
+            {
+                __m128 r0 = _mm_loadu_ps(c0 + j);
+                __m128 r1 = _mm_loadu_ps(c1 + j);
+                __m128 r2 = _mm_loadu_ps(c2 + j);
+                __m128 r3 = _mm_loadu_ps(c3 + j);
+
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+                Sum = _mm_add_ps(Sum, _mm_mul_ps(s[j],     r0));
+                Sum = _mm_add_ps(Sum, _mm_mul_ps(s[j + 1], r1));
+                Sum = _mm_add_ps(Sum, _mm_mul_ps(s[j + 2], r2));
+                Sum = _mm_add_ps(Sum, _mm_mul_ps(s[j + 3], r3));
+            }
+
+            _mm_storeu_ps(data + i, _mm_mul_ps(Sum, Scale));
+        }
+    }
+
+    /// <summary>
+    /// Runs the vector loop over whole groups of 4 frames and the scalar kernel over the remainder.
+    /// </summary>
+    template <void (* Vector)(const interpolator_source_t &, uint64_t &, uint64_t, float *, uint32_t) noexcept, block_fn_t Scalar>
+    void Run(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+    {
+        const uint32_t Frames = frameCount & ~3u;
+
+        Vector(source, position, increment, data, Frames);
+
+        if (Frames != frameCount)
+            Scalar(source, position, increment, data + Frames, frameCount - Frames);
+    }
+}
+
+void interpolator::LinearSSE2(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+{
+    if (source.DataLSB != nullptr)
+        Run<LinearBlock<true>, LinearScalar>(source, position, increment, data, frameCount);
+    else
+        Run<LinearBlock<false>, LinearScalar>(source, position, increment, data, frameCount);
+}
+
+void interpolator::CubicSSE2(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+{
+    if (source.DataLSB != nullptr)
+        Run<CubicBlock<true>, CubicScalar>(source, position, increment, data, frameCount);
+    else
+        Run<CubicBlock<false>, CubicScalar>(source, position, increment, data, frameCount);
+}
+
+void interpolator::SincSSE2(const interpolator_source_t & source, uint64_t position, uint64_t increment, float * data, uint32_t frameCount)
+{
+    if (source.DataLSB != nullptr)
+        Run<SincBlock<true>, SincScalar>(source, position, increment, data, frameCount);
+    else
+        Run<SincBlock<false>, SincScalar>(source, position, increment, data, frameCount);
+}
+
+#endif
@@ -0,0 +1,549 @@
+
+/** $VER: MIDIScanner.cpp (2026.10.18) P. Stuer - Computes the working set of a Standard MIDI File **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "MIDIScanner.h"
+
+using namespace sf;
+
+namespace
+{
+    uint32_t ReadBE32(const uint8_t * data) noexcept { return ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | data[3]; }
+    uint32_t ReadLE32(const uint8_t * data) noexcept { return ((uint32_t) data[3] << 24) | ((uint32_t) data[2] << 16) | ((uint32_t) data[1] << 8) | data[0]; }
+    uint16_t ReadBE16(const uint8_t * data) noexcept { return (uint16_t) ((data[0] << 8) | data[1]); }
+
+    /// <summary>
+    /// Reads a variable-length quantity. Returns false if it runs past the end.
+    /// </summary>
+    bool ReadVarLen(std::span<const uint8_t> data, size_t & offset, size_t end, uint32_t & value) noexcept
+    {
+        value = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            if (offset >= end)
+                return false;
+
+            const uint8_t Byte = data[offset++];
+
+            value = (value << 7) | (Byte & 0x7F);
+
+            if ((Byte & 0x80) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    /// <summary>
+    /// Returns true if a system exclusive message (without the leading F0) starts with the specified bytes. 0xFF matches any byte, e.g. the device ID.
+    /// </summary>
+    bool IsSysEx(std::span<const uint8_t> data, std::initializer_list<uint8_t> pattern) noexcept
+    {
+        if (data.size() < pattern.size())
+            return false;
+
+        size_t i = 0;
+
+        for (const uint8_t Byte : pattern)
+        {
+            if ((Byte != 0xFF) && (data[i] != Byte))
+                return false;
+
+            ++i;
+        }
+
+        return true;
+    }
+}
+
+/// <summary>
+/// Initializes a new instance.
+/// </summary>
+midi_scanner_t::midi_scanner_t(const bank_t & bank, const midi_scanner_options_t & options) : _Bank(bank), _Resolver(bank), _Options(options), _System(options.System), _Channels(), _ActiveVoices()
+{
+    // The working set is expressed in ranges of the sample pool. A pool that is managed by a sample_residency_t keeps its layout.
+    if (!bank.SampleBlocks.empty())
+        throw sf::exception("Can't scan a bank that shares its samples");
+}
+
+/// <summary>
+/// Scans a Standard MIDI File or an RMID file.
+/// </summary>
+working_set_t midi_scanner_t::Scan(const std::filesystem::path & filePath)
+{
+    platform::mapped_file_t File;
+
+    File.Open(filePath);
+
+    return Scan(std::span<const uint8_t>(File.Data(), (size_t) File.Size()));
+}
+
+/// <summary>
+/// Scans a Standard MIDI File or an RMID file in memory.
+/// </summary>
+working_set_t midi_scanner_t::Scan(std::span<const uint8_t> data)
+{
+    const auto SMF = FindSMF(data);
+
+    if (SMF.empty())
+        throw sf::exception("Not a Standard MIDI File");
+
+    ReadTracks(SMF);
+
+    working_set_t WorkingSet = { };
+
+    _System = _Options.System;
+
+    Reset();
+
+    _Notes.clear();
+    _IsPresetUsed.assign(_Bank.Presets.size(), false);
+    _IsSampleUsed.assign(_Bank.Samples.size(), false);
+
+    for (const auto & Event : _Events)
+    {
+        const uint8_t Channel = Event.Status & 0x0F;
+
+        switch (Event.Status & 0xF0)
+        {
+            case 0x80:
+                NoteOff(Channel, Event.Data1);
+                break;
+
+            case 0x90:
+                if (Event.Data2 != 0)
+                    NoteOn(WorkingSet, Channel, Event.Data1, Event.Data2);
+                else
+                    NoteOff(Channel, Event.Data1);
+                break;
+
+            case 0xB0:
+            {
+                auto & c = _Channels[Channel];
+
+                switch (Event.Data1)
+                {
+                    case 0: c.BankMSB = Event.Data2; break;
+                    case 32: c.BankLSB = Event.Data2; break;
+
+                    case 64: // Sustain
+                    {
+                        c.IsSustained = (Event.Data2 >= 64);
+
+                        if (!c.IsSustained)
+                        {
+                            _ActiveVoices -= c.SustainedVoices;
+                            c.SustainedVoices = 0;
+                        }
+                        break;
+                    }
+
+                    case 120: // All Sound Off
+                    case 123: // All Notes Off
+                    {
+                        for (uint8_t Key = 0; Key < 128; ++Key)
+                            NoteOff(Channel, Key);
+
+                        if (Event.Data1 == 120)
+                        {
+                            _ActiveVoices -= c.SustainedVoices;
+                            c.SustainedVoices = 0;
+                        }
+                        break;
+                    }
+                }
+                break;
+            }
+
+            case 0xC0:
+                _Channels[Channel].Program = Event.Data1;
+                SetBank(Channel);
+                break;
+
+            case 0xF0:
+                ProcessSysEx(SMF.subspan(Event.DataOffset, Event.DataSize));
+                break;
+        }
+    }
+
+    Finish(WorkingSet);
+
+    return WorkingSet;
+}
+
+/// <summary>
+/// Finds the Standard MIDI File in the data, which is either an SMF or an RMID file. Returns an empty span if there is none.
+/// </summary>
+std::span<const uint8_t> midi_scanner_t::FindSMF(std::span<const uint8_t> data) noexcept
+{
+    if ((data.size() >= 4) && (::memcmp(data.data(), "MThd", 4) == 0))
+        return data;
+
+    if ((data.size() < 12) || (::memcmp(data.data(), "RIFF", 4) != 0) || (::memcmp(data.data() + 8, "RMID", 4) != 0))
+        return { };
+
+    for (size_t Offset = 12; Offset + 8 <= data.size();)
+    {
+        const size_t Size = std::min((size_t) ReadLE32(data.data() + Offset + 4), data.size() - Offset - 8);
+
+        if (::memcmp(data.data() + Offset, "data", 4) == 0)
+            return (Size >= 4) && (::memcmp(data.data() + Offset + 8, "MThd", 4) == 0) ? data.subspan(Offset + 8, Size) : std::span<const uint8_t>();
+
+        Offset += 8 + Size + (Size & 1);
+    }
+
+    return { };
+}
+
+/// <summary>
+/// Reads the events of all tracks and merges them in time order. Events at the same time keep the order of their tracks.
+/// </summary>
+void midi_scanner_t::ReadTracks(std::span<const uint8_t> data)
+{
+    if (data.size() < 14)
+        throw sf::exception("Invalid MIDI file header");
+
+    const uint32_t HeaderSize = ReadBE32(data.data() + 4);
+    const uint16_t TrackCount = ReadBE16(data.data() + 10);
+
+    if ((HeaderSize < 6) || (HeaderSize > data.size() - 8))
+        throw sf::exception("Invalid MIDI file header");
+
+    _Events.clear();
+
+    size_t Offset = 8 + (size_t) HeaderSize;
+
+    for (uint16_t i = 0; (i < TrackCount) && (Offset + 8 <= data.size());)
+    {
+        const size_t Size = std::min((size_t) ReadBE32(data.data() + Offset + 4), data.size() - Offset - 8);
+
+        // Skip unknown chunks.
+        if (::memcmp(data.data() + Offset, "MTrk", 4) == 0)
+        {
+            ReadTrack(data, Offset + 8, Size, _Events);
+            ++i;
+        }
+
+        Offset += 8 + Size;
+    }
+
+    std::stable_sort(_Events.begin(), _Events.end(), [](const event_t & a, const event_t & b) { return a.Time < b.Time; });
+}
+
+/// <summary>
+/// Reads the events of a track that affect the working set: note on, note off, control change, program change and system exclusive. A truncated track ends at the damaged event.
+/// </summary>
+void midi_scanner_t::ReadTrack(std::span<const uint8_t> data, size_t offset, size_t size, std::vector<event_t> & events)
+{
+    const size_t End = offset + size;
+
+    uint64_t Time = 0;
+    uint8_t RunningStatus = 0;
+
+    while (offset < End)
+    {
+        uint32_t Delta;
+
+        if (!ReadVarLen(data, offset, End, Delta) || (offset >= End))
+            break;
+
+        Time += Delta;
+
+        uint8_t Status = data[offset];
+
+        if (Status & 0x80)
+            ++offset;
+        else
+        if (RunningStatus != 0)
+            Status = RunningStatus;
+        else
+            break;
+
+        if ((Status == 0xFF) || (Status == 0xF0) || (Status == 0xF7))
+        {
+            uint8_t Type = 0;
+
+            if (Status == 0xFF)
+            {
+                if (offset >= End)
+                    break;
+
+                Type = data[offset++];
+            }
+
+            uint32_t Size;
+
+            if (!ReadVarLen(data, offset, End, Size) || (Size > End - offset))
+                break;
+
+            if (Status == 0xF0)
+                events.push_back({ Time, Status, 0, 0, (uint32_t) offset, Size });
+
+            offset += Size;
+
+            RunningStatus = 0;
+
+            // End of Track
+            if ((Status == 0xFF) && (Type == 0x2F))
+                break;
+
+            continue;
+        }
+
+        // System common and real-time messages are not allowed in a MIDI file.
+        if (Status >= 0xF0)
+            break;
+
+        RunningStatus = Status;
+
+        const size_t Count = ((Status & 0xE0) == 0xC0) ? 1 : 2;
+
+        if (End - offset < Count)
+            break;
+
+        const uint8_t Data1 = data[offset] & 0x7F;
+        const uint8_t Data2 = (Count == 2) ? data[offset + 1] & 0x7F : 0;
+
+        offset += Count;
+
+        const uint8_t Type = Status & 0xF0;
+
+        if ((Type == 0x80) || (Type == 0x90) || (Type == 0xB0) || (Type == 0xC0))
+            events.push_back({ Time, Status, Data1, Data2, 0, 0 });
+    }
+}
+
+/// <summary>
+/// Resets the channels to their power-on state.
+/// </summary>
+void midi_scanner_t::Reset() noexcept
+{
+    for (uint8_t i = 0; i < _countof(_Channels); ++i)
+    {
+        auto & Channel = _Channels[i];
+
+        Channel = { };
+
+        // Channel 10 plays the percussion presets.
+        Channel.IsPercussion = (i == 9);
+        Channel.BankMSB      = ((i == 9) && (_System == midi_system_t::XG)) ? 127 : 0;
+
+        SetBank(i);
+    }
+
+    _ActiveVoices = 0;
+}
+
+/// <summary>
+/// Handles the GM, GS and XG reset messages and the GS drum part message.
+/// </summary>
+void midi_scanner_t::ProcessSysEx(std::span<const uint8_t> data) noexcept
+{
+    midi_system_t System = _System;
+
+    if (IsSysEx(data, { 0x7E, 0xFF, 0x09, 0x01 }))
+        System = midi_system_t::GM;
+    else
+    if (IsSysEx(data, { 0x41, 0xFF, 0x42, 0x12, 0x40, 0x00, 0x7F, 0x00 }))
+        System = midi_system_t::GS;
+    else
+    if (IsSysEx(data, { 0x43, 0xFF, 0x4C, 0x00, 0x00, 0x7E, 0x00 }))
+        System = midi_system_t::XG;
+    else
+    {
+        // Use For Rhythm Part: 41 dev 42 12 40 1p 15 map: part p (1 - 9, 0, 10 - 15) plays a drum map unless map is 0.
+        if ((_System == midi_system_t::GS || _System == midi_system_t::Auto) && IsSysEx(data, { 0x41, 0xFF, 0x42, 0x12, 0x40 }) && (data.size() >= 8) && ((data[5] & 0xF0) == 0x10) && (data[6] == 0x15))
+        {
+            const uint8_t Part = data[5] & 0x0F;
+            const uint8_t Channel = (Part == 0) ? 9 : ((Part < 10) ? Part - 1 : Part);
+
+            _Channels[Channel].IsPercussion = (data[7] != 0);
+
+            SetBank(Channel);
+        }
+
+        return;
+    }
+
+    // A reset only changes the rules if the MIDI file selects them.
+    if (_Options.System == midi_system_t::Auto)
+        _System = System;
+
+    Reset();
+}
+
+/// <summary>
+/// Adds the regions that respond to a note to the working set and tracks the number of voices.
+/// </summary>
+void midi_scanner_t::NoteOn(working_set_t & workingSet, uint8_t channel, uint8_t key, uint8_t velocity)
+{
+    auto & Channel = _Channels[channel];
+
+    ++workingSet.NoteCount;
+
+    const int PresetIndex = _Resolver.FindPreset(Channel.Bank, Channel.Program);
+
+    if (PresetIndex < 0)
+    {
+        ++workingSet.MissingNoteCount;
+
+        return;
+    }
+
+    const uint32_t Key = ((uint32_t) PresetIndex << 16) | ((uint32_t) key << 8) | velocity;
+
+    auto it = _Notes.find(Key);
+
+    if (it == _Notes.end())
+    {
+        _Regions.clear();
+
+        _Resolver.Resolve(Channel.Bank, Channel.Program, key, velocity, _Regions);
+
+        for (const auto & Region : _Regions)
+        {
+            _IsSampleUsed[Region.SampleIndex] = true;
+
+            // A stereo voice also plays the linked sample.
+            const auto & Sample = *Region.Sample;
+
+            if ((Sample.SampleType & (RightSample | LeftSample | LinkedSample)) && (Sample.SampleLink < _Bank.Samples.size()))
+                _IsSampleUsed[Sample.SampleLink] = true;
+        }
+
+        it = _Notes.emplace(Key, (uint16_t) _Regions.size()).first;
+    }
+
+    const uint16_t VoiceCount = it->second;
+
+    if (VoiceCount == 0)
+    {
+        ++workingSet.MissingNoteCount;
+
+        return;
+    }
+
+    _IsPresetUsed[(size_t) PresetIndex] = true;
+
+    // A repeated key releases the voices of the previous note.
+    NoteOff(channel, key);
+
+    Channel.HeldVoices[key] = VoiceCount;
+
+    _ActiveVoices += VoiceCount;
+
+    workingSet.PeakVoices = std::max(workingSet.PeakVoices, _ActiveVoices);
+}
+
+/// <summary>
+/// Releases the voices of a note, unless the sustain pedal holds them.
+/// </summary>
+void midi_scanner_t::NoteOff(uint8_t channel, uint8_t key) noexcept
+{
+    auto & Channel = _Channels[channel];
+
+    if (key > 127)
+        return;
+
+    const uint16_t VoiceCount = Channel.HeldVoices[key];
+
+    Channel.HeldVoices[key] = 0;
+
+    if (Channel.IsSustained)
+        Channel.SustainedVoices += VoiceCount;
+    else
+        _ActiveVoices -= VoiceCount;
+}
+
+/// <summary>
+/// Selects the bank of a channel from its bank select controllers, like the ConvertInstruments() of a DLS collection does: 128 selects the percussion presets.
+/// </summary>
+void midi_scanner_t::SetBank(uint8_t channel) noexcept
+{
+    auto & Channel = _Channels[channel];
+
+    switch (_System)
+    {
+        case midi_system_t::GM:
+            Channel.Bank = (channel == 9) ? 128 : 0;
+            break;
+
+        case midi_system_t::XG:
+            Channel.Bank = (Channel.BankMSB >= 126) ? 128 : ((Channel.BankMSB != 0) ? Channel.BankMSB : Channel.BankLSB);
+            break;
+
+        case midi_system_t::Auto:
+        case midi_system_t::GS:
+        default:
+            Channel.Bank = Channel.IsPercussion ? 128 : Channel.BankMSB;
+            break;
+    }
+}
+
+/// <summary>
+/// Collects the presets, samples and sample data ranges of the working set.
+/// </summary>
+void midi_scanner_t::Finish(working_set_t & workingSet) const
+{
+    for (size_t i = 0; i < _IsPresetUsed.size(); ++i)
+    {
+        if (_IsPresetUsed[i])
+            workingSet.Presets.push_back((uint16_t) i);
+    }
+
+    for (uint32_t i = 0; i < (uint32_t) _IsSampleUsed.size(); ++i)
+    {
+        sample_range_t Range;
+
+        if (_IsSampleUsed[i] && _Resolver.GetSampleRange(i, Range))
+            workingSet.Samples.push_back(Range);
+    }
+
+    // Merge the sample data ranges. Samples can share data.
+    const uint64_t PointCount = _Bank.SampleData.size() / sizeof(int16_t);
+
+    std::vector<byte_range_t> Points;
+
+    for (const auto & Range : workingSet.Samples)
+    {
+        const uint64_t Start = std::min((uint64_t) Range.Start, PointCount);
+        const uint64_t End   = std::min((uint64_t) Range.End,   PointCount);
+
+        if (End > Start)
+            Points.push_back({ Start, End - Start });
+    }
+
+    std::sort(Points.begin(), Points.end(), [](const byte_range_t & a, const byte_range_t & b) { return a.Offset < b.Offset; });
+
+    std::vector<byte_range_t> Merged;
+
+    for (const auto & Range : Points)
+    {
+        if (!Merged.empty() && (Range.Offset <= Merged.back().Offset + Merged.back().Size))
+            Merged.back().Size = std::max(Merged.back().Size, Range.Offset + Range.Size - Merged.back().Offset);
+        else
+            Merged.push_back(Range);
+    }
+
+    const bool HasLSB = !_Bank.SampleDataLSB.empty() && (_Bank.SampleDataLSB.size() >= PointCount);
+
+    for (const auto & Range : Merged)
+    {
+        workingSet.SampleData.push_back({ Range.Offset * sizeof(int16_t), Range.Size * sizeof(int16_t) });
+        workingSet.SampleDataSize += Range.Size * sizeof(int16_t);
+
+        if (HasLSB)
+        {
+            workingSet.SampleDataLSB.push_back(Range);
+            workingSet.SampleDataLSBSize += Range.Size;
+        }
+    }
+
+    const uint64_t DefinitionSize = _Bank.GetMemorySize() - _Bank.SampleData.size() - _Bank.SampleDataLSB.size();
+
+    workingSet.PeakMemory = workingSet.SampleDataSize + workingSet.SampleDataLSBSize + DefinitionSize;
+}
@@ -0,0 +1,135 @@
+
+/** $VER: Metrics.cpp (2026.10.18) P. Stuer - Optional timing, I/O and allocation instrumentation **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "Metrics.h"
+
+using namespace sf;
+
+namespace
+{
+    thread_local metrics_t * CurrentMetrics = nullptr;
+    thread_local metrics_scope_t * CurrentScope = nullptr;
+    thread_local uint32_t CurrentDepth = 0;
+}
+
+/// <summary>
+/// Finds the aggregated metrics of a scope.
+/// </summary>
+const metrics_t::entry_t * metrics_t::Find(const char * name, uint32_t chunkId) const noexcept
+{
+    for (const auto & Entry : _Entries)
+    {
+        if ((Entry.ChunkId == chunkId) && ((Entry.Name == name) || (::strcmp(Entry.Name, name) == 0)))
+            return &Entry;
+    }
+
+    return nullptr;
+}
+
+/// <summary>
+/// Adds the metrics of a single execution of a scope.
+/// </summary>
+void metrics_t::Add(const event_t & event)
+{
+    auto * Entry = (entry_t *) Find(event.Name, event.ChunkId);
+
+    if (Entry == nullptr)
+    {
+        _Entries.push_back({ event.Name, event.ChunkId, 0, 0, 0, 0, 0 });
+
+        Entry = &_Entries.back();
+    }
+
+    Entry->Count          += 1;
+    Entry->Time           += event.Time;
+    Entry->Bytes          += event.Bytes;
+    Entry->Allocations    += event.Allocations;
+    Entry->AllocatedBytes += event.AllocatedBytes;
+
+    if (Callback)
+        Callback(event);
+}
+
+/// <summary>
+/// Attaches a metrics instance to the current thread. Pass nullptr to detach. Returns the previously attached instance.
+/// </summary>
+metrics_t * metrics_t::Attach(metrics_t * metrics) noexcept
+{
+    auto * Previous = CurrentMetrics;
+
+    CurrentMetrics = metrics;
+
+    return Previous;
+}
+
+/// <summary>
+/// Gets the metrics instance attached to the current thread.
+/// </summary>
+metrics_t * metrics_t::Current() noexcept
+{
+    return CurrentMetrics;
+}
+
+/// <summary>
+/// Attributes an allocation to the innermost scope of the current thread. Meant to be called from a replacement of the global operator new.
+/// </summary>
+void metrics_t::RecordAllocation(size_t size) noexcept
+{
+    if (CurrentScope != nullptr)
+        CurrentScope->AddAllocation(size);
+}
+
+/// <summary>
+/// Starts measuring a scope.
+/// </summary>
+metrics_scope_t::metrics_scope_t(const char * name, uint32_t chunkId, uint64_t bytes) noexcept : _Metrics(CurrentMetrics), _Parent(), _Name(name), _ChunkId(chunkId), _Depth(), _Bytes(bytes), _Allocations(), _AllocatedBytes()
+{
+    if (_Metrics == nullptr)
+        return;
+
+    _Parent = CurrentScope;
+    _Depth  = CurrentDepth++;
+
+    CurrentScope = this;
+
+    _Start = std::chrono::steady_clock::now();
+}
+
+/// <summary>
+/// Stops measuring a scope and reports it.
+/// </summary>
+metrics_scope_t::~metrics_scope_t()
+{
+    if (_Metrics == nullptr)
+        return;
+
+    const auto Time = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _Start).count();
+
+    --CurrentDepth;
+
+    // Scopes are inclusive.
+    if (_Parent != nullptr)
+    {
+        _Parent->_Bytes          += _Bytes;
+        _Parent->_Allocations    += _Allocations;
+        _Parent->_AllocatedBytes += _AllocatedBytes;
+    }
+
+    // Don't attribute the allocations of the instrumentation itself to any scope.
+    CurrentScope = nullptr;
+
+    try
+    {
+        _Metrics->Add({ _Name, _ChunkId, _Depth, Time, _Bytes, _Allocations, _AllocatedBytes });
+    }
+    catch (...)
+    {
+        // Instrumentation must never change the outcome of the measured code.
+    }
+
+    CurrentScope = _Parent;
+}
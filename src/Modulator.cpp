@@ -0,0 +1,392 @@
+
+/** $VER: Modulator.cpp (2026.10.18) P. Stuer - Compiles the modulators of a region to a flat program **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+using namespace sf;
+
+namespace
+{
+    constexpr size_t CurveSize = 129;           // One entry per 7-bit value plus one to interpolate 14-bit values.
+    constexpr size_t CurveCount = 16 + 1;       // Type (4) x polarity (2) x direction (2), and the 'No controller' curve.
+    constexpr size_t NoControllerCurve = 16;
+
+    /// <summary>
+    /// Calculates the output of a source curve for a 7-bit controller value (SF2.04, 8.2.1).
+    /// </summary>
+    float GetCurveValue(uint32_t type, bool isBipolar, bool isMaxToMin, int32_t value) noexcept
+    {
+        if (isMaxToMin)
+            value = 127 - value;
+
+        value = std::max(value, 0);
+
+        double y = 0.;
+
+        switch (type)
+        {
+            case 0: y = (double) value / 128.; break;                                                                                   // Linear
+            case 1: y = (value >= 127) ? 1. : -40. / 96. * std::log10(1. - (double) value / 127.); break;                               // Concave
+            case 2: y = (value <= 0) ? 0. : 1. + 40. / 96. * std::log10((double) value / 127.); break;                                  // Convex
+            case 3: y = (value >= 64) ? 1. : 0.; break;                                                                                 // Switch
+        }
+
+        y = std::clamp(y, 0., 1.);
+
+        return (float) (isBipolar ? 2. * y - 1. : y);
+    }
+
+    /// <summary>
+    /// Creates the source curves.
+    /// </summary>
+    std::vector<float> CreateCurves()
+    {
+        std::vector<float> Curves(CurveSize * CurveCount);
+
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            for (int32_t j = 0; j < (int32_t) CurveSize; ++j)
+                Curves[i * CurveSize + (size_t) j] = GetCurveValue(i >> 2, (i & 2) != 0, (i & 1) != 0, j);
+        }
+
+        // The output of 'No controller' is 1.
+        std::fill_n(Curves.begin() + NoControllerCurve * CurveSize, CurveSize, 1.f);
+
+        return Curves;
+    }
+
+    const std::vector<float> & GetCurves() noexcept
+    {
+        static const std::vector<float> Curves = CreateCurves();
+
+        return Curves;
+    }
+
+    /// <summary>
+    /// The default modulators (SF2.04, 8.4). The pitch wheel modulates fineTune because there is no initial pitch generator.
+    /// </summary>
+    const modulator_t DefaultModulators[] =
+    {
+        { 0x0502, GeneratorOperator::initialAttenuation,  960, 0x0000, 0 },  // 8.4.1 Note-On Velocity to Initial Attenuation
+        { 0x0102, GeneratorOperator::initialFilterFc,   -2400, 0x0000, 0 },  // 8.4.2 Note-On Velocity to Filter Cutoff
+        { 0x000D, GeneratorOperator::vibLfoToPitch,        50, 0x0000, 0 },  // 8.4.3 Channel Pressure to Vibrato LFO Pitch Depth
+        { 0x0081, GeneratorOperator::vibLfoToPitch,        50, 0x0000, 0 },  // 8.4.4 Continuous Controller 1 to Vibrato LFO Pitch Depth
+        { 0x0587, GeneratorOperator::initialAttenuation,  960, 0x0000, 0 },  // 8.4.5 Continuous Controller 7 to Initial Attenuation
+        { 0x028A, GeneratorOperator::pan,                1000, 0x0000, 0 },  // 8.4.6 Continuous Controller 10 to Pan Position
+        { 0x058B, GeneratorOperator::initialAttenuation,  960, 0x0000, 0 },  // 8.4.7 Continuous Controller 11 to Initial Attenuation
+        { 0x00DB, GeneratorOperator::reverbEffectsSend,   200, 0x0000, 0 },  // 8.4.8 Continuous Controller 91 to Reverb Effects Send
+        { 0x00DD, GeneratorOperator::chorusEffectsSend,   200, 0x0000, 0 },  // 8.4.9 Continuous Controller 93 to Chorus Effects Send
+        { 0x020E, GeneratorOperator::fineTune,          12700, 0x0010, 0 },  // 8.4.10 Pitch Wheel to Initial Pitch Controlled by Pitch Wheel Sensitivity
+    };
+}
+
+#pragma region modulator_inputs_t
+
+/// <summary>
+/// Sets the sources to their initial values: pitch wheel centered, a pitch wheel sensitivity of 2 semitones, and the General MIDI defaults for volume, pan and expression.
+/// </summary>
+void modulator_inputs_t::Reset() noexcept
+{
+    Values.fill(0);
+
+    Values[7]  = 100 << 7;  // Volume
+    Values[10] =  64 << 7;  // Pan
+    Values[11] = 127 << 7;  // Expression
+
+    Values[PitchWheel]            = 8192;
+    Values[PitchWheelSensitivity] = 2 << 7;
+}
+
+#pragma endregion
+
+#pragma region modulator_program_t
+
+/// <summary>
+/// Evaluates all destinations. Values is indexed by generator; only the destinations of the program are written.
+/// </summary>
+void modulator_program_t::Evaluate(const modulator_inputs_t & inputs, float * values) const noexcept
+{
+    for (const auto & Destination : _Destinations)
+        values[Destination.Generator] = Evaluate(inputs, Destination);
+}
+
+/// <summary>
+/// Re-evaluates the destinations that depend on a source after it changed. Returns a mask of the generators that were written.
+/// </summary>
+uint64_t modulator_program_t::Update(const modulator_inputs_t & inputs, uint8_t source, float * values) const noexcept
+{
+    if (!_Sources.test(source))
+        return 0;
+
+    uint64_t Mask = 0;
+
+    for (const auto & Destination : _Destinations)
+    {
+        if (!Destination.Sources.test(source))
+            continue;
+
+        values[Destination.Generator] = Evaluate(inputs, Destination);
+
+        Mask |= 1ull << Destination.Generator;
+    }
+
+    return Mask;
+}
+
+/// <summary>
+/// Adds the modulation to the generators of a region, clamping them to their limits.
+/// </summary>
+void modulator_program_t::Apply(const float * values, region_t & region) const noexcept
+{
+    for (const auto & Destination : _Destinations)
+    {
+        int32_t & Value = region.Generators[Destination.Generator];
+
+        Value = std::clamp(Value + (int32_t) std::lround(values[Destination.Generator]), Destination.Min, Destination.Max);
+    }
+}
+
+/// <summary>
+/// Gets the curve of a modulation source.
+/// </summary>
+const float * modulator_program_t::GetCurve(uint16_t source) noexcept
+{
+    const auto & Curves = GetCurves();
+
+    if (((source & 0x0080) == 0) && ((source & 0x007F) == 0))
+        return Curves.data() + NoControllerCurve * CurveSize;
+
+    return Curves.data() + (size_t) ((source >> 8) & 0x0F) * CurveSize;
+}
+
+/// <summary>
+/// Sums the operations of a destination.
+/// </summary>
+float modulator_program_t::Evaluate(const modulator_inputs_t & inputs, const destination_t & destination) const noexcept
+{
+    float Sum = 0.f;
+
+    for (const op_t * Op = _Ops.data() + destination.FirstOp, * End = Op + destination.OpCount; Op < End; ++Op)
+    {
+        const float Value = Op->Amount * Lookup(Op->SourceCurve, inputs.Values[Op->Source]) * Lookup(Op->AmountSourceCurve, inputs.Values[Op->AmountSource]);
+
+        Sum += Op->IsAbsolute ? std::abs(Value) : Value;
+    }
+
+    return Sum;
+}
+
+#pragma endregion
+
+#pragma region modulator_compiler_t
+
+/// <summary>
+/// Initializes a new instance.
+/// </summary>
+modulator_compiler_t::modulator_compiler_t(const bank_t & bank) : _Bank(bank)
+{
+}
+
+/// <summary>
+/// Gets the program of a region, compiling it the first time.
+/// </summary>
+const modulator_program_t & modulator_compiler_t::Compile(const region_t & region)
+{
+    const uint64_t Key = ((uint64_t) region.InstrumentZoneIndex << 32) | region.PresetZoneIndex;
+
+    auto [it, IsNew] = _Programs.try_emplace(Key);
+
+    auto & Program = it->second;
+
+    if (!IsNew)
+        return Program;
+
+    // Instrument level: the default modulators, overridden by the identical modulators of the global zone and then of the local zone (SF2.04, 9.5.1).
+    _Modulators.assign(std::begin(DefaultModulators), std::end(DefaultModulators));
+
+    if (region.InstrumentGlobalZoneIndex != region_t::NoZone)
+        Override(_Modulators, GetInstrumentZoneModulators(region.InstrumentGlobalZoneIndex));
+
+    Override(_Modulators, GetInstrumentZoneModulators(region.InstrumentZoneIndex));
+
+    // Preset level: the global zone overridden by the local zone, added to the instrument level.
+    _PresetModulators.clear();
+
+    if (region.PresetGlobalZoneIndex != region_t::NoZone)
+        Override(_PresetModulators, GetPresetZoneModulators(region.PresetGlobalZoneIndex));
+
+    Override(_PresetModulators, GetPresetZoneModulators(region.PresetZoneIndex));
+
+    Add(_Modulators, _PresetModulators);
+
+    // Group the operations by destination.
+    std::erase_if(_Modulators, [](const modulator_t & modulator) { return (modulator.Amount == 0) || !IsSupported(modulator); });
+
+    std::stable_sort(_Modulators.begin(), _Modulators.end(), [](const modulator_t & a, const modulator_t & b) { return a.DstOper < b.DstOper; });
+
+    const size_t Count = std::min(_Modulators.size(), (size_t) UINT16_MAX);
+
+    Program._Ops.reserve(Count);
+
+    for (size_t i = 0; i < Count; ++i)
+    {
+        const auto & Modulator = _Modulators[i];
+
+        const uint8_t Source       = GetSourceIndex(Modulator.SrcOper);
+        const uint8_t AmountSource = GetSourceIndex(Modulator.SrcOperAmt);
+
+        if (Program._Destinations.empty() || (Program._Destinations.back().Generator != Modulator.DstOper))
+        {
+            const auto Limit = GeneratorLimits.find(Modulator.DstOper);
+
+            const int32_t Min = (Limit != GeneratorLimits.end()) ? Limit->second.Min : -32768;
+            const int32_t Max = (Limit != GeneratorLimits.end()) ? Limit->second.Max :  32767;
+
+            Program._Destinations.push_back({ Modulator.DstOper, (uint16_t) i, 0, Min, Max, { } });
+        }
+
+        auto & Destination = Program._Destinations.back();
+
+        Program._Ops.push_back({ modulator_program_t::GetCurve(Modulator.SrcOper), modulator_program_t::GetCurve(Modulator.SrcOperAmt), (float) Modulator.Amount, Source, AmountSource, Modulator.TransformOper == 2 });
+
+        Destination.OpCount++;
+
+        // 'No controller' is constant.
+        if (Source != modulator_inputs_t::GeneralController)
+            Destination.Sources.set(Source);
+
+        if (AmountSource != modulator_inputs_t::GeneralController)
+            Destination.Sources.set(AmountSource);
+
+        Program._Sources |= Destination.Sources;
+    }
+
+    return Program;
+}
+
+/// <summary>
+/// Gets the default modulators.
+/// </summary>
+std::span<const modulator_t> modulator_compiler_t::GetDefaultModulators() noexcept
+{
+    return DefaultModulators;
+}
+
+/// <summary>
+/// Replaces the amount of the identical modulators in the list with those of a zone and adds the others. A modulator that occurs more than once in the zone only counts the first time (SF2.04, 9.4).
+/// </summary>
+void modulator_compiler_t::Override(std::vector<modulator_t> & modulators, std::span<const modulator_t> zoneModulators)
+{
+    const size_t First = modulators.size();
+
+    for (size_t i = 0; i < zoneModulators.size(); ++i)
+    {
+        const auto & ZoneModulator = zoneModulators[i];
+
+        if (std::any_of(zoneModulators.begin(), zoneModulators.begin() + (ptrdiff_t) i, [&](const modulator_t & m) { return IsIdentical(m, ZoneModulator); }))
+            continue;
+
+        auto it = std::find_if(modulators.begin(), modulators.begin() + (ptrdiff_t) First, [&](const modulator_t & m) { return IsIdentical(m, ZoneModulator); });
+
+        if (it != modulators.begin() + (ptrdiff_t) First)
+            it->Amount = ZoneModulator.Amount;
+        else
+            modulators.push_back(ZoneModulator);
+    }
+}
+
+/// <summary>
+/// Adds the amount of the identical modulators to the list and adds the others.
+/// </summary>
+void modulator_compiler_t::Add(std::vector<modulator_t> & modulators, std::span<const modulator_t> zoneModulators)
+{
+    const size_t First = modulators.size();
+
+    for (const auto & ZoneModulator : zoneModulators)
+    {
+        auto it = std::find_if(modulators.begin(), modulators.begin() + (ptrdiff_t) First, [&](const modulator_t & m) { return IsIdentical(m, ZoneModulator); });
+
+        if (it != modulators.begin() + (ptrdiff_t) First)
+            it->Amount = (int16_t) std::clamp((int32_t) it->Amount + ZoneModulator.Amount, -32768, 32767);
+        else
+            modulators.push_back(ZoneModulator);
+    }
+}
+
+/// <summary>
+/// Returns true if two modulators have the same sources, destination and transform (SF2.04, 9.5.1).
+/// </summary>
+bool modulator_compiler_t::IsIdentical(const modulator_t & a, const modulator_t & b) noexcept
+{
+    return (a.SrcOper == b.SrcOper) && (a.DstOper == b.DstOper) && (a.SrcOperAmt == b.SrcOperAmt) && (a.TransformOper == b.TransformOper);
+}
+
+/// <summary>
+/// Returns true if the modulator can be evaluated. Linked modulators are not supported.
+/// </summary>
+bool modulator_compiler_t::IsSupported(const modulator_t & modulator) noexcept
+{
+    if (((size_t) modulator.DstOper >= region_t::GeneratorCount) || (modulator.DstOper == GeneratorOperator::instrument) || (modulator.DstOper == GeneratorOperator::sampleID))
+        return false;
+
+    if ((modulator.TransformOper != 0) && (modulator.TransformOper != 2))
+        return false;
+
+    return IsValidSource(modulator.SrcOper) && IsValidSource(modulator.SrcOperAmt);
+}
+
+/// <summary>
+/// Returns true if the source is defined by SF2.04, 8.2. The output of another modulator (Link) is not supported.
+/// </summary>
+bool modulator_compiler_t::IsValidSource(uint16_t source) noexcept
+{
+    if ((source >> 10) > 3) // Reserved curve type
+        return false;
+
+    const uint16_t Index = source & 0x007F;
+
+    if (source & 0x0080)
+        return (Index != 0) && (Index != 6) && ((Index < 32) || (Index > 63)) && ((Index < 98) || (Index > 101)) && (Index < 120);
+
+    return (Index == 0) || (Index == 2) || (Index == 3) || (Index == 10) || (Index == 13) || (Index == 14) || (Index == 16);
+}
+
+/// <summary>
+/// Gets the index of a source in modulator_inputs_t::Values.
+/// </summary>
+uint8_t modulator_compiler_t::GetSourceIndex(uint16_t source) noexcept
+{
+    return (uint8_t) ((source & 0x0080) ? (source & 0x007F) : modulator_inputs_t::GeneralController + (source & 0x007F));
+}
+
+/// <summary>
+/// Gets the modulators of the specified preset zone.
+/// </summary>
+std::span<const modulator_t> modulator_compiler_t::GetPresetZoneModulators(uint32_t zoneIndex) const noexcept
+{
+    if ((size_t) zoneIndex + 1 >= _Bank.PresetZones.size())
+        return { };
+
+    const size_t First = std::min((size_t) _Bank.PresetZones[zoneIndex].ModulatorIndex, _Bank.PresetModulators.size());
+    const size_t Last  = std::clamp((size_t) _Bank.PresetZones[zoneIndex + 1].ModulatorIndex, First, _Bank.PresetModulators.size());
+
+    return std::span<const modulator_t>(_Bank.PresetModulators.data() + First, Last - First);
+}
+
+/// <summary>
+/// Gets the modulators of the specified instrument zone.
+/// </summary>
+std::span<const modulator_t> modulator_compiler_t::GetInstrumentZoneModulators(uint32_t zoneIndex) const noexcept
+{
+    if ((size_t) zoneIndex + 1 >= _Bank.InstrumentZones.size())
+        return { };
+
+    const size_t First = std::min((size_t) _Bank.InstrumentZones[zoneIndex].ModulatorIndex, _Bank.InstrumentModulators.size());
+    const size_t Last  = std::clamp((size_t) _Bank.InstrumentZones[zoneIndex + 1].ModulatorIndex, First, _Bank.InstrumentModulators.size());
+
+    return std::span<const modulator_t>(_Bank.InstrumentModulators.data() + First, Last - First);
+}
+
+#pragma endregion
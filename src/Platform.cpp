@@ -0,0 +1,523 @@
+
+/** $VER: Platform.cpp (2026.10.18) P. Stuer - Isolates the platform-specific parts of the library **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "Platform.h"
+
+#include <time.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cstddef>
+
+static_assert((sizeof(sf::platform::io_vector_t) == sizeof(iovec)) && (offsetof(sf::platform::io_vector_t, Data) == offsetof(iovec, iov_base)) && (offsetof(sf::platform::io_vector_t, Size) == offsetof(iovec, iov_len)));
+#endif
+
+using namespace sf;
+
+/// <summary>
+/// Gets the current local date and time as "yyyy-MM-dd HH:mm:ss".
+/// </summary>
+std::string platform::GetLocalDateTime()
+{
+#ifdef _WIN32
+    SYSTEMTIME st = {};
+
+    ::GetLocalTime(&st);
+
+    char Date[32] = { };
+    char Time[32] = { };
+
+    ::GetDateFormatA(LOCALE_USER_DEFAULT, 0, &st, "yyyy-MM-dd", Date, sizeof(Date));
+    ::GetTimeFormatA(LOCALE_USER_DEFAULT, 0, &st, "HH:mm:ss", Time, sizeof(Time));
+
+    return std::string(Date) + " " + std::string(Time);
+#else
+    const time_t Now = ::time(nullptr);
+
+    struct tm tm = { };
+
+    ::localtime_r(&Now, &tm);
+
+    char Text[32] = { };
+
+    ::strftime(Text, sizeof(Text), "%Y-%m-%d %H:%M:%S", &tm);
+
+    return std::string(Text);
+#endif
+}
+
+/// <summary>
+/// Converts a GUID to its registry format, e.g. "{1A2B3C4D-0000-0000-0000-000000000000}".
+/// </summary>
+std::string platform::ToString(const guid_t & guid)
+{
+    char Text[40] = { };
+
+    ::snprintf(Text, sizeof(Text), "{%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X}", guid.Data1, guid.Data2, guid.Data3,
+        guid.Data4[0], guid.Data4[1], guid.Data4[2], guid.Data4[3], guid.Data4[4], guid.Data4[5], guid.Data4[6], guid.Data4[7]);
+
+    return std::string(Text);
+}
+
+/// <summary>
+/// Detects the best instruction set supported by both the CPU and the operating system.
+/// </summary>
+instruction_set_t platform::GetInstructionSet() noexcept
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    static const instruction_set_t InstructionSet = []() noexcept
+    {
+#ifdef _MSC_VER
+        int Info[4] = { };
+
+        ::__cpuid(Info, 0);
+
+        if (Info[0] >= 7)
+        {
+            ::__cpuid(Info, 1);
+
+            const bool HasFMA     = (Info[2] & (1 << 12)) != 0;
+            const bool HasOSXSAVE = (Info[2] & (1 << 27)) != 0;
+            const bool HasAVX     = (Info[2] & (1 << 28)) != 0;
+
+            ::__cpuidex(Info, 7, 0);
+
+            const bool HasAVX2 = (Info[1] & (1 << 5)) != 0;
+
+            // The OS must save the YMM registers on a context switch.
+            if (HasAVX && HasAVX2 && HasFMA && HasOSXSAVE && ((::_xgetbv(0) & 0x06) == 0x06))
+                return instruction_set_t::AVX2;
+        }
+#else
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return instruction_set_t::AVX2;
+#endif
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+        return instruction_set_t::SSE2;
+#else
+        return instruction_set_t::Scalar;
+#endif
+    }();
+
+    return InstructionSet;
+#elif defined(_M_ARM64) || defined(__ARM_NEON)
+    return instruction_set_t::NEON;
+#else
+    return instruction_set_t::Scalar;
+#endif
+}
+
+/// <summary>
+/// Gets the name of an instruction set.
+/// </summary>
+const char * platform::GetInstructionSetName(instruction_set_t instructionSet) noexcept
+{
+    switch (instructionSet)
+    {
+        case instruction_set_t::SSE2:   return "SSE2";
+        case instruction_set_t::AVX2:   return "AVX2";
+        case instruction_set_t::NEON:   return "NEON";
+        default:                        return "Scalar";
+    }
+}
+
+/// <summary>
+/// Gets the size of a page of virtual memory.
+/// </summary>
+size_t platform::GetPageSize() noexcept
+{
+    static const size_t PageSize = []
+    {
+#ifdef _WIN32
+        SYSTEM_INFO si = { };
+
+        ::GetSystemInfo(&si);
+
+        return (size_t) si.dwPageSize;
+#else
+        const long Size = ::sysconf(_SC_PAGESIZE);
+
+        return (Size > 0) ? (size_t) Size : (size_t) 4096;
+#endif
+    }();
+
+    return PageSize;
+}
+
+/// <summary>
+/// Releases the physical memory of the whole pages in a range. The pages of a read-only file mapping are read from the file again when they are accessed.
+/// On POSIX systems private pages read as zeros afterwards; on Windows they are only removed from the working set.
+/// </summary>
+void platform::DiscardPages(const void * data, size_t size) noexcept
+{
+    const uintptr_t PageSize = GetPageSize();
+
+    const uintptr_t First = ((uintptr_t) data + PageSize - 1) & ~(PageSize - 1);
+    const uintptr_t Last  = ((uintptr_t) data + size) & ~(PageSize - 1);
+
+    if (Last <= First)
+        return;
+
+#ifdef _WIN32
+    // Unlocking pages that aren't locked removes them from the working set.
+    ::VirtualUnlock((void *) First, Last - First);
+#else
+    ::madvise((void *) First, Last - First, MADV_DONTNEED);
+#endif
+}
+
+/// <summary>
+/// Asks the system to read the pages of a range of a file mapping in the background.
+/// </summary>
+void platform::PrefetchPages(const void * data, size_t size) noexcept
+{
+    const uintptr_t PageSize = GetPageSize();
+
+    const uintptr_t First = (uintptr_t) data & ~(PageSize - 1);
+    const uintptr_t Last  = ((uintptr_t) data + size + PageSize - 1) & ~(PageSize - 1);
+
+    if (Last <= First)
+        return;
+
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY Range = { (void *) First, Last - First };
+
+    ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &Range, 0);
+#else
+    ::madvise((void *) First, Last - First, MADV_WILLNEED);
+#endif
+}
+
+/// <summary>
+/// Takes over the mapping of another instance.
+/// </summary>
+platform::mapped_file_t & platform::mapped_file_t::operator=(mapped_file_t && other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+
+        _Data   = other._Data;
+        _Size   = other._Size;
+        _Handle = other._Handle;
+
+        other._Data   = nullptr;
+        other._Size   = 0;
+        other._Handle = nullptr;
+    }
+
+    return *this;
+}
+
+/// <summary>
+/// Maps the complete file into memory. An empty file results in an open mapping without data.
+/// </summary>
+void platform::mapped_file_t::Open(const std::filesystem::path & filePath)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE hFile = ::CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+        throw sf::exception(msc::FormatText("Failed to open \"%s\" (0x%08X)", (const char *) filePath.u8string().c_str(), ::GetLastError()));
+
+    LARGE_INTEGER FileSize = { };
+
+    if (!::GetFileSizeEx(hFile, &FileSize))
+    {
+        const DWORD LastError = ::GetLastError();
+
+        ::CloseHandle(hFile);
+
+        throw sf::exception(msc::FormatText("Failed to get the size of \"%s\" (0x%08X)", (const char *) filePath.u8string().c_str(), LastError));
+    }
+
+    _Size = (uint64_t) FileSize.QuadPart;
+
+    if (_Size == 0)
+    {
+        ::CloseHandle(hFile);
+
+        _Handle = INVALID_HANDLE_VALUE;
+
+        return;
+    }
+
+    HANDLE hMapping = ::CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    const DWORD LastError = ::GetLastError();
+
+    ::CloseHandle(hFile); // The mapping keeps the file open.
+
+    if (hMapping == nullptr)
+    {
+        _Size = 0;
+
+        throw sf::exception(msc::FormatText("Failed to map \"%s\" (0x%08X)", (const char *) filePath.u8string().c_str(), LastError));
+    }
+
+    _Data = (const uint8_t *) ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (_Data == nullptr)
+    {
+        const DWORD Error = ::GetLastError();
+
+        ::CloseHandle(hMapping);
+
+        _Size = 0;
+
+        throw sf::exception(msc::FormatText("Failed to map \"%s\" (0x%08X)", (const char *) filePath.u8string().c_str(), Error));
+    }
+
+    _Handle = hMapping;
+#else
+    const int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1)
+        throw sf::exception(msc::FormatText("Failed to open \"%s\" (%s)", (const char *) filePath.u8string().c_str(), ::strerror(errno)));
+
+    struct stat st = { };
+
+    if (::fstat(fd, &st) == -1)
+    {
+        const int Error = errno;
+
+        ::close(fd);
+
+        throw sf::exception(msc::FormatText("Failed to get the size of \"%s\" (%s)", (const char *) filePath.u8string().c_str(), ::strerror(Error)));
+    }
+
+    _Size = (uint64_t) st.st_size;
+
+    if (_Size == 0)
+    {
+        ::close(fd);
+
+        _Handle = (void *) -1; // Marks the instance as open.
+
+        return;
+    }
+
+    void * Data = ::mmap(nullptr, (size_t) _Size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    const int Error = errno;
+
+    ::close(fd); // The mapping keeps the file open.
+
+    if (Data == MAP_FAILED)
+    {
+        _Size = 0;
+
+        throw sf::exception(msc::FormatText("Failed to map \"%s\" (%s)", (const char *) filePath.u8string().c_str(), ::strerror(Error)));
+    }
+
+    _Data = (const uint8_t *) Data;
+#endif
+}
+
+/// <summary>
+/// Unmaps the file.
+/// </summary>
+void platform::mapped_file_t::Close() noexcept
+{
+#ifdef _WIN32
+    if (_Data != nullptr)
+        ::UnmapViewOfFile(_Data);
+
+    if ((_Handle != nullptr) && (_Handle != INVALID_HANDLE_VALUE))
+        ::CloseHandle(_Handle);
+#else
+    if (_Data != nullptr)
+        ::munmap((void *) _Data, (size_t) _Size);
+#endif
+
+    _Data   = nullptr;
+    _Size   = 0;
+    _Handle = nullptr;
+}
+
+/// <summary>
+/// Opens the file.
+/// </summary>
+void platform::file_t::Open(const std::filesystem::path & filePath)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE hFile = ::CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+        throw sf::exception(msc::FormatText("Failed to open \"%s\" (0x%08X)", (const char *) filePath.u8string().c_str(), ::GetLastError()));
+
+    LARGE_INTEGER FileSize = { };
+
+    if (!::GetFileSizeEx(hFile, &FileSize))
+    {
+        const DWORD LastError = ::GetLastError();
+
+        ::CloseHandle(hFile);
+
+        throw sf::exception(msc::FormatText("Failed to get the size of \"%s\" (0x%08X)", (const char *) filePath.u8string().c_str(), LastError));
+    }
+
+    _Size   = (uint64_t) FileSize.QuadPart;
+    _Handle = hFile;
+#else
+    const int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1)
+        throw sf::exception(msc::FormatText("Failed to open \"%s\" (%s)", (const char *) filePath.u8string().c_str(), ::strerror(errno)));
+
+    struct stat st = { };
+
+    if (::fstat(fd, &st) == -1)
+    {
+        const int Error = errno;
+
+        ::close(fd);
+
+        throw sf::exception(msc::FormatText("Failed to get the size of \"%s\" (%s)", (const char *) filePath.u8string().c_str(), ::strerror(Error)));
+    }
+
+    _Size   = (uint64_t) st.st_size;
+    _Handle = (void *) (intptr_t) (fd + 1);
+#endif
+}
+
+/// <summary>
+/// Closes the file.
+/// </summary>
+void platform::file_t::Close() noexcept
+{
+    if (_Handle != nullptr)
+    {
+#ifdef _WIN32
+        ::CloseHandle(_Handle);
+#else
+        ::close(Descriptor());
+#endif
+    }
+
+    _Size   = 0;
+    _Handle = nullptr;
+}
+
+/// <summary>
+/// Reads up to size bytes at the specified offset. Returns the number of bytes read, which is less than size at the end of the file or on an error.
+/// </summary>
+size_t platform::file_t::Read(uint64_t offset, void * data, size_t size) const noexcept
+{
+    size_t Total = 0;
+
+    while (Total < size)
+    {
+        const size_t Size = std::min(size - Total, (size_t) 0x40000000);
+
+#ifdef _WIN32
+        OVERLAPPED Overlapped = { };
+
+        Overlapped.Offset     = (DWORD) (offset & 0xFFFFFFFF);
+        Overlapped.OffsetHigh = (DWORD) (offset >> 32);
+
+        DWORD BytesRead = 0;
+
+        if (!::ReadFile(_Handle, (uint8_t *) data + Total, (DWORD) Size, &BytesRead, &Overlapped) || (BytesRead == 0))
+            break;
+#else
+        const ssize_t BytesRead = ::pread(Descriptor(), (uint8_t *) data + Total, Size, (off_t) offset);
+
+        if (BytesRead <= 0)
+        {
+            if ((BytesRead == -1) && (errno == EINTR))
+                continue;
+
+            break;
+        }
+#endif
+        Total  += (size_t) BytesRead;
+        offset += (uint64_t) BytesRead;
+    }
+
+    return Total;
+}
+
+/// <summary>
+/// Reads consecutive bytes at the specified offset into several buffers. Returns the total number of bytes read.
+/// </summary>
+size_t platform::file_t::Read(uint64_t offset, const io_vector_t * vectors, size_t count) const noexcept
+{
+    size_t Total = 0;
+
+#ifdef _WIN32
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t BytesRead = Read(offset + Total, vectors[i].Data, vectors[i].Size);
+
+        Total += BytesRead;
+
+        if (BytesRead != vectors[i].Size)
+            break;
+    }
+#else
+    // Continue after a partial read with the remainder of the current buffer.
+    size_t Index = 0;
+    size_t Skip = 0;
+
+    while (Index < count)
+    {
+        iovec Vectors[64];
+
+        size_t VectorCount = 0;
+
+        for (size_t i = Index; (i < count) && (VectorCount < _countof(Vectors)); ++i, ++VectorCount)
+        {
+            const size_t Offset = (i == Index) ? Skip : 0;
+
+            Vectors[VectorCount].iov_base = (uint8_t *) vectors[i].Data + Offset;
+            Vectors[VectorCount].iov_len  = vectors[i].Size - Offset;
+        }
+
+        const ssize_t BytesRead = ::preadv(Descriptor(), Vectors, (int) VectorCount, (off_t) (offset + Total));
+
+        if (BytesRead <= 0)
+        {
+            if ((BytesRead == -1) && (errno == EINTR))
+                continue;
+
+            break;
+        }
+
+        Total += (size_t) BytesRead;
+
+        // Advance to the buffer that the read ended in.
+        size_t Remaining = (size_t) BytesRead + Skip;
+
+        while ((Index < count) && (Remaining >= vectors[Index].Size))
+        {
+            Remaining -= vectors[Index].Size;
+            ++Index;
+        }
+
+        Skip = Remaining;
+    }
+#endif
+
+    return Total;
+}
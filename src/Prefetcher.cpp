@@ -0,0 +1,116 @@
+
+/** $VER: Prefetcher.cpp (2026.10.18) P. Stuer - Warms the sample data of a preset after a program change **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "Prefetcher.h"
+#include "BankCache.h"
+#include "ThreadPool.h"
+
+using namespace sf;
+
+/// <summary>
+/// Initializes a new instance that reads 16-bit sample data at the specified offset in a file, e.g. the smpl chunk of a SoundFont bank or the sample data of a bank cache.
+/// </summary>
+sample_prefetcher_t::sample_prefetcher_t(const std::filesystem::path & filePath, uint64_t dataOffset, const async_reader_options_t & options) :
+    _Reader(filePath, options), _DataOffset(dataOffset)
+{
+    _Scratch.resize(ScratchSize);
+
+    _Pool = std::make_unique<thread_pool_t>(1);
+}
+
+/// <summary>
+/// Finishes the queued prefetches.
+/// </summary>
+sample_prefetcher_t::~sample_prefetcher_t()
+{
+    _Pool.reset();
+}
+
+/// <summary>
+/// Queues the prefetch of the specified sample ranges. The future returns the number of bytes read or rethrows the error that stopped the prefetch.
+/// </summary>
+std::future<uint64_t> sample_prefetcher_t::Prefetch(std::vector<sample_range_t> ranges)
+{
+    auto Task = std::make_shared<std::packaged_task<uint64_t()>>([this, Ranges = std::move(ranges)] { return Read(Ranges); });
+
+    auto Future = Task->get_future();
+
+    _Pool->Submit([Task] { (*Task)(); });
+
+    return Future;
+}
+
+/// <summary>
+/// Queues the prefetch of the samples that the specified preset of a bank can play. A preset that doesn't exist completes immediately.
+/// </summary>
+std::future<uint64_t> sample_prefetcher_t::Prefetch(const region_resolver_t & resolver, uint16_t midiBank, uint16_t midiProgram)
+{
+    std::vector<sample_range_t> Ranges;
+
+    resolver.GetSampleRanges(midiBank, midiProgram, Ranges);
+
+    return Prefetch(std::move(Ranges));
+}
+
+/// <summary>
+/// Queues the prefetch of the samples that the specified preset of a bank cache can play. A preset that doesn't exist completes immediately.
+/// </summary>
+std::future<uint64_t> sample_prefetcher_t::Prefetch(const bank_cache_t & cache, uint16_t midiBank, uint16_t midiProgram)
+{
+    std::vector<sample_range_t> Ranges;
+
+    cache.GetSampleRanges(midiBank, midiProgram, Ranges);
+
+    return Prefetch(std::move(Ranges));
+}
+
+/// <summary>
+/// Reads the sample ranges in batches that fill the scratch buffer. Returns the number of bytes read.
+/// </summary>
+uint64_t sample_prefetcher_t::Read(const std::vector<sample_range_t> & ranges)
+{
+    uint64_t Total = 0;
+    size_t Used = 0;
+
+    const auto Flush = [this, &Total, &Used]
+    {
+        if (_Batch.empty())
+            return;
+
+        _Reader.Read(_Batch);
+
+        for (const auto & Request : _Batch)
+            Total += Request.BytesRead;
+
+        _Batch.clear();
+        Used = 0;
+    };
+
+    for (const auto & Range : ranges)
+    {
+        uint64_t Offset = _DataOffset + (uint64_t) Range.Start * sizeof(int16_t);
+        uint64_t Size   = (uint64_t) (Range.End - Range.Start) * sizeof(int16_t);
+
+        while (Size != 0)
+        {
+            if (Used == _Scratch.size())
+                Flush();
+
+            const uint32_t Chunk = (uint32_t) std::min(Size, (uint64_t) (_Scratch.size() - Used));
+
+            _Batch.push_back({ Offset, _Scratch.data() + Used, Chunk, 0 });
+
+            Used   += Chunk;
+            Offset += Chunk;
+            Size   -= Chunk;
+        }
+    }
+
+    Flush();
+
+    return Total;
+}
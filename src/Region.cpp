@@ -0,0 +1,381 @@
+
+/** $VER: Region.cpp (2026.10.18) P. Stuer - Resolves the playable regions of a bank **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "Region.h"
+
+using namespace sf;
+
+namespace
+{
+    /// <summary>
+    /// Generator defaults and limits indexed by operator.
+    /// </summary>
+    struct generator_table_t
+    {
+        generator_table_t() noexcept : Default(), Min(), Max(), IsAdditive()
+        {
+            for (size_t i = 0; i < region_t::GeneratorCount; ++i)
+            {
+                Min[i] = -32768;
+                Max[i] =  32767;
+                IsAdditive[i] = true;
+            }
+
+            for (const auto & [Operator, Limit] : GeneratorLimits)
+            {
+                if ((size_t) Operator >= region_t::GeneratorCount)
+                    continue;
+
+                Default[Operator] = Limit.Default;
+                Min[Operator]     = Limit.Min;
+                Max[Operator]     = Limit.Max;
+            }
+
+            // These generators are only valid at instrument level; a preset can't offset them (SF2.04, 8.5).
+            for (const auto Operator :
+            {
+                GeneratorOperator::startAddrsOffset, GeneratorOperator::endAddrsOffset, GeneratorOperator::startloopAddrsOffset, GeneratorOperator::endloopAddrsOffset,
+                GeneratorOperator::startAddrsCoarseOffset, GeneratorOperator::endAddrsCoarseOffset, GeneratorOperator::startloopAddrsCoarseOffset, GeneratorOperator::endloopAddrsCoarseOffset,
+                GeneratorOperator::instrument, GeneratorOperator::keyRange, GeneratorOperator::velRange, GeneratorOperator::keyNum, GeneratorOperator::velocity,
+                GeneratorOperator::sampleID, GeneratorOperator::sampleModes, GeneratorOperator::exclusiveClass, GeneratorOperator::overridingRootKey
+            })
+                IsAdditive[Operator] = false;
+        }
+
+        std::array<int32_t, region_t::GeneratorCount> Default;
+        std::array<int32_t, region_t::GeneratorCount> Min;
+        std::array<int32_t, region_t::GeneratorCount> Max;
+        std::array<bool, region_t::GeneratorCount> IsAdditive;
+    };
+
+    const generator_table_t & GetGeneratorTable() noexcept
+    {
+        static const generator_table_t Table;
+
+        return Table;
+    }
+}
+
+/// <summary>
+/// Initializes a new instance.
+/// </summary>
+region_resolver_t::region_resolver_t(const bank_t & bank) : _Bank(bank)
+{
+    // The last preset is the terminal record.
+    for (size_t i = 0; i + 1 < bank.Presets.size(); ++i)
+    {
+        const auto & Preset = bank.Presets[i];
+
+        _Presets.try_emplace(((uint32_t) Preset.MIDIBank << 16) | Preset.MIDIProgram, (uint16_t) i);
+    }
+}
+
+/// <summary>
+/// Gets the index of the preset with the specified bank and program number. Falls back to bank 0 (or program 0 for percussion) like a GM synthesizer does. Returns -1 if there is no such preset.
+/// </summary>
+int region_resolver_t::FindPreset(uint16_t midiBank, uint16_t midiProgram) const noexcept
+{
+    auto it = _Presets.find(((uint32_t) midiBank << 16) | midiProgram);
+
+    if (it == _Presets.end())
+        it = (midiBank == 128) ? _Presets.find((uint32_t) midiBank << 16) : _Presets.find(midiProgram);
+
+    return (it != _Presets.end()) ? (int) it->second : -1;
+}
+
+/// <summary>
+/// Adds the regions of the specified preset that respond to the specified key and velocity. Returns false if the preset does not exist.
+/// </summary>
+bool region_resolver_t::Resolve(uint16_t midiBank, uint16_t midiProgram, uint8_t key, uint8_t velocity, std::vector<region_t> & regions) const
+{
+    const int PresetIndex = FindPreset(midiBank, midiProgram);
+
+    if (PresetIndex < 0)
+        return false;
+
+    AddRegions((size_t) PresetIndex, key, key, velocity, velocity, regions);
+
+    return true;
+}
+
+/// <summary>
+/// Adds all regions of the specified preset, regardless of key and velocity, in the order in which Resolve() would return them.
+/// </summary>
+void region_resolver_t::GetRegions(size_t presetIndex, std::vector<region_t> & regions) const
+{
+    if (presetIndex + 1 < _Bank.Presets.size())
+        AddRegions(presetIndex, 0, 127, 0, 127, regions);
+}
+
+/// <summary>
+/// Stores the sample ranges that the specified preset can play: the samples referenced by the instrument zones of its instruments and their stereo partners.
+/// The ranges are sorted by sample index. Returns false if the preset does not exist.
+/// </summary>
+bool region_resolver_t::GetSampleRanges(uint16_t midiBank, uint16_t midiProgram, std::vector<sample_range_t> & ranges) const
+{
+    ranges.clear();
+
+    const int PresetIndex = FindPreset(midiBank, midiProgram);
+
+    if (PresetIndex < 0)
+        return false;
+
+    if (_Bank.PresetZones.empty() || _Bank.InstrumentZones.empty())
+        return true;
+
+    std::vector<uint32_t> SampleIndices;
+
+    const size_t PresetZoneFirst = _Bank.Presets[(size_t) PresetIndex].ZoneIndex;
+    const size_t PresetZoneLast  = std::min((size_t) _Bank.Presets[(size_t) PresetIndex + 1].ZoneIndex, _Bank.PresetZones.size() - 1);
+
+    for (size_t i = PresetZoneFirst; i < PresetZoneLast; ++i)
+    {
+        uint16_t InstrumentIndex = 0;
+
+        if (!HasGenerator(GetPresetZoneGenerators(i), GeneratorOperator::instrument, InstrumentIndex) || (InstrumentIndex + (size_t) 1 >= _Bank.Instruments.size()))
+            continue;
+
+        const size_t InstrumentZoneFirst = _Bank.Instruments[InstrumentIndex].ZoneIndex;
+        const size_t InstrumentZoneLast  = std::min((size_t) _Bank.Instruments[InstrumentIndex + (size_t) 1].ZoneIndex, _Bank.InstrumentZones.size() - 1);
+
+        for (size_t j = InstrumentZoneFirst; j < InstrumentZoneLast; ++j)
+        {
+            uint16_t SampleIndex = 0;
+
+            if (!HasGenerator(GetInstrumentZoneGenerators(j), GeneratorOperator::sampleID, SampleIndex) || (SampleIndex >= _Bank.Samples.size()))
+                continue;
+
+            SampleIndices.push_back(SampleIndex);
+
+            // A stereo voice also plays the linked sample.
+            const auto & Sample = _Bank.Samples[SampleIndex];
+
+            if ((Sample.SampleType & (RightSample | LeftSample | LinkedSample)) && (Sample.SampleLink < _Bank.Samples.size()))
+                SampleIndices.push_back(Sample.SampleLink);
+        }
+    }
+
+    std::sort(SampleIndices.begin(), SampleIndices.end());
+    SampleIndices.erase(std::unique(SampleIndices.begin(), SampleIndices.end()), SampleIndices.end());
+
+    for (const uint32_t SampleIndex : SampleIndices)
+    {
+        sample_range_t Range;
+
+        if (GetSampleRange(SampleIndex, Range))
+            ranges.push_back(Range);
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Gets the range of sample data points of a sample, including its guard points. Returns false if the sample has no data in the bank, e.g. a ROM sample.
+/// </summary>
+bool region_resolver_t::GetSampleRange(uint32_t sampleIndex, sample_range_t & range) const noexcept
+{
+    if (sampleIndex >= _Bank.Samples.size())
+        return false;
+
+    const auto & Sample = _Bank.Samples[sampleIndex];
+
+    if ((Sample.SampleType & 0x8000) || (Sample.End <= Sample.Start))
+        return false;
+
+    range.SampleIndex = sampleIndex;
+    range.Start       = Sample.Start - std::min(Sample.Start, _Bank.SamplePadding);
+    range.End         = Sample.End + _Bank.SamplePadding;
+
+    return true;
+}
+
+/// <summary>
+/// Adds the regions of the specified preset whose zones overlap the specified key and velocity ranges.
+/// </summary>
+void region_resolver_t::AddRegions(size_t presetIndex, uint8_t keyLo, uint8_t keyHi, uint8_t velLo, uint8_t velHi, std::vector<region_t> & regions) const
+{
+    // Both zone lists end with a terminal record.
+    if (_Bank.PresetZones.empty() || _Bank.InstrumentZones.empty())
+        return;
+
+    const auto & Table = GetGeneratorTable();
+
+    const size_t PresetZoneFirst = _Bank.Presets[presetIndex].ZoneIndex;
+    const size_t PresetZoneLast  = std::min((size_t) _Bank.Presets[presetIndex + 1].ZoneIndex, _Bank.PresetZones.size() - 1);
+
+    zone_t PresetGlobal = { };
+
+    PresetGlobal.KeyHi = 127;
+    PresetGlobal.VelHi = 127;
+
+    uint32_t PresetGlobalZoneIndex = region_t::NoZone;
+
+    for (size_t i = PresetZoneFirst; i < PresetZoneLast; ++i)
+    {
+        const auto PresetGenerators = GetPresetZoneGenerators(i);
+
+        uint16_t InstrumentIndex = 0;
+
+        if (!HasGenerator(PresetGenerators, GeneratorOperator::instrument, InstrumentIndex))
+        {
+            // Only the first zone can be a global zone.
+            if (i == PresetZoneFirst)
+            {
+                ApplyGenerators(PresetGenerators, PresetGlobal);
+
+                PresetGlobalZoneIndex = (uint32_t) i;
+            }
+
+            continue;
+        }
+
+        if (InstrumentIndex + (size_t) 1 >= _Bank.Instruments.size())
+            continue;
+
+        zone_t PresetZone = PresetGlobal;
+
+        ApplyGenerators(PresetGenerators, PresetZone);
+
+        if ((keyHi < PresetZone.KeyLo) || (keyLo > PresetZone.KeyHi) || (velHi < PresetZone.VelLo) || (velLo > PresetZone.VelHi))
+            continue;
+
+        const size_t InstrumentZoneFirst = _Bank.Instruments[InstrumentIndex].ZoneIndex;
+        const size_t InstrumentZoneLast  = std::min((size_t) _Bank.Instruments[InstrumentIndex + (size_t) 1].ZoneIndex, _Bank.InstrumentZones.size() - 1);
+
+        zone_t InstrumentGlobal = { };
+
+        InstrumentGlobal.Generators = Table.Default;
+        InstrumentGlobal.KeyHi = 127;
+        InstrumentGlobal.VelHi = 127;
+
+        uint32_t InstrumentGlobalZoneIndex = region_t::NoZone;
+
+        for (size_t j = InstrumentZoneFirst; j < InstrumentZoneLast; ++j)
+        {
+            const auto InstrumentGenerators = GetInstrumentZoneGenerators(j);
+
+            uint16_t SampleIndex = 0;
+
+            if (!HasGenerator(InstrumentGenerators, GeneratorOperator::sampleID, SampleIndex))
+            {
+                if (j == InstrumentZoneFirst)
+                {
+                    ApplyGenerators(InstrumentGenerators, InstrumentGlobal);
+
+                    InstrumentGlobalZoneIndex = (uint32_t) j;
+                }
+
+                continue;
+            }
+
+            if (SampleIndex >= _Bank.Samples.size())
+                continue;
+
+            zone_t InstrumentZone = InstrumentGlobal;
+
+            ApplyGenerators(InstrumentGenerators, InstrumentZone);
+
+            if ((keyHi < InstrumentZone.KeyLo) || (keyLo > InstrumentZone.KeyHi) || (velHi < InstrumentZone.VelLo) || (velLo > InstrumentZone.VelHi))
+                continue;
+
+            region_t Region;
+
+            Region.SampleIndex = SampleIndex;
+            Region.Sample      = &_Bank.Samples[SampleIndex];
+
+            Region.KeyLo = std::max(PresetZone.KeyLo, InstrumentZone.KeyLo);
+            Region.KeyHi = std::min(PresetZone.KeyHi, InstrumentZone.KeyHi);
+            Region.VelLo = std::max(PresetZone.VelLo, InstrumentZone.VelLo);
+            Region.VelHi = std::min(PresetZone.VelHi, InstrumentZone.VelHi);
+
+            // Disjoint preset and instrument zone ranges can only occur when the regions of all keys are requested.
+            if ((Region.KeyLo > Region.KeyHi) || (Region.VelLo > Region.VelHi))
+                continue;
+
+            Region.PresetGlobalZoneIndex     = PresetGlobalZoneIndex;
+            Region.PresetZoneIndex           = (uint32_t) i;
+            Region.InstrumentGlobalZoneIndex = InstrumentGlobalZoneIndex;
+            Region.InstrumentZoneIndex       = (uint32_t) j;
+
+            for (size_t k = 0; k < region_t::GeneratorCount; ++k)
+            {
+                int32_t Value = InstrumentZone.Generators[k];
+
+                if (Table.IsAdditive[k])
+                    Value = std::clamp(Value + PresetZone.Generators[k], Table.Min[k], Table.Max[k]);
+
+                Region.Generators[k] = Value;
+            }
+
+            regions.push_back(Region);
+        }
+    }
+}
+
+/// <summary>
+/// Applies a list of generators to a zone.
+/// </summary>
+void region_resolver_t::ApplyGenerators(std::span<const generator_t> generators, zone_t & zone) noexcept
+{
+    for (const auto & Generator : generators)
+    {
+        if (Generator.Operator == GeneratorOperator::keyRange)
+        {
+            zone.KeyLo = (uint8_t) (Generator.Amount & 0xFF);
+            zone.KeyHi = (uint8_t) ((Generator.Amount >> 8) & 0xFF);
+        }
+        else
+        if (Generator.Operator == GeneratorOperator::velRange)
+        {
+            zone.VelLo = (uint8_t) (Generator.Amount & 0xFF);
+            zone.VelHi = (uint8_t) ((Generator.Amount >> 8) & 0xFF);
+        }
+        else
+        if (Generator.Operator < region_t::GeneratorCount)
+            zone.Generators[Generator.Operator] = Generator.Amount;
+    }
+}
+
+/// <summary>
+/// Returns true if the list contains the specified generator.
+/// </summary>
+bool region_resolver_t::HasGenerator(std::span<const generator_t> generators, GeneratorOperator generator, uint16_t & value) noexcept
+{
+    for (const auto & Generator : generators)
+    {
+        if (Generator.Operator == generator)
+        {
+            value = (uint16_t) Generator.Amount;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Gets the generators of the specified preset zone.
+/// </summary>
+std::span<const generator_t> region_resolver_t::GetPresetZoneGenerators(size_t zoneIndex) const noexcept
+{
+    const size_t First = std::min((size_t) _Bank.PresetZones[zoneIndex].GeneratorIndex, _Bank.PresetGenerators.size());
+    const size_t Last  = std::clamp((size_t) _Bank.PresetZones[zoneIndex + 1].GeneratorIndex, First, _Bank.PresetGenerators.size());
+
+    return std::span<const generator_t>(_Bank.PresetGenerators.data() + First, Last - First);
+}
+
+/// <summary>
+/// Gets the generators of the specified instrument zone.
+/// </summary>
+std::span<const generator_t> region_resolver_t::GetInstrumentZoneGenerators(size_t zoneIndex) const noexcept
+{
+    const size_t First = std::min((size_t) _Bank.InstrumentZones[zoneIndex].GeneratorIndex, _Bank.InstrumentGenerators.size());
+    const size_t Last  = std::clamp((size_t) _Bank.InstrumentZones[zoneIndex + 1].GeneratorIndex, First, _Bank.InstrumentGenerators.size());
+
+    return std::span<const generator_t>(_Bank.InstrumentGenerators.data() + First, Last - First);
+}
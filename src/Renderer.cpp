@@ -0,0 +1,634 @@
+
+/** $VER: Renderer.cpp (2026.10.18) P. Stuer - Minimal offline renderer for banks **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "Renderer.h"
+
+#include <numbers>
+
+using namespace sf;
+
+/// <summary>
+/// Initializes a new instance.
+/// </summary>
+renderer_t::renderer_t(const bank_t & bank, const renderer_options_t & options) : _Bank(bank), _Options(options), _Resolver(bank), _Compiler(bank), _Articulation(options.SampleRate, std::max(options.MaxVoices, 1u)), _Filter(options.SampleRate, std::max(options.MaxVoices, 1u)), _Channels(), _Serial(), _VoiceFrameCount()
+{
+    _Options.MaxVoices = std::max(_Options.MaxVoices, 1u);
+
+    if (_Options.BankCache != nullptr)
+    {
+        const auto & Cache = *_Options.BankCache;
+
+        if (!Cache.IsOpen() || (Cache.Samples().size() != _Bank.Samples.size()) || (Cache.GetSamplePadding() != _Bank.SamplePadding))
+            throw sf::exception("The bank cache does not match the bank");
+
+        // The cache clamps the sample headers to its sample data.
+        for (size_t i = 0; i < _Bank.Samples.size(); ++i)
+        {
+            if (Cache.Samples()[i].Start != std::min(_Bank.Samples[i].Start, Cache.Samples()[i].End))
+                throw sf::exception("The bank cache does not match the bank");
+        }
+
+        _SampleData    = Cache.SampleData().data();
+        _SampleCount   = Cache.SampleData().size();
+        _SampleDataLSB = ((_SampleCount != 0) && (Cache.SampleDataLSB().size() >= _SampleCount)) ? Cache.SampleDataLSB().data() : nullptr;
+    }
+    else
+    {
+        _SampleData    = (const int16_t *) _Bank.SampleData.data();
+        _SampleCount   = _Bank.SampleData.size() / sizeof(int16_t);
+        _SampleDataLSB = ((_SampleCount != 0) && (_Bank.SampleDataLSB.size() >= _SampleCount)) ? _Bank.SampleDataLSB.data() : nullptr;
+    }
+
+    // Pages of a managed sample pool may have been discarded. Only the voices that acquire their samples can read it.
+    if ((_Options.Residency != nullptr) ? (_Options.Residency->GetSampleData() != (const uint8_t *) _SampleData) : ((_Options.BankCache == nullptr) && (_Bank.Residency.Get() != nullptr)))
+        throw sf::exception("The renderer must use the residency manager of its sample pool");
+
+    _Interpolator = GetInterpolator(_Options.Interpolation);
+
+    if (_Interpolator == nullptr)
+        throw sf::exception("Unsupported interpolation");
+
+    _Voices.reserve(_Options.MaxVoices);
+    _Modulation.resize(_Articulation.GetCapacity());
+
+    for (uint8_t i = 0; i < ChannelCount; ++i)
+    {
+        _Channels[i].Inputs.Reset();
+        _Channels[i].RPN  = 0x3FFF; // Null
+        _Channels[i].Bank = (i == 9) ? 128 : 0; // General MIDI percussion channel
+    }
+}
+
+/// <summary>
+/// Starts a voice for each region of the current preset of the channel that responds to the key and velocity.
+/// </summary>
+void renderer_t::NoteOn(uint8_t channel, uint8_t key, uint8_t velocity)
+{
+    if (velocity == 0)
+    {
+        NoteOff(channel, key);
+
+        return;
+    }
+
+    if ((channel >= ChannelCount) || (key > 127) || (velocity > 127))
+        return;
+
+    _Regions.clear();
+
+    if (!_Resolver.Resolve(_Channels[channel].Bank, _Channels[channel].Program, key, velocity, _Regions))
+        return;
+
+    // A new note stops all notes of the same exclusive class on the channel.
+    for (const auto & Region : _Regions)
+    {
+        const int32_t ExclusiveClass = Region.Get(GeneratorOperator::exclusiveClass);
+
+        if (ExclusiveClass == 0)
+            continue;
+
+        for (auto & Voice : _Voices)
+        {
+            if ((Voice.Channel == channel) && (Voice.ExclusiveClass == ExclusiveClass))
+                Voice.IsFinished = true;
+        }
+    }
+
+    for (const auto & Region : _Regions)
+        StartVoice(Region, channel, key, velocity);
+}
+
+/// <summary>
+/// Releases all voices playing the key on the channel.
+/// </summary>
+void renderer_t::NoteOff(uint8_t channel, uint8_t key) noexcept
+{
+    for (auto & Voice : _Voices)
+    {
+        if ((Voice.Channel == channel) && (Voice.Key == key) && !Voice.IsReleased)
+        {
+            Voice.IsReleased = true;
+            _Articulation.Release(Voice.Slot);
+        }
+    }
+}
+
+/// <summary>
+/// Selects the preset for the next notes on the channel.
+/// </summary>
+void renderer_t::ProgramChange(uint8_t channel, uint16_t midiBank, uint8_t program) noexcept
+{
+    if (channel >= ChannelCount)
+        return;
+
+    _Channels[channel].Bank    = midiBank;
+    _Channels[channel].Program = program;
+}
+
+/// <summary>
+/// Changes a controller of the channel and updates the voices whose modulators use it. Handles the pitch bend sensitivity (RPN 0) and Reset All Controllers.
+/// </summary>
+void renderer_t::ControlChange(uint8_t channel, uint8_t controller, uint8_t value) noexcept
+{
+    if ((channel >= ChannelCount) || (controller > 127))
+        return;
+
+    auto & Channel = _Channels[channel];
+
+    value &= 0x7F;
+
+    switch (controller)
+    {
+        case 6: // Data Entry
+        {
+            if (Channel.RPN == 0)
+                SetSource(channel, modulator_inputs_t::PitchWheelSensitivity, (uint16_t) (value << 7));
+            break;
+        }
+
+        case 100: Channel.RPN = (uint16_t) ((Channel.RPN & 0x3F80) | value); break;
+        case 101: Channel.RPN = (uint16_t) ((Channel.RPN & 0x007F) | (value << 7)); break;
+
+        case 121: // Reset All Controllers
+        {
+            Channel.Inputs.Reset();
+            Channel.RPN = 0x3FFF;
+
+            for (auto & Voice : _Voices)
+            {
+                if ((Voice.Channel != channel) || Voice.IsFinished)
+                    continue;
+
+                auto & Modulation = _Modulation[Voice.Slot];
+
+                Channel.Inputs.Values[modulator_inputs_t::Velocity]  = (uint16_t) (Modulation.Velocity << 7);
+                Channel.Inputs.Values[modulator_inputs_t::KeyNumber] = (uint16_t) (Modulation.Key << 7);
+
+                Modulation.Program->Evaluate(Channel.Inputs, Modulation.Values.data());
+
+                Modulate(Voice, ~0ull);
+            }
+            return;
+        }
+    }
+
+    SetSource(channel, controller, (uint16_t) (value << 7));
+}
+
+/// <summary>
+/// Changes the pitch wheel of the channel.
+/// </summary>
+void renderer_t::PitchBend(uint8_t channel, uint16_t value) noexcept
+{
+    if (channel >= ChannelCount)
+        return;
+
+    SetSource(channel, modulator_inputs_t::PitchWheel, std::min(value, (uint16_t) 16383));
+}
+
+/// <summary>
+/// Changes the channel pressure of the channel.
+/// </summary>
+void renderer_t::ChannelPressure(uint8_t channel, uint8_t value) noexcept
+{
+    if (channel >= ChannelCount)
+        return;
+
+    SetSource(channel, modulator_inputs_t::ChannelPressure, (uint16_t) ((value & 0x7F) << 7));
+}
+
+/// <summary>
+/// Releases all voices.
+/// </summary>
+void renderer_t::AllNotesOff() noexcept
+{
+    for (auto & Voice : _Voices)
+    {
+        Voice.IsReleased = true;
+        _Articulation.Release(Voice.Slot);
+    }
+}
+
+/// <summary>
+/// Releases the samples of the voices that are still playing.
+/// </summary>
+renderer_t::~renderer_t()
+{
+    Reset();
+}
+
+/// <summary>
+/// Stops all voices immediately.
+/// </summary>
+void renderer_t::Reset() noexcept
+{
+    for (auto & Voice : _Voices)
+        FreeVoice(Voice);
+
+    _Voices.clear();
+}
+
+/// <summary>
+/// Processes a note event.
+/// </summary>
+void renderer_t::Process(const note_event_t & event)
+{
+    switch (event.Type)
+    {
+        case note_event_type_t::NoteOn:         NoteOn(event.Channel, event.Key, event.Velocity); break;
+        case note_event_type_t::NoteOff:        NoteOff(event.Channel, event.Key); break;
+        case note_event_type_t::ProgramChange:  ProgramChange(event.Channel, event.Bank, event.Key); break;
+        case note_event_type_t::AllNotesOff:    AllNotesOff(); break;
+        case note_event_type_t::ControlChange:  ControlChange(event.Channel, event.Key, (uint8_t) event.Value); break;
+        case note_event_type_t::PitchBend:      PitchBend(event.Channel, event.Value); break;
+        case note_event_type_t::ChannelPressure: ChannelPressure(event.Channel, (uint8_t) event.Value); break;
+    }
+}
+
+/// <summary>
+/// Renders the active voices to interleaved stereo frames.
+/// </summary>
+void renderer_t::Render(float * data, size_t frameCount) noexcept
+{
+    ::memset(data, 0, frameCount * 2 * sizeof(float));
+
+    while (frameCount != 0)
+    {
+        const uint32_t Frames = (uint32_t) std::min(frameCount, (size_t) BlockSize);
+
+        _Articulation.Process(Frames);
+
+        // Render the voices in groups that are filtered together.
+        voice_t * Group[lowpass_filter_t::Lanes];
+        uint32_t Count = 0;
+
+        for (auto & Voice : _Voices)
+        {
+            if (Voice.IsFinished)
+                continue;
+
+            Group[Count++] = &Voice;
+
+            if (Count == lowpass_filter_t::Lanes)
+            {
+                RenderVoices(Group, Count, data, Frames);
+                Count = 0;
+            }
+        }
+
+        if (Count != 0)
+            RenderVoices(Group, Count, data, Frames);
+
+        // Remove the voices that finished.
+        for (auto & Voice : _Voices)
+        {
+            if (Voice.IsFinished)
+                FreeVoice(Voice);
+        }
+
+        std::erase_if(_Voices, [](const voice_t & voice) { return voice.IsFinished; });
+
+        data       += (size_t) Frames * 2;
+        frameCount -= Frames;
+    }
+}
+
+/// <summary>
+/// Renders the events to interleaved stereo frames. The events must be sorted by time. Events at or past the end of the buffer are not processed.
+/// </summary>
+void renderer_t::Render(std::span<const note_event_t> events, std::span<float> data)
+{
+    const size_t FrameCount = data.size() / 2;
+
+    size_t Frame = 0;
+
+    for (const auto & Event : events)
+    {
+        if (Event.Time >= FrameCount)
+            break;
+
+        if (Event.Time > Frame)
+        {
+            Render(data.data() + Frame * 2, (size_t) Event.Time - Frame);
+
+            Frame = (size_t) Event.Time;
+        }
+
+        Process(Event);
+    }
+
+    Render(data.data() + Frame * 2, FrameCount - Frame);
+}
+
+/// <summary>
+/// Starts a voice for a region.
+/// </summary>
+bool renderer_t::StartVoice(const region_t & region, uint8_t channel, uint8_t key, uint8_t velocity)
+{
+    const sample_t & Sample = *region.Sample;
+
+    if (Sample.SampleType & 0x8000) // ROM samples are not available.
+        return false;
+
+    const int64_t Start     = (int64_t) Sample.Start     + region.Get(GeneratorOperator::startAddrsOffset)     + 32768 * (int64_t) region.Get(GeneratorOperator::startAddrsCoarseOffset);
+    const int64_t End       = (int64_t) Sample.End       + region.Get(GeneratorOperator::endAddrsOffset)       + 32768 * (int64_t) region.Get(GeneratorOperator::endAddrsCoarseOffset);
+    const int64_t LoopStart = (int64_t) Sample.LoopStart + region.Get(GeneratorOperator::startloopAddrsOffset) + 32768 * (int64_t) region.Get(GeneratorOperator::startloopAddrsCoarseOffset);
+    const int64_t LoopEnd   = (int64_t) Sample.LoopEnd   + region.Get(GeneratorOperator::endloopAddrsOffset)   + 32768 * (int64_t) region.Get(GeneratorOperator::endloopAddrsCoarseOffset);
+
+    const int16_t * Data    = _SampleData;
+    const uint8_t * DataLSB = _SampleDataLSB;
+    size_t Count            = _SampleCount;
+    int64_t Origin          = 0;
+
+    // A shared or cached sample is read from its own block. The offsets become relative to the first point of the block.
+    sample_handle_t Block;
+
+    if (_Options.SampleCache != nullptr)
+        Block = _Options.SampleCache->Get(region.SampleIndex);
+    else
+    if (region.SampleIndex < _Bank.SampleBlocks.size())
+        Block = _Bank.SampleBlocks[region.SampleIndex];
+
+    if (Block != nullptr)
+    {
+        Data    = Block->Data();
+        DataLSB = Block->DataLSB();
+        Count   = Block->Count();
+        Origin  = _Bank.GetSampleBlockOrigin(Sample);
+    }
+    else
+    if ((_Options.SampleCache != nullptr) || !_Bank.SampleBlocks.empty())
+        return false;
+
+    const int64_t ClampedEnd = std::min(End, Origin + (int64_t) Count);
+
+    if ((Start < Origin) || (Start >= ClampedEnd))
+        return false;
+
+    const int64_t ClampedLoopStart = std::clamp(LoopStart, Start, ClampedEnd);
+    const int64_t ClampedLoopEnd   = std::clamp(LoopEnd, Start, ClampedEnd);
+
+    // A sample of the pool must be resident while the voice plays it.
+    const bool IsPinned = (_Options.Residency != nullptr) && (Block == nullptr);
+
+    if (IsPinned && !_Options.Residency->Acquire(region.SampleIndex))
+        return false;
+
+    voice_t & Voice = AllocateVoice();
+
+    Voice.ResidentSample   = IsPinned ? region.SampleIndex : UINT32_MAX;
+    Voice.Block            = std::move(Block);
+    Voice.Source.Data      = Data;
+    Voice.Source.DataLSB   = DataLSB;
+    Voice.Source.Count     = Count;
+    Voice.Source.Start     = (uint32_t) (Start - Origin);
+    Voice.Source.End       = (uint32_t) (ClampedEnd - Origin);
+    Voice.Source.LoopStart = (uint32_t) (ClampedLoopStart - Origin);
+    Voice.Source.LoopEnd   = (uint32_t) (ClampedLoopEnd - Origin);
+    Voice.Source.Padding   = 0;
+    Voice.Source.IsLooping = false;
+
+    // The guard points only surround the range of the sample header.
+    if ((Start == Sample.Start) && (ClampedEnd == Sample.End) && (ClampedLoopStart == Sample.LoopStart) && (ClampedLoopEnd == Sample.LoopEnd))
+        Voice.Source.Padding = _Bank.SamplePadding;
+
+    Voice.Position = (uint64_t) (Start - Origin) << 32;
+
+    Voice.SampleMode = (Voice.Source.LoopEnd > Voice.Source.LoopStart) ? (uint8_t) (region.Get(GeneratorOperator::sampleModes) & 3) : 0;
+
+    if (Voice.SampleMode == 2) // Reserved
+        Voice.SampleMode = 0;
+
+    // Pitch
+    const int32_t KeyNumber = (region.Get(GeneratorOperator::keyNum) >= 0) ? region.Get(GeneratorOperator::keyNum) : key;
+    const int32_t Velocity  = (region.Get(GeneratorOperator::velocity) >= 0) ? region.Get(GeneratorOperator::velocity) : velocity;
+    const int32_t RootKey   = (region.Get(GeneratorOperator::overridingRootKey) >= 0) ? region.Get(GeneratorOperator::overridingRootKey) : ((Sample.Pitch <= 127) ? Sample.Pitch : 60);
+
+    const double Cents = (double) (KeyNumber - RootKey) * region.Get(GeneratorOperator::scaleTuning) + region.Get(GeneratorOperator::coarseTune) * 100. + region.Get(GeneratorOperator::fineTune) + Sample.PitchCorrection;
+
+    const uint32_t SampleRate = (Sample.SampleRate != 0) ? Sample.SampleRate : _Options.SampleRate;
+
+    Voice.BaseIncrement = std::exp2(Cents / 1200.) * SampleRate / _Options.SampleRate;
+
+    // Modulators
+    const modulator_program_t & Program = _Compiler.Compile(region);
+
+    auto & Inputs = _Channels[channel].Inputs;
+
+    Inputs.Values[modulator_inputs_t::Velocity]  = (uint16_t) (Velocity << 7);
+    Inputs.Values[modulator_inputs_t::KeyNumber] = (uint16_t) (KeyNumber << 7);
+
+    std::array<float, region_t::GeneratorCount> Values = { };
+
+    Program.Evaluate(Inputs, Values.data());
+
+    region_t ModulatedRegion = region;
+
+    Program.Apply(Values.data(), ModulatedRegion);
+
+    Voice.Slot = _Articulation.Start(ModulatedRegion, KeyNumber);
+
+    Voice.Serial         = _Serial++;
+    Voice.ExclusiveClass = region.Get(GeneratorOperator::exclusiveClass);
+    Voice.Channel        = channel;
+    Voice.Key            = key;
+    Voice.IsReleased     = false;
+    Voice.IsFinished     = (Voice.Slot == articulation_engine_t::NoSlot);
+
+    if (Voice.IsFinished)
+        return true;
+
+    auto & Modulation = _Modulation[Voice.Slot];
+
+    Modulation.Program  = &Program;
+    Modulation.Region   = region;
+    Modulation.Values   = Values;
+    Modulation.Key      = (uint8_t) KeyNumber;
+    Modulation.Velocity = (uint8_t) Velocity;
+
+    // Attenuation, pitch, pan and the modulation depths
+    Modulate(Voice, ~0ull);
+
+    _Filter.Start(Voice.Slot);
+
+    Voice.LastGain = Voice.Gain * _Articulation.GetGain(Voice.Slot);
+
+    return true;
+}
+
+/// <summary>
+/// Gets a free voice or steals one, preferring the oldest released voice.
+/// </summary>
+renderer_t::voice_t & renderer_t::AllocateVoice() noexcept
+{
+    if (_Voices.size() < _Options.MaxVoices)
+        return _Voices.emplace_back();
+
+    voice_t * Oldest = &_Voices[0];
+
+    for (auto & Voice : _Voices)
+    {
+        if ((Voice.IsReleased > Oldest->IsReleased) || ((Voice.IsReleased == Oldest->IsReleased) && (Voice.Serial < Oldest->Serial)))
+            Oldest = &Voice;
+    }
+
+    FreeVoice(*Oldest);
+
+    return *Oldest;
+}
+
+/// <summary>
+/// Releases the articulation slot and the sample of a voice that ends or is stolen.
+/// </summary>
+void renderer_t::FreeVoice(voice_t & voice) noexcept
+{
+    _Articulation.Free(voice.Slot);
+
+    if (voice.ResidentSample != UINT32_MAX)
+    {
+        _Options.Residency->Release(voice.ResidentSample);
+
+        voice.ResidentSample = UINT32_MAX;
+    }
+
+    voice.Block = nullptr;
+}
+
+/// <summary>
+/// Changes a modulation source of a channel and re-evaluates the destinations that depend on it in each voice of the channel.
+/// </summary>
+void renderer_t::SetSource(uint8_t channel, uint8_t source, uint16_t value) noexcept
+{
+    auto & Inputs = _Channels[channel].Inputs;
+
+    if (Inputs.Values[source] == value)
+        return;
+
+    Inputs.Values[source] = value;
+
+    for (auto & Voice : _Voices)
+    {
+        if ((Voice.Channel != channel) || Voice.IsFinished)
+            continue;
+
+        auto & Modulation = _Modulation[Voice.Slot];
+
+        if (!Modulation.Program->IsAffectedBy(source))
+            continue;
+
+        Inputs.Values[modulator_inputs_t::Velocity]  = (uint16_t) (Modulation.Velocity << 7);
+        Inputs.Values[modulator_inputs_t::KeyNumber] = (uint16_t) (Modulation.Key << 7);
+
+        Modulate(Voice, Modulation.Program->Update(Inputs, source, Modulation.Values.data()));
+    }
+}
+
+/// <summary>
+/// Applies the modulation of the specified generators (a mask of generator operators) to a playing voice. Other generators only take effect when a voice starts.
+/// </summary>
+void renderer_t::Modulate(voice_t & voice, uint64_t generators) noexcept
+{
+    const auto & Modulation = _Modulation[voice.Slot];
+
+    auto IsModulated = [generators](GeneratorOperator generator) { return (generators & (1ull << generator)) != 0; };
+    auto GetValue    = [&Modulation](GeneratorOperator generator) { return (float) Modulation.Region.Get(generator) + Modulation.Values[generator]; };
+
+    if (IsModulated(GeneratorOperator::initialAttenuation))
+        voice.Gain = units::CentibelsToGain(std::clamp(GetValue(GeneratorOperator::initialAttenuation), 0.f, 1440.f));
+
+    // The modulation of the tuning is not limited to the range of the generators so that the pitch wheel can bend more than a semitone.
+    if (IsModulated(GeneratorOperator::coarseTune) || IsModulated(GeneratorOperator::fineTune))
+        voice.Increment = voice.BaseIncrement * units::CentsToRatio(Modulation.Values[GeneratorOperator::coarseTune] * 100.f + Modulation.Values[GeneratorOperator::fineTune]);
+
+    // Equal-power pan
+    if (IsModulated(GeneratorOperator::pan))
+    {
+        const double Angle = (double) (std::clamp(GetValue(GeneratorOperator::pan), -500.f, 500.f) + 500.f) / 1000. * (std::numbers::pi / 2.);
+
+        voice.GainL = (float) std::cos(Angle);
+        voice.GainR = (float) std::sin(Angle);
+    }
+
+    if (IsModulated(GeneratorOperator::initialFilterQ))
+        _Filter.SetResonance(voice.Slot, GetValue(GeneratorOperator::initialFilterQ));
+
+    for (const auto Generator :
+    {
+        GeneratorOperator::modLfoToPitch, GeneratorOperator::vibLfoToPitch, GeneratorOperator::modEnvToPitch,
+        GeneratorOperator::initialFilterFc, GeneratorOperator::modLfoToFilterFc, GeneratorOperator::modEnvToFilterFc, GeneratorOperator::modLfoToVolume
+    })
+    {
+        if (IsModulated(Generator))
+            _Articulation.SetGenerator(voice.Slot, Generator, GetValue(Generator));
+    }
+}
+
+/// <summary>
+/// Mixes a block of a group of voices into the output. The voices are interpolated, filtered together and mixed, ramping the gain over the block.
+/// </summary>
+void renderer_t::RenderVoices(voice_t * const * voices, uint32_t count, float * data, uint32_t frameCount) noexcept
+{
+    assert(count <= lowpass_filter_t::Lanes);
+
+    uint32_t Slots[lowpass_filter_t::Lanes] = { };
+    float * Buffers[lowpass_filter_t::Lanes] = { };
+    uint32_t Frames[lowpass_filter_t::Lanes] = { };
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        voice_t & Voice = *voices[i];
+
+        Voice.Source.IsLooping = Voice.IsLooping();
+
+        // The pitch modulation of the articulation engine is applied once per block.
+        const uint64_t Increment = (uint64_t) std::clamp(Voice.Increment * _Articulation.GetPitchRatio(Voice.Slot) * 4294967296., 1., 281474976710656.); // 2^48
+
+        Slots[i]   = Voice.Slot;
+        Buffers[i] = _Buffers[i];
+        Frames[i]  = _Interpolator(Voice.Source, Voice.Position, Increment, Buffers[i], frameCount);
+
+        // Silence the rest of the block of a voice that ended so that the filter sees a defined input.
+        std::fill(Buffers[i] + Frames[i], Buffers[i] + frameCount, 0.f);
+
+        _Filter.SetCutoff(Voice.Slot, _Articulation.GetFilterCutoff(Voice.Slot));
+    }
+
+    _Filter.Process(Slots, Buffers, count, frameCount);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        voice_t & Voice = *voices[i];
+
+        const float TargetGain = Voice.Gain * _Articulation.GetGain(Voice.Slot);
+
+        const float Step = (TargetGain - Voice.LastGain) / (float) frameCount;
+
+        float Gain = Voice.LastGain;
+
+        Voice.LastGain = TargetGain;
+
+        const float GainL = Voice.GainL;
+        const float GainR = Voice.GainR;
+
+        const float * Buffer = Buffers[i];
+
+        for (uint32_t j = 0; j < Frames[i]; ++j)
+        {
+            const float s = Buffer[j] * Gain;
+
+            data[j * 2]     += s * GainL;
+            data[j * 2 + 1] += s * GainR;
+
+            Gain += Step;
+        }
+
+        _VoiceFrameCount += Frames[i];
+
+        if ((Frames[i] < frameCount) || _Articulation.IsFinished(Voice.Slot))
+            Voice.IsFinished = true;
+    }
+}
@@ -1,5 +1,5 @@
 
-/** $VER: SF2Reader.cpp (2025.08.20) P. Stuer - Reads a SoundFont bank. **/
+/** $VER: SF2Reader.cpp (2026.10.18) P. Stuer - Reads a SoundFont bank. **/
 
 #include "pch.h"
 
@@ -14,9 +14,13 @@ using namespace sf;
 /// </summary>
 void reader_t::Process(bank_t & bank, const soundfont_reader_options_t & options)
 {
+    METRICS_SCOPE("sf::reader_t::Process");
+
     TRACE_RESET();
     TRACE_INDENT();
 
+    _SampleDataLSBSize = 0;
+
     uint32_t FormType;
 
     ReadHeader(FormType);
@@ -29,6 +33,8 @@ void reader_t::Process(bank_t & bank, const soundfont_reader_options_t & options
 
     std::function<bool(const riff::chunk_header_t & ch)> ChunkHandler = [this, &options, &bank, &ChunkHandler](const riff::chunk_header_t & ch) -> bool
     {
+        METRICS_CHUNK(ch);
+
         switch (ch.Id)
         {
             case FOURCC_LIST:
@@ -192,6 +198,8 @@ void reader_t::Process(bank_t & bank, const soundfont_reader_options_t & options
             {
                 TRACE_CHUNK(ch.Id, ch.Size);
 
+                _SampleDataLSBSize = ch.Size;
+
                 if (options.ReadSampleData)
                 {
                     bank.SampleDataLSB.resize((size_t) ch.Size);
@@ -1,5 +1,5 @@
 
-/** $VER: SF2Writer.cpp (2025.09.01) P. Stuer - Writes a SoundFont bank. **/
+/** $VER: SF2Writer.cpp (2026.10.18) P. Stuer - Writes a SoundFont bank. **/
 
 #include "pch.h"
 
@@ -16,6 +16,10 @@ using namespace sf;
 /// </summary>
 void writer_t::Process(const bank_t & bank, const soundfont_writer_options_t & options)
 {
+    METRICS_SCOPE("sf::writer_t::Process");
+
+    bank.CheckSamplePool("write");
+
     TRACE_RESET();
     TRACE_INDENT();
 
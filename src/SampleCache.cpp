@@ -0,0 +1,357 @@
+
+/** $VER: SampleCache.cpp (2026.10.18) P. Stuer - Compressed sample data with a cache of decoded samples **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "SampleCache.h"
+#include "Hash.h"
+
+#include <bit>
+#include <chrono>
+
+using namespace sf;
+
+namespace
+{
+    uint32_t ZigZag(int32_t value) noexcept { return ((uint32_t) value << 1) ^ (uint32_t) (value >> 31); }
+    int32_t UnZigZag(uint32_t value) noexcept { return (int32_t) (value >> 1) ^ -(int32_t) (value & 1); }
+}
+
+/// <summary>
+/// Initializes a new instance and compresses the samples of a bank. Each sample is compressed from the first to the last point that a shared sample
+/// block of the bank would hold, i.e. including its guard points. ROM samples and samples outside the sample pool are not available.
+/// </summary>
+sample_cache_t::sample_cache_t(const bank_t & bank, const sample_cache_options_t & options) : _Options(options), _Statistics()
+{
+    bank.CheckSamplePool("compress");
+
+    const int16_t * Data    = (const int16_t *) bank.SampleData.data();
+    const size_t Count      = bank.SampleData.size() / sizeof(int16_t);
+    const uint8_t * DataLSB = (bank.SampleDataLSB.size() >= Count) ? bank.SampleDataLSB.data() : nullptr;
+
+    _Samples.resize(bank.Samples.size());
+    _Entries.resize(bank.Samples.size());
+
+    for (size_t i = 0; i < bank.Samples.size(); ++i)
+    {
+        const auto & Sample = bank.Samples[i];
+
+        if ((Sample.SampleType & 0x8000) || (Sample.Start >= Sample.End) || (Sample.End > Count))
+            continue;
+
+        const size_t First = bank.GetSampleBlockOrigin(Sample);
+        const size_t Last  = std::min((size_t) Sample.End + bank.SamplePadding, Count);
+
+        auto & s = _Samples[i];
+
+        s.Count = (uint32_t) (Last - First);
+
+        Encode(Data + First, s.Count, s.Data);
+
+        hash_t Hasher;
+
+        Hasher.Update(Data + First, s.Count * sizeof(int16_t));
+
+        if (DataLSB != nullptr)
+        {
+            s.DataLSB.assign(DataLSB + First, DataLSB + Last);
+
+            Hasher.Update(s.DataLSB.data(), s.DataLSB.size());
+        }
+
+        s.Hash = Hasher.Digest();
+
+        _Statistics.CompressedSize   += s.Data.size() + s.DataLSB.size();
+        _Statistics.UncompressedSize += (uint64_t) s.Count * sizeof(int16_t) + s.DataLSB.size();
+    }
+}
+
+/// <summary>
+/// Gets a decoded sample, decoding it if it is not in the cache. Returns nullptr if the sample is not available.
+/// </summary>
+sample_handle_t sample_cache_t::Get(uint32_t sampleIndex)
+{
+    if ((sampleIndex >= _Samples.size()) || _Samples[sampleIndex].Data.empty())
+        return nullptr;
+
+    {
+        std::lock_guard Lock(_Mutex);
+
+        auto & Entry = _Entries[sampleIndex];
+
+        if (Entry.Block != nullptr)
+        {
+            _Uses.splice(_Uses.begin(), _Uses, Entry.Use);
+
+            ++_Statistics.Hits;
+
+            return Entry.Block;
+        }
+    }
+
+    // Decode outside the lock. Another thread may decode the same sample in the meantime.
+    const auto Start = std::chrono::steady_clock::now();
+
+    auto Block = DecodeSample(sampleIndex);
+
+    const auto DecodeTime = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Start).count();
+
+    std::vector<sample_handle_t> Evicted;
+
+    std::lock_guard Lock(_Mutex);
+
+    auto & Entry = _Entries[sampleIndex];
+
+    // Another thread decoded the sample first. Only the decode that was inserted counts as a miss.
+    if (Entry.Block != nullptr)
+    {
+        _Uses.splice(_Uses.begin(), _Uses, Entry.Use);
+
+        ++_Statistics.Hits;
+
+        return Entry.Block;
+    }
+
+    ++_Statistics.Misses;
+
+    _Statistics.DecodeTime += DecodeTime;
+
+    Entry.Block = Block;
+    Entry.Use   = _Uses.insert(_Uses.begin(), sampleIndex);
+
+    _Statistics.DecodedSize += Block->GetMemorySize();
+
+    // Evict the least recently used samples, except the one that was just decoded. Samples that are still playing stay valid until their voices end.
+    while ((_Statistics.DecodedSize > _Options.Budget) && (_Uses.size() > 1))
+    {
+        auto & Oldest = _Entries[_Uses.back()];
+
+        _Statistics.DecodedSize -= Oldest.Block->GetMemorySize();
+        ++_Statistics.Evictions;
+
+        Evicted.push_back(std::move(Oldest.Block));
+
+        _Uses.pop_back();
+    }
+
+    // The evicted samples are released here, outside the lock.
+    return Block;
+}
+
+/// <summary>
+/// Gets a decoded sample if it is in the cache. Never decodes.
+/// </summary>
+sample_handle_t sample_cache_t::Find(uint32_t sampleIndex)
+{
+    if (sampleIndex >= _Samples.size())
+        return nullptr;
+
+    std::lock_guard Lock(_Mutex);
+
+    auto & Entry = _Entries[sampleIndex];
+
+    if (Entry.Block == nullptr)
+        return nullptr;
+
+    _Uses.splice(_Uses.begin(), _Uses, Entry.Use);
+
+    ++_Statistics.Hits;
+
+    return Entry.Block;
+}
+
+/// <summary>
+/// Decodes the samples of the specified ranges, e.g. from region_resolver_t::GetSampleRanges(), unless they are in the cache. Returns the number of decoded samples.
+/// </summary>
+size_t sample_cache_t::Prefetch(std::span<const sample_range_t> ranges)
+{
+    size_t DecodedCount = 0;
+
+    for (const auto & Range : ranges)
+    {
+        if (Range.SampleIndex >= _Samples.size())
+            continue;
+
+        {
+            std::lock_guard Lock(_Mutex);
+
+            if (_Entries[Range.SampleIndex].Block != nullptr)
+                continue;
+        }
+
+        if (Get(Range.SampleIndex) != nullptr)
+            ++DecodedCount;
+    }
+
+    return DecodedCount;
+}
+
+/// <summary>
+/// Removes all decoded samples from the cache.
+/// </summary>
+void sample_cache_t::Clear()
+{
+    std::vector<sample_handle_t> Evicted;
+
+    std::lock_guard Lock(_Mutex);
+
+    for (const uint32_t SampleIndex : _Uses)
+        Evicted.push_back(std::move(_Entries[SampleIndex].Block));
+
+    _Uses.clear();
+
+    _Statistics.DecodedSize = 0;
+}
+
+/// <summary>
+/// Gets the counters of the cache.
+/// </summary>
+sample_cache_statistics_t sample_cache_t::GetStatistics() const
+{
+    std::lock_guard Lock(_Mutex);
+
+    return _Statistics;
+}
+
+/// <summary>
+/// Compresses 16-bit sample points. Each frame of FrameSize points stores its first point followed by the differences between successive points,
+/// zigzag-encoded and bit-packed with the smallest width that fits the largest difference of the frame.
+/// </summary>
+void sample_cache_t::Encode(const int16_t * data, size_t count, std::vector<uint8_t> & encoded)
+{
+    encoded.clear();
+    encoded.reserve(count * sizeof(int16_t) / 2);
+
+    for (size_t Offset = 0; Offset < count; Offset += FrameSize)
+    {
+        const size_t n = std::min((size_t) FrameSize, count - Offset);
+        const int16_t * Frame = data + Offset;
+
+        encoded.push_back((uint8_t) ((uint16_t) Frame[0]));
+        encoded.push_back((uint8_t) ((uint16_t) Frame[0] >> 8));
+
+        if (n == 1)
+            break;
+
+        // The combined bits of the differences have the width of the largest one.
+        uint32_t Mask = 0;
+
+        for (size_t i = 1; i < n; ++i)
+            Mask |= ZigZag((int32_t) Frame[i] - Frame[i - 1]);
+
+        const uint32_t Width = (uint32_t) std::bit_width(Mask);
+
+        encoded.push_back((uint8_t) Width);
+
+        uint64_t Bits = 0;
+        uint32_t BitCount = 0;
+
+        for (size_t i = 1; i < n; ++i)
+        {
+            Bits |= (uint64_t) ZigZag((int32_t) Frame[i] - Frame[i - 1]) << BitCount;
+            BitCount += Width;
+
+            while (BitCount >= 8)
+            {
+                encoded.push_back((uint8_t) Bits);
+
+                Bits >>= 8;
+                BitCount -= 8;
+            }
+        }
+
+        if (BitCount != 0)
+            encoded.push_back((uint8_t) Bits);
+    }
+
+    encoded.shrink_to_fit();
+}
+
+/// <summary>
+/// Decompresses the specified number of 16-bit sample points compressed by Encode().
+/// </summary>
+void sample_cache_t::Decode(const uint8_t * encoded, size_t count, int16_t * data) noexcept
+{
+    for (size_t Offset = 0; Offset < count; Offset += FrameSize)
+    {
+        const size_t n = std::min((size_t) FrameSize, count - Offset);
+        int16_t * Frame = data + Offset;
+
+        Frame[0] = (int16_t) (encoded[0] | (encoded[1] << 8));
+        encoded += 2;
+
+        if (n == 1)
+            break;
+
+        const uint32_t Width = *encoded++;
+
+        if (Width == 0)
+        {
+            std::fill(Frame + 1, Frame + n, Frame[0]);
+            continue;
+        }
+
+        const uint32_t Mask = (1u << Width) - 1;
+
+        const uint8_t * End = encoded + ((n - 1) * Width + 7) / 8;
+
+        uint64_t Bits = 0;
+        uint32_t BitCount = 0;
+
+        int32_t Value = Frame[0];
+
+        for (size_t i = 1; i < n; ++i)
+        {
+            if (BitCount < Width)
+            {
+                // Refill with as many whole bytes as fit, 8 at a time while the frame has them (little-endian).
+                if (End - encoded >= 8)
+                {
+                    uint64_t Word;
+
+                    ::memcpy(&Word, encoded, sizeof(Word));
+
+                    Bits |= Word << BitCount;
+
+                    const uint32_t ByteCount = (63 - BitCount) >> 3;
+
+                    encoded  += ByteCount;
+                    BitCount += ByteCount * 8;
+                }
+                else
+                {
+                    while (BitCount < Width)
+                    {
+                        Bits |= (uint64_t) *encoded++ << BitCount;
+                        BitCount += 8;
+                    }
+                }
+            }
+
+            Value += UnZigZag((uint32_t) Bits & Mask);
+
+            Frame[i] = (int16_t) Value;
+
+            Bits >>= Width;
+            BitCount -= Width;
+        }
+
+        encoded = End;
+    }
+}
+
+/// <summary>
+/// Decodes a sample to a new block.
+/// </summary>
+sample_handle_t sample_cache_t::DecodeSample(uint32_t sampleIndex) const
+{
+    const auto & Sample = _Samples[sampleIndex];
+
+    std::vector<int16_t> Data(Sample.Count);
+
+    Decode(Sample.Data.data(), Sample.Count, Data.data());
+
+    return std::make_shared<const sample_block_t>(std::move(Data), std::vector<uint8_t>(Sample.DataLSB), Sample.Hash);
+}
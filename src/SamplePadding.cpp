@@ -0,0 +1,176 @@
+
+/** $VER: SamplePadding.cpp (2026.10.18) P. Stuer - Lays out the sample pool with guard points for branch-free playback **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+using namespace sf;
+
+namespace
+{
+    /// <summary>
+    /// Describes the part of the original sample pool used by a sample header.
+    /// </summary>
+    struct range_t
+    {
+        uint32_t Start;
+        uint32_t End;
+        uint32_t LoopStart;
+        uint32_t LoopEnd;
+        bool IsLooped;
+
+        auto operator<=>(const range_t &) const = default;
+    };
+
+    /// <summary>
+    /// Returns true for each sample that is played by at least one instrument zone with a loop (sampleModes 1 or 3).
+    /// </summary>
+    std::vector<bool> GetLoopedSamples(const bank_t & bank)
+    {
+        std::vector<bool> IsLooped(bank.Samples.size());
+
+        // The instrument and zone lists end with a terminal record.
+        if (bank.InstrumentZones.empty())
+            return IsLooped;
+
+        for (size_t i = 0; i + 1 < bank.Instruments.size(); ++i)
+        {
+            const size_t ZoneFirst = bank.Instruments[i].ZoneIndex;
+            const size_t ZoneLast  = std::min((size_t) bank.Instruments[i + 1].ZoneIndex, bank.InstrumentZones.size() - 1);
+
+            int32_t GlobalSampleMode = 0;
+
+            for (size_t j = ZoneFirst; j < ZoneLast; ++j)
+            {
+                const size_t First = std::min((size_t) bank.InstrumentZones[j].GeneratorIndex, bank.InstrumentGenerators.size());
+                const size_t Last  = std::clamp((size_t) bank.InstrumentZones[j + 1].GeneratorIndex, First, bank.InstrumentGenerators.size());
+
+                int32_t SampleMode  = GlobalSampleMode;
+                int32_t SampleIndex = -1;
+
+                for (size_t k = First; k < Last; ++k)
+                {
+                    const auto & Generator = bank.InstrumentGenerators[k];
+
+                    if (Generator.Operator == GeneratorOperator::sampleModes)
+                        SampleMode = Generator.Amount;
+                    else
+                    if (Generator.Operator == GeneratorOperator::sampleID)
+                        SampleIndex = (uint16_t) Generator.Amount;
+                }
+
+                if (SampleIndex < 0)
+                {
+                    // Only the first zone can be a global zone.
+                    if (j == ZoneFirst)
+                        GlobalSampleMode = SampleMode;
+
+                    continue;
+                }
+
+                if ((SampleMode & 1) && ((size_t) SampleIndex < IsLooped.size()))
+                    IsLooped[(size_t) SampleIndex] = true;
+            }
+        }
+
+        return IsLooped;
+    }
+}
+
+/// <summary>
+/// Re-lays the sample pool so that every sample is preceded by silence and every loop that is played by an instrument zone is followed by a copy of its first points.
+/// The interpolation kernels can then read across the start and the loop end of a sample without any boundary checks. The offsets of the sample headers are rewritten.
+/// The loop continuation replaces the points after the loop end, so a release tail that follows the loop loses its first guard points.
+/// </summary>
+void bank_t::PadSamples(const sample_padding_options_t & options)
+{
+    METRICS_SCOPE("sf::bank_t::PadSamples");
+
+    CheckSamplePool("pad");
+
+    const uint32_t GuardPoints = options.GuardPoints;
+
+    const size_t PointCount = SampleData.size() / sizeof(int16_t);
+    const bool HasLSB = (PointCount != 0) && (SampleDataLSB.size() >= PointCount);
+
+    const std::vector<bool> IsLooped = GetLoopedSamples(*this);
+
+    // Assign a location to each range. Sample headers with the same range share the copy.
+    std::map<range_t, uint32_t> Locations;
+
+    uint64_t Size = GuardPoints;
+
+    for (size_t i = 0; i + 1 < Samples.size(); ++i) // The last sample is the terminal record.
+    {
+        auto & Sample = Samples[i];
+
+        if (Sample.SampleType & 0x8000) // ROM samples are not in the pool.
+            continue;
+
+        range_t Range;
+
+        Range.Start     = (uint32_t) std::min((size_t) Sample.Start, PointCount);
+        Range.End       = (uint32_t) std::clamp((size_t) Sample.End, (size_t) Range.Start, PointCount);
+        Range.LoopStart = std::clamp(Sample.LoopStart, Range.Start, Range.End);
+        Range.LoopEnd   = std::clamp(Sample.LoopEnd, Range.LoopStart, Range.End);
+        Range.IsLooped  = IsLooped[i] && (Range.LoopEnd > Range.LoopStart);
+
+        auto [it, IsNew] = Locations.try_emplace(Range, (uint32_t) 0);
+
+        if (IsNew)
+        {
+            const uint64_t Length = std::max((uint64_t) (Range.End - Range.Start), Range.IsLooped ? (uint64_t) (Range.LoopEnd - Range.Start) + GuardPoints : 0);
+
+            if (Size + Length + GuardPoints > UINT32_MAX)
+                throw sf::exception("Sample pool too large to add guard points");
+
+            it->second = (uint32_t) Size;
+
+            Size += Length + GuardPoints;
+        }
+
+        const uint32_t Start = it->second;
+
+        Sample.Start     = Start;
+        Sample.End       = Start + (Range.End       - Range.Start);
+        Sample.LoopStart = Start + (Range.LoopStart - Range.Start);
+        Sample.LoopEnd   = Start + (Range.LoopEnd   - Range.Start);
+    }
+
+    // Copy the sample points. The guard points are silent unless they continue a loop.
+    std::vector<uint8_t> Data((size_t) Size * sizeof(int16_t));
+    std::vector<uint8_t> DataLSB(HasLSB ? (size_t) Size : 0);
+
+    const int16_t * Src = (const int16_t *) SampleData.data();
+          int16_t * Dst = (int16_t *) Data.data();
+
+    for (const auto & [Range, Start] : Locations)
+    {
+        const size_t Length = (size_t) (Range.End - Range.Start);
+
+        ::memcpy(Dst + Start, Src + Range.Start, Length * sizeof(int16_t));
+
+        if (HasLSB)
+            ::memcpy(DataLSB.data() + Start, SampleDataLSB.data() + Range.Start, Length);
+
+        if (!Range.IsLooped)
+            continue;
+
+        const uint32_t LoopStart  = Start + (Range.LoopStart - Range.Start);
+        const uint32_t LoopEnd    = Start + (Range.LoopEnd   - Range.Start);
+        const uint32_t LoopLength = LoopEnd - LoopStart;
+
+        for (uint32_t j = 0; j < GuardPoints; ++j)
+        {
+            Dst[LoopEnd + j] = Dst[LoopStart + (j % LoopLength)];
+
+            if (HasLSB)
+                DataLSB[LoopEnd + j] = DataLSB[LoopStart + (j % LoopLength)];
+        }
+    }
+
+    SampleData    = std::move(Data);
+    SampleDataLSB = std::move(DataLSB);
+    SamplePadding = GuardPoints;
+}
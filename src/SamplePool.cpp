@@ -0,0 +1,164 @@
+
+/** $VER: SamplePool.cpp (2026.10.18) P. Stuer - Normalized float copy of the sample pool of a bank **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define SAMPLEPOOL_SSE2
+#include <emmintrin.h>
+#elif defined(_M_ARM64) || defined(__ARM_NEON)
+#define SAMPLEPOOL_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace sf;
+
+namespace
+{
+    constexpr float Scale16 = 1.f / 32768.f;
+    constexpr float Scale24 = 1.f / 8388608.f;
+
+    /// <summary>
+    /// Converts 16-bit sample points to normalized floats. Uses the SSE2 or NEON baseline of the target, so no run-time dispatch is needed.
+    /// </summary>
+    void Convert16(const int16_t * src, float * dst, size_t count) noexcept
+    {
+        size_t i = 0;
+
+#if defined(SAMPLEPOOL_SSE2)
+        const __m128 Scale = _mm_set1_ps(Scale16);
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+
+            _mm_storeu_ps(dst + i,     _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16)), Scale));
+            _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16)), Scale));
+        }
+#elif defined(SAMPLEPOOL_NEON)
+        for (; i + 8 <= count; i += 8)
+        {
+            const int16x8_t s = vld1q_s16(src + i);
+
+            vst1q_f32(dst + i,     vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))),  Scale16));
+            vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), Scale16));
+        }
+#endif
+
+        for (; i < count; ++i)
+            dst[i] = (float) src[i] * Scale16;
+    }
+
+    /// <summary>
+    /// Merges 16-bit sample points and their low bytes to normalized floats.
+    /// </summary>
+    void Convert24(const int16_t * src, const uint8_t * srcLSB, float * dst, size_t count) noexcept
+    {
+        size_t i = 0;
+
+#if defined(SAMPLEPOOL_SSE2)
+        const __m128 Scale = _mm_set1_ps(Scale24);
+        const __m128i Zero = _mm_setzero_si128();
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+            const __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (srcLSB + i)), Zero);
+
+            // Put each 16-bit point in the upper half of a 32-bit lane, shift it down to bits 8 - 23 and insert the low byte.
+            const __m128i Lo = _mm_or_si128(_mm_srai_epi32(_mm_unpacklo_epi16(Zero, s), 8), _mm_unpacklo_epi16(b, Zero));
+            const __m128i Hi = _mm_or_si128(_mm_srai_epi32(_mm_unpackhi_epi16(Zero, s), 8), _mm_unpackhi_epi16(b, Zero));
+
+            _mm_storeu_ps(dst + i,     _mm_mul_ps(_mm_cvtepi32_ps(Lo), Scale));
+            _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(Hi), Scale));
+        }
+#elif defined(SAMPLEPOOL_NEON)
+        for (; i + 8 <= count; i += 8)
+        {
+            const int16x8_t s = vld1q_s16(src + i);
+            const uint16x8_t b = vmovl_u8(vld1_u8(srcLSB + i));
+
+            const int32x4_t Lo = vorrq_s32(vshlq_n_s32(vmovl_s16(vget_low_s16(s)),  8), vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(b))));
+            const int32x4_t Hi = vorrq_s32(vshlq_n_s32(vmovl_s16(vget_high_s16(s)), 8), vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(b))));
+
+            vst1q_f32(dst + i,     vmulq_n_f32(vcvtq_f32_s32(Lo), Scale24));
+            vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(Hi), Scale24));
+        }
+#endif
+
+        for (; i < count; ++i)
+            dst[i] = (float) (((int32_t) src[i] * 256) | srcLSB[i]) * Scale24;
+    }
+}
+
+/// <summary>
+/// Initializes a new instance. Unless the pool is lazy, all sample points are converted.
+/// </summary>
+sample_pool_t::sample_pool_t(const bank_t & bank, const sample_pool_options_t & options) : _Bank(bank)
+{
+    METRICS_SCOPE("sf::sample_pool_t::sample_pool_t");
+
+    bank.CheckSamplePool("convert");
+
+    _Data16  = (const int16_t *) bank.SampleData.data();
+    _Count   = bank.SampleData.size() / sizeof(int16_t);
+    _DataLSB = ((_Count != 0) && (bank.SampleDataLSB.size() >= _Count)) ? bank.SampleDataLSB.data() : nullptr;
+
+    _Data.reset((float *) ::operator new[](std::max(_Count, (size_t) 1) * sizeof(float), std::align_val_t(Alignment)));
+
+    if (options.IsLazy)
+    {
+        ::memset(_Data.get(), 0, _Count * sizeof(float));
+
+        _IsConverted.resize(bank.Samples.size());
+    }
+    else
+        Convert(0, _Count);
+}
+
+/// <summary>
+/// Gets the points of a sample from Start to End, converting them and the guard points around them first if necessary. The span is empty for ROM samples and invalid indexes.
+/// </summary>
+std::span<const float> sample_pool_t::GetSample(size_t sampleIndex)
+{
+    if (sampleIndex >= _Bank.Samples.size())
+        return { };
+
+    const auto & Sample = _Bank.Samples[sampleIndex];
+
+    if (Sample.SampleType & 0x8000) // ROM samples are not in the pool.
+        return { };
+
+    const size_t Start = std::min((size_t) Sample.Start, _Count);
+    const size_t End   = std::clamp((size_t) Sample.End, Start, _Count);
+
+    if (!IsConverted(sampleIndex))
+    {
+        const size_t Padding = _Bank.SamplePadding;
+
+        const size_t First = (Start > Padding) ? Start - Padding : 0;
+        const size_t Last  = std::min(std::max(End, (size_t) Sample.LoopEnd) + Padding, _Count);
+
+        Convert(First, Last);
+
+        _IsConverted[sampleIndex] = true;
+    }
+
+    return std::span<const float>(_Data.get() + Start, End - Start);
+}
+
+/// <summary>
+/// Converts the sample points from first up to last.
+/// </summary>
+void sample_pool_t::Convert(size_t first, size_t last) noexcept
+{
+    if (first >= last)
+        return;
+
+    if (_DataLSB != nullptr)
+        Convert24(_Data16 + first, _DataLSB + first, _Data.get() + first, last - first);
+    else
+        Convert16(_Data16 + first, _Data.get() + first, last - first);
+}
@@ -0,0 +1,479 @@
+
+/** $VER: SampleResidency.cpp (2026.10.18) P. Stuer - Keeps the used samples of a bank in memory within a budget **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "SampleResidency.h"
+#include "BankCache.h"
+
+using namespace sf;
+
+/// <summary>
+/// Initializes a new instance for the sample pool of a bank in memory. The pool is read again from the 16-bit sample data at the specified offset of a file,
+/// e.g. the smpl chunk of the SoundFont bank it was read from. All samples start resident.
+/// </summary>
+sample_residency_t::sample_residency_t(bank_t & bank, const std::filesystem::path & filePath, uint64_t dataOffset, const sample_residency_options_t & options) :
+    _Options(options), _Data(bank.SampleData.data()), _MappedData(), _Size(bank.SampleData.size()), _DataOffset(dataOffset), _PageSize(platform::GetPageSize()), _PageOffset(), _ResidentSize(), _Evictions()
+{
+    bank.CheckSamplePool("manage");
+
+    _File.Open(filePath);
+
+    if (_DataOffset + _Size > _File.Size())
+        throw sf::exception(msc::FormatText("\"%s\" does not contain the sample data of the bank", (const char *) filePath.u8string().c_str()));
+
+    const region_resolver_t Resolver(bank);
+
+    std::vector<sample_range_t> Ranges;
+
+    for (uint32_t i = 0; i < (uint32_t) bank.Samples.size(); ++i)
+    {
+        sample_range_t Range;
+
+        if (Resolver.GetSampleRange(i, Range))
+            Ranges.push_back(Range);
+    }
+
+    Initialize(_Data, bank.Samples.size(), Ranges, true);
+
+    // The preset list ends with a terminal record.
+    for (size_t i = 0; i + 1 < bank.Presets.size(); ++i)
+    {
+        const auto & Preset = bank.Presets[i];
+
+        Resolver.GetSampleRanges(Preset.MIDIBank, Preset.MIDIProgram, Ranges);
+
+        preset_t p = { Preset.MIDIBank, Preset.MIDIProgram, { } };
+
+        for (const auto & Range : Ranges)
+            p.Samples.push_back(Range.SampleIndex);
+
+        _Presets.push_back(std::move(p));
+    }
+}
+
+/// <summary>
+/// Initializes a new instance for the sample pool of a bank cache. The system reads the pages of the mapped pool again when they are accessed. No samples start resident.
+/// </summary>
+sample_residency_t::sample_residency_t(const bank_cache_t & cache, const sample_residency_options_t & options) :
+    _Options(options), _Data(), _MappedData((const uint8_t *) cache.SampleData().data()), _Size(cache.SampleData().size_bytes()), _DataOffset(), _PageSize(platform::GetPageSize()), _PageOffset(), _ResidentSize(), _Evictions()
+{
+    const auto Samples = cache.Samples();
+    const uint32_t Padding = cache.GetSamplePadding();
+
+    std::vector<sample_range_t> Ranges;
+
+    for (uint32_t i = 0; i < (uint32_t) Samples.size(); ++i)
+    {
+        const auto & Sample = Samples[i];
+
+        if ((Sample.SampleType & 0x8000) || (Sample.End <= Sample.Start))
+            continue;
+
+        Ranges.push_back({ i, Sample.Start - std::min(Sample.Start, Padding), Sample.End + Padding });
+    }
+
+    Initialize(_MappedData, Samples.size(), Ranges, false);
+
+    for (const auto & Preset : cache.Presets())
+    {
+        preset_t p = { (uint16_t) (Preset.Key >> 16), (uint16_t) (Preset.Key & 0xFFFF), { } };
+
+        cache.GetSampleRanges(p.Bank, p.Program, Ranges);
+
+        for (const auto & Range : Ranges)
+            p.Samples.push_back(Range.SampleIndex);
+
+        _Presets.push_back(std::move(p));
+    }
+}
+
+/// <summary>
+/// Makes a sample resident, reading it again if it was evicted, and keeps it resident until it is released. Returns false if the sample is not available
+/// or could not be read.
+/// </summary>
+bool sample_residency_t::Acquire(uint32_t sampleIndex)
+{
+    if ((sampleIndex >= _Samples.size()) || !_Samples[sampleIndex].IsAvailable)
+        return false;
+
+    std::lock_guard Lock(_Mutex);
+
+    auto & Sample = _Samples[sampleIndex];
+
+    if (Sample.IsResident)
+    {
+        _Uses.splice(_Uses.begin(), _Uses, Sample.Use);
+
+        ++Sample.Hits;
+    }
+    else
+    {
+        if (!Load(sampleIndex))
+            return false;
+
+        ++Sample.Misses;
+    }
+
+    ++Sample.PinCount;
+
+    Evict(sampleIndex);
+
+    return true;
+}
+
+/// <summary>
+/// Releases a sample acquired by Acquire(). It may be evicted once it isn't used anymore.
+/// </summary>
+void sample_residency_t::Release(uint32_t sampleIndex) noexcept
+{
+    if (sampleIndex >= _Samples.size())
+        return;
+
+    std::lock_guard Lock(_Mutex);
+
+    auto & Sample = _Samples[sampleIndex];
+
+    if (Sample.PinCount != 0)
+        --Sample.PinCount;
+}
+
+/// <summary>
+/// Evicts the least recently used samples that aren't in use until the resident pages are within the budget. Returns the number of bytes of the resident pages.
+/// </summary>
+uint64_t sample_residency_t::Trim()
+{
+    std::lock_guard Lock(_Mutex);
+
+    Evict(UINT32_MAX);
+
+    return _ResidentSize;
+}
+
+/// <summary>
+/// Returns true if the sample is resident.
+/// </summary>
+bool sample_residency_t::IsResident(uint32_t sampleIndex) const
+{
+    std::lock_guard Lock(_Mutex);
+
+    return (sampleIndex < _Samples.size()) && _Samples[sampleIndex].IsResident;
+}
+
+/// <summary>
+/// Gets the number of times a sample has been acquired.
+/// </summary>
+uint64_t sample_residency_t::GetAccessCount(uint32_t sampleIndex) const
+{
+    std::lock_guard Lock(_Mutex);
+
+    return (sampleIndex < _Samples.size()) ? _Samples[sampleIndex].Hits + _Samples[sampleIndex].Misses : 0;
+}
+
+/// <summary>
+/// Gets the residency and access counters of the bank.
+/// </summary>
+residency_statistics_t sample_residency_t::GetStatistics() const
+{
+    std::lock_guard Lock(_Mutex);
+
+    residency_statistics_t Statistics = { };
+
+    for (const auto & Sample : _Samples)
+    {
+        if (!Sample.IsAvailable)
+            continue;
+
+        Statistics.Hits      += Sample.Hits;
+        Statistics.Misses    += Sample.Misses;
+        Statistics.TotalSize += Sample.Size;
+
+        if (Sample.IsResident)
+            ++Statistics.ResidentCount;
+
+        ++Statistics.SampleCount;
+    }
+
+    Statistics.Evictions    = _Evictions;
+    Statistics.ResidentSize = _ResidentSize;
+
+    return Statistics;
+}
+
+/// <summary>
+/// Gets the residency and access counters of each preset.
+/// </summary>
+std::vector<preset_residency_t> sample_residency_t::GetPresetStatistics() const
+{
+    std::lock_guard Lock(_Mutex);
+
+    std::vector<preset_residency_t> Presets;
+
+    Presets.reserve(_Presets.size());
+
+    for (const auto & Preset : _Presets)
+    {
+        preset_residency_t p = { Preset.Bank, Preset.Program, { } };
+
+        for (const uint32_t SampleIndex : Preset.Samples)
+        {
+            const auto & Sample = _Samples[SampleIndex];
+
+            if (!Sample.IsAvailable)
+                continue;
+
+            p.Statistics.Hits      += Sample.Hits;
+            p.Statistics.Misses    += Sample.Misses;
+            p.Statistics.TotalSize += Sample.Size;
+
+            if (Sample.IsResident)
+            {
+                p.Statistics.ResidentSize += Sample.Size;
+                ++p.Statistics.ResidentCount;
+            }
+
+            ++p.Statistics.SampleCount;
+        }
+
+        Presets.push_back(std::move(p));
+    }
+
+    return Presets;
+}
+
+/// <summary>
+/// Sets up the samples and the use counts of the pages of the pool.
+/// </summary>
+void sample_residency_t::Initialize(const uint8_t * data, size_t sampleCount, const std::vector<sample_range_t> & ranges, bool isResident)
+{
+    _PageOffset = (size_t) ((uintptr_t) data % _PageSize);
+
+    _Samples.resize(sampleCount);
+    _PageUseCounts.assign((size_t) ((_Size + _PageOffset + _PageSize - 1) / _PageSize), 0);
+
+    for (const auto & Range : ranges)
+    {
+        auto & Sample = _Samples[Range.SampleIndex];
+
+        Sample.Offset = (uint64_t) Range.Start * sizeof(int16_t);
+        Sample.Size   = std::min((uint64_t) Range.End * sizeof(int16_t), _Size) - std::min(Sample.Offset, _Size);
+
+        Sample.IsAvailable = (Sample.Offset < _Size);
+
+        if (!Sample.IsAvailable || !isResident)
+            continue;
+
+        for (size_t Page = GetFirstPage(Sample); Page < GetLastPage(Sample); ++Page)
+        {
+            if (_PageUseCounts[Page]++ == 0)
+                _ResidentSize += _PageSize;
+        }
+
+        Sample.IsResident = true;
+        Sample.Use = _Uses.insert(_Uses.end(), Range.SampleIndex);
+    }
+}
+
+/// <summary>
+/// Reads the discarded pages of a pool in memory again and stops managing it. Returns false if the pool could not be read.
+/// </summary>
+bool sample_residency_t::Restore()
+{
+    std::lock_guard Lock(_Mutex);
+
+    const size_t PageCount = _PageUseCounts.size();
+
+    for (size_t Page = 0; Page < PageCount;)
+    {
+        if (_PageUseCounts[Page] != 0)
+        {
+            ++Page;
+            continue;
+        }
+
+        size_t End = Page + 1;
+
+        while ((End < PageCount) && (_PageUseCounts[End] == 0))
+            ++End;
+
+        const uint64_t Offset = GetPageStart(Page);
+        const size_t Size     = (size_t) (GetPageStart(End) - Offset);
+
+        if (_File.Read(_DataOffset + Offset, _Data + Offset, Size) != Size)
+            return false;
+
+        Page = End;
+    }
+
+    // Acquire() fails from now on.
+    _Samples.clear();
+    _Presets.clear();
+    _PageUseCounts.clear();
+    _Uses.clear();
+
+    _Data = nullptr;
+    _Size = 0;
+    _ResidentSize = 0;
+
+    return true;
+}
+
+/// <summary>
+/// Makes a sample resident. The pages that no resident sample used are read again from the file, or prefetched if the pool is mapped.
+/// </summary>
+bool sample_residency_t::Load(uint32_t sampleIndex)
+{
+    auto & Sample = _Samples[sampleIndex];
+
+    const size_t FirstPage = GetFirstPage(Sample);
+    const size_t LastPage  = GetLastPage(Sample);
+
+    if (_Data != nullptr)
+    {
+        for (size_t Page = FirstPage; Page < LastPage;)
+        {
+            if (_PageUseCounts[Page] != 0)
+            {
+                ++Page;
+                continue;
+            }
+
+            size_t End = Page + 1;
+
+            while ((End < LastPage) && (_PageUseCounts[End] == 0))
+                ++End;
+
+            const uint64_t Offset = GetPageStart(Page);
+            const size_t Size     = (size_t) (GetPageStart(End) - Offset);
+
+            if (_File.Read(_DataOffset + Offset, _Data + Offset, Size) != Size)
+                return false;
+
+            Page = End;
+        }
+    }
+    else
+        platform::PrefetchPages(_MappedData + Sample.Offset, (size_t) Sample.Size);
+
+    for (size_t Page = FirstPage; Page < LastPage; ++Page)
+    {
+        if (_PageUseCounts[Page]++ == 0)
+            _ResidentSize += _PageSize;
+    }
+
+    Sample.IsResident = true;
+    Sample.Use = _Uses.insert(_Uses.begin(), sampleIndex);
+
+    return true;
+}
+
+/// <summary>
+/// Evicts a sample and releases the pages that no other resident sample uses.
+/// </summary>
+void sample_residency_t::Unload(uint32_t sampleIndex) noexcept
+{
+    auto & Sample = _Samples[sampleIndex];
+
+    const size_t FirstPage = GetFirstPage(Sample);
+    const size_t LastPage  = GetLastPage(Sample);
+
+    size_t RunStart = LastPage;
+
+    for (size_t Page = FirstPage; Page < LastPage; ++Page)
+    {
+        if (--_PageUseCounts[Page] == 0)
+        {
+            _ResidentSize -= _PageSize;
+
+            if (RunStart == LastPage)
+                RunStart = Page;
+        }
+        else
+        if (RunStart != LastPage)
+        {
+            Discard(RunStart, Page);
+
+            RunStart = LastPage;
+        }
+    }
+
+    if (RunStart != LastPage)
+        Discard(RunStart, LastPage);
+
+    _Uses.erase(Sample.Use);
+
+    Sample.IsResident = false;
+
+    ++_Evictions;
+}
+
+/// <summary>
+/// Evicts the least recently used samples that aren't in use, except the specified one, until the resident pages are within the budget.
+/// </summary>
+void sample_residency_t::Evict(uint32_t keep) noexcept
+{
+    // Unload() only removes the evicted sample from the list, so the iterator stays valid.
+    auto it = _Uses.end();
+
+    while ((_ResidentSize > _Options.Budget) && (it != _Uses.begin()))
+    {
+        const auto Candidate = std::prev(it);
+        const uint32_t SampleIndex = *Candidate;
+
+        if ((SampleIndex == keep) || (_Samples[SampleIndex].PinCount != 0))
+        {
+            it = Candidate;
+            continue;
+        }
+
+        Unload(SampleIndex);
+    }
+}
+
+/// <summary>
+/// Releases a run of pages of the pool. Pages at the edges of the pool that it shares with other memory are kept.
+/// </summary>
+void sample_residency_t::Discard(size_t firstPage, size_t lastPage) const noexcept
+{
+    const uint64_t Offset = GetPageStart(firstPage);
+    const uint64_t Size   = GetPageStart(lastPage) - Offset;
+
+    if (Size == 0)
+        return;
+
+    platform::DiscardPages(GetSampleData() + Offset, (size_t) Size);
+}
+
+/// <summary>
+/// Initializes a new instance that takes over a bank and manages its sample pool. The pool is read again from the 16-bit sample data at the specified offset
+/// of a file, e.g. the smpl chunk of the SoundFont bank it was read from.
+/// </summary>
+managed_bank_t::managed_bank_t(bank_t && bank, const std::filesystem::path & filePath, uint64_t dataOffset, const sample_residency_options_t & options) :
+    _Bank(std::move(bank)), _Residency(_Bank, filePath, dataOffset, options)
+{
+    _Bank.Residency._Residency = &_Residency;
+}
+
+/// <summary>
+/// Reads the evicted samples again and returns the bank. The bank of this instance is empty afterwards. No renderer may use the residency manager anymore.
+/// </summary>
+bank_t managed_bank_t::Release()
+{
+    if (!_Residency.Restore())
+        throw sf::exception("Failed to read the evicted samples of the bank");
+
+    _Bank.Residency._Residency = nullptr;
+
+    return std::move(_Bank);
+}
+
+/// <summary>
+/// Throws if a bank is copied from or to a bank whose sample pool is managed by a residency manager.
+/// </summary>
+void residency_link_t::CheckCopy(const residency_link_t & link)
+{
+    if (link._Residency != nullptr)
+        throw sf::exception("Can't copy a bank whose samples are managed by a residency manager");
+}
@@ -0,0 +1,220 @@
+
+/** $VER: SampleStore.cpp (2026.10.18) P. Stuer - Process-wide store that shares identical samples between banks **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "SampleStore.h"
+#include "Hash.h"
+
+using namespace sf;
+
+/// <summary>
+/// Initializes a new instance with a copy of the specified sample points.
+/// </summary>
+sample_block_t::sample_block_t(const int16_t * data, const uint8_t * dataLSB, size_t count, uint64_t hash) : _Data(data, data + count), _Hash(hash)
+{
+    if (dataLSB != nullptr)
+        _DataLSB.assign(dataLSB, dataLSB + count);
+}
+
+/// <summary>
+/// Returns true if the block holds the specified sample points.
+/// </summary>
+bool sample_block_t::IsEqual(const int16_t * data, const uint8_t * dataLSB, size_t count) const noexcept
+{
+    if ((count != _Data.size()) || ((dataLSB != nullptr) != !_DataLSB.empty()))
+        return false;
+
+    if (::memcmp(data, _Data.data(), count * sizeof(int16_t)) != 0)
+        return false;
+
+    return (dataLSB == nullptr) || (::memcmp(dataLSB, _DataLSB.data(), count) == 0);
+}
+
+/// <summary>
+/// Gets the store that is shared by the whole process.
+/// </summary>
+sample_store_t & sample_store_t::Instance()
+{
+    static sample_store_t Store;
+
+    return Store;
+}
+
+/// <summary>
+/// Gets the block with the specified sample points. The points are hashed and compared with the blocks in use; a new block is created if none matches.
+/// </summary>
+sample_handle_t sample_store_t::Intern(const int16_t * data, const uint8_t * dataLSB, size_t count)
+{
+    hash_t Hasher;
+
+    Hasher.Update(data, count * sizeof(int16_t));
+
+    if (dataLSB != nullptr)
+        Hasher.Update(dataLSB, count);
+
+    const uint64_t Hash = Hasher.Digest();
+
+    {
+        std::lock_guard Lock(_Mutex);
+
+        ++_InternCount;
+
+        auto Block = Find(Hash, data, dataLSB, count);
+
+        if (Block != nullptr)
+        {
+            ++_SharedCount;
+
+            return Block;
+        }
+    }
+
+    // Copy the points outside the lock. Another thread may have added the same sample in the meantime.
+    auto NewBlock = std::make_shared<const sample_block_t>(data, dataLSB, count, Hash);
+
+    std::lock_guard Lock(_Mutex);
+
+    auto Block = Find(Hash, data, dataLSB, count);
+
+    if (Block != nullptr)
+    {
+        ++_SharedCount;
+
+        return Block;
+    }
+
+    _Blocks.emplace(Hash, NewBlock);
+
+    return NewBlock;
+}
+
+/// <summary>
+/// Removes the entries of the blocks that have been freed. Returns the number of blocks in use.
+/// </summary>
+size_t sample_store_t::Purge()
+{
+    std::lock_guard Lock(_Mutex);
+
+    std::erase_if(_Blocks, [](const auto & item) { return item.second.expired(); });
+
+    return _Blocks.size();
+}
+
+/// <summary>
+/// Gets the number of blocks in use.
+/// </summary>
+size_t sample_store_t::GetBlockCount() const
+{
+    std::lock_guard Lock(_Mutex);
+
+    return (size_t) std::count_if(_Blocks.begin(), _Blocks.end(), [](const auto & item) { return !item.second.expired(); });
+}
+
+/// <summary>
+/// Gets the number of bytes of the blocks in use.
+/// </summary>
+uint64_t sample_store_t::GetMemoryUsage() const
+{
+    std::vector<sample_handle_t> Blocks;
+
+    {
+        std::lock_guard Lock(_Mutex);
+
+        Blocks.reserve(_Blocks.size());
+
+        for (const auto & [ Hash, WeakBlock ] : _Blocks)
+        {
+            auto Block = WeakBlock.lock();
+
+            if (Block != nullptr)
+                Blocks.push_back(std::move(Block));
+        }
+    }
+
+    uint64_t Size = 0;
+
+    for (const auto & Block : Blocks)
+        Size += Block->GetMemorySize();
+
+    // A block released by its last bank meanwhile is freed here, outside the lock.
+    return Size;
+}
+
+/// <summary>
+/// Finds the block with the specified content. Entries of freed blocks with the same hash are removed.
+/// </summary>
+sample_handle_t sample_store_t::Find(uint64_t hash, const int16_t * data, const uint8_t * dataLSB, size_t count)
+{
+    auto [ First, Last ] = _Blocks.equal_range(hash);
+
+    for (auto it = First; it != Last;)
+    {
+        auto Block = it->second.lock();
+
+        if (Block == nullptr)
+        {
+            it = _Blocks.erase(it);
+            continue;
+        }
+
+        if (Block->IsEqual(data, dataLSB, count))
+            return Block;
+
+        ++it;
+    }
+
+    return nullptr;
+}
+
+/// <summary>
+/// Moves the sample points of each sample to a block of the specified store, so banks with identical samples share them, and releases the sample pool.
+/// A block holds the points from the start to the end of the sample header, and the guard points around them when the pool has been padded. ROM samples
+/// and samples outside the pool get no block. Pad the samples first; a bank that shares its samples can be rendered but the operations that read the pool
+/// throw (see CheckSamplePool()).
+/// </summary>
+void bank_t::ShareSamples(sample_store_t & store)
+{
+    if (SampleData.empty())
+        return;
+
+    const int16_t * Data    = (const int16_t *) SampleData.data();
+    const size_t Count      = SampleData.size() / sizeof(int16_t);
+    const uint8_t * DataLSB = (SampleDataLSB.size() >= Count) ? SampleDataLSB.data() : nullptr;
+
+    SampleBlocks.assign(Samples.size(), nullptr);
+
+    for (size_t i = 0; i < Samples.size(); ++i)
+    {
+        const auto & Sample = Samples[i];
+
+        if ((Sample.SampleType & 0x8000) || (Sample.Start >= Sample.End) || (Sample.End > Count))
+            continue;
+
+        const size_t First = GetSampleBlockOrigin(Sample);
+        const size_t Last  = std::min((size_t) Sample.End + SamplePadding, Count);
+
+        SampleBlocks[i] = store.Intern(Data + First, (DataLSB != nullptr) ? DataLSB + First : nullptr, Last - First);
+    }
+
+    SampleData.clear();
+    SampleData.shrink_to_fit();
+
+    SampleDataLSB.clear();
+    SampleDataLSB.shrink_to_fit();
+}
+
+/// <summary>
+/// Throws if the sample pool of the bank can't be read because ShareSamples() has released it, or because a sample_residency_t may have discarded its pages.
+/// Called by the operations that read the pool directly.
+/// </summary>
+void bank_t::CheckSamplePool(const char * operation) const
+{
+    if (!SampleBlocks.empty())
+        throw sf::exception(msc::FormatText("Can't %s a bank that shares its samples", operation));
+
+    if (Residency.Get() != nullptr)
+        throw sf::exception(msc::FormatText("Can't %s a bank whose samples are managed by a residency manager", operation));
+}
@@ -0,0 +1,467 @@
+
+/** $VER: SampleStreamer.cpp (2026.10.18) P. Stuer - Streams sample data from disk with a resident preload of each sample **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "SampleStreamer.h"
+#include "BankCache.h"
+
+#include <bit>
+
+using namespace sf;
+
+/// <summary>
+/// Initializes a new instance that streams the samples from 16-bit sample data at the specified offset in a file, e.g. the smpl chunk of a SoundFont bank.
+/// </summary>
+sample_streamer_t::sample_streamer_t(const std::filesystem::path & filePath, uint64_t dataOffset, std::span<const sample_t> samples, const sample_streamer_options_t & options) :
+    _DataOffset(), _PreloadPoints(), _ReadPoints(), _RingSize(), _UnderrunCount(), _BytesRead(), _Pending(), _IsStopping()
+{
+    _Samples.reserve(samples.size());
+
+    for (const auto & Sample : samples)
+        AddSample(Sample.Start, Sample.End, Sample.LoopStart, Sample.LoopEnd);
+
+    Initialize(filePath, dataOffset, options);
+}
+
+/// <summary>
+/// Initializes a new instance that streams the samples of a bank cache.
+/// </summary>
+sample_streamer_t::sample_streamer_t(const std::filesystem::path & cachePath, const bank_cache_t & cache, const sample_streamer_options_t & options) :
+    _DataOffset(), _PreloadPoints(), _ReadPoints(), _RingSize(), _UnderrunCount(), _BytesRead(), _Pending(), _IsStopping()
+{
+    if (!cache.IsOpen())
+        throw sf::exception("Bank cache not open");
+
+    _Samples.reserve(cache.Samples().size());
+
+    for (const auto & Sample : cache.Samples())
+        AddSample(Sample.Start, Sample.End, Sample.LoopStart, Sample.LoopEnd);
+
+    Initialize(cachePath, cache.GetSampleDataOffset(), options);
+}
+
+/// <summary>
+/// Stops the I/O thread.
+/// </summary>
+sample_streamer_t::~sample_streamer_t()
+{
+    _IsStopping.store(true);
+
+    Wake();
+
+    if (_Thread.joinable())
+        _Thread.join();
+}
+
+/// <summary>
+/// Starts playing a sample on a stream, offset points from its start. Returns false if the sample doesn't exist, its index doesn't fit in a request
+/// (see MaxSampleIndex) or the offset is beyond its end. The I/O thread is asked to read the points beyond the preload; any data that was buffered for the stream is dropped.
+/// </summary>
+bool sample_streamer_t::Start(uint32_t stream, uint32_t sampleIndex, uint32_t offset, bool isLooping) noexcept
+{
+    Stop(stream);
+
+    if ((sampleIndex >= _Samples.size()) || (sampleIndex > MaxSampleIndex) || (offset >= _Samples[sampleIndex].Length))
+        return false;
+
+    auto & Voice = _Voices[stream];
+
+    const auto & Sample = _Samples[sampleIndex];
+
+    Voice.Position    = offset;
+    Voice.LastWake    = 0;
+    Voice.SampleIndex = sampleIndex;
+    Voice.IsLooping   = IsLooped(Sample, isLooping);
+    Voice.IsActive    = true;
+
+    if (IsResident(sampleIndex, isLooping) && (offset < Sample.PreloadCount))
+        return true;
+
+    Voice.StreamStart = std::max(offset, Sample.PreloadCount);
+    Voice.Generation  = (Voice.Generation + 1) & GenerationMask;
+    Voice.IsStreaming = true;
+
+    _Streams[stream].Request.store(MakeRequest(Voice.Generation, true, Voice.IsLooping, sampleIndex, Voice.StreamStart), std::memory_order_release);
+
+    Wake();
+
+    return true;
+}
+
+/// <summary>
+/// Stops a stream. The I/O thread stops reading for it.
+/// </summary>
+void sample_streamer_t::Stop(uint32_t stream) noexcept
+{
+    auto & Voice = _Voices[stream];
+
+    Voice.IsActive = false;
+
+    if (!Voice.IsStreaming)
+        return;
+
+    Voice.IsStreaming = false;
+    Voice.Generation  = (Voice.Generation + 1) & GenerationMask;
+
+    _Streams[stream].Request.store(MakeRequest(Voice.Generation, false, false, 0, 0), std::memory_order_release);
+}
+
+/// <summary>
+/// Copies the next points of a stream, in playback order with the loop unrolled. Returns the number of points copied.
+/// Fewer points are returned at the end of a sample that doesn't loop (see IsFinished()) and when the I/O thread has fallen behind.
+/// </summary>
+uint32_t sample_streamer_t::Read(uint32_t stream, int16_t * data, uint32_t count) noexcept
+{
+    auto & Voice = _Voices[stream];
+
+    if (!Voice.IsActive)
+        return 0;
+
+    const auto & Sample = _Samples[Voice.SampleIndex];
+
+    const int16_t * Preload = _Preload.data() + Sample.PreloadOffset;
+
+    uint64_t Available = 0;
+
+    if (Voice.IsStreaming)
+    {
+        const uint64_t Produced = _Streams[stream].Produced.load(std::memory_order_acquire);
+
+        Available = (GetGeneration(Produced) == Voice.Generation) ? GetCount(Produced) : 0;
+    }
+
+    uint32_t Total = 0;
+
+    while (Total < count)
+    {
+        if (!Voice.IsLooping && (Voice.Position >= Sample.Length))
+            break;
+
+        uint32_t SegmentEnd;
+
+        const uint32_t Point = Map(Sample, Voice.IsLooping, Voice.Position, SegmentEnd);
+
+        uint32_t Size = std::min(count - Total, SegmentEnd - Point);
+
+        if (!Voice.IsStreaming || (Voice.Position < Voice.StreamStart))
+        {
+            if (Voice.IsStreaming)
+                Size = (uint32_t) std::min((uint64_t) Size, Voice.StreamStart - Voice.Position);
+
+            ::memcpy(data + Total, Preload + Point, Size * sizeof(int16_t));
+        }
+        else
+        {
+            const uint64_t Index = Voice.Position - Voice.StreamStart;
+
+            if (Index >= Available)
+            {
+                _UnderrunCount.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+
+            const uint32_t RingIndex = (uint32_t) (Index & (_RingSize - 1));
+
+            Size = (uint32_t) std::min({ (uint64_t) Size, Available - Index, (uint64_t) (_RingSize - RingIndex) });
+
+            ::memcpy(data + Total, _Rings.data() + (size_t) stream * _RingSize + RingIndex, Size * sizeof(int16_t));
+        }
+
+        Voice.Position += Size;
+        Total += Size;
+    }
+
+    if (Voice.IsStreaming && (Voice.Position > Voice.StreamStart))
+    {
+        const uint64_t Consumed = Voice.Position - Voice.StreamStart;
+
+        _Streams[stream].Consumed.store(MakeCount(Voice.Generation, Consumed), std::memory_order_release);
+
+        // Wake the I/O thread when the buffered points drop below half the ring, once for each fill that it published, or when it has fallen behind.
+        const uint64_t Buffered = (Available > Consumed) ? Available - Consumed : 0;
+
+        if (((Buffered < _RingSize / 2) && (Available != Voice.LastWake)) || (Total < count))
+        {
+            Voice.LastWake = Available;
+
+            Wake();
+        }
+    }
+
+    return Total;
+}
+
+/// <summary>
+/// Returns true if a stream is not playing or has reached the end of a sample that doesn't loop.
+/// </summary>
+bool sample_streamer_t::IsFinished(uint32_t stream) const noexcept
+{
+    const auto & Voice = _Voices[stream];
+
+    return !Voice.IsActive || (!Voice.IsLooping && (Voice.Position >= _Samples[Voice.SampleIndex].Length));
+}
+
+/// <summary>
+/// Returns true if a sample can be played from start to end, or through its loop, without reading from disk.
+/// </summary>
+bool sample_streamer_t::IsResident(uint32_t sampleIndex, bool isLooping) const noexcept
+{
+    if (sampleIndex >= _Samples.size())
+        return false;
+
+    const auto & Sample = _Samples[sampleIndex];
+
+    return (Sample.PreloadCount == Sample.Length) || (IsLooped(Sample, isLooping) && (Sample.LoopEnd <= Sample.PreloadCount));
+}
+
+/// <summary>
+/// Opens the file, reads the preload of each sample and starts the I/O thread.
+/// </summary>
+void sample_streamer_t::Initialize(const std::filesystem::path & filePath, uint64_t dataOffset, const sample_streamer_options_t & options)
+{
+    if ((options.MaxStreams == 0) || (options.ReadPoints == 0))
+        throw sf::exception("Invalid sample streamer options");
+
+    _Reader = std::make_unique<async_reader_t>(filePath);
+
+    _DataOffset    = dataOffset;
+    _PreloadPoints = options.PreloadPoints;
+    _ReadPoints    = options.ReadPoints;
+    _RingSize      = std::bit_ceil(std::max(options.StreamPoints, options.ReadPoints));
+
+    // Read the preloads in one batch.
+    size_t PreloadSize = 0;
+
+    for (auto & Sample : _Samples)
+    {
+        Sample.PreloadOffset = PreloadSize;
+        Sample.PreloadCount  = std::min(Sample.Length, _PreloadPoints);
+
+        PreloadSize += Sample.PreloadCount;
+    }
+
+    _Preload.resize(PreloadSize);
+
+    for (const auto & Sample : _Samples)
+    {
+        if (Sample.PreloadCount != 0)
+            _Batch.push_back({ _DataOffset + (uint64_t) Sample.Start * sizeof(int16_t), _Preload.data() + Sample.PreloadOffset, Sample.PreloadCount * (uint32_t) sizeof(int16_t), 0 });
+    }
+
+    _Reader->Read(_Batch);
+
+    for (const auto & Request : _Batch)
+    {
+        if (Request.BytesRead != Request.Size)
+            throw sf::exception("Failed to read the sample data");
+
+        _BytesRead.fetch_add(Request.BytesRead, std::memory_order_relaxed);
+    }
+
+    _Batch.clear();
+
+    // Create the streams.
+    _Streams = std::make_unique<stream_t[]>(options.MaxStreams);
+    _Voices.assign(options.MaxStreams, voice_t());
+    _Producers.assign(options.MaxStreams, producer_t());
+    _Rings.resize((size_t) options.MaxStreams * _RingSize);
+
+    _Fills.reserve(options.MaxStreams);
+
+    _Thread = std::thread(&sample_streamer_t::Run, this);
+}
+
+/// <summary>
+/// Adds a sample header. Samples that are not within the sample data are played as silence of zero length.
+/// </summary>
+void sample_streamer_t::AddSample(uint32_t start, uint32_t end, uint32_t loopStart, uint32_t loopEnd) noexcept
+{
+    sample_info_t Info = { };
+
+    if (end > start)
+    {
+        Info.Start  = start;
+        Info.Length = end - start;
+
+        if ((loopStart >= start) && (loopEnd > loopStart) && (loopEnd <= end))
+        {
+            Info.LoopStart = loopStart - start;
+            Info.LoopEnd   = loopEnd - start;
+        }
+    }
+
+    _Samples.push_back(Info);
+}
+
+/// <summary>
+/// Fills the ring buffers until the streamer is destroyed. The reads of all streams that have room are submitted as one batch. Sleeps when all buffers are full.
+/// </summary>
+void sample_streamer_t::Run() noexcept
+{
+    while (!_IsStopping.load())
+    {
+        _Pending.store(0);
+
+        _Batch.clear();
+        _Fills.clear();
+
+        bool HasWork = false;
+
+        try
+        {
+            for (uint32_t i = 0; i < _Voices.size(); ++i)
+                HasWork |= Prepare(i);
+
+            if (!_Batch.empty())
+                _Reader->Read(_Batch);
+        }
+        catch (...)
+        {
+            // Failed reads are played as silence.
+        }
+
+        for (const auto & Fill : _Fills)
+            Publish(Fill);
+
+        if (!HasWork)
+            _Pending.wait(0);
+    }
+}
+
+/// <summary>
+/// Adds the reads of the next points of a stream to the batch. Returns true if data will be read.
+/// </summary>
+bool sample_streamer_t::Prepare(uint32_t stream)
+{
+    auto & Stream = _Streams[stream];
+    auto & Producer = _Producers[stream];
+
+    const uint64_t Request = Stream.Request.load(std::memory_order_acquire);
+
+    const uint32_t Generation = GetGeneration(Request);
+
+    if (Request != Producer.Request)
+    {
+        Producer.Request = Request;
+        Producer.Filled  = 0;
+
+        Stream.Produced.store(MakeCount(Generation, 0), std::memory_order_release);
+    }
+
+    if ((Request & (1ull << 49)) == 0)
+        return false;
+
+    const bool IsLooping       = (Request & (1ull << 48)) != 0;
+    const uint32_t SampleIndex = (uint32_t) (Request >> 32) & MaxSampleIndex;
+    const uint32_t StreamStart = (uint32_t) Request;
+
+    const auto & Sample = _Samples[SampleIndex];
+
+    // The stream hasn't consumed any points of this request until it publishes a count of its generation, so the whole ring can be filled.
+    const uint64_t Consumed = Stream.Consumed.load(std::memory_order_acquire);
+
+    const uint64_t ConsumedCount = (GetGeneration(Consumed) == Generation) ? GetCount(Consumed) : 0;
+
+    const uint64_t Free = _RingSize - (Producer.Filled - ConsumedCount);
+
+    uint64_t Position = StreamStart + Producer.Filled;
+
+    const uint64_t Remaining = IsLooping ? UINT64_MAX : ((Position < Sample.Length) ? Sample.Length - Position : 0);
+
+    // Read in chunks of ReadPoints, except at the end of the sample.
+    uint64_t Count = std::min((uint64_t) _ReadPoints, Remaining);
+
+    if ((Count == 0) || (Free < Count))
+        return false;
+
+    int16_t * Ring = _Rings.data() + (size_t) stream * _RingSize;
+
+    fill_t Fill;
+
+    Fill.Request      = Request;
+    Fill.Filled       = Producer.Filled;
+    Fill.Stream       = stream;
+    Fill.FirstRequest = (uint32_t) _Batch.size();
+    Fill.RequestCount = 0;
+
+    while (Count != 0)
+    {
+        uint32_t SegmentEnd;
+
+        const uint32_t Point = Map(Sample, IsLooping, Position, SegmentEnd);
+        const uint32_t RingIndex = (uint32_t) (Fill.Filled & (_RingSize - 1));
+
+        const uint32_t Size = (uint32_t) std::min({ Count, (uint64_t) (SegmentEnd - Point), (uint64_t) (_RingSize - RingIndex) });
+
+        _Batch.push_back({ _DataOffset + ((uint64_t) Sample.Start + Point) * sizeof(int16_t), Ring + RingIndex, Size * (uint32_t) sizeof(int16_t), 0 });
+
+        ++Fill.RequestCount;
+
+        Position    += Size;
+        Fill.Filled += Size;
+        Count       -= Size;
+    }
+
+    _Fills.push_back(Fill);
+
+    return true;
+}
+
+/// <summary>
+/// Makes the points of a completed fill available to the stream.
+/// </summary>
+void sample_streamer_t::Publish(const fill_t & fill) noexcept
+{
+    for (uint32_t i = fill.FirstRequest; i < fill.FirstRequest + fill.RequestCount; ++i)
+    {
+        const auto & Request = _Batch[i];
+
+        // Play a truncated file as silence.
+        if (Request.BytesRead != Request.Size)
+            ::memset((uint8_t *) Request.Data + Request.BytesRead, 0, Request.Size - Request.BytesRead);
+
+        _BytesRead.fetch_add(Request.BytesRead, std::memory_order_relaxed);
+    }
+
+    auto & Stream = _Streams[fill.Stream];
+
+    // Drop the data if the stream was restarted during the read.
+    if (Stream.Request.load(std::memory_order_acquire) != fill.Request)
+        return;
+
+    _Producers[fill.Stream].Filled = fill.Filled;
+
+    Stream.Produced.store(MakeCount(GetGeneration(fill.Request), fill.Filled), std::memory_order_release);
+}
+
+/// <summary>
+/// Wakes the I/O thread.
+/// </summary>
+void sample_streamer_t::Wake() noexcept
+{
+    _Pending.store(1);
+    _Pending.notify_one();
+}
+
+/// <summary>
+/// Maps a position with the loop unrolled to a point of the sample. Returns the point and the end of the contiguous segment that contains it.
+/// </summary>
+uint32_t sample_streamer_t::Map(const sample_info_t & sample, bool isLooping, uint64_t position, uint32_t & segmentEnd) noexcept
+{
+    if (!isLooping)
+    {
+        segmentEnd = sample.Length;
+
+        return (uint32_t) position;
+    }
+
+    segmentEnd = sample.LoopEnd;
+
+    if (position < sample.LoopEnd)
+        return (uint32_t) position;
+
+    return sample.LoopStart + (uint32_t) ((position - sample.LoopStart) % (sample.LoopEnd - sample.LoopStart));
+}
@@ -0,0 +1,192 @@
+
+/** $VER: ThreadPool.cpp (2026.10.18) P. Stuer - Work-stealing thread pool **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+#include "ThreadPool.h"
+
+using namespace sf;
+
+namespace
+{
+    // Identifies the pool and queue of the current worker thread so tasks submitted by a task end up in the queue of that worker.
+    thread_local const thread_pool_t * CurrentPool = nullptr;
+    thread_local size_t CurrentQueue = 0;
+}
+
+/// <summary>
+/// Initializes a new instance. A thread count of 0 creates a worker for each hardware thread.
+/// </summary>
+thread_pool_t::thread_pool_t(size_t threadCount) : _QueuedCount(), _PendingCount(), _IsStopping(), _NextQueue()
+{
+    if (threadCount == 0)
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    _Queues.reserve(threadCount);
+
+    for (size_t i = 0; i < threadCount; ++i)
+        _Queues.push_back(std::make_unique<queue_t>());
+
+    _Threads.reserve(threadCount);
+
+    for (size_t i = 0; i < threadCount; ++i)
+        _Threads.emplace_back(&thread_pool_t::Run, this, i);
+}
+
+/// <summary>
+/// Finishes the queued tasks and stops the workers.
+/// </summary>
+thread_pool_t::~thread_pool_t()
+{
+    {
+        std::lock_guard Lock(_Mutex);
+
+        _IsStopping = true;
+    }
+
+    _TaskAvailable.notify_all();
+
+    for (auto & Thread : _Threads)
+        Thread.join();
+}
+
+/// <summary>
+/// Queues a task. Tasks submitted from a worker thread are queued on that worker; other tasks are distributed round-robin.
+/// </summary>
+void thread_pool_t::Submit(task_t task)
+{
+    {
+        std::lock_guard Lock(_Mutex);
+
+        ++_PendingCount;
+    }
+
+    const size_t Index = (CurrentPool == this) ? CurrentQueue : (_NextQueue++ % _Queues.size());
+
+    {
+        auto & Queue = *_Queues[Index];
+
+        std::lock_guard Lock(Queue.Mutex);
+
+        Queue.Tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard Lock(_Mutex);
+
+        ++_QueuedCount;
+    }
+
+    _TaskAvailable.notify_one();
+}
+
+/// <summary>
+/// Waits until all submitted tasks have finished. Rethrows the first exception thrown by a task. Must not be called from a task.
+/// </summary>
+void thread_pool_t::Wait()
+{
+    std::unique_lock Lock(_Mutex);
+
+    _TasksDone.wait(Lock, [this] { return _PendingCount == 0; });
+
+    if (_Exception)
+    {
+        auto Exception = _Exception;
+
+        _Exception = nullptr;
+
+        std::rethrow_exception(Exception);
+    }
+}
+
+/// <summary>
+/// Executes tasks until the pool is stopped.
+/// </summary>
+void thread_pool_t::Run(size_t index) noexcept
+{
+    CurrentPool  = this;
+    CurrentQueue = index;
+
+    for (;;)
+    {
+        task_t Task;
+
+        if (Pop(index, Task))
+        {
+            std::exception_ptr Exception;
+
+            try
+            {
+                Task();
+            }
+            catch (...)
+            {
+                Exception = std::current_exception();
+            }
+
+            bool IsDone;
+
+            {
+                std::lock_guard Lock(_Mutex);
+
+                if (Exception && !_Exception)
+                    _Exception = Exception;
+
+                IsDone = (--_PendingCount == 0);
+            }
+
+            if (IsDone)
+                _TasksDone.notify_all();
+
+            continue;
+        }
+
+        std::unique_lock Lock(_Mutex);
+
+        _TaskAvailable.wait(Lock, [this] { return _IsStopping || (_QueuedCount > 0); });
+
+        if (_IsStopping && (_QueuedCount <= 0))
+            break;
+    }
+}
+
+/// <summary>
+/// Takes the most recent task from the worker's own queue or steals the oldest task from another queue.
+/// </summary>
+bool thread_pool_t::Pop(size_t index, task_t & task) noexcept
+{
+    const size_t Count = _Queues.size();
+
+    for (size_t i = 0; i < Count; ++i)
+    {
+        auto & Queue = *_Queues[(index + i) % Count];
+
+        {
+            std::lock_guard Lock(Queue.Mutex);
+
+            if (Queue.Tasks.empty())
+                continue;
+
+            if (i == 0)
+            {
+                task = std::move(Queue.Tasks.back());
+                Queue.Tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(Queue.Tasks.front());
+                Queue.Tasks.pop_front();
+            }
+        }
+
+        std::lock_guard Lock(_Mutex);
+
+        --_QueuedCount;
+
+        return true;
+    }
+
+    return false;
+}
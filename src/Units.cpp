@@ -0,0 +1,34 @@
+
+/** $VER: Units.cpp (2026.10.18) P. Stuer - Conversion of the logarithmic generator units using lookup tables **/
+
+#include "pch.h"
+
+#include "libsf.h"
+
+using namespace sf;
+
+namespace
+{
+    /// <summary>
+    /// Creates the table of 2^(i / 1200) for 1 octave. The extra entry lets Exp2Cents() interpolate without a check.
+    /// </summary>
+    std::vector<float> CreateExp2Table()
+    {
+        std::vector<float> Table(units::Exp2Steps + 1);
+
+        for (int32_t i = 0; i <= units::Exp2Steps; ++i)
+            Table[(size_t) i] = (float) std::exp2((double) i / units::Exp2Steps);
+
+        return Table;
+    }
+}
+
+/// <summary>
+/// Gets the exp2 table.
+/// </summary>
+const float * units::GetExp2Table() noexcept
+{
+    static const std::vector<float> Table = CreateExp2Table();
+
+    return Table.data();
+}
@@ -1,5 +1,5 @@
 
-/** $VER: SoundFont.cpp (2025.09.09) P. Stuer **/
+/** $VER: SoundFont.cpp (2026.10.18) P. Stuer **/
 
 #include "pch.h"
 
@@ -7,8 +7,6 @@
 
 #include "SF2.h"
 
-#include <mmreg.h>
-
 using namespace sf;
 
 static void ApplyKeyNumToCorrection(std::vector<sf::generator_t> & generators, int16_t value, GeneratorOperator keynumToOperator, GeneratorOperator realOperator);
@@ -18,24 +16,14 @@ static void ApplyKeyNumToCorrection(std::vector<sf::generator_t> & generators, i
 /// </summary>
 void bank_t::ConvertFrom(const dls::collection_t & collection)
 {
+    METRICS_SCOPE("sf::bank_t::ConvertFrom");
+
     Major       = 2;
     Minor       = 4;
     SoundEngine = "E-mu 10K2"; // https://en.wikipedia.org/wiki/E-mu_20K
     Name        = GetPropertyValue(collection.Properties, FOURCC_INAM);
 
-    {
-         SYSTEMTIME st = {};
-
-        ::GetLocalTime(&st);
-
-        char Date[32] = { };
-        char Time[32] = { };
-
-        ::GetDateFormatA(LOCALE_USER_DEFAULT, 0, &st, "yyyy-MM-dd", Date, sizeof(Date));
-        ::GetTimeFormatA(LOCALE_USER_DEFAULT, 0, &st, "HH:mm:ss", Time, sizeof(Time));
-
-        Properties.push_back(sf::property_t(FOURCC_ICRD, std::string(Date) + " " + std::string(Time)));
-    }
+    Properties.push_back(sf::property_t(FOURCC_ICRD, platform::GetLocalDateTime()));
 
     for (const auto & Property : collection.Properties)
     {
@@ -50,11 +38,33 @@ void bank_t::ConvertFrom(const dls::collection_t & collection)
     ConvertWaves(collection);
 }
 
+/// <summary>
+/// Gets the approximate number of bytes the bank occupies in memory: the sample data and the definitions, without the names. Shared samples are not included.
+/// </summary>
+size_t bank_t::GetMemorySize() const noexcept
+{
+    return
+        SampleData.size() +
+        SampleDataLSB.size() +
+        Presets.size()              * sizeof(preset_t) +
+        PresetZones.size()          * sizeof(preset_zone_t) +
+        PresetGenerators.size()     * sizeof(generator_t) +
+        PresetModulators.size()     * sizeof(modulator_t) +
+        Instruments.size()          * sizeof(instrument_t) +
+        InstrumentZones.size()      * sizeof(instrument_zone_t) +
+        InstrumentGenerators.size() * sizeof(generator_t) +
+        InstrumentModulators.size() * sizeof(modulator_t) +
+        Samples.size()              * sizeof(sample_t) +
+        SampleBlocks.size()         * sizeof(SampleBlocks[0]);
+}
+
 /// <summary>
 /// Converts the DLS instruments to SF2 presets and instruments.
 /// </summary>
 void bank_t::ConvertInstruments(const dls::collection_t & collection)
 {
+    METRICS_SCOPE("sf::bank_t::ConvertInstruments");
+
     for (const auto & Instrument : collection.Instruments)
     {
         // Use bank LSB if bank MSB is zero. This might indicate we're converting an XG collection.
@@ -294,6 +304,8 @@ void bank_t::ConvertRegions(const dls::collection_t & collection, const sf::dls:
 /// </summary>
 void bank_t::ConvertWaves(const dls::collection_t & collection)
 {
+    METRICS_SCOPE("sf::bank_t::ConvertWaves");
+
     a_law_codec_t ALawCodec;
 
     // Calculate the size of the sample data buffer.
@@ -1,12 +1,15 @@
 
-/** $VER: framework.h (2025.09.06) P. Stuer **/
+/** $VER: framework.h (2026.10.18) P. Stuer **/
 
 #pragma once
 
+#ifdef _MSC_VER
 #include <CppCoreCheck/Warnings.h>
 
 #pragma warning(disable: 4100 4625 4626 4710 4711 4738 5045 ALL_CPPCORECHECK_WARNINGS)
+#endif
 
+#ifdef _WIN32
 #include <SDKDDKVer.h>
 
 #define NOMINMAX
@@ -14,11 +17,11 @@
 #include <WinSock2.h>
 #include <Windows.h>
 #include <wincodec.h>
+#endif
 
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
-#include <strsafe.h>
 #include <string.h>
 
 #pragma warning(disable: 4242)
@@ -26,6 +29,7 @@
 #pragma warning(default: 4242)
 #include <cmath>
 #include <cassert>
+#include <cstring>
 #include <format>
 #include <functional>
 #include <stdexcept>
@@ -39,7 +43,7 @@
 #include <libmsc.h>
 
 #ifndef Assert
-#if defined(DEBUG) || defined(_DEBUG)
+#if (defined(DEBUG) || defined(_DEBUG)) && defined(_WIN32)
 #define Assert(b) do {if (!(b)) { ::OutputDebugStringA("Assert: " #b "\n");}} while(0)
 #else
 #define Assert(b)
@@ -49,7 +53,7 @@
 #define TOSTRING_IMPL(x) #x
 #define TOSTRING(x) TOSTRING_IMPL(x)
 
-#ifndef THIS_HINSTANCE
+#if defined(_WIN32) && !defined(THIS_HINSTANCE)
 EXTERN_C IMAGE_DOS_HEADER __ImageBase;
 #define THIS_HINSTANCE ((HINSTANCE) &__ImageBase)
 #endif
@@ -0,0 +1,854 @@
+
+/** $VER: main.cpp (2026.10.18) P. Stuer - Measures the read, convert, write, cache, render, interpolation, filter and articulation throughput of libsf **/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <map>
+#include <numbers>
+#include <string>
+#include <vector>
+
+#include <libsf.h>
+
+namespace fs = std::filesystem;
+
+using namespace sf;
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Accumulates the throughput of a benchmark phase.
+/// </summary>
+struct phase_t
+{
+    const char * Name;
+
+    uint64_t Files;
+    uint64_t Bytes;
+    double Seconds;
+};
+
+/// <summary>
+/// Describes the synthetic collection.
+/// </summary>
+struct synthetic_options_t
+{
+    uint32_t Instruments = 128;
+    uint32_t Regions     = 8;           // Regions per instrument
+    uint32_t Waves       = 256;
+    uint32_t WaveLength  = 32768;       // in samples
+};
+
+/// <summary>
+/// Describes the note stream that is rendered for each bank.
+/// </summary>
+struct render_options_t
+{
+    uint32_t Seconds    = 10;           // Audio rendered per bank
+    uint32_t Voices     = 64;           // Notes struck at the start of every second
+    uint32_t SampleRate = 44100;
+    uint32_t GuardPoints = 0;           // Lay out the sample pool with bank_t::PadSamples() first, 0 to render the original layout
+    uint32_t Controllers = 0;           // Controller changes per second on each channel, cycling through modulation wheel, expression and pitch wheel
+};
+
+/// <summary>
+/// Accumulates the throughput of the renderer.
+/// </summary>
+struct render_phase_t
+{
+    uint64_t Banks;
+    uint64_t VoiceFrames;
+    double AudioSeconds;
+    double Seconds;
+};
+
+#pragma warning(default: 4820) // x bytes padding
+
+static void BenchmarkSynthetic(const synthetic_options_t & options, uint32_t iterations, const fs::path & tempPath);
+static void BenchmarkFile(const fs::path & filePath, uint32_t iterations, const fs::path & tempPath);
+static void BenchmarkCache(const bank_t & bank, const fs::path & sourcePath, const fs::path & tempPath);
+static void BenchmarkRender(const bank_t & bank);
+static void BenchmarkInterpolators();
+static void BenchmarkFilter();
+static void BenchmarkArticulation();
+
+static dls::collection_t CreateCollection(const synthetic_options_t & options);
+
+static void ReadBank(const fs::path & filePath, bank_t & bank);
+static void ReadCollection(const fs::path & filePath, dls::collection_t & collection);
+static void ReadWaveset(const fs::path & filePath, ecw::waveset_t & waveset);
+static void WriteBank(const fs::path & filePath, const bank_t & bank);
+
+static void Report(const char * title, const std::vector<phase_t> & phases);
+static void ReportRender();
+
+/// <summary>
+/// Measures the duration of a phase.
+/// </summary>
+template <typename F> static void Measure(phase_t & phase, uint64_t bytes, F && f)
+{
+    const auto Start = std::chrono::steady_clock::now();
+
+    f();
+
+    phase.Seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    phase.Bytes   += bytes;
+    phase.Files   += 1;
+}
+
+static std::vector<phase_t> Phases =
+{
+    { "Read SF2",    0, 0, 0. },
+    { "Read DLS",    0, 0, 0. },
+    { "Read ECW",    0, 0, 0. },
+    { "Map ECW",     0, 0, 0. },
+    { "Convert DLS", 0, 0, 0. },
+    { "Convert ECW", 0, 0, 0. },
+    { "Write SF2",   0, 0, 0. },
+    { "Write cache", 0, 0, 0. },
+    { "Open cache",  0, 0, 0. },
+};
+
+enum PhaseIndex { ReadSF2, ReadDLS, ReadECW, MapECW, ConvertDLS, ConvertECW, WriteSF2, WriteCache, OpenCache };
+
+static render_options_t RenderOptions;
+static render_phase_t RenderPhase;
+static bool RunRender = true;
+static bool RunInterpolators = true;
+static uint32_t ArticulationVoices = 256;
+
+static void Usage()
+{
+    ::printf("Usage: libsf_bench [-i iterations] [-instruments n] [-regions n] [-waves n] [-length n] [-nosynthetic] [-seconds n] [-voices n] [-padding n] [-controllers n] [-norender] [-nokernels] [-articulation n] [file or directory ...]\n");
+}
+
+int main(int argc, char * argv[])
+{
+    synthetic_options_t Options;
+
+    uint32_t Iterations = 5;
+    bool RunSynthetic = true;
+
+    std::vector<fs::path> Paths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char * Arg = argv[i];
+
+        auto NextValue = [&]() -> uint32_t
+        {
+            if (i + 1 >= argc)
+            {
+                Usage();
+
+                ::exit(-1);
+            }
+
+            return (uint32_t) ::strtoul(argv[++i], nullptr, 10);
+        };
+
+        if (::strcmp(Arg, "-i") == 0)            Iterations          = std::max(NextValue(), 1u);
+        else
+        if (::strcmp(Arg, "-instruments") == 0)  Options.Instruments = NextValue();
+        else
+        if (::strcmp(Arg, "-regions") == 0)      Options.Regions     = NextValue();
+        else
+        if (::strcmp(Arg, "-waves") == 0)        Options.Waves       = std::max(NextValue(), 1u);
+        else
+        if (::strcmp(Arg, "-length") == 0)       Options.WaveLength  = std::max(NextValue(), 2u);
+        else
+        if (::strcmp(Arg, "-nosynthetic") == 0)  RunSynthetic        = false;
+        else
+        if (::strcmp(Arg, "-seconds") == 0)      RenderOptions.Seconds = std::max(NextValue(), 1u);
+        else
+        if (::strcmp(Arg, "-voices") == 0)       RenderOptions.Voices  = std::max(NextValue(), 1u);
+        else
+        if (::strcmp(Arg, "-padding") == 0)      RenderOptions.GuardPoints = NextValue();
+        else
+        if (::strcmp(Arg, "-controllers") == 0)  RenderOptions.Controllers = NextValue();
+        else
+        if (::strcmp(Arg, "-norender") == 0)     RunRender           = false;
+        else
+        if (::strcmp(Arg, "-nokernels") == 0)    RunInterpolators    = false;
+        else
+        if (::strcmp(Arg, "-articulation") == 0) ArticulationVoices  = NextValue();
+        else
+        if ((::strcmp(Arg, "-h") == 0) || (::strcmp(Arg, "--help") == 0))
+        {
+            Usage();
+
+            return 0;
+        }
+        else
+            Paths.push_back(fs::path(Arg));
+    }
+
+    const fs::path TempPath = fs::temp_directory_path() / ("libsf_bench." + std::to_string((uint64_t) std::chrono::steady_clock::now().time_since_epoch().count()) + ".sf2");
+
+    try
+    {
+        if (RunInterpolators)
+        {
+            BenchmarkInterpolators();
+            BenchmarkFilter();
+        }
+
+        if (ArticulationVoices != 0)
+            BenchmarkArticulation();
+
+        if (RunSynthetic)
+        {
+            BenchmarkSynthetic(Options, Iterations, TempPath);
+
+            Report(msc::FormatText("Synthetic: %u instruments, %u regions, %u waves of %u samples, %u iterations", Options.Instruments, Options.Regions, Options.Waves, Options.WaveLength, Iterations).c_str(), Phases);
+            ReportRender();
+        }
+
+        if (!Paths.empty())
+        {
+            for (auto & Phase : Phases)
+                Phase = { Phase.Name, 0, 0, 0. };
+
+            RenderPhase = { };
+
+            for (const auto & Path : Paths)
+            {
+                if (fs::is_directory(Path))
+                {
+                    for (const auto & Entry : fs::recursive_directory_iterator(Path, fs::directory_options::skip_permission_denied))
+                    {
+                        if (Entry.is_regular_file())
+                            BenchmarkFile(Entry.path(), Iterations, TempPath);
+                    }
+                }
+                else
+                    BenchmarkFile(Path, Iterations, TempPath);
+            }
+
+            Report(msc::FormatText("Files: %u iterations", Iterations).c_str(), Phases);
+            ReportRender();
+        }
+    }
+    catch (const std::exception & e)
+    {
+        ::printf("Error: %s\n", e.what());
+
+        std::error_code ec;
+
+        fs::remove(TempPath, ec);
+
+        return -1;
+    }
+
+    std::error_code ec;
+
+    fs::remove(TempPath, ec);
+
+    return 0;
+}
+
+/// <summary>
+/// Converts, writes and reads a synthetic collection.
+/// </summary>
+static void BenchmarkSynthetic(const synthetic_options_t & options, uint32_t iterations, const fs::path & tempPath)
+{
+    const auto Collection = CreateCollection(options);
+
+    uint64_t CollectionSize = 0;
+
+    for (const auto & Wave : Collection.Waves)
+        CollectionSize += Wave.Data.size();
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        bank_t Bank;
+
+        Measure(Phases[ConvertDLS], CollectionSize, [&]() { Bank.ConvertFrom(Collection); });
+
+        Measure(Phases[WriteSF2], 0, [&]() { WriteBank(tempPath, Bank); });
+
+        const uint64_t BankSize = (uint64_t) fs::file_size(tempPath);
+
+        Phases[WriteSF2].Bytes += BankSize;
+
+        bank_t Copy;
+
+        Measure(Phases[ReadSF2], BankSize, [&]() { ReadBank(tempPath, Copy); });
+
+        if (Copy.Samples.size() != Bank.Samples.size())
+            throw sf::exception(msc::FormatText("Round trip failed: wrote %zu samples, read %zu", Bank.Samples.size(), Copy.Samples.size()));
+
+        BenchmarkCache(Copy, tempPath, tempPath);
+
+        BenchmarkRender(Copy);
+    }
+}
+
+/// <summary>
+/// Reads a bank, collection or waveset. DLS collections and wavesets are also converted and all banks are written back to a temporary file.
+/// </summary>
+static void BenchmarkFile(const fs::path & filePath, uint32_t iterations, const fs::path & tempPath)
+{
+    std::string Extension = filePath.extension().string();
+
+    for (auto & c : Extension)
+        c = (char) ::tolower((unsigned char) c);
+
+    const uint64_t FileSize = (uint64_t) fs::file_size(filePath);
+
+    try
+    {
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            if ((Extension == ".sf2") || (Extension == ".sbk") || (Extension == ".sf3"))
+            {
+                bank_t Bank;
+
+                Measure(Phases[ReadSF2], FileSize, [&]() { ReadBank(filePath, Bank); });
+                Measure(Phases[WriteSF2], 0, [&]() { WriteBank(tempPath, Bank); });
+
+                Phases[WriteSF2].Bytes += (uint64_t) fs::file_size(tempPath);
+
+                BenchmarkCache(Bank, filePath, tempPath);
+                BenchmarkRender(Bank);
+            }
+            else
+            if ((Extension == ".dls") || (Extension == ".dlp"))
+            {
+                dls::collection_t Collection;
+
+                Measure(Phases[ReadDLS], FileSize, [&]() { ReadCollection(filePath, Collection); });
+
+                bank_t Bank;
+
+                Measure(Phases[ConvertDLS], FileSize, [&]() { Bank.ConvertFrom(Collection); });
+                Measure(Phases[WriteSF2], 0, [&]() { WriteBank(tempPath, Bank); });
+
+                Phases[WriteSF2].Bytes += (uint64_t) fs::file_size(tempPath);
+
+                BenchmarkCache(Bank, filePath, tempPath);
+                BenchmarkRender(Bank);
+            }
+            else
+            if (Extension == ".ecw")
+            {
+                ecw::waveset_t Waveset;
+
+                Measure(Phases[ReadECW], FileSize, [&]() { ReadWaveset(filePath, Waveset); });
+
+                Measure(Phases[MapECW], FileSize, [&]()
+                {
+                    ecw::mapped_reader_t er;
+                    ecw::waveset_t Mapped;
+
+                    er.Open(filePath);
+                    er.Process(Mapped);
+                });
+
+                bank_t Bank;
+
+                Measure(Phases[ConvertECW], FileSize, [&]() { Bank.ConvertFrom(Waveset); });
+                Measure(Phases[WriteSF2], 0, [&]() { WriteBank(tempPath, Bank); });
+
+                Phases[WriteSF2].Bytes += (uint64_t) fs::file_size(tempPath);
+
+                BenchmarkCache(Bank, filePath, tempPath);
+                BenchmarkRender(Bank);
+            }
+            else
+                return;
+        }
+    }
+    catch (const std::exception & e)
+    {
+        ::printf("Skipped \"%s\": %s\n", (const char *) filePath.u8string().c_str(), e.what());
+    }
+}
+
+/// <summary>
+/// Writes a bank cache next to the temporary bank and maps it back. The cache is keyed by the content hash of the source file, which is not measured.
+/// </summary>
+static void BenchmarkCache(const bank_t & bank, const fs::path & sourcePath, const fs::path & tempPath)
+{
+    const uint64_t SourceHash = catalog_t::HashFile(sourcePath);
+
+    fs::path CachePath = tempPath;
+
+    CachePath.replace_extension(".sfc");
+
+    Measure(Phases[WriteCache], 0, [&]() { bank_cache_t::Write(CachePath, bank, SourceHash); });
+
+    const uint64_t CacheSize = (uint64_t) fs::file_size(CachePath);
+
+    Phases[WriteCache].Bytes += CacheSize;
+
+    {
+        bank_cache_t Cache;
+
+        Measure(Phases[OpenCache], CacheSize, [&]()
+        {
+            if (!Cache.Open(CachePath, SourceHash))
+                throw sf::exception("Failed to open the bank cache");
+        });
+
+        if (Cache.Samples().size() != bank.Samples.size())
+            throw sf::exception(msc::FormatText("Cache round trip failed: wrote %zu samples, read %zu", bank.Samples.size(), Cache.Samples().size()));
+    }
+
+    fs::remove(CachePath);
+}
+
+/// <summary>
+/// Renders a note stream with the presets of a bank on one core.
+/// </summary>
+static void BenchmarkRender(const bank_t & bank)
+{
+    if (!RunRender || (bank.Presets.size() < 2))
+        return;
+
+    renderer_options_t Options;
+
+    Options.SampleRate = RenderOptions.SampleRate;
+    Options.MaxVoices  = RenderOptions.Voices * 4; // Leave room for layered presets and releasing notes.
+
+    // The layout of the sample pool is changed outside of the measurement.
+    bank_t PaddedBank;
+
+    if (RenderOptions.GuardPoints != 0)
+    {
+        sample_padding_options_t PaddingOptions;
+
+        PaddingOptions.GuardPoints = RenderOptions.GuardPoints;
+
+        PaddedBank = bank;
+        PaddedBank.PadSamples(PaddingOptions);
+    }
+
+    renderer_t Renderer((RenderOptions.GuardPoints != 0) ? PaddedBank : bank, Options);
+
+    // Strike the notes at the start of every second and release them just before the next second starts.
+    std::vector<note_event_t> Events;
+
+    const size_t PresetCount = bank.Presets.size() - 1; // Skip the terminal record.
+
+    for (uint8_t i = 0; i < renderer_t::ChannelCount; ++i)
+    {
+        const auto & Preset = bank.Presets[i % PresetCount];
+
+        Events.push_back({ 0, note_event_type_t::ProgramChange, i, (uint8_t) Preset.MIDIProgram, 0, Preset.MIDIBank });
+    }
+
+    for (uint32_t i = 0; i < RenderOptions.Voices; ++i)
+        Events.push_back({ 0, note_event_type_t::NoteOn, (uint8_t) (i % renderer_t::ChannelCount), (uint8_t) (36 + (i * 7) % 60), 100, 0 });
+
+    for (uint32_t i = 0; i < RenderOptions.Voices; ++i)
+        Events.push_back({ RenderOptions.SampleRate - renderer_t::BlockSize * 4, note_event_type_t::NoteOff, (uint8_t) (i % renderer_t::ChannelCount), (uint8_t) (36 + (i * 7) % 60), 0, 0 });
+
+    // Sweep the controllers while the notes play.
+    for (uint32_t i = 1; i < RenderOptions.Controllers; ++i)
+    {
+        const uint64_t Time = (uint64_t) RenderOptions.SampleRate * i / RenderOptions.Controllers;
+        const uint16_t Value = (uint16_t) ((i * 127 / RenderOptions.Controllers) & 0x7F);
+
+        for (uint8_t j = 0; j < renderer_t::ChannelCount; ++j)
+        {
+            switch (i % 3)
+            {
+                case 0: Events.push_back({ Time, note_event_type_t::ControlChange, j,  1, 0, 0, Value }); break;
+                case 1: Events.push_back({ Time, note_event_type_t::ControlChange, j, 11, 0, 0, (uint16_t) (127 - Value) }); break;
+                case 2: Events.push_back({ Time, note_event_type_t::PitchBend,     j,  0, 0, 0, (uint16_t) (Value << 7) }); break;
+            }
+        }
+    }
+
+    std::stable_sort(Events.begin(), Events.end(), [](const note_event_t & a, const note_event_t & b) { return a.Time < b.Time; });
+
+    std::vector<float> Data((size_t) RenderOptions.SampleRate * 2);
+
+    const auto Start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < RenderOptions.Seconds; ++i)
+        Renderer.Render(Events, Data);
+
+    RenderPhase.Seconds      += std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    RenderPhase.AudioSeconds += RenderOptions.Seconds;
+    RenderPhase.VoiceFrames  += Renderer.GetVoiceFrameCount();
+    RenderPhase.Banks        += 1;
+}
+
+/// <summary>
+/// Measures the interpolation kernels for each instruction set the CPU supports, with and without 24-bit sample data.
+/// </summary>
+static void BenchmarkInterpolators()
+{
+    constexpr uint32_t PointCount  = 65536;
+    constexpr uint32_t FrameCount  = 1 << 24;
+    constexpr uint32_t BlockSize   = renderer_t::BlockSize;
+
+    std::vector<int16_t> Data(PointCount);
+    std::vector<uint8_t> DataLSB(PointCount);
+
+    const double Step = 2. * std::numbers::pi * 440. / 44100.;
+
+    for (uint32_t i = 0; i < PointCount; ++i)
+    {
+        const int32_t Value = (int32_t) (::sin(Step * i) * 4194304.); // 24-bit, -6 dB
+
+        Data[i]    = (int16_t) (Value >> 8);
+        DataLSB[i] = (uint8_t) Value;
+    }
+
+    const auto Supported = platform::GetInstructionSet();
+
+    ::printf("\nInterpolation: %u frames per kernel, 1 semitone up, looped, best instruction set: %s\n\n", FrameCount, platform::GetInstructionSetName(Supported));
+    ::printf("%-12s %-8s %6s %12s %10s\n", "Kernel", "ISA", "Bits", "Seconds", "MS/s");
+
+    std::vector<float> Output(BlockSize);
+
+    for (const auto Interpolation : { interpolation_t::Linear, interpolation_t::Cubic, interpolation_t::Sinc })
+    {
+        for (const auto InstructionSet : { instruction_set_t::Scalar, instruction_set_t::SSE2, instruction_set_t::AVX2, instruction_set_t::NEON })
+        {
+            const bool IsSupported = (InstructionSet == instruction_set_t::Scalar) || (InstructionSet == Supported) || ((InstructionSet == instruction_set_t::SSE2) && (Supported == instruction_set_t::AVX2));
+
+            const auto Interpolator = IsSupported ? GetInterpolator(Interpolation, InstructionSet) : nullptr;
+
+            if (Interpolator == nullptr)
+                continue;
+
+            for (const uint32_t Bits : { 16u, 24u })
+            {
+                const interpolator_source_t Source = { Data.data(), (Bits == 24) ? DataLSB.data() : nullptr, PointCount, 0, PointCount - 8, 100, PointCount - 100, 0, true };
+
+                uint64_t Position = 0;
+                const uint64_t Increment = (uint64_t) (1.0594630943592953 * 4294967296.);
+
+                const auto Start = std::chrono::steady_clock::now();
+
+                for (uint32_t i = 0; i < FrameCount; i += BlockSize)
+                    Interpolator(Source, Position, Increment, Output.data(), BlockSize);
+
+                const double Seconds = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count(), 1e-9);
+
+                ::printf("%-12s %-8s %6u %12.3f %10.1f\n", GetInterpolationName(Interpolation), platform::GetInstructionSetName(InstructionSet), Bits, Seconds, FrameCount / Seconds / 1e6);
+            }
+        }
+    }
+}
+
+/// <summary>
+/// Measures the low-pass filter, one voice at a time and in groups of lowpass_filter_t::Lanes voices.
+/// </summary>
+static void BenchmarkFilter()
+{
+    constexpr uint32_t VoiceCount = 256;
+    constexpr uint32_t FrameCount = 1 << 20;    // per voice
+    constexpr uint32_t BlockSize  = renderer_t::BlockSize;
+
+    lowpass_filter_t Filter(44100, VoiceCount);
+
+    std::vector<uint32_t> Slots(VoiceCount);
+    std::vector<float> Data((size_t) VoiceCount * BlockSize);
+    std::vector<float *> Buffers(VoiceCount);
+
+    for (uint32_t i = 0; i < VoiceCount; ++i)
+    {
+        Slots[i]   = i;
+        Buffers[i] = Data.data() + (size_t) i * BlockSize;
+
+        Filter.SetResonance(i, (float) (i % 8) * 30.f);
+    }
+
+    ::printf("\nLow-pass filter: %u voices, %u frames per voice, coefficients updated every %u frames\n\n", VoiceCount, FrameCount, BlockSize);
+    ::printf("%-12s %12s %10s\n", "Variant", "Seconds", "MS/s");
+
+    for (const bool IsGrouped : { false, true })
+    {
+        for (size_t i = 0; i < Data.size(); ++i)
+            Data[i] = (float) ((i * 7919) % 2001) / 1000.f - 1.f;
+
+        const auto Start = std::chrono::steady_clock::now();
+
+        for (uint32_t i = 0; i < FrameCount; i += BlockSize)
+        {
+            for (uint32_t j = 0; j < VoiceCount; ++j)
+                Filter.SetCutoff(j, 500.f + (float) ((i / BlockSize + j) % 64) * 200.f);
+
+            if (IsGrouped)
+                Filter.Process(Slots.data(), Buffers.data(), VoiceCount, BlockSize);
+            else
+            {
+                for (uint32_t j = 0; j < VoiceCount; ++j)
+                    Filter.Process(j, Buffers[j], BlockSize);
+            }
+        }
+
+        const double Seconds = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count(), 1e-9);
+
+        ::printf("%-12s %12.3f %10.1f\n", IsGrouped ? "Grouped" : "Per voice", Seconds, (double) VoiceCount * FrameCount / Seconds / 1e6);
+    }
+}
+
+/// <summary>
+/// Measures the envelope and LFO engine with many concurrent voices. Voices are released half-way their note and restarted when they finish.
+/// </summary>
+static void BenchmarkArticulation()
+{
+    constexpr uint32_t SampleRate = 44100;
+    constexpr uint32_t BlockSize  = renderer_t::BlockSize;
+    constexpr uint32_t Seconds    = 60;
+    constexpr uint32_t NoteFrames = SampleRate / 2;
+
+    region_t Region = { };
+
+    for (const auto & [Operator, Limit] : GeneratorLimits)
+        Region.Generators[(size_t) Operator] = Limit.Default;
+
+    // A typical sustained instrument with all modulation sources in use.
+    Region.Generators[(size_t) GeneratorOperator::attackVolEnv]     = -3986; // 0.1 s
+    Region.Generators[(size_t) GeneratorOperator::decayVolEnv]      = -1200; // 0.5 s
+    Region.Generators[(size_t) GeneratorOperator::sustainVolEnv]    = 100;
+    Region.Generators[(size_t) GeneratorOperator::releaseVolEnv]    = -2400; // 0.25 s
+    Region.Generators[(size_t) GeneratorOperator::attackModEnv]     = -2400;
+    Region.Generators[(size_t) GeneratorOperator::decayModEnv]      = 0;
+    Region.Generators[(size_t) GeneratorOperator::sustainModEnv]    = 500;
+    Region.Generators[(size_t) GeneratorOperator::modEnvToFilterFc] = 2400;
+    Region.Generators[(size_t) GeneratorOperator::modEnvToPitch]    = 10;
+    Region.Generators[(size_t) GeneratorOperator::modLfoToPitch]    = 5;
+    Region.Generators[(size_t) GeneratorOperator::modLfoToVolume]   = 10;
+    Region.Generators[(size_t) GeneratorOperator::modLfoToFilterFc] = 100;
+    Region.Generators[(size_t) GeneratorOperator::vibLfoToPitch]    = 20;
+    Region.Generators[(size_t) GeneratorOperator::delayVibLFO]      = -3986;
+
+    articulation_engine_t Engine(SampleRate, ArticulationVoices);
+
+    std::vector<uint32_t> Slots(ArticulationVoices);
+    std::vector<uint32_t> Ages(ArticulationVoices);
+
+    // Stagger the voices so that all stages are in use at any time.
+    for (uint32_t i = 0; i < ArticulationVoices; ++i)
+    {
+        Slots[i] = Engine.Start(Region, (int) (36 + (i * 7) % 60));
+        Ages[i]  = (uint32_t) (((uint64_t) i * NoteFrames / ArticulationVoices) / BlockSize * BlockSize);
+    }
+
+    const uint32_t BlockCount = Seconds * SampleRate / BlockSize;
+
+    double Sum = 0.;
+
+    const auto Start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < BlockCount; ++i)
+    {
+        Engine.Process(BlockSize);
+
+        const float * Gains = Engine.GetGains();
+
+        for (uint32_t j = 0; j < ArticulationVoices; ++j)
+        {
+            const uint32_t Slot = Slots[j];
+
+            Sum += Gains[Slot];
+
+            Ages[j] += BlockSize;
+
+            if (Ages[j] == NoteFrames / BlockSize * BlockSize)
+                Engine.Release(Slot);
+            else
+            if (Engine.IsFinished(Slot))
+            {
+                Engine.Free(Slot);
+
+                Slots[j] = Engine.Start(Region, (int) (36 + (j * 7) % 60));
+                Ages[j]  = 0;
+            }
+        }
+    }
+
+    const double Elapsed = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count(), 1e-9);
+
+    ::printf("\nArticulation: %u voices, %u Hz, %u frames per block, %u s of audio (checksum %.1f)\n\n", ArticulationVoices, SampleRate, BlockSize, Seconds, Sum);
+    ::printf("%-12s %12s %10s %10s %12s\n", "Phase", "Blocks", "Seconds", "Realtime", "Voices/s");
+    ::printf("%-12s %12u %10.3f %9.1fx %12.0f\n", "Articulate", BlockCount, Elapsed, Seconds / Elapsed, (double) ArticulationVoices * Seconds / Elapsed);
+}
+
+/// <summary>
+/// Creates a DLS collection with looped 16-bit sine waves.
+/// </summary>
+static dls::collection_t CreateCollection(const synthetic_options_t & options)
+{
+    dls::collection_t Collection;
+
+    Collection.Major = Collection.Minor = Collection.Revision = Collection.Build = 1;
+
+    Collection.Properties.push_back(property_t(FOURCC_INAM, "libsf_bench"));
+
+    Collection.Waves.reserve(options.Waves);
+
+    for (uint32_t i = 0; i < options.Waves; ++i)
+    {
+        dls::wave_t Wave;
+
+        Wave.Name           = msc::FormatText("Wave %u", i);
+        Wave.SamplesPerSec  = 44100;
+        Wave.BlockAlign     = 2;
+        Wave.AvgBytesPerSec = Wave.SamplesPerSec * Wave.BlockAlign;
+
+        Wave.WaveSample.UnityNote = (uint16_t) (36 + (i % 60));
+        Wave.WaveSample.Loops.push_back(dls::wave_sample_loop_t(dls::wave_sample_loop_t::WLOOP_TYPE_FORWARD, options.WaveLength / 2, options.WaveLength / 2));
+
+        Wave.Data.resize((size_t) options.WaveLength * 2);
+
+        auto * Data = (int16_t *) Wave.Data.data();
+
+        const double Step = 2. * std::numbers::pi * 440. / Wave.SamplesPerSec;
+
+        for (uint32_t j = 0; j < options.WaveLength; ++j)
+            Data[j] = (int16_t) (::sin(Step * j) * 16384.);
+
+        Collection.Waves.push_back(std::move(Wave));
+        Collection.Cues.push_back(i);
+    }
+
+    Collection.Instruments.reserve(options.Instruments);
+
+    for (uint32_t i = 0; i < options.Instruments; ++i)
+    {
+        dls::instrument_t Instrument;
+
+        Instrument.Name         = msc::FormatText("Instrument %u", i);
+        Instrument.Program      = (uint8_t) (i % 128);
+        Instrument.BankLSB      = (uint8_t) (i / 128);
+        Instrument.IsPercussion = false;
+
+        for (uint32_t j = 0; j < options.Regions; ++j)
+        {
+            const uint16_t LowKey  = (uint16_t) ((j * 128) / options.Regions);
+            const uint16_t HighKey = (uint16_t) ((((j + 1) * 128) / options.Regions) - 1);
+
+            dls::region_t Region(LowKey, HighKey, 0, 127, 0, 0, 0);
+
+            Region.WaveLink.CueIndex = (i * options.Regions + j) % options.Waves;
+
+            Instrument.Regions.push_back(std::move(Region));
+        }
+
+        Collection.Instruments.push_back(std::move(Instrument));
+    }
+
+    return Collection;
+}
+
+/// <summary>
+/// Reads a SoundFont bank.
+/// </summary>
+static void ReadBank(const fs::path & filePath, bank_t & bank)
+{
+    msc::file_stream_t fs;
+
+    if (!fs.Open(filePath))
+        throw sf::exception(msc::FormatText("Failed to open \"%s\"", (const char *) filePath.u8string().c_str()));
+
+    sf::reader_t sr;
+
+    if (sr.Open(&fs, riff::reader_t::option_t::None))
+        sr.Process(bank, sf::soundfont_reader_options_t(true));
+
+    fs.Close();
+}
+
+/// <summary>
+/// Reads a DLS collection.
+/// </summary>
+static void ReadCollection(const fs::path & filePath, dls::collection_t & collection)
+{
+    msc::file_stream_t fs;
+
+    if (!fs.Open(filePath))
+        throw sf::exception(msc::FormatText("Failed to open \"%s\"", (const char *) filePath.u8string().c_str()));
+
+    sf::dls::reader_t dr;
+
+    if (dr.Open(&fs, riff::reader_t::option_t::None))
+        dr.Process(collection, sf::dls::reader_options_t(true));
+
+    fs.Close();
+}
+
+/// <summary>
+/// Reads an ECW waveset.
+/// </summary>
+static void ReadWaveset(const fs::path & filePath, ecw::waveset_t & waveset)
+{
+    msc::file_stream_t fs;
+
+    if (!fs.Open(filePath))
+        throw sf::exception(msc::FormatText("Failed to open \"%s\"", (const char *) filePath.u8string().c_str()));
+
+    ecw::reader_t er;
+
+    if (er.Open(&fs))
+        er.Process(waveset);
+
+    fs.Close();
+}
+
+/// <summary>
+/// Writes a SoundFont bank.
+/// </summary>
+static void WriteBank(const fs::path & filePath, const bank_t & bank)
+{
+    msc::file_stream_t fs;
+
+    if (!fs.Open(filePath, true))
+        throw sf::exception(msc::FormatText("Failed to create \"%s\"", (const char *) filePath.u8string().c_str()));
+
+    sf::writer_t sw;
+
+    if (sw.Open(&fs, riff::writer_t::Options::PolyphoneCompatible))
+        sw.Process(bank);
+
+    fs.Close();
+}
+
+/// <summary>
+/// Prints the throughput of each phase that was executed.
+/// </summary>
+static void Report(const char * title, const std::vector<phase_t> & phases)
+{
+    ::printf("\n%s\n\n", title);
+    ::printf("%-12s %8s %12s %10s %10s %10s\n", "Phase", "Files", "MB", "Seconds", "MB/s", "Files/s");
+
+    for (const auto & Phase : phases)
+    {
+        if (Phase.Files == 0)
+            continue;
+
+        const double MB = (double) Phase.Bytes / (1024. * 1024.);
+        const double Seconds = std::max(Phase.Seconds, 1e-9);
+
+        ::printf("%-12s %8llu %12.2f %10.3f %10.2f %10.2f\n", Phase.Name, (unsigned long long) Phase.Files, MB, Phase.Seconds, MB / Seconds, (double) Phase.Files / Seconds);
+    }
+}
+
+/// <summary>
+/// Prints the throughput of the renderer. Voices/s is the number of voices that one core renders in real time.
+/// </summary>
+static void ReportRender()
+{
+    if (RenderPhase.Banks == 0)
+        return;
+
+    const double Seconds = std::max(RenderPhase.Seconds, 1e-9);
+
+    ::printf("\nRender: %u notes per second, %u Hz, %u guard points, %u controller changes per second per channel, one core\n\n", RenderOptions.Voices, RenderOptions.SampleRate, RenderOptions.GuardPoints, RenderOptions.Controllers);
+    ::printf("%-12s %8s %12s %10s %10s %10s\n", "Phase", "Banks", "Audio s", "Seconds", "Realtime", "Voices/s");
+    ::printf("%-12s %8llu %12.2f %10.3f %9.1fx %10.0f\n", "Render", (unsigned long long) RenderPhase.Banks, RenderPhase.AudioSeconds, RenderPhase.Seconds,
+        RenderPhase.AudioSeconds / Seconds, (double) RenderPhase.VoiceFrames / RenderOptions.SampleRate / Seconds);
+}
@@ -0,0 +1,72 @@
+
+/** $VER: Output.cpp (2026.10.18) P. Stuer - Buffered per-file output **/
+
+#include "pch.h"
+
+#include "Output.h"
+
+#include <stdarg.h>
+#include <fstream>
+
+/// <summary>
+/// Appends formatted text.
+/// </summary>
+void output_t::Printf(const char * format, ...) noexcept
+{
+    va_list Args;
+
+    va_start(Args, format);
+
+    char Text[1024];
+
+    va_list ArgsCopy;
+
+    va_copy(ArgsCopy, Args);
+
+    const int Size = ::vsnprintf(Text, sizeof(Text), format, ArgsCopy);
+
+    va_end(ArgsCopy);
+
+    if (Size > 0)
+    {
+        if ((size_t) Size < sizeof(Text))
+            _Buffer.append(Text, (size_t) Size);
+        else
+        {
+            // The text did not fit in the stack buffer. Format it directly at the end of the output buffer.
+            const size_t Offset = _Buffer.size();
+
+            _Buffer.resize(Offset + (size_t) Size + 1);
+
+            ::vsnprintf(_Buffer.data() + Offset, (size_t) Size + 1, format, Args);
+
+            _Buffer.resize(Offset + (size_t) Size);
+        }
+    }
+
+    va_end(Args);
+}
+
+/// <summary>
+/// Appends raw data.
+/// </summary>
+void output_t::Write(const char * data, size_t size) noexcept
+{
+    _Buffer.append(data, size);
+}
+
+/// <summary>
+/// Writes the collected output to a file. Text output uses the line endings of the platform.
+/// </summary>
+void output_t::Save(const std::filesystem::path & filePath, bool isBinary) const
+{
+    std::ofstream Stream(filePath, std::ios::out | std::ios::trunc | (isBinary ? std::ios::binary : std::ios::openmode()));
+
+    if (!Stream)
+        throw std::runtime_error(msc::FormatText("Failed to create \"%s\"", (const char *) filePath.u8string().c_str()));
+
+    Stream.write(_Buffer.data(), (std::streamsize) _Buffer.size());
+
+    if (!Stream)
+        throw std::runtime_error(msc::FormatText("Failed to write \"%s\"", (const char *) filePath.u8string().c_str()));
+}
@@ -0,0 +1,36 @@
+
+/** $VER: Output.h (2026.10.18) P. Stuer - Buffered per-file output **/
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Collects the dump of a single file in memory. Each file gets its own writer so files can be processed in parallel without sharing stdout.
+/// </summary>
+class output_t
+{
+public:
+    output_t() noexcept : Level()
+    {
+        _Buffer.reserve(64 * 1024);
+    }
+
+    void Printf(const char * format, ...) noexcept;
+    void Write(const char * data, size_t size) noexcept;
+
+    void Save(const std::filesystem::path & filePath, bool isBinary = false) const;
+
+    const std::string & Text() const noexcept { return _Buffer; }
+
+public:
+    uint32_t Level;                         // Indentation level
+
+private:
+    std::string _Buffer;
+};
+
+#pragma warning(default: 4820) // x bytes padding
@@ -0,0 +1,294 @@
+
+/** $VER: Serializer.cpp (2026.10.18) P. Stuer - Streaming structured output (JSON Lines, CBOR) **/
+
+#include "pch.h"
+
+#include "Serializer.h"
+
+#include <charconv>
+
+/// <summary>
+/// Writes a string value. Names in banks are fixed-size, zero-padded and stored in code page 850.
+/// </summary>
+void serializer_t::Value(std::string_view value)
+{
+    const size_t Size = value.find('\0');
+
+    if (Size != std::string_view::npos)
+        value = value.substr(0, Size);
+
+    bool IsASCII = true;
+
+    for (const char c : value)
+    {
+        if ((uint8_t) c >= 0x80)
+        {
+            IsASCII = false;
+            break;
+        }
+    }
+
+    if (IsASCII)
+        WriteString(value);
+    else
+    {
+        _Text = msc::CodePageToUTF8(850, value.data(), value.size());
+
+        WriteString(_Text);
+    }
+}
+
+void json_serializer_t::BeginObject()
+{
+    Separate();
+
+    _Output.Write("{", 1);
+
+    _IsFirst = true;
+}
+
+void json_serializer_t::EndObject()
+{
+    _Output.Write("}", 1);
+
+    _IsFirst = false;
+}
+
+void json_serializer_t::BeginArray()
+{
+    Separate();
+
+    _Output.Write("[", 1);
+
+    _IsFirst = true;
+}
+
+void json_serializer_t::EndArray()
+{
+    _Output.Write("]", 1);
+
+    _IsFirst = false;
+}
+
+void json_serializer_t::Key(std::string_view name)
+{
+    Separate();
+
+    WriteQuoted(name);
+
+    _Output.Write(":", 1);
+
+    // The value follows the key without a separator.
+    _IsFirst = true;
+}
+
+void json_serializer_t::Null()
+{
+    Separate();
+
+    _Output.Write("null", 4);
+}
+
+void json_serializer_t::EndRecord()
+{
+    _Output.Write("\n", 1);
+
+    _IsFirst = true;
+}
+
+void json_serializer_t::WriteInt(int64_t value)
+{
+    Separate();
+
+    char Text[24];
+
+    auto Result = std::to_chars(Text, Text + sizeof(Text), value);
+
+    _Output.Write(Text, (size_t) (Result.ptr - Text));
+}
+
+void json_serializer_t::WriteUInt(uint64_t value)
+{
+    Separate();
+
+    char Text[24];
+
+    auto Result = std::to_chars(Text, Text + sizeof(Text), value);
+
+    _Output.Write(Text, (size_t) (Result.ptr - Text));
+}
+
+void json_serializer_t::WriteBool(bool value)
+{
+    Separate();
+
+    if (value)
+        _Output.Write("true", 4);
+    else
+        _Output.Write("false", 5);
+}
+
+void json_serializer_t::WriteString(std::string_view value)
+{
+    Separate();
+
+    WriteQuoted(value);
+}
+
+/// <summary>
+/// Writes a quoted and escaped UTF-8 string.
+/// </summary>
+void json_serializer_t::WriteQuoted(std::string_view value) noexcept
+{
+    static const char Hex[] = "0123456789abcdef";
+
+    _Output.Write("\"", 1);
+
+    const char * Run = value.data(); // Start of the current run of characters that need no escaping
+
+    for (const char & c : value)
+    {
+        const uint8_t Byte = (uint8_t) c;
+
+        if ((Byte >= 0x20) && (c != '"') && (c != '\\'))
+            continue;
+
+        _Output.Write(Run, (size_t) (&c - Run));
+
+        Run = &c + 1;
+
+        switch (c)
+        {
+            case '"':  _Output.Write("\\\"", 2); break;
+            case '\\': _Output.Write("\\\\", 2); break;
+            case '\n': _Output.Write("\\n", 2); break;
+            case '\r': _Output.Write("\\r", 2); break;
+            case '\t': _Output.Write("\\t", 2); break;
+
+            default:
+            {
+                const char Escape[] = { '\\', 'u', '0', '0', Hex[Byte >> 4], Hex[Byte & 0x0F] };
+
+                _Output.Write(Escape, sizeof(Escape));
+            }
+        }
+    }
+
+    _Output.Write(Run, (size_t) (value.data() + value.size() - Run));
+
+    _Output.Write("\"", 1);
+}
+
+/// <summary>
+/// Writes a separator if the next item is not the first one in its container.
+/// </summary>
+void json_serializer_t::Separate() noexcept
+{
+    if (!_IsFirst)
+        _Output.Write(",", 1);
+
+    _IsFirst = false;
+}
+
+// Maps and arrays use the indefinite-length encoding so they can be written without knowing the number of items up front.
+
+void cbor_serializer_t::BeginObject()
+{
+    _Output.Write("\xBF", 1);
+}
+
+void cbor_serializer_t::EndObject()
+{
+    _Output.Write("\xFF", 1);
+}
+
+void cbor_serializer_t::BeginArray()
+{
+    _Output.Write("\x9F", 1);
+}
+
+void cbor_serializer_t::EndArray()
+{
+    _Output.Write("\xFF", 1);
+}
+
+void cbor_serializer_t::Key(std::string_view name)
+{
+    WriteString(name);
+}
+
+void cbor_serializer_t::Null()
+{
+    _Output.Write("\xF6", 1);
+}
+
+void cbor_serializer_t::WriteInt(int64_t value)
+{
+    if (value >= 0)
+        WriteHead(0, (uint64_t) value);
+    else
+        WriteHead(1, (uint64_t) (-1 - value));
+}
+
+void cbor_serializer_t::WriteUInt(uint64_t value)
+{
+    WriteHead(0, value);
+}
+
+void cbor_serializer_t::WriteBool(bool value)
+{
+    _Output.Write(value ? "\xF5" : "\xF4", 1);
+}
+
+void cbor_serializer_t::WriteString(std::string_view value)
+{
+    WriteHead(3, value.size());
+
+    _Output.Write(value.data(), value.size());
+}
+
+/// <summary>
+/// Writes the initial byte of a data item and its argument in the shortest form.
+/// </summary>
+void cbor_serializer_t::WriteHead(uint8_t majorType, uint64_t value) noexcept
+{
+    char Data[9];
+    size_t Size;
+
+    const uint8_t Type = (uint8_t) (majorType << 5);
+
+    if (value < 24)
+    {
+        Data[0] = (char) (Type | value);
+        Size = 1;
+    }
+    else
+    if (value <= 0xFF)
+    {
+        Data[0] = (char) (Type | 24);
+        Size = 2;
+    }
+    else
+    if (value <= 0xFFFF)
+    {
+        Data[0] = (char) (Type | 25);
+        Size = 3;
+    }
+    else
+    if (value <= 0xFFFFFFFF)
+    {
+        Data[0] = (char) (Type | 26);
+        Size = 5;
+    }
+    else
+    {
+        Data[0] = (char) (Type | 27);
+        Size = 9;
+    }
+
+    // The argument is stored in network byte order.
+    for (size_t i = Size - 1; i > 0; --i, value >>= 8)
+        Data[i] = (char) (value & 0xFF);
+
+    _Output.Write(Data, Size);
+}
@@ -0,0 +1,139 @@
+
+/** $VER: Serializer.h (2026.10.18) P. Stuer - Streaming structured output (JSON Lines, CBOR) **/
+
+#pragma once
+
+#include <concepts>
+#include <string_view>
+#include <vector>
+
+#include "Output.h"
+
+#pragma warning(disable: 4820) // x bytes padding
+
+/// <summary>
+/// Writes structured data directly to an output without building intermediate documents or strings.
+/// </summary>
+class serializer_t
+{
+public:
+    serializer_t(output_t & output) noexcept : _Output(output) { }
+    virtual ~serializer_t() { }
+
+    virtual void BeginObject() = 0;
+    virtual void EndObject() = 0;
+
+    virtual void BeginArray() = 0;
+    virtual void EndArray() = 0;
+
+    virtual void Key(std::string_view name) = 0;
+
+    virtual void Null() = 0;
+
+    /// <summary>
+    /// Writes an integer or boolean value.
+    /// </summary>
+    template <typename T> requires std::integral<T> void Value(T value)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            WriteBool(value);
+        else
+        if constexpr (std::is_signed_v<T>)
+            WriteInt((int64_t) value);
+        else
+            WriteUInt((uint64_t) value);
+    }
+
+    void Value(std::string_view value);
+
+    /// <summary>
+    /// Writes a key and its value.
+    /// </summary>
+    template <typename T> void Field(std::string_view name, const T & value)
+    {
+        Key(name);
+        Value(value);
+    }
+
+    void Field(std::string_view name, const char * value) { Key(name); Value(std::string_view(value)); }
+
+    virtual void EndRecord() = 0;
+
+protected:
+    virtual void WriteInt(int64_t value) = 0;
+    virtual void WriteUInt(uint64_t value) = 0;
+    virtual void WriteBool(bool value) = 0;
+    virtual void WriteString(std::string_view value) = 0;
+
+protected:
+    output_t & _Output;
+
+private:
+    std::string _Text;                      // Conversion buffer for non-ASCII strings
+};
+
+/// <summary>
+/// Writes each record as a single line of JSON (JSON Lines).
+/// </summary>
+class json_serializer_t : public serializer_t
+{
+public:
+    json_serializer_t(output_t & output) noexcept : serializer_t(output), _IsFirst(true) { }
+
+    void BeginObject() override;
+    void EndObject() override;
+
+    void BeginArray() override;
+    void EndArray() override;
+
+    void Key(std::string_view name) override;
+
+    void Null() override;
+
+    void EndRecord() override;
+
+protected:
+    void WriteInt(int64_t value) override;
+    void WriteUInt(uint64_t value) override;
+    void WriteBool(bool value) override;
+    void WriteString(std::string_view value) override;
+
+private:
+    void Separate() noexcept;
+    void WriteQuoted(std::string_view value) noexcept;
+
+private:
+    bool _IsFirst;                          // True if the next item is the first one in its container.
+};
+
+/// <summary>
+/// Writes each record as a CBOR data item (RFC 8949). Consecutive records form a CBOR sequence (RFC 8742).
+/// </summary>
+class cbor_serializer_t : public serializer_t
+{
+public:
+    cbor_serializer_t(output_t & output) noexcept : serializer_t(output) { }
+
+    void BeginObject() override;
+    void EndObject() override;
+
+    void BeginArray() override;
+    void EndArray() override;
+
+    void Key(std::string_view name) override;
+
+    void Null() override;
+
+    void EndRecord() override { }
+
+protected:
+    void WriteInt(int64_t value) override;
+    void WriteUInt(uint64_t value) override;
+    void WriteBool(bool value) override;
+    void WriteString(std::string_view value) override;
+
+private:
+    void WriteHead(uint8_t majorType, uint64_t value) noexcept;
+};
+
+#pragma warning(default: 4820) // x bytes padding
@@ -1,19 +1,25 @@
 
-/** $VER: main.cpp (2025.09.06) P. Stuer **/
+/** $VER: main.cpp (2026.10.18) P. Stuer **/
 
 #include "pch.h"
 
+#ifdef _MSC_VER
 #include <CppCoreCheck/Warnings.h>
 
 #pragma warning(disable: 4100 4625 4626 4710 4711 4738 5045 ALL_CPPCORECHECK_WARNINGS)
+#endif
 
 #include <libsf.h>
 
 #include "Encoding.h"
 
+#include "Output.h"
+#include "Serializer.h"
+
 using namespace sf;
 
 static void ProcessDirectory(const fs::path & directoryPath);
+static void ProcessDirectory(const fs::path & directoryPath, std::vector<fs::path> & filePaths);
 static void ProcessFile(const fs::path & filePath);
 static void ExamineFile(const fs::path & filePath);
 
@@ -21,7 +27,6 @@ static void ProcessDLS(const fs::path & filePath);
 static void ProcessSF(const fs::path & filePath);
 static void ProcessECW(const fs::path & filePath);
 
-static void ConvertECW(const ecw::waveset_t & ws, sf::bank_t & bank);
 
 static void DumpPresets(const bank_t & bank) noexcept;
 static void DumpPresetZoneList(const bank_t & bank, size_t fromIndex, size_t toIndex) noexcept;
@@ -37,11 +42,21 @@ static void DumpPresetZones(const bank_t & bank) noexcept;
 
 static void DumpSamples(const bank_t & bank) noexcept;
 
+static void DumpMetrics(const metrics_t & metrics) noexcept;
+
+static void SerializeFile(const fs::path & filePath, serializer_t & s);
+static void SerializeSF(const bank_t & bank, serializer_t & s);
+static void SerializeDLS(const dls::collection_t & dls, serializer_t & s);
+static void SerializeECW(const ecw::waveset_t & ws, serializer_t & s);
+
 static const char * GetChunkName(const uint32_t chunkId) noexcept;
+static std::string GetFourCC(const uint32_t chunkId);
 
 fs::path FilePath;
 uint32_t __TRACE_LEVEL = 0;
 
+thread_local output_t * Output = nullptr; // Output of the file being processed by the current thread.
+
 const std::vector<fs::path> Filters = { ".sbk", ".sf2", ".sf3", ".sf4", ".dls", ".dlp", ".ecw", ".arl" };
 
 class arguments_t
@@ -69,6 +84,22 @@ public:
 
                 if ((::_stricmp(argv[i], "-all") == 0) || (::_stricmp(argv[i], "-samples") == 0)) Items["samples"] = "";
 
+                if (::_stricmp(argv[i], "-metrics") == 0) Items["metrics"] = "";
+
+                // Structured output: JSON Lines or CBOR instead of text.
+                if (::_stricmp(argv[i], "-json") == 0) Items["format"] = "json";
+                if (::_stricmp(argv[i], "-cbor") == 0) Items["format"] = "cbor";
+
+                // -j N: Number of files to process in parallel. Defaults to the number of hardware threads.
+                if (::strncmp(argv[i], "-j", 2) == 0)
+                {
+                    if (argv[i][2] != '\0')
+                        Items["threads"] = argv[i] + 2;
+                    else
+                    if (i + 1 < argc)
+                        Items["threads"] = argv[++i];
+                }
+
             }
             else
             if (Items["pathname"].empty())
@@ -86,12 +117,137 @@ public:
         return Items.contains(key);
     }
 
+    /// <summary>
+    /// Gets the value of an argument without inserting it. Safe to call from multiple threads.
+    /// </summary>
+    std::string Get(const std::string & key) const
+    {
+        auto it = Items.find(key);
+
+        return (it != Items.end()) ? it->second : std::string();
+    }
+
 private:
     std::map<std::string, std::string> Items;
 };
 
 arguments_t Arguments;
 
+/// <summary>
+/// Reports an allocation to the metrics of the current thread (-metrics) and allocates it. Returns nullptr if out of memory.
+/// </summary>
+static void * Allocate(size_t size) noexcept
+{
+    metrics_t::RecordAllocation(size);
+
+    return ::malloc((size != 0) ? size : 1);
+}
+
+/// <summary>
+/// Reports an over-aligned allocation to the metrics of the current thread (-metrics) and allocates it. Returns nullptr if out of memory.
+/// </summary>
+static void * Allocate(size_t size, std::align_val_t alignment) noexcept
+{
+    metrics_t::RecordAllocation(size);
+
+#ifdef _WIN32
+    return ::_aligned_malloc((size != 0) ? size : 1, (size_t) alignment);
+#else
+    void * p = nullptr;
+
+    return (::posix_memalign(&p, std::max((size_t) alignment, sizeof(void *)), (size != 0) ? size : 1) == 0) ? p : nullptr;
+#endif
+}
+
+/// <summary>
+/// Frees an over-aligned allocation.
+/// </summary>
+static void Free(void * p, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    ::_aligned_free(p);
+#else
+    ::free(p);
+#endif
+}
+
+/// <summary>
+/// Replaces every form of the global allocation functions so each allocation is counted and freed by its matching function.
+/// </summary>
+void * operator new(size_t size)
+{
+    void * p = Allocate(size);
+
+    if (p == nullptr)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void * operator new[](size_t size)
+{
+    return ::operator new(size);
+}
+
+void * operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return Allocate(size);
+}
+
+void * operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return Allocate(size);
+}
+
+void * operator new(size_t size, std::align_val_t alignment)
+{
+    void * p = Allocate(size, alignment);
+
+    if (p == nullptr)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void * operator new[](size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void * operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return Allocate(size, alignment);
+}
+
+void * operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return Allocate(size, alignment);
+}
+
+// GCC sees through the replaced functions when it inlines them and reports the free() of a pointer from operator new, which Allocate() got from malloc().
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void * p) noexcept                                 { ::free(p); }
+void operator delete[](void * p) noexcept                               { ::free(p); }
+void operator delete(void * p, size_t) noexcept                         { ::free(p); }
+void operator delete[](void * p, size_t) noexcept                       { ::free(p); }
+void operator delete(void * p, const std::nothrow_t &) noexcept         { ::free(p); }
+void operator delete[](void * p, const std::nothrow_t &) noexcept       { ::free(p); }
+
+void operator delete(void * p, std::align_val_t alignment) noexcept                             { Free(p, alignment); }
+void operator delete[](void * p, std::align_val_t alignment) noexcept                           { Free(p, alignment); }
+void operator delete(void * p, size_t, std::align_val_t alignment) noexcept                     { Free(p, alignment); }
+void operator delete[](void * p, size_t, std::align_val_t alignment) noexcept                   { Free(p, alignment); }
+void operator delete(void * p, std::align_val_t alignment, const std::nothrow_t &) noexcept     { Free(p, alignment); }
+void operator delete[](void * p, std::align_val_t alignment, const std::nothrow_t &) noexcept   { Free(p, alignment); }
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
 typedef std::unordered_map<uint32_t, const char *> info_map_t;
 
 int main(int argc, char * argv[])
@@ -136,7 +292,10 @@ static bool IsOneOf(const fs::path & item, const std::vector<fs::path> & list) n
     return false;
 }
 
-static void ProcessDirectory(const fs::path & directoryPath)
+/// <summary>
+/// Collects the files to process in the specified directory and its subdirectories.
+/// </summary>
+static void ProcessDirectory(const fs::path & directoryPath, std::vector<fs::path> & filePaths)
 {
     ::printf("\"%s\"\n", (const char *) directoryPath.u8string().c_str());
 
@@ -144,44 +303,131 @@ static void ProcessDirectory(const fs::path & directoryPath)
     {
         if (Entry.is_directory())
         {
-            ProcessDirectory(Entry.path());
+            ProcessDirectory(Entry.path(), filePaths);
         }
         else
         if (IsOneOf(Entry.path().extension(), Filters))
         {
-            ProcessFile(Entry.path());
+            filePaths.push_back(Entry.path());
         }
     }
 }
 
 /// <summary>
-/// Processes the specified file.
+/// Processes the files in the specified directory and its subdirectories in parallel.
+/// </summary>
+static void ProcessDirectory(const fs::path & directoryPath)
+{
+    std::vector<fs::path> FilePaths;
+
+    ProcessDirectory(directoryPath, FilePaths);
+
+    // Files with the same stem share the log file and the converted SF2 file. Process them in the same task, in directory order, so the result does not depend on the scheduling.
+    std::vector<std::vector<fs::path>> Groups;
+    std::map<fs::path, size_t> GroupIndex;
+
+    for (const auto & FilePath : FilePaths)
+    {
+        fs::path Stem = FilePath; Stem.replace_extension();
+
+        auto it = GroupIndex.try_emplace(Stem, Groups.size());
+
+        if (it.second)
+            Groups.emplace_back();
+
+        Groups[it.first->second].push_back(FilePath);
+    }
+
+    const int ThreadCount = Arguments.IsSet("threads") ? std::max(::atoi(Arguments["threads"].c_str()), 0) : 0;
+
+    thread_pool_t Pool((size_t) ThreadCount);
+
+    std::vector<std::string> Errors(Groups.size());
+
+    for (size_t i = 0; i < Groups.size(); ++i)
+    {
+        Pool.Submit([&Groups, &Errors, i]
+        {
+            for (const auto & FilePath : Groups[i])
+            {
+                try
+                {
+                    ProcessFile(FilePath);
+                }
+                catch (const std::exception & e)
+                {
+                    Errors[i] += msc::FormatText("Failed to process \"%s\": %s\n", (const char *) FilePath.u8string().c_str(), e.what());
+                }
+            }
+        });
+    }
+
+    Pool.Wait();
+
+    for (const auto & Error : Errors)
+        ::printf("%s", Error.c_str());
+}
+
+/// <summary>
+/// Processes the specified file. The dump is collected in memory and written to a log file next to the file.
 /// </summary>
 static void ProcessFile(const fs::path & filePath)
 {
-    FILE * fp = nullptr;
+    output_t Out;
+
+    if (Arguments.IsSet("format"))
+    {
+        const bool IsCBOR = (Arguments.Get("format") == "cbor");
+
+        if (IsCBOR)
+        {
+            cbor_serializer_t Serializer(Out);
+
+            SerializeFile(filePath, Serializer);
+        }
+        else
+        {
+            json_serializer_t Serializer(Out);
+
+            SerializeFile(filePath, Serializer);
+        }
 
-    fs::path StdOut = filePath; StdOut.replace_extension(".log");
+        fs::path OutputPath = filePath; OutputPath.replace_extension(IsCBOR ? ".cbor" : ".jsonl");
 
-    (void) _chmod(StdOut.string().c_str(), _S_IWRITE | _S_IREAD);
+        Out.Save(OutputPath, true);
 
-    if ((::freopen_s(&fp, StdOut.string().c_str(), "w", stdout) != 0) || (fp == nullptr))
         return;
+    }
 
-    ::printf("\xEF\xBB\xBF"); // UTF-8 BOM
+    Output = &Out;
+
+    Output->Printf("\xEF\xBB\xBF"); // UTF-8 BOM
 
     auto FileSize = fs::file_size(filePath);
 
-    ::printf("\"%s\", %llu bytes\n", (const char *) filePath.u8string().c_str(), (uint64_t) FileSize);
+    Output->Printf("\"%s\", %llu bytes\n", (const char *) filePath.u8string().c_str(), (uint64_t) FileSize);
+
+    metrics_t Metrics;
+
+    if (Arguments.IsSet("metrics"))
+        metrics_t::Attach(&Metrics);
 
     ExamineFile(filePath);
 
-    ::fflush(fp);
+    metrics_t::Attach(nullptr);
 
-    ::fclose(fp);
+    if (Arguments.IsSet("metrics"))
+        DumpMetrics(Metrics);
 
-    if ((::freopen_s(&fp, "CON", "w", stdout) != 0) || (fp == nullptr))
-        return;
+    Output = nullptr;
+
+    fs::path LogPath = filePath; LogPath.replace_extension(".log");
+
+    std::error_code ec;
+
+    fs::permissions(LogPath, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::add, ec); // Make an existing log writable.
+
+    Out.Save(LogPath);
 }
 
 /// <summary>
@@ -204,14 +450,16 @@ static void ExamineFile(const fs::path & filePath)
     }
     catch (const sf::exception & e)
     {
-        ::printf("Failed to process soundfont: %s\n\n", e.what());
+        Output->Printf("Failed to process soundfont: %s\n\n", e.what());
     }
     catch (const riff::exception & e)
     {
-        ::printf("Failed to process RIFF file: %s\n\n", e.what());
+        Output->Printf("Failed to process RIFF file: %s\n\n", e.what());
+    }
+    catch (const std::exception & e)
+    {
+        Output->Printf("Failed to process file: %s\n\n", e.what());
     }
-
-    ::fflush(stdout);
 }
 
 /// <summary>
@@ -233,29 +481,29 @@ static void ProcessSF(const fs::path & filePath)
         ms.Close();
     }
 
-    ::printf("%*sSoundFont specification version: v%d.%02d\n", __TRACE_LEVEL * 4, "", Bank.Major, Bank.Minor);
-    ::printf("%*sSound Engine: \"%s\"\n", __TRACE_LEVEL * 4, "", Bank.SoundEngine.c_str());
-    ::printf("%*sBank Name: \"%s\"\n", __TRACE_LEVEL * 4, "", Bank.Name.c_str());
+    Output->Printf("%*sSoundFont specification version: v%d.%02d\n", Output->Level * 4, "", Bank.Major, Bank.Minor);
+    Output->Printf("%*sSound Engine: \"%s\"\n", Output->Level * 4, "", Bank.SoundEngine.c_str());
+    Output->Printf("%*sBank Name: \"%s\"\n", Output->Level * 4, "", Bank.Name.c_str());
 
     if ((Bank.ROMName.length() != 0) && !((Bank.ROMMajor == 0) && (Bank.ROMMinor == 0)))
-        ::printf("%*sSound Data ROM: %s v%d.%02d\n", __TRACE_LEVEL * 4, "", Bank.ROMName.c_str(), Bank.ROMMajor, Bank.ROMMinor);
+        Output->Printf("%*sSound Data ROM: %s v%d.%02d\n", Output->Level * 4, "", Bank.ROMName.c_str(), Bank.ROMMajor, Bank.ROMMinor);
 
     {
-        ::printf("%*sProperties\n", __TRACE_LEVEL * 4, "");
-        __TRACE_LEVEL++;
+        Output->Printf("%*sProperties\n", Output->Level * 4, "");
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & [ ChunkId, Value ] : Bank.Properties)
         {
-            ::printf("%*s%s: \"%s\"\n", __TRACE_LEVEL * 4, "", GetChunkName(ChunkId), msc::CodePageToUTF8(850, Value.c_str(), Value.length()).c_str());
+            Output->Printf("%*s%s: \"%s\"\n", Output->Level * 4, "", GetChunkName(ChunkId), msc::CodePageToUTF8(850, Value.c_str(), Value.length()).c_str());
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
-    ::printf("%*sSample Data: %zu bytes\n", __TRACE_LEVEL * 4, "", Bank.SampleData.size());
-    ::printf("%*sSample Data LSB: %zu bytes\n", __TRACE_LEVEL * 4, "", Bank.SampleDataLSB.size());
+    Output->Printf("%*sSample Data: %zu bytes\n", Output->Level * 4, "", Bank.SampleData.size());
+    Output->Printf("%*sSample Data LSB: %zu bytes\n", Output->Level * 4, "", Bank.SampleDataLSB.size());
 
     if (Arguments.IsSet("presets"))
         DumpPresets(Bank);
@@ -266,15 +514,15 @@ static void ProcessSF(const fs::path & filePath)
     // Dump the preset zone modulators.
     if (Arguments.IsSet("presetzonemodulators"))
     {
-        ::printf("%*sPreset Zone Modulators (%zu)\n", __TRACE_LEVEL * 4, "", Bank.PresetModulators.size());
+        Output->Printf("%*sPreset Zone Modulators (%zu)\n", Output->Level * 4, "", Bank.PresetModulators.size());
 
-        __TRACE_LEVEL++;
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & Modulator : Bank.PresetModulators)
         {
-            ::printf("%*s%5zu. Src Op: 0x%04X (%s), Dst Op: 0x%04X (%s), Amount: %6d, Amount Src Op: 0x%04X (%s), Transform Op: 0x%04X (%s)\n", __TRACE_LEVEL * 4, "", i++,
+            Output->Printf("%*s%5zu. Src Op: 0x%04X (%s), Dst Op: 0x%04X (%s), Amount: %6d, Amount Src Op: 0x%04X (%s), Transform Op: 0x%04X (%s)\n", Output->Level * 4, "", i++,
                 Modulator.SrcOper,         Bank.DescribeModulatorSource(Modulator.SrcOper).c_str(),
                 Modulator.DstOper,         Bank.DescribeGenerator(Modulator.DstOper, Modulator.Amount).c_str(),
                 Modulator.Amount,
@@ -282,15 +530,15 @@ static void ProcessSF(const fs::path & filePath)
                 Modulator.TransformOper,   Bank.DescribeModulatorTransform(Modulator.TransformOper).c_str());
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     // Dump the preset zone generators.
     if (Arguments.IsSet("presetzonegenerators"))
     {
-        ::printf("%*sPreset Zone Generators (%zu)\n", __TRACE_LEVEL * 4, "", Bank.PresetGenerators.size());
+        Output->Printf("%*sPreset Zone Generators (%zu)\n", Output->Level * 4, "", Bank.PresetGenerators.size());
 
-        __TRACE_LEVEL++;
+        Output->Level++;
 
         bool StartOfList = true;
 
@@ -298,19 +546,19 @@ static void ProcessSF(const fs::path & filePath)
 
         for (const auto & Generator : Bank.PresetGenerators)
         {
-            ::printf("%*sZone %5zu. Operator: 0x%04X, Amount: 0x%04X, \"%s\"\n", __TRACE_LEVEL * 4, "", i++,
+            Output->Printf("%*sZone %5zu. Operator: 0x%04X, Amount: 0x%04X, \"%s\"\n", Output->Level * 4, "", i++,
                 Generator.Operator, Generator.Amount, Bank.DescribeGenerator(Generator.Operator, Generator.Amount).c_str());
 
             // 8.1.2 Should only appear in the PGEN sub-chunk, and it must appear as the last generator enumerator in all but the global preset zone.
             if (Generator.Operator == GeneratorOperator::instrument) // 8.1.2 Should only appear in the PGEN sub-chunk, and it must appear as the last generator enumerator in all but the global preset zone.
             {
-                ::putchar('\n');
+                Output->Printf("\n");
 
                 StartOfList = true;
             }
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     // Dump the instruments.
@@ -320,32 +568,32 @@ static void ProcessSF(const fs::path & filePath)
     // Dump the instrument zones.
     if (Arguments.IsSet("instrumentzones"))
     {
-        ::printf("%*sInstrument Zones (%zu)\n", __TRACE_LEVEL * 4, "", Bank.InstrumentZones.size());
+        Output->Printf("%*sInstrument Zones (%zu)\n", Output->Level * 4, "", Bank.InstrumentZones.size());
 
-        __TRACE_LEVEL++;
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & iz : Bank.InstrumentZones)
         {
-            ::printf("%*sZone %5zu. Generator %5d, Modulator %5d\n", __TRACE_LEVEL * 4, "", i++, iz.GeneratorIndex, iz.ModulatorIndex);
+            Output->Printf("%*sZone %5zu. Generator %5d, Modulator %5d\n", Output->Level * 4, "", i++, iz.GeneratorIndex, iz.ModulatorIndex);
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     // Dump the instrument zone modulators.
     if (Arguments.IsSet("instrumentzonemodulators"))
     {
-        ::printf("%*sInstrument Zone Modulators (%zu)\n", __TRACE_LEVEL * 4, "", Bank.InstrumentModulators.size());
+        Output->Printf("%*sInstrument Zone Modulators (%zu)\n", Output->Level * 4, "", Bank.InstrumentModulators.size());
 
-        __TRACE_LEVEL++;
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & Modulator : Bank.InstrumentModulators)
         {
-            ::printf("%*s%5zu. Src Op: 0x%04X, Dst Op: 0x%04X, Amount: %6d, Amount Src Op: 0x%04X, Transform Op: 0x%04X\n", __TRACE_LEVEL * 4, "", i++,
+            Output->Printf("%*s%5zu. Src Op: 0x%04X, Dst Op: 0x%04X, Amount: %6d, Amount Src Op: 0x%04X, Transform Op: 0x%04X\n", Output->Level * 4, "", i++,
                 Modulator.SrcOper,
                 Modulator.DstOper,
                 Modulator.Amount,
@@ -353,25 +601,25 @@ static void ProcessSF(const fs::path & filePath)
                 Modulator.TransformOper);
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     // Dump the instrument zone generators.
     if (Arguments.IsSet("instrumentzonegenerators"))
     {
-        ::printf("%*sInstrument Zone Generators (%zu)\n", __TRACE_LEVEL * 4, "", Bank.InstrumentGenerators.size());
+        Output->Printf("%*sInstrument Zone Generators (%zu)\n", Output->Level * 4, "", Bank.InstrumentGenerators.size());
 
-        __TRACE_LEVEL++;
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & Generator : Bank.InstrumentGenerators)
         {
-            ::printf("%*s%5zu. Operator: 0x%04X, Amount: 0x%04X, \"%s\"\n", __TRACE_LEVEL * 4, "", i++,
+            Output->Printf("%*s%5zu. Operator: 0x%04X, Amount: 0x%04X, \"%s\"\n", Output->Level * 4, "", i++,
                 Generator.Operator, Generator.Amount, Bank.DescribeGenerator(Generator.Operator, Generator.Amount).c_str());
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     // Dump the sample names (SoundFont v1.0 only).
@@ -379,20 +627,20 @@ static void ProcessSF(const fs::path & filePath)
     {
         if ((Bank.Major == 1) && (Bank.SampleNames.size() != 0))
         {
-            ::printf("%*sSample Names (%zu)\n", __TRACE_LEVEL * 4, "", Bank.SampleNames.size() - 1);
-            __TRACE_LEVEL++;
+            Output->Printf("%*sSample Names (%zu)\n", Output->Level * 4, "", Bank.SampleNames.size() - 1);
+            Output->Level++;
 
             size_t i = 0;
 
             for (const auto & SampleName : Bank.SampleNames)
             {
-                ::printf("%*s%5zu. \"%-20s\"\n", __TRACE_LEVEL * 4, "", i++, SampleName.c_str());
+                Output->Printf("%*s%5zu. \"%-20s\"\n", Output->Level * 4, "", i++, SampleName.c_str());
 
                 if (i == Bank.Samples.size() - 1)
                     break;
             }
 
-            __TRACE_LEVEL--;
+            Output->Level--;
         }
     }
 
@@ -406,7 +654,7 @@ static void ProcessSF(const fs::path & filePath)
 
     riff::file_stream_t fs;
 
-    ::printf("\n\"%s\"\n", riff::WideToUTF8(FilePath).c_str());
+    Output->Printf("\n\"%s\"\n", riff::WideToUTF8(FilePath).c_str());
 
     // Tests the Sound Font writer.
     if (fs.Open(FilePath, true))
@@ -453,7 +701,7 @@ static void ProcessDLS(const fs::path & filePath)
             }
             catch (const std::exception & e)
             {
-                ::printf("Failed to process \"%s\": %s\n", filePath.string().c_str(), e.what());
+                Output->Printf("Failed to process \"%s\": %s\n", filePath.string().c_str(), e.what());
 
                 return;
             }
@@ -463,107 +711,107 @@ static void ProcessDLS(const fs::path & filePath)
     }
 
 #ifdef _DEBUG
-    uint32_t __TRACE_LEVEL = 0;
+    Output->Level = 0;
 
-    ::printf("%*sContent Version: %d.%d.%d.%d\n", __TRACE_LEVEL * 4, "", dls.Major, dls.Minor, dls.Revision, dls.Build);
+    Output->Printf("%*sContent Version: %d.%d.%d.%d\n", Output->Level * 4, "", dls.Major, dls.Minor, dls.Revision, dls.Build);
 
-    ::printf("%*s%zu instruments\n", __TRACE_LEVEL * 4, "", dls.Instruments.size());
+    Output->Printf("%*s%zu instruments\n", Output->Level * 4, "", dls.Instruments.size());
 
     size_t i = 1;
 
     for (const auto & Instrument : dls.Instruments)
     {
-        ::printf("%*s%4zu. Regions: %3zu, Articulators: %3zu, Bank: CC0 0x%02X CC32 0x%02X (MMA %5d), Program: %3d, Is Percussion: %-5s, Name: \"%s\"\n", __TRACE_LEVEL * 4, "", i++,
+        Output->Printf("%*s%4zu. Regions: %3zu, Articulators: %3zu, Bank: CC0 0x%02X CC32 0x%02X (MMA %5d), Program: %3d, Is Percussion: %-5s, Name: \"%s\"\n", Output->Level * 4, "", i++,
             Instrument.Regions.size(), Instrument.Articulators.size(), Instrument.BankMSB, Instrument.BankLSB, ((uint16_t) Instrument.BankMSB << 7) + Instrument.BankLSB, Instrument.Program, Instrument.IsPercussion ? "true" : "false", Instrument.Name.c_str());
 
-        __TRACE_LEVEL += 2;
+        Output->Level += 2;
 
-        ::printf("%*sRegions:\n", __TRACE_LEVEL * 4, "");
+        Output->Printf("%*sRegions:\n", Output->Level * 4, "");
 
-        __TRACE_LEVEL++;
+        Output->Level++;
 
         for (const auto & Region : Instrument.Regions)
         {
-            ::printf("%*sMIDI Key: %3d - %3d, Velocity: %3d - %3d, Options: 0x%04X, Key Group: %d, Zone: %d\n", __TRACE_LEVEL * 4, "",
+            Output->Printf("%*sMIDI Key: %3d - %3d, Velocity: %3d - %3d, Options: 0x%04X, Key Group: %d, Zone: %d\n", Output->Level * 4, "",
                 Region.LowKey, Region.HighKey, Region.LowVelocity, Region.HighVelocity, Region.Options, Region.KeyGroup, Region.Layer);
 
             if (!Region.Articulators.empty())
             {
-                __TRACE_LEVEL += 2;
+                Output->Level += 2;
 
-                ::printf("%*sArticulators:\n", __TRACE_LEVEL * 4, "");
+                Output->Printf("%*sArticulators:\n", Output->Level * 4, "");
 
-                __TRACE_LEVEL++;
+                Output->Level++;
 
                 for (const auto & Articulator : Region.Articulators)
                 {
-                    ::printf("%*s%3zu connection blocks\n", __TRACE_LEVEL * 4, "", Articulator.ConnectionBlocks.size());
+                    Output->Printf("%*s%3zu connection blocks\n", Output->Level * 4, "", Articulator.ConnectionBlocks.size());
 
-                    __TRACE_LEVEL++;
+                    Output->Level++;
 
                     for (const auto & ConnectionBlock: Articulator.ConnectionBlocks)
                     {
-                        ::printf("%*sSource: 0x%04X, Control: 0x%04X, Destination: 0x%04X, Transform: 0x%04X, Scale: 0x%08X\n", __TRACE_LEVEL * 4, "",
+                        Output->Printf("%*sSource: 0x%04X, Control: 0x%04X, Destination: 0x%04X, Transform: 0x%04X, Scale: 0x%08X\n", Output->Level * 4, "",
                             ConnectionBlock.Source, ConnectionBlock.Control, ConnectionBlock.Destination, ConnectionBlock.Transform, ConnectionBlock.Scale);
                     }
 
-                    __TRACE_LEVEL--;
+                    Output->Level--;
                 }
 
-                __TRACE_LEVEL--;
-                __TRACE_LEVEL -= 2;
+                Output->Level--;
+                Output->Level -= 2;
             }
         }
 
-        __TRACE_LEVEL--;
-        __TRACE_LEVEL -=2;
+        Output->Level--;
+        Output->Level -=2;
 
-        __TRACE_LEVEL += 2;
+        Output->Level += 2;
 
-        ::printf("%*sArticulators:\n", __TRACE_LEVEL * 4, "");
+        Output->Printf("%*sArticulators:\n", Output->Level * 4, "");
 
-        __TRACE_LEVEL++;
+        Output->Level++;
 
         for (const auto & Articulator : Instrument.Articulators)
         {
-            ::printf("%*s%3zu connection blocks\n", __TRACE_LEVEL * 4, "", Articulator.ConnectionBlocks.size());
+            Output->Printf("%*s%3zu connection blocks\n", Output->Level * 4, "", Articulator.ConnectionBlocks.size());
 
-            __TRACE_LEVEL++;
+            Output->Level++;
 
             for (const auto & ConnectionBlock: Articulator.ConnectionBlocks)
             {
-                ::printf("%*sSource: 0x%04X, Control: 0x%04X, Destination: 0x%04X, Transform: 0x%04X, Scale: 0x%08X\n", __TRACE_LEVEL * 4, "",
+                Output->Printf("%*sSource: 0x%04X, Control: 0x%04X, Destination: 0x%04X, Transform: 0x%04X, Scale: 0x%08X\n", Output->Level * 4, "",
                     ConnectionBlock.Source, ConnectionBlock.Control, ConnectionBlock.Destination, ConnectionBlock.Transform, ConnectionBlock.Scale);
             }
 
-            __TRACE_LEVEL--;
+            Output->Level--;
         }
 
-        __TRACE_LEVEL--;
-        __TRACE_LEVEL -= 2;
+        Output->Level--;
+        Output->Level -= 2;
     }
 
-    ::putchar('\n');
+    Output->Printf("\n");
 
-    ::printf("%*s%zu waves\n", __TRACE_LEVEL * 4, "", dls.Waves.size());
+    Output->Printf("%*s%zu waves\n", Output->Level * 4, "", dls.Waves.size());
 
     i = 1;
 
     for (const auto & Wave : dls.Waves)
     {
-        ::printf("%*s%4zu. Channels: %d, %5d samples/s, %5d avg. bytes/s, Block Align: %5d, Name: \"%s\"\n", __TRACE_LEVEL * 4, "", i++,
+        Output->Printf("%*s%4zu. Channels: %d, %5d samples/s, %5d avg. bytes/s, Block Align: %5d, Name: \"%s\"\n", Output->Level * 4, "", i++,
             Wave.Channels, Wave.SamplesPerSec, Wave.AvgBytesPerSec, Wave.BlockAlign, Wave.Name.c_str());
     }
 
-    ::putchar('\n');
+    Output->Printf("\n");
 
-    ::printf("%*sProperties:\n", __TRACE_LEVEL * 4, "");
+    Output->Printf("%*sProperties:\n", Output->Level * 4, "");
 
     i = 1;
 
     for (const auto & [ ChunkId, Value ] : dls.Properties)
     {
-        ::printf("%*s%4zu. %s: %s\n", __TRACE_LEVEL * 4, "", i++, GetChunkName(ChunkId), Value.c_str());
+        Output->Printf("%*s%4zu. %s: %s\n", Output->Level * 4, "", i++, GetChunkName(ChunkId), Value.c_str());
     }
 #endif
 
@@ -575,7 +823,7 @@ static void ProcessDLS(const fs::path & filePath)
     }
     catch (const sf::exception & e)
     {
-        ::printf("Failed to convert DLS to SF2: %s\n\n", e.what());
+        Output->Printf("Failed to convert DLS to SF2: %s\n\n", e.what());
 
         return;
     } 
@@ -584,7 +832,7 @@ static void ProcessDLS(const fs::path & filePath)
 
     FilePath.replace_extension(L".sf2");
 
-    ::printf("\n\"%s\"\n", (const char *) FilePath.u8string().c_str());
+    Output->Printf("\n\"%s\"\n", (const char *) FilePath.u8string().c_str());
 
     try
     {
@@ -603,7 +851,7 @@ static void ProcessDLS(const fs::path & filePath)
     }
     catch (const sf::exception & e)
     {
-        ::printf("Failed to write converted SF2: %s\n\n", e.what());
+        Output->Printf("Failed to write converted SF2: %s\n\n", e.what());
 
         return;
     } 
@@ -629,118 +877,118 @@ static void ProcessECW(const fs::path & filePath)
     }
 
 #ifdef _DEBUG
-    uint32_t __TRACE_LEVEL = 0;
+    Output->Level = 0;
 
-    ::printf("%*sName: \"%s\"\n", __TRACE_LEVEL * 4, "", msc::CodePageToUTF8(850, ws.Name.c_str(), ws.Name.length()).c_str());
-    ::printf("%*sCopyright: \"%s\"\n", __TRACE_LEVEL * 4, "", msc::CodePageToUTF8(850, ws.Copyright.c_str(), ws.Copyright.length()).c_str());
-    ::printf("%*sDescription: \"%s\"\n", __TRACE_LEVEL * 4, "", msc::CodePageToUTF8(850, ws.Description.c_str(), ws.Description.length()).c_str());
-    ::printf("%*sInformation: \"%s\"\n", __TRACE_LEVEL * 4, "", msc::CodePageToUTF8(850, ws.Information.c_str(), ws.Information.length()).c_str());
-    ::printf("%*sFile Name: \"%s\"\n", __TRACE_LEVEL * 4, "", msc::CodePageToUTF8(850, ws.FileName.c_str(), ws.FileName.length()).c_str());
+    Output->Printf("%*sName: \"%s\"\n", Output->Level * 4, "", msc::CodePageToUTF8(850, ws.Name.c_str(), ws.Name.length()).c_str());
+    Output->Printf("%*sCopyright: \"%s\"\n", Output->Level * 4, "", msc::CodePageToUTF8(850, ws.Copyright.c_str(), ws.Copyright.length()).c_str());
+    Output->Printf("%*sDescription: \"%s\"\n", Output->Level * 4, "", msc::CodePageToUTF8(850, ws.Description.c_str(), ws.Description.length()).c_str());
+    Output->Printf("%*sInformation: \"%s\"\n", Output->Level * 4, "", msc::CodePageToUTF8(850, ws.Information.c_str(), ws.Information.length()).c_str());
+    Output->Printf("%*sFile Name: \"%s\"\n", Output->Level * 4, "", msc::CodePageToUTF8(850, ws.FileName.c_str(), ws.FileName.length()).c_str());
 
     // Dump the bank maps.
     {
-        ::printf("\n%*sBank Maps\n", __TRACE_LEVEL * 4, "");
-        __TRACE_LEVEL++;
+        Output->Printf("\n%*sBank Maps\n", Output->Level * 4, "");
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & BankMap : ws.BankMaps)
         {
-            ::printf("%*sBank Map %zu\n", __TRACE_LEVEL * 4, "", i++);
-            __TRACE_LEVEL++;
+            Output->Printf("%*sBank Map %zu\n", Output->Level * 4, "", i++);
+            Output->Level++;
 
             size_t j = 0;
 
             for (const auto & MIDIPatchMap : BankMap.MIDIPatchMaps)
             {
-                ::printf("%*s%5zu. Patch Map %5d\n", __TRACE_LEVEL * 4, "", j++, MIDIPatchMap);
+                Output->Printf("%*s%5zu. Patch Map %5d\n", Output->Level * 4, "", j++, MIDIPatchMap);
             }
 
-            __TRACE_LEVEL--;
+            Output->Level--;
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     // Dump the drum kit maps.
     {
-        ::printf("\n%*sDrum Kit Maps\n", __TRACE_LEVEL * 4, "");
-        __TRACE_LEVEL++;
+        Output->Printf("\n%*sDrum Kit Maps\n", Output->Level * 4, "");
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & DrumKitMap : ws.DrumKitMaps)
         {
-            ::printf("%*sDrum Kit Map %zu\n", __TRACE_LEVEL * 4, "", i++);
-            __TRACE_LEVEL++;
+            Output->Printf("%*sDrum Kit Map %zu\n", Output->Level * 4, "", i++);
+            Output->Level++;
 
             size_t j = 0;
 
             for (const auto & DrumNoteMap : DrumKitMap.DrumNoteMaps)
             {
-                ::printf("%*s%5zu. Drum Note Map %5d\n", __TRACE_LEVEL * 4, "", j++, DrumNoteMap);
+                Output->Printf("%*s%5zu. Drum Note Map %5d\n", Output->Level * 4, "", j++, DrumNoteMap);
             }
 
-            __TRACE_LEVEL--;
+            Output->Level--;
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     // Dump the MIDI Patch maps.
     {
-        ::printf("\n%*sMIDI Patch Maps\n", __TRACE_LEVEL * 4, "");
-        __TRACE_LEVEL++;
+        Output->Printf("\n%*sMIDI Patch Maps\n", Output->Level * 4, "");
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & MIDIPatchMap : ws.MIDIPatchMaps)
         {
-            ::printf("%*sMIDI Patch Map %zu\n", __TRACE_LEVEL * 4, "", i++);
-            __TRACE_LEVEL++;
+            Output->Printf("%*sMIDI Patch Map %zu\n", Output->Level * 4, "", i++);
+            Output->Level++;
 
             size_t j = 0;
 
             for (const auto & Instrument : MIDIPatchMap.Instruments)
             {
-                ::printf("%*sMIDI Program %3zu = ECW Instrument %5d\n", __TRACE_LEVEL * 4, "", j++, Instrument);
+                Output->Printf("%*sMIDI Program %3zu = ECW Instrument %5d\n", Output->Level * 4, "", j++, Instrument);
             }
 
-            __TRACE_LEVEL--;
+            Output->Level--;
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     // Dump the MIDI Drum Note maps.
     {
-        ::printf("\n%*sDrum Note Maps\n", __TRACE_LEVEL * 4, "");
-        __TRACE_LEVEL++;
+        Output->Printf("\n%*sDrum Note Maps\n", Output->Level * 4, "");
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & DrumNoteMap : ws.DrumNoteMaps)
         {
-            ::printf("%*sDrum Note Map %zu\n", __TRACE_LEVEL * 4, "", i++);
-            __TRACE_LEVEL++;
+            Output->Printf("%*sDrum Note Map %zu\n", Output->Level * 4, "", i++);
+            Output->Level++;
 
             size_t j = 0;
 
             for (const auto & Instrument : DrumNoteMap.Instruments)
             {
-                ::printf("%*sMIDI Program %3zu = ECW Instrument %5d\n", __TRACE_LEVEL * 4, "", j++, Instrument);
+                Output->Printf("%*sMIDI Program %3zu = ECW Instrument %5d\n", Output->Level * 4, "", j++, Instrument);
             }
 
-            __TRACE_LEVEL--;
+            Output->Level--;
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     // Dump the instruments.
     {
-        ::printf("\n%*sInstruments\n", __TRACE_LEVEL * 4, "");
-        __TRACE_LEVEL++;
+        Output->Printf("\n%*sInstruments\n", Output->Level * 4, "");
+        Output->Level++;
 
         size_t i = 0;
 
@@ -750,12 +998,12 @@ static void ProcessECW(const fs::path & filePath)
             {
                 const auto & ih = (ecw::instrument_v1_t &) InstrumentHeader;
 
-                ::printf("%*s%5zu. v1, Sub Type: %d, Note: %3d\n", __TRACE_LEVEL * 4, "", i++, ih.SubType, ih.NoteThreshold);
+                Output->Printf("%*s%5zu. v1, Sub Type: %d, Note: %3d\n", Output->Level * 4, "", i++, ih.SubType, ih.NoteThreshold);
 
-                __TRACE_LEVEL++;
+                Output->Level++;
 
                 if (ih.SubType < 3)
-                    ::printf("%*s       Header 0, Patch: %5d, Amplitude: %4d, Pan: %4d, Coarse Tune: %4d, Fine Tune: %4d, Delay: %5d, Group: %3d\n", __TRACE_LEVEL * 4, "",
+                    Output->Printf("%*s       Header 0, Patch: %5d, Amplitude: %4d, Pan: %4d, Coarse Tune: %4d, Fine Tune: %4d, Delay: %5d, Group: %3d\n", Output->Level * 4, "",
                         ih.SubHeaders[0].PatchIndex,
                         ih.SubHeaders[0].Amplitude,
                         ih.SubHeaders[0].Pan,
@@ -766,7 +1014,7 @@ static void ProcessECW(const fs::path & filePath)
                     );
 
                 if (ih.SubType > 0)
-                    ::printf("%*s       Header 1, Patch: %5d, Amplitude: %4d, Pan: %4d, Coarse Tune: %4d, Fine Tune: %4d, Delay: %5d, Group: %3d\n", __TRACE_LEVEL * 4, "",
+                    Output->Printf("%*s       Header 1, Patch: %5d, Amplitude: %4d, Pan: %4d, Coarse Tune: %4d, Fine Tune: %4d, Delay: %5d, Group: %3d\n", Output->Level * 4, "",
                         ih.SubHeaders[1].PatchIndex,
                         ih.SubHeaders[1].Amplitude,
                         ih.SubHeaders[1].Pan,
@@ -776,35 +1024,35 @@ static void ProcessECW(const fs::path & filePath)
                         ih.SubHeaders[1].Group
                     );
 
-                __TRACE_LEVEL--;
+                Output->Level--;
             }
             else
             if (InstrumentHeader.Type == 255)
             {
                 const auto & ih = (ecw::instrument_v2_t &) InstrumentHeader;
 
-                ::printf("%*s%5zu. v2\n", __TRACE_LEVEL * 4, "", i++);
+                Output->Printf("%*s%5zu. v2\n", Output->Level * 4, "", i++);
 
                 for (const auto & sh : ih.SubHeaders)
-                    ::printf("%*s       Instrument: %5d, Note: %3d\n", __TRACE_LEVEL * 4, "", sh.InstrumentIndex, sh.NoteThreshold);
+                    Output->Printf("%*s       Instrument: %5d, Note: %3d\n", Output->Level * 4, "", sh.InstrumentIndex, sh.NoteThreshold);
             }
             else
-                ::printf("%*s%5zu. Unknown instrument type\n", __TRACE_LEVEL * 4, "", i++);
+                Output->Printf("%*s%5zu. Unknown instrument type\n", Output->Level * 4, "", i++);
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     // Dump the patches.
     {
-        ::printf("\n%*sPatches\n", __TRACE_LEVEL * 4, "");
-        __TRACE_LEVEL++;
+        Output->Printf("\n%*sPatches\n", Output->Level * 4, "");
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & ph : ws.Patches)
         {
-            ::printf("%*s%5zu. Pitch Env: %4d, Modulation: %4d, Scale: %4d, Array 1 Index: %5d, Detune: %4d\n", __TRACE_LEVEL * 4, "", i++,
+            Output->Printf("%*s%5zu. Pitch Env: %4d, Modulation: %4d, Scale: %4d, Array 1 Index: %5d, Detune: %4d\n", Output->Level * 4, "", i++,
                 ph.PitchEnvelopeLevel,
                 ph.ModulationSensitivity,
                 ph.Scale,
@@ -813,75 +1061,75 @@ static void ProcessECW(const fs::path & filePath)
             );
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     {
-        ::printf("\n%*sArray 1 (%d)\n", __TRACE_LEVEL * 4, "", (int) ws.Array1.size());
-        __TRACE_LEVEL++;
+        Output->Printf("\n%*sArray 1 (%d)\n", Output->Level * 4, "", (int) ws.Array1.size());
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & Item : ws.Array1)
         {
             if (Item.Index != 0xFFFF)
-                ::printf("%*s%5zu. Slot: %5d, Name: \"%s\"\n", __TRACE_LEVEL * 4, "", i, Item.Index, Item.Name.c_str());
+                Output->Printf("%*s%5zu. Slot: %5d, Name: \"%s\"\n", Output->Level * 4, "", i, Item.Index, ws.GetSampleSetName(Item).c_str());
             else
-                ::printf("%*s%5zu. Unused\n", __TRACE_LEVEL * 4, "", i);
+                Output->Printf("%*s%5zu. Unused\n", Output->Level * 4, "", i);
 
             ++i;
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     {
-        ::printf("\n%*sArray 2 (%d)\n", __TRACE_LEVEL * 4, "", (int) ws.Array2.size());
-        __TRACE_LEVEL++;
+        Output->Printf("\n%*sArray 2 (%d)\n", Output->Level * 4, "", (int) ws.Array2.size());
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & Item : ws.Array2)
         {
             if (Item.Index != 0)
-                ::printf("%*s%5zu. Slot: %5d, Name: \"%s\"\n", __TRACE_LEVEL * 4, "", i, Item.Index, Item.Name.c_str());
+                Output->Printf("%*s%5zu. Slot: %5d, Name: \"%s\"\n", Output->Level * 4, "", i, Item.Index, ws.GetSampleSetName(Item).c_str());
             else
-                ::printf("%*s%5zu. Unused\n", __TRACE_LEVEL * 4, "", i);
+                Output->Printf("%*s%5zu. Unused\n", Output->Level * 4, "", i);
 
             ++i;
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     {
-        ::printf("\n%*sArray 3 (%d)\n", __TRACE_LEVEL * 4, "", (int) ws.Array3.size());
-        __TRACE_LEVEL++;
+        Output->Printf("\n%*sArray 3 (%d)\n", Output->Level * 4, "", (int) ws.Array3.size());
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & Item : ws.Array3)
         {
             if (Item.Index != 0)
-                ::printf("%*s%5zu. Slot: %5d, Name: \"%s\"\n", __TRACE_LEVEL * 4, "", i, Item.Index, Item.Name.c_str());
+                Output->Printf("%*s%5zu. Slot: %5d, Name: \"%s\"\n", Output->Level * 4, "", i, Item.Index, ws.GetSampleSetName(Item).c_str());
             else
-                ::printf("%*s%5zu. Unused\n", __TRACE_LEVEL * 4, "", i);
+                Output->Printf("%*s%5zu. Unused\n", Output->Level * 4, "", i);
 
             ++i;
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 
     {
-        ::printf("\n%*sSamples\n", __TRACE_LEVEL * 4, "");
-        __TRACE_LEVEL++;
+        Output->Printf("\n%*sSamples\n", Output->Level * 4, "");
+        Output->Level++;
 
         size_t i = 0;
 
         for (const auto & s : ws.Samples)
         {
-            ::printf("%*s%5zu. \"%-14s\", MIDI Key: %3d-%3d, Flags: 0x%02X, Fine Tune: %4d, Coarse Tune: %4d, Offset: %9d, Loop: %9d-%9d\n", __TRACE_LEVEL * 4, "", i++,
+            Output->Printf("%*s%5zu. \"%-14s\", MIDI Key: %3d-%3d, Flags: 0x%02X, Fine Tune: %4d, Coarse Tune: %4d, Offset: %9d, Loop: %9d-%9d\n", Output->Level * 4, "", i++,
                 s.Name.c_str(),
                 s.LowKey, s.HighKey,
                 s.Flags,
@@ -893,7 +1141,7 @@ static void ProcessECW(const fs::path & filePath)
             );
         }
 
-        __TRACE_LEVEL--;
+        Output->Level--;
     }
 #endif
 
@@ -901,7 +1149,18 @@ static void ProcessECW(const fs::path & filePath)
     {
         sf::bank_t Bank;
 
-//      ConvertECW(ws, Bank);
+        try
+        {
+            Bank.ConvertFrom(ws);
+
+            Bank.Properties.push_back(sf::property_t(FOURCC_ISFT, "sfdump"));
+        }
+        catch (const sf::exception & e)
+        {
+            Output->Printf("Failed to convert ECW to SF2: %s\n\n", e.what());
+
+            return;
+        }
 
         {
             fs::path FilePath(filePath);
@@ -910,7 +1169,7 @@ static void ProcessECW(const fs::path & filePath)
 
             msc::file_stream_t fs;
 
-            ::printf("\n\"%s\"\n", FilePath.string().c_str());
+            Output->Printf("\n\"%s\"\n", FilePath.string().c_str());
 
             {
                 if (fs.Open(FilePath, true))
@@ -929,134 +1188,6 @@ static void ProcessECW(const fs::path & filePath)
     }
 }
 
-/// <summary>
-/// Converts an ECW waveset to a SoundFont bank.
-/// </summary>
-static void ConvertECW(const ecw::waveset_t & ws, sf::bank_t & bank)
-{
-    bank.Major = 2;
-    bank.Minor = 4;
-    bank.SoundEngine = "E-mu 10K1";
-    bank.Name = ws.Name;
-
-    {
-         SYSTEMTIME st = {};
-
-        ::GetLocalTime(&st);
-
-        char Date[32] = { };
-        char Time[32] = { };
-
-        ::GetDateFormatA(LOCALE_USER_DEFAULT, 0, &st, "yyyy-MM-dd", Date, sizeof(Date));
-        ::GetTimeFormatA(LOCALE_USER_DEFAULT, 0, &st, "HH:mm:ss", Time, sizeof(Time));
-
-        bank.Properties.push_back(sf::property_t(FOURCC_ICRD, std::string(Date) + " " + std::string(Time)));
-    }
-
-    if (!ws.Information.empty())
-        bank.Properties.push_back(sf::property_t(FOURCC_ICMT, ws.Information));
-
-    if (!ws.Copyright.empty())
-        bank.Properties.push_back(sf::property_t(FOURCC_ICOP, ws.Copyright));
-
-    if (!ws.Description.empty())
-        bank.Properties.push_back(sf::property_t(FOURCC_ISBJ, ws.Description));
-
-    bank.Properties.push_back(sf::property_t(FOURCC_ISFT, "sfdump"));
-
-    bank.SampleData = ws.SampleData;
-
-    // Initialize Hydra.
-    {
-        // Add the samples.
-        {
-            for (const auto & s : ws.Samples)
-            {
-                uint8_t Pitch = 127 + s.CoarseTune;
-
-                if (s.FineTune < 0)
-                    Pitch--;
-
-                int8_t PitchCorrection = 0;
-
-                bank.Samples.push_back(sf::sample_t
-                (
-                    s.Name,
-                    s.SampleStart / sizeof(int16_t),
-                    s.LoopEnd     / sizeof(int16_t),
-                    s.LoopStart   / sizeof(int16_t),
-                    s.LoopEnd     / sizeof(int16_t),
-                    22050,
-                    Pitch,
-                    PitchCorrection,
-                    0,
-                    sf::SampleTypes::MonoSample
-                ));
-            }
-
-            bank.Samples.push_back(sf::sample_t("EOS"));
-        }
-
-        // Add the instruments.
-        {
-            for (const auto & Slot : ws.Array3)
-            {
-                if (Slot.Index == 0)
-                    continue;
-
-                uint16_t i = Slot.Index;
-
-                bank.Instruments.push_back(sf::instrument_t(Slot.Name, (uint16_t) bank.InstrumentZones.size()));
-
-                for (auto it = std::next(ws.Samples.begin(), i); (it != ws.Samples.end()); ++it)
-                {
-                    if (it->Name != Slot.Name)
-                        break;
-
-                    bank.InstrumentZones.push_back(sf::instrument_zone_t((uint16_t) bank.InstrumentGenerators.size(), (uint16_t) bank.InstrumentModulators.size()));
-
-                    bank.InstrumentGenerators.push_back(sf::generator_t(GeneratorOperator::keyRange, MAKEWORD(it->LowKey, it->HighKey)));
-                    bank.InstrumentGenerators.push_back(sf::generator_t(GeneratorOperator::sampleID, i));
-
-                    ++i;
-                }
-            }
-
-            bank.Instruments.push_back(sf::instrument_t("EOI"));
-
-            // Add the instrument zone modulators.
-            bank.InstrumentModulators.push_back(sf::modulator_t());
-        }
-/*
-        // Add the presets.
-        {
-            constexpr const uint16_t Banks[] = { 0, 127 };
-
-            for (const uint16_t & Bank : Banks)
-            {
-                const uint16_t Index = ws.BankMaps[0].MIDIPatchMaps[Bank];
-
-                const auto & mpm = ws.MIDIPatchMaps[Index];
-
-                for (const auto & Instrument : mpm.Instruments)
-                {
-                    bank.Presets.push_back(sf::preset_t(bank.Instruments[Instrument].Name, Instrument, Bank, (uint16_t) bank.PresetZones.size(), 0, 0, 0));
-
-                    bank.PresetZones.push_back(sf::preset_zone_t((uint16_t) bank.PresetZoneGenerators.size(), (uint16_t) bank.PresetZoneModulators.size()));
-
-                    bank.PresetZoneGenerators.push_back(sf::preset_zone_generator_t(41, Instrument)); // Generator "instrument"
-                }
-            }
-
-            bank.Presets.push_back(sf::preset_t("EOP"));
-
-            // Add the preset zone modulators.
-            bank.PresetZoneModulators.push_back(sf::preset_zone_modulator_t(0, 0, 0, 0, 0));
-        }
-*/
-    }
-}
-
 /// <summary>
 /// Dumps the presets.
 /// </summary>
@@ -1065,20 +1196,20 @@ static void DumpPresets(const bank_t & bank) noexcept
     if (bank.Presets.size() == 0)
         return;
 
-    ::printf("%*sPresets (%zu)\n", __TRACE_LEVEL * 4, "", bank.Presets.size() - 1);
+    Output->Printf("%*sPresets (%zu)\n", Output->Level * 4, "", bank.Presets.size() - 1);
 
-    __TRACE_LEVEL++;
+    Output->Level++;
 
     size_t i = 0;
 
     for (auto Preset = bank.Presets.begin(); Preset < bank.Presets.end() - 1; ++Preset)
     {
-        ::printf("%*s%5zu. \"%s\", Bank %d, Program %d, Zone %d\n", __TRACE_LEVEL * 4, "", i++, Preset->Name.c_str(), Preset->MIDIBank, Preset->MIDIProgram, Preset->ZoneIndex);
+        Output->Printf("%*s%5zu. \"%s\", Bank %d, Program %d, Zone %d\n", Output->Level * 4, "", i++, Preset->Name.c_str(), Preset->MIDIBank, Preset->MIDIProgram, Preset->ZoneIndex);
 
         DumpPresetZoneList(bank, Preset->ZoneIndex, (Preset + 1)->ZoneIndex);
     }
 
-    __TRACE_LEVEL--;
+    Output->Level--;
 }
 
 /// <summary>
@@ -1086,7 +1217,7 @@ static void DumpPresets(const bank_t & bank) noexcept
 /// </summary>
 static void DumpPresetZoneList(const bank_t & bank, size_t fromIndex, size_t toIndex) noexcept
 {
-    __TRACE_LEVEL++;
+    Output->Level++;
 
     for (size_t Index = fromIndex; Index < toIndex; ++Index)
     {
@@ -1098,7 +1229,7 @@ static void DumpPresetZoneList(const bank_t & bank, size_t fromIndex, size_t toI
             ((z1.GeneratorIndex == z2.GeneratorIndex) ||
              (z1.GeneratorIndex < z2.GeneratorIndex) && (bank.PresetGenerators[(size_t) z2.GeneratorIndex - 1].Operator != GeneratorOperator::instrument));
 
-        ::printf("%*sZone %5zu. Generator: %d, Modulator: %d%s\n", __TRACE_LEVEL * 4, "", Index,
+        Output->Printf("%*sZone %5zu. Generator: %d, Modulator: %d%s\n", Output->Level * 4, "", Index,
             z1.GeneratorIndex, z1.ModulatorIndex,
             (IsGlobalZone ? " (Global zone)" : ""));
 
@@ -1106,7 +1237,7 @@ static void DumpPresetZoneList(const bank_t & bank, size_t fromIndex, size_t toI
         DumpPresetZoneModulators(bank, z1.ModulatorIndex, z2.ModulatorIndex);
     }
 
-    __TRACE_LEVEL--;
+    Output->Level--;
 }
 
 /// <summary>
@@ -1114,7 +1245,7 @@ static void DumpPresetZoneList(const bank_t & bank, size_t fromIndex, size_t toI
 /// </summary>
 static void DumpPresetZoneGenerators(const bank_t & bank, size_t fromIndex, size_t toIndex) noexcept
 {
-    __TRACE_LEVEL++;
+    Output->Level++;
 
     uint16_t OldOperator = GeneratorOperator::Invalid;
 
@@ -1122,39 +1253,39 @@ static void DumpPresetZoneGenerators(const bank_t & bank, size_t fromIndex, size
 
     for (size_t Index = fromIndex; Index < toIndex; ++Generator, ++Index)
     {
-        ::printf("%*s%5zu. Operator: 0x%04X, Amount: 0x%04X, \"%s\"", __TRACE_LEVEL * 4, "", Index,
+        Output->Printf("%*s%5zu. Operator: 0x%04X, Amount: 0x%04X, \"%s\"", Output->Level * 4, "", Index,
             Generator->Operator, (uint16_t) Generator->Amount, bank.DescribeGenerator(Generator->Operator, Generator->Amount).c_str());
 
         if (Generator->Operator == GeneratorOperator::keyRange)
         {
             if (Index != fromIndex)
-                ::printf(" Warning: keyRange must be the first generator in the zone generator list.\n"); // 8.1.2
+                Output->Printf(" Warning: keyRange must be the first generator in the zone generator list.\n"); // 8.1.2
             else
-                ::putchar('\n');
+                Output->Printf("\n");
         }
         else
         if (Generator->Operator == GeneratorOperator::velRange)
         {
             if ((Index != fromIndex) && (OldOperator != GeneratorOperator::keyRange))
-                ::printf(" Warning: velRange must be only preceded by keyRange.\n"); // 8.1.2
+                Output->Printf(" Warning: velRange must be only preceded by keyRange.\n"); // 8.1.2
             else
-                ::putchar('\n');
+                Output->Printf("\n");
         }
         else
         if (Generator->Operator == GeneratorOperator::instrument)
         {
             if (Index != toIndex - 1)
-                ::printf(" Warning: instrument must be the last generator.\n"); // 8.1.2 Should only appear in the PGEN sub-chunk, and it must appear as the last generator enumerator in all but the global preset zone.
+                Output->Printf(" Warning: instrument must be the last generator.\n"); // 8.1.2 Should only appear in the PGEN sub-chunk, and it must appear as the last generator enumerator in all but the global preset zone.
             else
-                ::putchar('\n');
+                Output->Printf("\n");
         }
         else
-            ::putchar('\n'); // 8.1.2 
+            Output->Printf("\n"); // 8.1.2 
 
         OldOperator = Generator->Operator;
     }
 
-    __TRACE_LEVEL--;
+    Output->Level--;
 }
 
 /// <summary>
@@ -1162,13 +1293,13 @@ static void DumpPresetZoneGenerators(const bank_t & bank, size_t fromIndex, size
 /// </summary>
 static void DumpPresetZoneModulators(const bank_t & bank, size_t fromIndex, size_t toIndex) noexcept
 {
-    __TRACE_LEVEL++;
+    Output->Level++;
 
     auto Modulator = bank.PresetModulators.begin() + fromIndex;
 
     for (size_t Index = fromIndex; Index < toIndex; ++Modulator, ++Index)
     {
-        ::printf("%*s%5zu. Src Op: 0x%04X (%s), Dst Op: 0x%04X (%s), Amount: %6d, Src Op Amount: 0x%04X (%s), Transform Op: 0x%04X (%s)\n", __TRACE_LEVEL * 4, "", Index,
+        Output->Printf("%*s%5zu. Src Op: 0x%04X (%s), Dst Op: 0x%04X (%s), Amount: %6d, Src Op Amount: 0x%04X (%s), Transform Op: 0x%04X (%s)\n", Output->Level * 4, "", Index,
             Modulator->SrcOper,        bank.DescribeModulatorSource(Modulator->SrcOper).c_str(),
             Modulator->DstOper,        bank.DescribeGenerator(Modulator->DstOper, Modulator->Amount).c_str(),
             Modulator->Amount,
@@ -1177,7 +1308,7 @@ static void DumpPresetZoneModulators(const bank_t & bank, size_t fromIndex, size
         );
     }
 
-    __TRACE_LEVEL--;
+    Output->Level--;
 }
 
 /// <summary>
@@ -1188,20 +1319,20 @@ static void DumpInstruments(const bank_t & bank) noexcept
     if (bank.Instruments.size() == 0)
         return;
 
-    ::printf("%*sInstruments (%zu)\n", __TRACE_LEVEL * 4, "", bank.Instruments.size() - 1);
+    Output->Printf("%*sInstruments (%zu)\n", Output->Level * 4, "", bank.Instruments.size() - 1);
 
-    __TRACE_LEVEL++;
+    Output->Level++;
 
     size_t i = 0;
 
     for (auto Instrument = bank.Instruments.begin(); Instrument < bank.Instruments.end() - 1; ++Instrument)
     {
-        ::printf("%*s%5zu. \"%s\", Instrument Zone %d\n", __TRACE_LEVEL * 4, "", i++, Instrument->Name.c_str(), Instrument->ZoneIndex);
+        Output->Printf("%*s%5zu. \"%s\", Instrument Zone %d\n", Output->Level * 4, "", i++, Instrument->Name.c_str(), Instrument->ZoneIndex);
 
         DumpInstrumentZoneList(bank, Instrument->ZoneIndex, (Instrument + 1)->ZoneIndex);
     }
 
-    __TRACE_LEVEL--;
+    Output->Level--;
 }
 
 /// <summary>
@@ -1209,7 +1340,7 @@ static void DumpInstruments(const bank_t & bank) noexcept
 /// </summary>
 static void DumpInstrumentZoneList(const bank_t & bank, size_t fromIndex, size_t toIndex) noexcept
 {
-    __TRACE_LEVEL++;
+    Output->Level++;
 
     for (size_t Index = fromIndex; Index < toIndex; ++Index)
     {
@@ -1221,7 +1352,7 @@ static void DumpInstrumentZoneList(const bank_t & bank, size_t fromIndex, size_t
             ((z1.GeneratorIndex == z2.GeneratorIndex) ||
              (z1.GeneratorIndex < z2.GeneratorIndex) && (bank.InstrumentGenerators[(size_t) z2.GeneratorIndex - 1].Operator != GeneratorOperator::sampleID));
 
-        ::printf("%*s%5zu. Generator: %d, Modulator: %d%s\n", __TRACE_LEVEL * 4, "", Index,
+        Output->Printf("%*s%5zu. Generator: %d, Modulator: %d%s\n", Output->Level * 4, "", Index,
             z1.GeneratorIndex, z1.ModulatorIndex,
             (IsGlobalZone ? " (Global zone)" : ""));
 
@@ -1229,7 +1360,7 @@ static void DumpInstrumentZoneList(const bank_t & bank, size_t fromIndex, size_t
         DumpInstrumentZoneModulators(bank, z1.ModulatorIndex, z2.ModulatorIndex);
     }
 
-    __TRACE_LEVEL--;
+    Output->Level--;
 }
 
 /// <summary>
@@ -1237,7 +1368,7 @@ static void DumpInstrumentZoneList(const bank_t & bank, size_t fromIndex, size_t
 /// </summary>
 static void DumpInstrumentZoneGenerators(const bank_t & bank, size_t fromIndex, size_t toIndex) noexcept
 {
-    __TRACE_LEVEL++;
+    Output->Level++;
 
     uint16_t OldOperator = GeneratorOperator::Invalid;
 
@@ -1245,39 +1376,39 @@ static void DumpInstrumentZoneGenerators(const bank_t & bank, size_t fromIndex,
 
     for (size_t Index = fromIndex; Index < toIndex; ++Generator, ++Index)
     {
-        ::printf("%*s%5zu. Operator: 0x%04X, Amount: 0x%04X, \"%s\"", __TRACE_LEVEL * 4, "", Index,
+        Output->Printf("%*s%5zu. Operator: 0x%04X, Amount: 0x%04X, \"%s\"", Output->Level * 4, "", Index,
             Generator->Operator, (uint16_t) Generator->Amount, bank.DescribeGenerator(Generator->Operator, Generator->Amount).c_str());
 
         if (Generator->Operator == GeneratorOperator::keyRange)
         {
             if (Index != fromIndex)
-                ::printf(" Warning: keyRange must be the first generator in the zone generator list.\n"); // 8.1.2
+                Output->Printf(" Warning: keyRange must be the first generator in the zone generator list.\n"); // 8.1.2
             else
-                ::putchar('\n');
+                Output->Printf("\n");
         }
         else
         if (Generator->Operator == GeneratorOperator::velRange)
         {
             if ((Index != fromIndex) && (OldOperator != GeneratorOperator::keyRange))
-                ::printf(" Warning: velRange must be only preceded by keyRange.\n"); // 8.1.2
+                Output->Printf(" Warning: velRange must be only preceded by keyRange.\n"); // 8.1.2
             else
-                ::putchar('\n');
+                Output->Printf("\n");
         }
         else
         if (Generator->Operator == GeneratorOperator::sampleID)
         {
             if (Index != toIndex - 1)
-                ::printf(" Warning: sampleID must be the last generator.\n"); // 8.1.2 Should appear only in the IGEN sub-chunk and must appear as the last generator enumerator in all but the global zone.
+                Output->Printf(" Warning: sampleID must be the last generator.\n"); // 8.1.2 Should appear only in the IGEN sub-chunk and must appear as the last generator enumerator in all but the global zone.
             else
-                ::putchar('\n');
+                Output->Printf("\n");
         }
         else
-            ::putchar('\n'); // 8.1.2 
+            Output->Printf("\n"); // 8.1.2 
 
         OldOperator = Generator->Operator;
     }
 
-    __TRACE_LEVEL--;
+    Output->Level--;
 }
 
 /// <summary>
@@ -1285,13 +1416,13 @@ static void DumpInstrumentZoneGenerators(const bank_t & bank, size_t fromIndex,
 /// </summary>
 static void DumpInstrumentZoneModulators(const bank_t & bank, size_t fromIndex, size_t toIndex) noexcept
 {
-    __TRACE_LEVEL++;
+    Output->Level++;
 
     auto Modulator = bank.InstrumentModulators.begin() + fromIndex;
 
     for (size_t Index = fromIndex; Index < toIndex; ++Modulator, ++Index)
     {
-        ::printf("%*s%5zu. Src Op: 0x%04X (%s), Dst Op: 0x%04X (%s), Amount: %6d, Src Op Amount: 0x%04X (%s), Transform Op: 0x%04X (%s)\n", __TRACE_LEVEL * 4, "", Index,
+        Output->Printf("%*s%5zu. Src Op: 0x%04X (%s), Dst Op: 0x%04X (%s), Amount: %6d, Src Op Amount: 0x%04X (%s), Transform Op: 0x%04X (%s)\n", Output->Level * 4, "", Index,
             Modulator->SrcOper,        bank.DescribeModulatorSource(Modulator->SrcOper).c_str(),
             Modulator->DstOper,        bank.DescribeGenerator(Modulator->DstOper, Modulator->Amount).c_str(),
             Modulator->Amount,
@@ -1300,7 +1431,7 @@ static void DumpInstrumentZoneModulators(const bank_t & bank, size_t fromIndex,
         );
     }
 
-    __TRACE_LEVEL--;
+    Output->Level--;
 }
 
 /// <summary>
@@ -1308,18 +1439,18 @@ static void DumpInstrumentZoneModulators(const bank_t & bank, size_t fromIndex,
 /// </summary>
 static void DumpPresetZones(const bank_t & bank) noexcept
 {
-    ::printf("%*sPreset Zones (%zu)\n", __TRACE_LEVEL * 4, "", bank.PresetZones.size());
+    Output->Printf("%*sPreset Zones (%zu)\n", Output->Level * 4, "", bank.PresetZones.size());
 
-    __TRACE_LEVEL++;
+    Output->Level++;
 
     size_t i = 0;
 
     for (const auto & pz : bank.PresetZones)
     {
-        ::printf("%*s%5zu. Generator: %5d, Modulator: %5d\n", __TRACE_LEVEL * 4, "", i++, pz.GeneratorIndex, pz.ModulatorIndex);
+        Output->Printf("%*s%5zu. Generator: %5d, Modulator: %5d\n", Output->Level * 4, "", i++, pz.GeneratorIndex, pz.ModulatorIndex);
     }
 
-    __TRACE_LEVEL--;
+    Output->Level--;
 }
 
 /// <summary>
@@ -1330,45 +1461,631 @@ static void DumpSamples(const bank_t & bank) noexcept
     if (bank.Samples.size() == 0)
         return;
 
-    ::printf("%*sSamples (%zu)\n", __TRACE_LEVEL * 4, "", bank.Samples.size() - 1);
+    Output->Printf("%*sSamples (%zu)\n", Output->Level * 4, "", bank.Samples.size() - 1);
 
-    __TRACE_LEVEL++;
+    Output->Level++;
 
     size_t i = 0;
 
     for (const auto & Sample : bank.Samples)
     {
-        ::printf("%*s%5zu. \"%-20s\", %9d-%9d, Loop: %9d-%9d, %6d Hz, Pitch (MIDI Key): %3d, Pitch Correction: %3d, Linked Sample: %5d, Type: 0x%04X \"%s\"", __TRACE_LEVEL * 4, "", i++,
+        Output->Printf("%*s%5zu. \"%-20s\", %9d-%9d, Loop: %9d-%9d, %6d Hz, Pitch (MIDI Key): %3d, Pitch Correction: %3d, Linked Sample: %5d, Type: 0x%04X \"%s\"", Output->Level * 4, "", i++,
             Sample.Name.c_str(), Sample.Start, Sample.End, Sample.LoopStart, Sample.LoopEnd,
             Sample.SampleRate, Sample.Pitch, Sample.PitchCorrection,
             Sample.SampleLink, Sample.SampleType, bank.DescribeSampleType(Sample.SampleType).c_str());
 
         if ((Sample.End - Sample.Start) < 48)
-            ::printf(" Warning: Sample should have at least 48 data points.\n");
+            Output->Printf(" Warning: Sample should have at least 48 data points.\n");
         else
         if (Sample.LoopStart != Sample.LoopEnd)
         {
             if (Sample.Start >= (Sample.LoopStart - 7))
-                ::printf(" Warning: Sample start should be at least 8 data points before sample loop start.\n");
+                Output->Printf(" Warning: Sample start should be at least 8 data points before sample loop start.\n");
             else
             if (Sample.End <= (Sample.LoopEnd - 7))
-                ::printf(" Warning: Sample end should be at least 8 data points after sample loop end.\n");
+                Output->Printf(" Warning: Sample end should be at least 8 data points after sample loop end.\n");
             else
             if ((Sample.LoopEnd - Sample.LoopStart) < 32)
-                ::printf(" Warning: Sample loop should have at least 32 data points.\n");
+                Output->Printf(" Warning: Sample loop should have at least 32 data points.\n");
             else
-                ::putchar('\n');
+                Output->Printf("\n");
         }
         else
-            ::putchar('\n');
+            Output->Printf("\n");
 
         if (i == bank.Samples.size() - 1)
             break;
     }
 
-    __TRACE_LEVEL--;
+    Output->Level--;
+}
+
+
+/// <summary>
+/// Dumps the metrics collected while processing a file.
+/// </summary>
+static void DumpMetrics(const metrics_t & metrics) noexcept
+{
+    Output->Printf("\n%*sMetrics\n", Output->Level * 4, "");
+    Output->Level++;
+
+    for (const auto & Entry : metrics.Entries())
+    {
+        const std::string Name = (Entry.ChunkId != 0) ? std::string(Entry.Name) + " " + GetFourCC(Entry.ChunkId) : std::string(Entry.Name);
+
+        Output->Printf("%*s%-36s %8llu x, %10.3f ms, %12llu bytes, %8llu allocations (%llu bytes)\n", Output->Level * 4, "",
+            Name.c_str(), Entry.Count, (double) Entry.Time / 1'000'000., Entry.Bytes, Entry.Allocations, Entry.AllocatedBytes);
+    }
+
+    Output->Level--;
+}
+
+/// <summary>
+/// Serializes the specified file as a single structured record.
+/// </summary>
+static void SerializeFile(const fs::path & filePath, serializer_t & s)
+{
+    s.BeginObject();
+
+    s.Field("file", (const char *) filePath.u8string().c_str());
+    s.Field("size", (uint64_t) fs::file_size(filePath));
+
+    metrics_t Metrics;
+
+    if (Arguments.IsSet("metrics"))
+        metrics_t::Attach(&Metrics);
+
+    try
+    {
+        const std::string FileExtension = filePath.extension().string();
+
+        if (IsOneOf(filePath.extension(), { ".dls", ".dlp" }))
+        {
+            sf::dls::collection_t dls;
+
+            msc::file_stream_t fs;
+
+            if (fs.Open(filePath))
+            {
+                sf::dls::reader_t dr;
+
+                if (dr.Open(&fs, riff::reader_t::option_t::None))
+                    dr.Process(dls, sf::dls::reader_options_t(false));
+
+                fs.Close();
+            }
+
+            SerializeDLS(dls, s);
+        }
+        else
+        if (IsOneOf(filePath.extension(), { ".sbk", ".sf2", ".sf3", ".sf4", ".arl" }))
+        {
+            sf::bank_t Bank;
+
+            msc::file_stream_t fs;
+
+            if (fs.Open(filePath))
+            {
+                sf::reader_t sr;
+
+                if (sr.Open(&fs, riff::reader_t::option_t::None))
+                    sr.Process(Bank, sf::soundfont_reader_options_t(false));
+
+                fs.Close();
+            }
+
+            SerializeSF(Bank, s);
+        }
+        else
+        if (::_stricmp(FileExtension.c_str(), ".ecw") == 0)
+        {
+            ecw::waveset_t ws;
+
+            msc::file_stream_t fs;
+
+            if (fs.Open(filePath))
+            {
+                ecw::reader_t er;
+
+                if (er.Open(&fs))
+                    er.Process(ws);
+
+                fs.Close();
+            }
+
+            SerializeECW(ws, s);
+        }
+    }
+    catch (const std::exception & e)
+    {
+        s.Field("error", e.what());
+    }
+
+    metrics_t::Attach(nullptr);
+
+    if (Arguments.IsSet("metrics"))
+    {
+        s.Key("metrics");
+        s.BeginArray();
+
+        for (const auto & Entry : Metrics.Entries())
+        {
+            s.BeginObject();
+            s.Field("name", Entry.Name);
+
+            if (Entry.ChunkId != 0)
+                s.Field("chunkId", GetFourCC(Entry.ChunkId).c_str());
+
+            s.Field("count", Entry.Count);
+            s.Field("time", Entry.Time);
+            s.Field("bytes", Entry.Bytes);
+            s.Field("allocations", Entry.Allocations);
+            s.Field("allocatedBytes", Entry.AllocatedBytes);
+            s.EndObject();
+        }
+
+        s.EndArray();
+    }
+
+    s.EndObject();
+    s.EndRecord();
+}
+
+/// <summary>
+/// Serializes a zone generator list.
+/// </summary>
+static void SerializeGenerators(const std::vector<generator_t> & generators, size_t fromIndex, size_t toIndex, serializer_t & s)
+{
+    s.Key("generators");
+    s.BeginArray();
+
+    for (size_t i = fromIndex; i < std::min(toIndex, generators.size()); ++i)
+    {
+        s.BeginObject();
+        s.Field("operator", generators[i].Operator);
+        s.Field("amount", generators[i].Amount);
+        s.EndObject();
+    }
+
+    s.EndArray();
+}
+
+/// <summary>
+/// Serializes a zone modulator list.
+/// </summary>
+static void SerializeModulators(const std::vector<modulator_t> & modulators, size_t fromIndex, size_t toIndex, serializer_t & s)
+{
+    s.Key("modulators");
+    s.BeginArray();
+
+    for (size_t i = fromIndex; i < std::min(toIndex, modulators.size()); ++i)
+    {
+        const auto & m = modulators[i];
+
+        s.BeginObject();
+        s.Field("srcOperator", m.SrcOper);
+        s.Field("dstOperator", (uint16_t) m.DstOper);
+        s.Field("amount", m.Amount);
+        s.Field("amountSrcOperator", m.SrcOperAmt);
+        s.Field("transformOperator", m.TransformOper);
+        s.EndObject();
+    }
+
+    s.EndArray();
+}
+
+/// <summary>
+/// Serializes a list of properties. The keys are the chunk ids.
+/// </summary>
+static void SerializeProperties(const properties_t & properties, serializer_t & s)
+{
+    s.Key("properties");
+    s.BeginObject();
+
+    for (const auto & [ ChunkId, Value ] : properties)
+    {
+        s.Key(GetFourCC(ChunkId));
+        s.Value(Value);
+    }
+
+    s.EndObject();
+}
+
+/// <summary>
+/// Serializes an SF bank.
+/// </summary>
+static void SerializeSF(const bank_t & bank, serializer_t & s)
+{
+    s.Field("format", "sf");
+    s.Field("major", bank.Major);
+    s.Field("minor", bank.Minor);
+    s.Field("soundEngine", bank.SoundEngine);
+    s.Field("name", bank.Name);
+
+    if ((bank.ROMName.length() != 0) && !((bank.ROMMajor == 0) && (bank.ROMMinor == 0)))
+    {
+        s.Key("rom");
+        s.BeginObject();
+        s.Field("name", bank.ROMName);
+        s.Field("major", bank.ROMMajor);
+        s.Field("minor", bank.ROMMinor);
+        s.EndObject();
+    }
+
+    SerializeProperties(bank.Properties, s);
+
+    // Don't count the terminal records.
+    s.Field("presetCount", !bank.Presets.empty() ? bank.Presets.size() - 1 : 0);
+    s.Field("instrumentCount", !bank.Instruments.empty() ? bank.Instruments.size() - 1 : 0);
+    s.Field("sampleCount", !bank.Samples.empty() ? bank.Samples.size() - 1 : 0);
+
+    if (Arguments.IsSet("presets") && !bank.Presets.empty())
+    {
+        s.Key("presets");
+        s.BeginArray();
+
+        for (size_t i = 0; i < bank.Presets.size() - 1; ++i)
+        {
+            const auto & Preset = bank.Presets[i];
+
+            s.BeginObject();
+            s.Field("name", Preset.Name);
+            s.Field("bank", Preset.MIDIBank);
+            s.Field("program", Preset.MIDIProgram);
+
+            s.Key("zones");
+            s.BeginArray();
+
+            for (size_t j = Preset.ZoneIndex; j < std::min((size_t) bank.Presets[i + 1].ZoneIndex, bank.PresetZones.size() - 1); ++j)
+            {
+                const auto & Zone = bank.PresetZones[j];
+                const auto & NextZone = bank.PresetZones[j + 1];
+
+                s.BeginObject();
+                SerializeGenerators(bank.PresetGenerators, Zone.GeneratorIndex, NextZone.GeneratorIndex, s);
+                SerializeModulators(bank.PresetModulators, Zone.ModulatorIndex, NextZone.ModulatorIndex, s);
+                s.EndObject();
+            }
+
+            s.EndArray();
+            s.EndObject();
+        }
+
+        s.EndArray();
+    }
+
+    if (Arguments.IsSet("instruments") && !bank.Instruments.empty())
+    {
+        s.Key("instruments");
+        s.BeginArray();
+
+        for (size_t i = 0; i < bank.Instruments.size() - 1; ++i)
+        {
+            const auto & Instrument = bank.Instruments[i];
+
+            s.BeginObject();
+            s.Field("name", Instrument.Name);
+
+            s.Key("zones");
+            s.BeginArray();
+
+            for (size_t j = Instrument.ZoneIndex; j < std::min((size_t) bank.Instruments[i + 1].ZoneIndex, bank.InstrumentZones.size() - 1); ++j)
+            {
+                const auto & Zone = bank.InstrumentZones[j];
+                const auto & NextZone = bank.InstrumentZones[j + 1];
+
+                s.BeginObject();
+                SerializeGenerators(bank.InstrumentGenerators, Zone.GeneratorIndex, NextZone.GeneratorIndex, s);
+                SerializeModulators(bank.InstrumentModulators, Zone.ModulatorIndex, NextZone.ModulatorIndex, s);
+                s.EndObject();
+            }
+
+            s.EndArray();
+            s.EndObject();
+        }
+
+        s.EndArray();
+    }
+
+    if (Arguments.IsSet("samples") && !bank.Samples.empty())
+    {
+        s.Key("samples");
+        s.BeginArray();
+
+        for (size_t i = 0; i < bank.Samples.size() - 1; ++i)
+        {
+            const auto & Sample = bank.Samples[i];
+
+            s.BeginObject();
+            s.Field("name", Sample.Name);
+            s.Field("start", Sample.Start);
+            s.Field("end", Sample.End);
+            s.Field("loopStart", Sample.LoopStart);
+            s.Field("loopEnd", Sample.LoopEnd);
+            s.Field("sampleRate", Sample.SampleRate);
+            s.Field("pitch", Sample.Pitch);
+            s.Field("pitchCorrection", Sample.PitchCorrection);
+            s.Field("sampleLink", Sample.SampleLink);
+            s.Field("sampleType", Sample.SampleType);
+            s.EndObject();
+        }
+
+        s.EndArray();
+    }
+}
+
+/// <summary>
+/// Serializes a list of DLS articulators.
+/// </summary>
+static void SerializeArticulators(const std::vector<dls::articulator_t> & articulators, serializer_t & s)
+{
+    s.Key("articulators");
+    s.BeginArray();
+
+    for (const auto & Articulator : articulators)
+    {
+        s.BeginArray();
+
+        for (const auto & cb : Articulator.ConnectionBlocks)
+        {
+            s.BeginObject();
+            s.Field("source", cb.Source);
+            s.Field("control", cb.Control);
+            s.Field("destination", cb.Destination);
+            s.Field("transform", cb.Transform);
+            s.Field("scale", cb.Scale);
+            s.EndObject();
+        }
+
+        s.EndArray();
+    }
+
+    s.EndArray();
 }
 
+/// <summary>
+/// Serializes a DLS collection.
+/// </summary>
+static void SerializeDLS(const dls::collection_t & dls, serializer_t & s)
+{
+    s.Field("format", "dls");
+    s.Field("major", dls.Major);
+    s.Field("minor", dls.Minor);
+    s.Field("revision", dls.Revision);
+    s.Field("build", dls.Build);
+
+    SerializeProperties(dls.Properties, s);
+
+    s.Field("instrumentCount", dls.Instruments.size());
+    s.Field("waveCount", dls.Waves.size());
+
+    if (Arguments.IsSet("presets") || Arguments.IsSet("instruments"))
+    {
+        s.Key("instruments");
+        s.BeginArray();
+
+        for (const auto & Instrument : dls.Instruments)
+        {
+            s.BeginObject();
+            s.Field("name", Instrument.Name);
+            s.Field("bankMSB", Instrument.BankMSB);
+            s.Field("bankLSB", Instrument.BankLSB);
+            s.Field("program", Instrument.Program);
+            s.Field("isPercussion", Instrument.IsPercussion);
+
+            s.Key("regions");
+            s.BeginArray();
+
+            for (const auto & Region : Instrument.Regions)
+            {
+                s.BeginObject();
+                s.Field("lowKey", Region.LowKey);
+                s.Field("highKey", Region.HighKey);
+                s.Field("lowVelocity", Region.LowVelocity);
+                s.Field("highVelocity", Region.HighVelocity);
+                s.Field("options", Region.Options);
+                s.Field("keyGroup", Region.KeyGroup);
+                s.Field("cueIndex", Region.WaveLink.CueIndex);
+
+                SerializeArticulators(Region.Articulators, s);
+
+                s.EndObject();
+            }
+
+            s.EndArray();
+
+            SerializeArticulators(Instrument.Articulators, s);
+
+            s.EndObject();
+        }
+
+        s.EndArray();
+    }
+
+    if (Arguments.IsSet("samples"))
+    {
+        s.Key("waves");
+        s.BeginArray();
+
+        for (const auto & Wave : dls.Waves)
+        {
+            s.BeginObject();
+            s.Field("name", Wave.Name);
+            s.Field("formatTag", Wave.FormatTag);
+            s.Field("channels", Wave.Channels);
+            s.Field("samplesPerSec", Wave.SamplesPerSec);
+            s.Field("bitsPerSample", Wave.BitsPerSample);
+            s.EndObject();
+        }
+
+        s.EndArray();
+    }
+}
+
+/// <summary>
+/// Serializes a list of 128-entry ECW maps.
+/// </summary>
+template <typename T, typename F> static void SerializeMaps(std::string_view name, const std::vector<T> & maps, F entries, serializer_t & s)
+{
+    s.Key(name);
+    s.BeginArray();
+
+    for (const auto & Map : maps)
+    {
+        s.BeginArray();
+
+        for (const auto Entry : entries(Map))
+            s.Value(Entry);
+
+        s.EndArray();
+    }
+
+    s.EndArray();
+}
+
+/// <summary>
+/// Serializes an ECW waveset.
+/// </summary>
+static void SerializeECW(const ecw::waveset_t & ws, serializer_t & s)
+{
+    s.Field("format", "ecw");
+    s.Field("name", ws.Name);
+    s.Field("copyright", ws.Copyright);
+    s.Field("description", ws.Description);
+    s.Field("information", ws.Information);
+    s.Field("fileName", ws.FileName);
+
+    s.Field("instrumentCount", ws.Instruments.size());
+    s.Field("patchCount", ws.Patches.size());
+    s.Field("sampleSetCount", ws.SampleSets.size());
+    s.Field("sampleCount", ws.Samples.size());
+    s.Field("sampleDataSize", ws.SampleData.size());
+
+    if (Arguments.IsSet("presets"))
+    {
+        SerializeMaps("bankMaps",      ws.BankMaps,      [](const ecw::bank_map_t & m)       { return std::span(m.MIDIPatchMaps); }, s);
+        SerializeMaps("drumKitMaps",   ws.DrumKitMaps,   [](const ecw::drum_kit_map_t & m)   { return std::span(m.DrumNoteMaps); }, s);
+        SerializeMaps("midiPatchMaps", ws.MIDIPatchMaps, [](const ecw::midi_patch_map_t & m) { return std::span(m.Instruments); }, s);
+        SerializeMaps("drumNoteMaps",  ws.DrumNoteMaps,  [](const ecw::drum_note_map_t & m)  { return std::span(m.Instruments); }, s);
+    }
+
+    if (Arguments.IsSet("instruments"))
+    {
+        s.Key("instruments");
+        s.BeginArray();
+
+        for (const auto & Instrument : ws.Instruments)
+        {
+            s.BeginObject();
+            s.Field("type", Instrument.Type);
+
+            if (Instrument.Type == 2)
+            {
+                const auto & iv1 = (const ecw::instrument_v1_t &) Instrument;
+
+                s.Field("subType", iv1.SubType);
+                s.Field("noteThreshold", iv1.NoteThreshold);
+
+                s.Key("subHeaders");
+                s.BeginArray();
+
+                for (const auto & sh : iv1.SubHeaders)
+                {
+                    s.BeginObject();
+                    s.Field("patchIndex", sh.PatchIndex);
+                    s.Field("amplitude", sh.Amplitude);
+                    s.Field("pan", sh.Pan);
+                    s.Field("coarseTune", sh.CoarseTune);
+                    s.Field("fineTune", sh.FineTune);
+                    s.Field("delay", sh.Delay);
+                    s.Field("group", sh.Group);
+                    s.EndObject();
+                }
+
+                s.EndArray();
+            }
+            else
+            if (Instrument.Type == 255)
+            {
+                const auto & iv2 = (const ecw::instrument_v2_t &) Instrument;
+
+                s.Key("subHeaders");
+                s.BeginArray();
+
+                for (const auto & sh : iv2.SubHeaders)
+                {
+                    s.BeginObject();
+                    s.Field("instrumentIndex", sh.InstrumentIndex);
+                    s.Field("noteThreshold", sh.NoteThreshold);
+                    s.EndObject();
+                }
+
+                s.EndArray();
+            }
+
+            s.EndObject();
+        }
+
+        s.EndArray();
+
+        s.Key("patches");
+        s.BeginArray();
+
+        for (const auto & Patch : ws.Patches)
+        {
+            s.BeginObject();
+            s.Field("array1Index", Patch.Array1Index);
+            s.Field("detune", Patch.Detune);
+            s.Field("splitPointAdjust", Patch.SplitPointAdjust);
+            s.Field("initialAmplitude", Patch.InitialAmplitude);
+            s.Field("amplitudeAttackTime", Patch.AmplitudeAttackTime);
+            s.Field("amplitudeDecayTime", Patch.AmplitudeDecayTime);
+            s.Field("amplitudeSustainLevel", Patch.AmplitudeSustainLevel);
+            s.Field("amplitudeReleaseTime", Patch.AmplitudeReleaseTime);
+            s.EndObject();
+        }
+
+        s.EndArray();
+    }
+
+    if (Arguments.IsSet("samples"))
+    {
+        s.Key("sampleSets");
+        s.BeginArray();
+
+        for (const auto & SampleSet : ws.SampleSets)
+        {
+            s.BeginObject();
+            s.Field("name", SampleSet.Name);
+            s.Field("sampleIndex", SampleSet.SampleIndex);
+            s.Field("array1Index", SampleSet.Array1Index);
+            s.Field("code", SampleSet.Code);
+            s.EndObject();
+        }
+
+        s.EndArray();
+
+        s.Key("samples");
+        s.BeginArray();
+
+        for (const auto & Sample : ws.Samples)
+        {
+            s.BeginObject();
+            s.Field("name", Sample.Name);
+            s.Field("lowKey", Sample.LowKey);
+            s.Field("highKey", Sample.HighKey);
+            s.Field("flags", Sample.Flags);
+            s.Field("fineTune", Sample.FineTune);
+            s.Field("coarseTune", Sample.CoarseTune);
+            s.Field("sampleStart", Sample.SampleStart);
+            s.Field("loopStart", Sample.LoopStart);
+            s.Field("loopEnd", Sample.LoopEnd);
+            s.EndObject();
+        }
+
+        s.EndArray();
+    }
+}
 
 /// <summary>
 /// Describes a SoundFont Generator (8.1).
@@ -1612,3 +2329,13 @@ static const char * GetChunkName(const uint32_t chunkId) noexcept
 
     return (it != ChunkNames.end()) ? it->second : "Unknown";
 }
+
+/// <summary>
+/// Gets the FOURCC of a chunk as a string.
+/// </summary>
+static std::string GetFourCC(const uint32_t chunkId)
+{
+    const char Id[] = { (char) (chunkId & 0xFF), (char) ((chunkId >> 8) & 0xFF), (char) ((chunkId >> 16) & 0xFF), (char) (chunkId >> 24) };
+
+    return std::string(Id, sizeof(Id));
+}